@@ -99,6 +99,16 @@ PrintChoices("Precision"
   1
   36
 )
+PrintChoices("Compact particles"
+  "compact_prtl"
+  "${ON_OFF_VALUES}"
+  ${compact_prtl}
+  ${default_compact_prtl}
+  "${Green}"
+  COMPACT_PRTL_REPORT
+  0
+  36
+)
 PrintChoices("Output"
   "output"
   "${ON_OFF_VALUES}"
@@ -275,6 +285,7 @@ if(${PGEN_FOUND})
 endif()
 
 message("  ${PRECISION_REPORT}")
+message("  ${COMPACT_PRTL_REPORT}")
 message("  ${OUTPUT_REPORT}")
 message("${DASHED_LINE_SYMBOL}
 Compile configurations")
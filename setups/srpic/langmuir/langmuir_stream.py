@@ -0,0 +1,32 @@
+# In-situ analysis of the streamed output
+#
+# Run the simulation with `format = "SST"` in the [output] block of
+# `langmuir.toml` & start this script in the same directory (at the same time,
+# or before the simulation): each output step is received over the network
+# instead of being written to disk
+#
+# Requires the python bindings of ADIOS2 (>= 2.10) built with SST support
+
+import adios2
+import numpy as np
+import matplotlib.pyplot as plt
+
+adios = adios2.Adios()
+io = adios.declare_io("langmuir-reader")
+io.set_engine("SST")
+
+with adios2.Stream(io, "langmuir", "r") as stream:
+    for _ in stream.steps():
+        step = stream.read("Step")
+        time = stream.read("Time")
+        ex = stream.read("fE1")
+        rho = stream.read("fRho")
+        print(f"step {int(step)}, t = {float(time):.4f}: <Ex^2> = {np.mean(ex**2):.4e}")
+
+        fig = plt.figure(figsize=(10, 5), dpi=150)
+        ax = fig.add_subplot(211)
+        ax.imshow(rho, cmap="inferno", vmin=0, vmax=4, origin="lower")
+        ax = fig.add_subplot(212)
+        ax.imshow(ex, cmap="RdBu_r", vmin=-1, vmax=1, origin="lower")
+        fig.savefig(f"langmuir_{int(step):08d}.png")
+        plt.close(fig)
@@ -208,8 +208,8 @@ namespace user {
             auto gamma   = math::sqrt(ONE + SQR(px) + SQR(py) + SQR(pz));
 
             const coord_t<D> xCd{
-                static_cast<real_t>(i1(p)) + dx1(p),
-                static_cast<real_t>(i2(p)) + dx2(p)};
+                static_cast<real_t>(i1(p)) + from_prtldx(dx1(p)),
+                static_cast<real_t>(i2(p)) + from_prtldx(dx2(p))};
 
             coord_t<D> xPh { ZERO };
             metric.template convert<Crd::Cd, Crd::Ph>(xCd, xPh);
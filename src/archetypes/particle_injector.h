@@ -216,6 +216,10 @@ namespace arch {
       Kokkos::deep_copy(ni, ni_h);
       const auto nparticles = static_cast<std::size_t>(
         (long double)(ppc0 * number_density * 0.5) * (long double)(ncells));
+      domain.species[injector.species.first - 1].Reserve(
+        domain.species[injector.species.first - 1].npart() + nparticles);
+      domain.species[injector.species.second - 1].Reserve(
+        domain.species[injector.species.second - 1].npart() + nparticles);
 
       Kokkos::parallel_for(
         "InjectUniform",
@@ -256,8 +260,11 @@ namespace arch {
                              const std::map<std::string, std::vector<real_t>>& data,
                              bool use_weights = false) {
     static_assert(M::is_metric, "M must be a metric class");
-    const auto n_inject        = data.at("ux1").size();
-    auto       injector_kernel = kernel::GlobalInjector_kernel<S, M>(
+    const auto n_inject = data.at("ux1").size();
+    // upper bound: only the particles within the local domain are injected
+    local_domain.species[spidx - 1].Reserve(
+      local_domain.species[spidx - 1].npart() + n_inject);
+    auto injector_kernel = kernel::GlobalInjector_kernel<S, M>(
       local_domain.species[spidx - 1],
       global_domain.mesh().metric,
       local_domain,
@@ -309,8 +316,12 @@ namespace arch {
     }
     {
       range_t<M::Dim> cell_range;
+      std::size_t     ncells = 1;
       if (box.size() == 0) {
         cell_range = domain.mesh.rangeActiveCells();
+        for (auto d = 0; d < M::Dim; ++d) {
+          ncells *= domain.mesh.n_active()[d];
+        }
       } else {
         raise::ErrorIf(box.size() != M::Dim,
                        "Box must have the same dimension as the mesh",
@@ -322,13 +333,20 @@ namespace arch {
         const auto extent = domain.mesh.ExtentToRange(box, incl_ghosts);
         tuple_t<std::size_t, M::Dim> x_min { 0 }, x_max { 0 };
         for (auto d = 0; d < M::Dim; ++d) {
-          x_min[d] = extent[d].first;
-          x_max[d] = extent[d].second;
+          x_min[d]  = extent[d].first;
+          x_max[d]  = extent[d].second;
+          ncells   *= x_max[d] - x_min[d];
         }
         cell_range = CreateRangePolicy<M::Dim>(x_min, x_max);
       }
       const auto ppc = number_density *
                        params.template get<real_t>("particles.ppc0") * HALF;
+      // upper bound, assuming the spatial distribution does not exceed 1
+      const auto nmax = static_cast<std::size_t>(ppc) * ncells;
+      domain.species[injector.species.first - 1].Reserve(
+        domain.species[injector.species.first - 1].npart() + nmax);
+      domain.species[injector.species.second - 1].Reserve(
+        domain.species[injector.species.second - 1].npart() + nmax);
       auto injector_kernel =
         kernel::NonUniformInjector_kernel<S, M, typename I::energy_dist_t, typename I::spatial_dist_t>(
           ppc,
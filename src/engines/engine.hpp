@@ -120,7 +120,19 @@ namespace ntt {
     void print_report() const;
     void print_step_report(timer::Timers&, pbar::DurationHistory&, bool, bool) const;
 
-    virtual void step_forward(timer::Timers&, Domain<S, M>&) = 0;
+    /**
+     * @brief Appends the timings, work counters & MPI traffic of the current
+     * step (min/mean/max across the ranks) to `diagnostics.report_path`
+     * @note Does nothing if `diagnostics.report` is disabled
+     */
+    void write_perf_report(const timer::Timers&) const;
+
+    /**
+     * @brief Advances all the local domains by a single timestep
+     * @note The domains are advanced in lockstep, so that the exchanges
+     * between them are performed at once
+     */
+    virtual void step_forward(timer::Timers&) = 0;
 
     void run();
   };
@@ -15,6 +15,8 @@
 
 #include <Kokkos_Core.hpp>
 
+#include <tuple>
+
 namespace ntt {
 
   template <SimEngine::type S, class M>
@@ -22,8 +24,18 @@ namespace ntt {
     if constexpr (pgen_is_ok) {
 #if defined(OUTPUT_ENABLED)
       m_metadomain.InitWriter(m_params);
+      m_metadomain.InitCheckpointWriter(m_params);
 #endif
       logger::Checkpoint("Initializing Engine", HERE);
+      if (m_params.template get<bool>("checkpoint.is_resuming")) {
+#if defined(OUTPUT_ENABLED)
+        logger::Checkpoint("Resuming from a checkpoint", HERE);
+        std::tie(step, time) = m_metadomain.ContinueFromCheckpoint(m_params);
+        return;
+#else
+        raise::Error("Resuming from a checkpoint requires output enabled", HERE);
+#endif
+      }
       if constexpr (
         traits::has_member<traits::pgen::init_flds_t, user::PGen<S, M>>::value) {
         logger::Checkpoint("Initializing fields from problem generator", HERE);
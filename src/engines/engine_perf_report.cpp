@@ -0,0 +1,170 @@
+#include "enums.h"
+#include "global.h"
+
+#include "arch/directions.h"
+#include "arch/mpi_aliases.h"
+#include "utils/error.h"
+#include "utils/formatting.h"
+#include "utils/timer.h"
+
+#include "metrics/kerr_schild.h"
+#include "metrics/kerr_schild_0.h"
+#include "metrics/minkowski.h"
+#include "metrics/qkerr_schild.h"
+#include "metrics/qspherical.h"
+#include "metrics/spherical.h"
+
+#include "engines/engine.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace ntt {
+  namespace {
+    /**
+     * @brief Rate of a counter named `<name>:<quantity>` per second, if there
+     * is a timer (or a sub-timer) `<name>`
+     */
+    void AddRates(std::vector<std::string>& names, std::vector<long double>& values) {
+      const auto ncounted = names.size();
+      for (std::size_t i { 0 }; i < ncounted; ++i) {
+        const auto sep = names[i].rfind(':');
+        if (sep == std::string::npos) {
+          continue;
+        }
+        const auto timer = std::find(names.begin(),
+                                     names.begin() + ncounted,
+                                     names[i].substr(0, sep));
+        if (timer == names.begin() + ncounted) {
+          continue;
+        }
+        const auto duration = values[timer - names.begin()] * 1e-6;
+        names.push_back(names[i] + "/s");
+        values.push_back(duration > 0.0 ? values[i] / duration : 0.0);
+      }
+    }
+  } // namespace
+
+  template <SimEngine::type S, class M>
+  void Engine<S, M>::write_perf_report(const timer::Timers& timers) const {
+    const auto format = m_params.template get<std::string>("diagnostics.report");
+    if (format == "disabled") {
+      return;
+    }
+    // quantities measured on this rank: durations [us] of the timers &
+    // ... sub-timers, work counters, MPI traffic & derived rates
+    std::vector<std::string> names;
+    std::vector<long double> values;
+    for (const auto& name : timers.names()) {
+      names.push_back(name);
+      values.push_back(timers.get(name));
+    }
+    for (const auto& [name, value] : timers.counters()) {
+      names.push_back(name);
+      values.push_back(value);
+    }
+    const auto& directions = dir::Directions<M::Dim>::all;
+    const auto& comm_bytes = m_metadomain.comm_bytes();
+    for (std::size_t d { 0 }; d < directions.size(); ++d) {
+      std::string dir_str = "";
+      for (const auto& di : directions[d]) {
+        dir_str += (di > 0) ? "+" : ((di < 0) ? "-" : "0");
+      }
+      names.push_back(fmt::format("Communications[%s]:bytes_sent", dir_str.c_str()));
+      values.push_back(comm_bytes[d].first);
+      names.push_back(fmt::format("Communications[%s]:bytes_recv", dir_str.c_str()));
+      values.push_back(comm_bytes[d].second);
+    }
+    AddRates(names, values);
+
+    // statistics across the ranks
+    const auto               nvalues = values.size();
+    std::vector<long double> v_min { values }, v_max { values }, v_mean { values };
+#if defined(MPI_ENABLED)
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    std::size_t nvalues_min, nvalues_max;
+    MPI_Allreduce(&nvalues,
+                  &nvalues_min,
+                  1,
+                  mpi::get_type<std::size_t>(),
+                  MPI_MIN,
+                  MPI_COMM_WORLD);
+    MPI_Allreduce(&nvalues,
+                  &nvalues_max,
+                  1,
+                  mpi::get_type<std::size_t>(),
+                  MPI_MAX,
+                  MPI_COMM_WORLD);
+    raise::ErrorIf(nvalues_min != nvalues_max,
+                   "Different quantities measured on different ranks",
+                   HERE);
+    std::vector<long double> all_values(rank == MPI_ROOT_RANK ? nvalues * size : 0);
+    MPI_Gather(values.data(),
+               nvalues,
+               mpi::get_type<long double>(),
+               all_values.data(),
+               nvalues,
+               mpi::get_type<long double>(),
+               MPI_ROOT_RANK,
+               MPI_COMM_WORLD);
+    if (rank != MPI_ROOT_RANK) {
+      return;
+    }
+    for (std::size_t i { 0 }; i < nvalues; ++i) {
+      v_mean[i] = 0.0;
+      for (auto r { 0 }; r < size; ++r) {
+        const auto value  = all_values[r * nvalues + i];
+        v_min[i]          = std::min(v_min[i], value);
+        v_max[i]          = std::max(v_max[i], value);
+        v_mean[i]        += value / size;
+      }
+    }
+#endif
+
+    const auto path = m_params.template get<std::string>("diagnostics.report_path");
+    const auto is_new = not std::filesystem::exists(path) or
+                        std::filesystem::is_empty(path);
+    std::ofstream report(path, std::ios::app);
+    raise::ErrorIf(not report.is_open(),
+                   "Could not open the performance report file " + path,
+                   HERE);
+    report << std::setprecision(8);
+    if (format == "csv") {
+      // long format: one row per quantity
+      if (is_new) {
+        report << "step,time,quantity,min,mean,max\n";
+      }
+      for (std::size_t i { 0 }; i < nvalues; ++i) {
+        report << step << "," << time << "," << names[i] << "," << v_min[i]
+               << "," << v_mean[i] << "," << v_max[i] << "\n";
+      }
+    } else if (format == "json") {
+      // one JSON object per line
+      report << "{\"step\": " << step << ", \"time\": " << time << ", \"quantities\": {";
+      for (std::size_t i { 0 }; i < nvalues; ++i) {
+        report << (i > 0 ? ", " : "") << "\"" << names[i] << "\": {\"min\": "
+               << v_min[i] << ", \"mean\": " << v_mean[i]
+               << ", \"max\": " << v_max[i] << "}";
+      }
+      report << "}}\n";
+    } else {
+      raise::Error("Unknown performance report format " + format, HERE);
+    }
+  }
+
+  template void Engine<SimEngine::SRPIC, metric::Minkowski<Dim::_1D>>::write_perf_report(const timer::Timers&) const;
+  template void Engine<SimEngine::SRPIC, metric::Minkowski<Dim::_2D>>::write_perf_report(const timer::Timers&) const;
+  template void Engine<SimEngine::SRPIC, metric::Minkowski<Dim::_3D>>::write_perf_report(const timer::Timers&) const;
+  template void Engine<SimEngine::SRPIC, metric::Spherical<Dim::_2D>>::write_perf_report(const timer::Timers&) const;
+  template void Engine<SimEngine::SRPIC, metric::QSpherical<Dim::_2D>>::write_perf_report(const timer::Timers&) const;
+  template void Engine<SimEngine::GRPIC, metric::KerrSchild<Dim::_2D>>::write_perf_report(const timer::Timers&) const;
+  template void Engine<SimEngine::GRPIC, metric::KerrSchild0<Dim::_2D>>::write_perf_report(const timer::Timers&) const;
+  template void Engine<SimEngine::GRPIC, metric::QKerrSchild<Dim::_2D>>::write_perf_report(const timer::Timers&) const;
+} // namespace ntt
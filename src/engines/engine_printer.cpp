@@ -221,6 +221,11 @@ namespace ntt {
         add_param(report, 4, "Kokkos", "%s", kokkos_version.c_str());
         add_param(report, 4, "ADIOS2", "%s", adios2_version.c_str());
         add_param(report, 4, "Precision", "%s", precision);
+        add_param(report,
+                  4,
+                  "Particle displacements",
+                  "%d-bit",
+                  static_cast<int>(8 * sizeof(prtldx_t)));
         add_param(report, 4, "Debug", "%s", dbg.c_str());
         report += "\n";
         add_category(report, 4, "Configuration");
@@ -322,6 +327,14 @@ namespace ntt {
           add_param(report, 6, "Mass", "%.1f", species.mass());
           add_param(report, 6, "Charge", "%.1f", species.charge());
           add_param(report, 6, "Max #", "%d [per domain]", species.maxnpart());
+          if (species.growth_factor() > 1.0f) {
+            add_param(report,
+                      6,
+                      "Capacity",
+                      "growth x%.2f, shrink below %.0f%%",
+                      species.growth_factor(),
+                      100.0 * species.shrink_threshold());
+          }
           add_param(report, 6, "Pusher", "%s", species.pusher().to_string());
           if (species.mass() != 0.0) {
             add_param(report, 6, "GCA", "%s", species.use_gca() ? "ON" : "OFF");
@@ -403,6 +416,11 @@ namespace ntt {
           auto [size, unit] = bytes_to_human_readable(species.memory_footprint());
           add_param(report, 10, str.c_str(), "%.2Lf %s", size, unit.c_str());
         }
+        if (domain.species.size() > 0) {
+          auto [size, unit] = bytes_to_human_readable(
+            domain.prtl_prev.memory_footprint());
+          add_param(report, 10, "Previous coords", "%.2Lf %s", size, unit.c_str());
+        }
         report.pop_back();
         if (idx == m_metadomain.ndomains() - 1) {
           report += "\n\n";
@@ -34,17 +34,22 @@ namespace ntt {
       };
       const auto diag_interval = m_params.get<std::size_t>(
         "diagnostics.interval");
+      if (m_params.get<std::string>("diagnostics.report") != "disabled") {
+        timers.enableCounters();
+      }
 
       auto       time_history  = pbar::DurationHistory { 1000 };
       const auto sort_interval = m_params.template get<std::size_t>(
         "particles.sort_interval");
+      const auto spatial_sort_interval = m_params.template get<std::size_t>(
+        "particles.spatial_sort_interval");
+      const auto lb_interval = m_params.template get<std::size_t>(
+        "simulation.domain.load_balancing.interval");
 
       // main algorithm loop
       while (step < max_steps) {
         // run the engine-dependent algorithm step
-        m_metadomain.runOnLocalDomains([&timers, this](auto& dom) {
-          step_forward(timers, dom);
-        });
+        step_forward(timers);
         // poststep (if defined)
         if constexpr (
           traits::has_method<traits::pgen::custom_poststep_t, decltype(m_pgen)>::value) {
@@ -54,7 +59,15 @@ namespace ntt {
           });
           timers.stop("Custom");
         }
-        auto print_sorting = (sort_interval > 0 and step % sort_interval == 0);
+        // redistribute the cells between the domains (if imbalanced)
+        if (lb_interval > 0 and step > 0 and step % lb_interval == 0) {
+          timers.start("Communications");
+          m_metadomain.Rebalance(m_params);
+          timers.stop("Communications");
+        }
+        auto print_sorting = (sort_interval > 0 and step % sort_interval == 0) or
+                             (spatial_sort_interval > 0 and
+                              step % spatial_sort_interval == 0);
 
         // advance time & timestep
         ++step;
@@ -63,6 +76,7 @@ namespace ntt {
         auto print_output = false;
 #if defined(OUTPUT_ENABLED)
         timers.start("Output");
+        m_metadomain.AccumulateFields(m_params, step);
         if constexpr (
           traits::has_method<traits::pgen::custom_field_output_t, decltype(m_pgen)>::value) {
           auto lambda_custom_field_output = [&](const std::string&    name,
@@ -78,6 +92,9 @@ namespace ntt {
         } else {
           print_output = m_metadomain.Write(m_params, step, time);
         }
+        if (m_metadomain.WriteCheckpoint(m_params, step, time)) {
+          print_output = true;
+        }
         timers.stop("Output");
 #endif
 
@@ -86,8 +103,10 @@ namespace ntt {
         // print final timestep report
         if (diag_interval > 0 and step % diag_interval == 0) {
           print_step_report(timers, time_history, print_output, print_sorting);
+          write_perf_report(timers);
         }
         timers.resetAll();
+        m_metadomain.reset_comm_bytes();
       }
     }
   }
@@ -13,29 +13,872 @@
 #define ENGINES_GRPIC_GRPIC_H
 
 #include "enums.h"
+#include "global.h"
 
+#include "arch/kokkos_aliases.h"
+#include "utils/error.h"
+#include "utils/log.h"
+#include "utils/numeric.h"
 #include "utils/timer.h"
 
 #include "framework/domain/domain.h"
+#include "framework/parameters.h"
 
 #include "engines/engine.hpp"
+#include "kernels/ampere_gr.hpp"
+#include "kernels/aux_fields_gr.hpp"
+#include "kernels/currents_deposit.hpp"
+#include "kernels/digital_filter.hpp"
+#include "kernels/faraday_gr.hpp"
+#include "kernels/fields_bcs.hpp"
+#include "kernels/particle_pusher_gr.hpp"
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_ScatterView.hpp>
+
+#include <algorithm>
+#include <string>
+#include <utility>
 
 namespace ntt {
 
+  /**
+   * @brief Which time levels of D & B are used to compute the auxiliary E
+   */
+  enum class gr_getE {
+    D0_B,
+    D_B0
+  };
+
+  /**
+   * @brief Which time levels of D & B are used to compute the auxiliary H
+   */
+  enum class gr_getH {
+    D_B0,
+    D0_B0
+  };
+
+  /**
+   * @brief Faraday substeps: `aux` advances B0 in-place, `main` writes
+   * B + dt * curl E into B0
+   */
+  enum class gr_faraday {
+    aux,
+    main
+  };
+
+  /**
+   * @brief Ampere substeps: `aux` advances D0 in-place, `main` writes
+   * D + dt * curl H into D0
+   */
+  enum class gr_ampere {
+    aux,
+    main
+  };
+
+  /**
+   * @brief Field container to which the boundary conditions are applied
+   */
+  enum class gr_bc {
+    main,
+    backup,
+    aux
+  };
+
   template <class M>
   class GRPICEngine : public Engine<SimEngine::GRPIC, M> {
-    using Engine<SimEngine::GRPIC, M>::m_params;
-    using Engine<SimEngine::GRPIC, M>::m_metadomain;
+
+    using base_t    = Engine<SimEngine::GRPIC, M>;
+    using domain_t  = Domain<SimEngine::GRPIC, M>;
+    using species_t = Particles<M::Dim, M::CoordType>;
+    // contents
+    using base_t::m_metadomain;
+    using base_t::m_params;
+    // variables
+    using base_t::dt;
+    using base_t::step;
+    using base_t::time;
 
   public:
-    static constexpr auto S { SimEngine::SRPIC };
+    static constexpr auto S { SimEngine::GRPIC };
 
-    GRPICEngine(SimulationParams& params)
-      : Engine<SimEngine::GRPIC, M> { params } {}
+    GRPICEngine(SimulationParams& params) : base_t { params } {}
 
     ~GRPICEngine() = default;
 
-    void step_forward(timer::Timers&, Domain<SimEngine::GRPIC, M>&) override {}
+    /**
+     * @note at the beginning of the step:
+     *   em   : D^n,       B^{n-1/2}
+     *   em0  : D^{n-1},   B^{n-3/2}
+     *   cur  : J^{n-1/2}
+     * at the end of the step the same holds for n + 1
+     */
+    void step_forward(timer::Timers& timers) override {
+      const auto fieldsolver_enabled = m_params.template get<bool>(
+        "algorithms.toggles.fieldsolver");
+      const auto deposit_enabled = m_params.template get<bool>(
+        "algorithms.toggles.deposit");
+      const auto sort_interval = m_params.template get<std::size_t>(
+        "particles.sort_interval");
+      const auto spatial_sort_interval = m_params.template get<std::size_t>(
+        "particles.spatial_sort_interval");
+
+      if (step == 0) {
+        // communicate fields and apply BCs on the first timestep
+        // ... the initial fields are used for both time levels
+        m_metadomain.CommunicateFields(Comm::D | Comm::B);
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          FieldBoundaries(dom, BC::D | BC::B, gr_bc::main);
+          Kokkos::deep_copy(dom.fields.em0, dom.fields.em);
+        });
+      }
+
+      if (fieldsolver_enabled) {
+        timers.start("FieldSolver");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          // # of cells advanced by a full timestep
+          if (timers.countersEnabled()) {
+            timers.count("FieldSolver:ncells", dom.mesh.num_active());
+          }
+          // em0 <- (em0 + em) / 2 : D^{n-1/2}, B^{n-1}
+          TimeAverageDB(dom);
+          // E^{n-1/2} from D^{n-1/2} & B^{n-1/2}
+          ComputeAuxE(dom, gr_getE::D0_B);
+        });
+        timers.stop("FieldSolver");
+
+        timers.start("Communications");
+        m_metadomain.CommunicateFields(Comm::E);
+        timers.stop("Communications");
+
+        timers.start("FieldBoundaries");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          FieldBoundaries(dom, BC::E, gr_bc::aux);
+        });
+        timers.stop("FieldBoundaries");
+
+        timers.start("FieldSolver");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          // B0 : B^{n-1} -> B^n
+          Faraday(dom, gr_faraday::aux, ONE);
+        });
+        timers.stop("FieldSolver");
+
+        timers.start("Communications");
+        m_metadomain.CommunicateFields(Comm::B0);
+        timers.stop("Communications");
+
+        timers.start("FieldBoundaries");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          FieldBoundaries(dom, BC::B, gr_bc::backup);
+        });
+        timers.stop("FieldBoundaries");
+
+        timers.start("FieldSolver");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          // E^n & H^n from D^n & B^n (for the pusher)
+          ComputeAuxE(dom, gr_getE::D_B0);
+          ComputeAuxH(dom, gr_getH::D_B0);
+        });
+        timers.stop("FieldSolver");
+
+        timers.start("Communications");
+        m_metadomain.CommunicateFields(Comm::E | Comm::H);
+        timers.stop("Communications");
+
+        timers.start("FieldBoundaries");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          FieldBoundaries(dom, BC::E | BC::H, gr_bc::aux);
+        });
+        timers.stop("FieldBoundaries");
+      }
+
+      {
+        if (deposit_enabled) {
+          timers.start("CurrentDeposit");
+          m_metadomain.runOnLocalDomains([&](auto& dom) {
+            // cur0 <- J^{n-1/2}, cur <- J^{n+1/2}
+            std::swap(dom.fields.cur, dom.fields.cur0);
+            Kokkos::deep_copy(dom.fields.cur, ZERO);
+          });
+          timers.stop("CurrentDeposit");
+        }
+
+        // each species is deposited right after it is pushed, so that the
+        // ... coordinates before the push are kept for one species at a time
+        for (auto s { 0u }; s < m_metadomain.species_params().size(); ++s) {
+          timers.start("ParticlePusher");
+          m_metadomain.runOnLocalDomains([&](auto& dom) {
+            ParticlePush(dom, dom.species[s], timers);
+          });
+          timers.stop("ParticlePusher");
+
+          if (deposit_enabled) {
+            timers.start("CurrentDeposit");
+            m_metadomain.runOnLocalDomains([&](auto& dom) {
+              CurrentsDeposit(dom, dom.species[s]);
+            });
+            timers.stop("CurrentDeposit");
+          }
+        }
+
+        if (deposit_enabled) {
+          timers.start("Communications");
+          m_metadomain.SynchronizeFields(Comm::J);
+          m_metadomain.CommunicateFields(Comm::J);
+          timers.stop("Communications");
+
+          timers.start("CurrentFiltering");
+          CurrentsFilter();
+          timers.stop("CurrentFiltering");
+        }
+
+        timers.start("Communications");
+        if ((sort_interval > 0) and (step % sort_interval == 0)) {
+          m_metadomain.CommunicateParticles(&timers);
+        }
+        timers.stop("Communications");
+
+        if ((spatial_sort_interval > 0) and (step % spatial_sort_interval == 0)) {
+          timers.start("Sorting");
+          m_metadomain.runOnLocalDomains([&](auto& dom) {
+            SortParticlesByCells(dom);
+          });
+          timers.stop("Sorting");
+        }
+      }
+
+      if (fieldsolver_enabled) {
+        timers.start("FieldSolver");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          // B0 <- B^{n-1/2} - dt curl E^n : B^{n+1/2}
+          Faraday(dom, gr_faraday::main, ONE);
+          // D0 : D^{n-1/2} -> D^{n+1/2}
+          Ampere(dom, gr_ampere::aux, ONE);
+          if (deposit_enabled) {
+            // cur0 <- J^n
+            TimeAverageJ(dom);
+            CurrentsAmpere(dom, dom.fields.cur0);
+          }
+        });
+        timers.stop("FieldSolver");
+
+        timers.start("Communications");
+        m_metadomain.CommunicateFields(Comm::D0 | Comm::B0);
+        timers.stop("Communications");
+
+        timers.start("FieldBoundaries");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          FieldBoundaries(dom, BC::D | BC::B, gr_bc::backup);
+        });
+        timers.stop("FieldBoundaries");
+
+        timers.start("FieldSolver");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          // H^{n+1/2} from D^{n+1/2} & B^{n+1/2}
+          ComputeAuxH(dom, gr_getH::D0_B0);
+        });
+        timers.stop("FieldSolver");
+
+        timers.start("Communications");
+        m_metadomain.CommunicateFields(Comm::H);
+        timers.stop("Communications");
+
+        timers.start("FieldBoundaries");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          FieldBoundaries(dom, BC::H, gr_bc::aux);
+        });
+        timers.stop("FieldBoundaries");
+
+        timers.start("FieldSolver");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          // D0 <- D^n + dt curl H^{n+1/2} : D^{n+1}
+          Ampere(dom, gr_ampere::main, ONE);
+          if (deposit_enabled) {
+            CurrentsAmpere(dom, dom.fields.cur);
+          }
+        });
+        timers.stop("FieldSolver");
+
+        timers.start("Communications");
+        m_metadomain.CommunicateFields(Comm::D0);
+        timers.stop("Communications");
+
+        timers.start("FieldBoundaries");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          FieldBoundaries(dom, BC::D, gr_bc::backup);
+          // em  : D^{n+1}, B^{n+1/2}
+          // em0 : D^n,     B^{n-1/2}
+          std::swap(dom.fields.em, dom.fields.em0);
+        });
+        timers.stop("FieldBoundaries");
+      }
+    }
+
+    /* algorithm substeps --------------------------------------------------- */
+    void SortParticlesByCells(domain_t& domain) {
+      logger::Checkpoint("Sorting particles by cells", HERE);
+      for (auto& species : domain.species) {
+        species.SortByCells(domain.mesh.n_active());
+      }
+    }
+
+    void TimeAverageDB(domain_t& domain) {
+      logger::Checkpoint("Launching time-averaging kernel for D & B", HERE);
+      Kokkos::parallel_for("TimeAverageDB",
+                           domain.mesh.rangeAllCells(),
+                           kernel::gr::TimeAverageDB_kernel<M>(domain.fields.em,
+                                                               domain.fields.em0));
+    }
+
+    void TimeAverageJ(domain_t& domain) {
+      logger::Checkpoint("Launching time-averaging kernel for J", HERE);
+      Kokkos::parallel_for("TimeAverageJ",
+                           domain.mesh.rangeAllCells(),
+                           kernel::gr::TimeAverageJ_kernel<M>(domain.fields.cur,
+                                                              domain.fields.cur0));
+    }
+
+    void ComputeAuxE(domain_t& domain, const gr_getE& g) {
+      logger::Checkpoint("Launching auxiliary E kernel", HERE);
+      auto range = range_with_axis_BCs(domain);
+      if (g == gr_getE::D0_B) {
+        Kokkos::parallel_for("ComputeAuxE",
+                             range,
+                             kernel::gr::ComputeAuxE_kernel<M>(domain.fields.em0,
+                                                               domain.fields.em,
+                                                               domain.fields.aux,
+                                                               domain.mesh.metric));
+      } else if (g == gr_getE::D_B0) {
+        Kokkos::parallel_for("ComputeAuxE",
+                             range,
+                             kernel::gr::ComputeAuxE_kernel<M>(domain.fields.em,
+                                                               domain.fields.em0,
+                                                               domain.fields.aux,
+                                                               domain.mesh.metric));
+      } else {
+        raise::Error("Wrong option for `g`", HERE);
+      }
+    }
+
+    void ComputeAuxH(domain_t& domain, const gr_getH& g) {
+      logger::Checkpoint("Launching auxiliary H kernel", HERE);
+      auto range = domain.mesh.rangeActiveCells();
+      if (g == gr_getH::D_B0) {
+        Kokkos::parallel_for("ComputeAuxH",
+                             range,
+                             kernel::gr::ComputeAuxH_kernel<M>(domain.fields.em,
+                                                               domain.fields.em0,
+                                                               domain.fields.aux,
+                                                               domain.mesh.metric));
+      } else if (g == gr_getH::D0_B0) {
+        Kokkos::parallel_for("ComputeAuxH",
+                             range,
+                             kernel::gr::ComputeAuxH_kernel<M>(domain.fields.em0,
+                                                               domain.fields.em0,
+                                                               domain.fields.aux,
+                                                               domain.mesh.metric));
+      } else {
+        raise::Error("Wrong option for `g`", HERE);
+      }
+    }
+
+    void Faraday(domain_t& domain, const gr_faraday& g, real_t fraction = ONE) {
+      logger::Checkpoint("Launching Faraday kernel", HERE);
+      const auto dT = fraction *
+                      m_params.template get<real_t>(
+                        "algorithms.timestep.correction") *
+                      dt;
+      const auto ni2 = domain.mesh.n_active(in::x2);
+      if (g == gr_faraday::aux) {
+        Kokkos::parallel_for("Faraday",
+                             domain.mesh.rangeActiveCells(),
+                             kernel::gr::Faraday_kernel<M>(domain.fields.em0,
+                                                           domain.fields.em0,
+                                                           domain.fields.aux,
+                                                           domain.mesh.metric,
+                                                           dT,
+                                                           ni2,
+                                                           domain.mesh.flds_bc()));
+      } else if (g == gr_faraday::main) {
+        Kokkos::parallel_for("Faraday",
+                             domain.mesh.rangeActiveCells(),
+                             kernel::gr::Faraday_kernel<M>(domain.fields.em,
+                                                           domain.fields.em0,
+                                                           domain.fields.aux,
+                                                           domain.mesh.metric,
+                                                           dT,
+                                                           ni2,
+                                                           domain.mesh.flds_bc()));
+      } else {
+        raise::Error("Wrong option for `g`", HERE);
+      }
+    }
+
+    void Ampere(domain_t& domain, const gr_ampere& g, real_t fraction = ONE) {
+      logger::Checkpoint("Launching Ampere kernel", HERE);
+      const auto dT = fraction *
+                      m_params.template get<real_t>(
+                        "algorithms.timestep.correction") *
+                      dt;
+      auto       range = range_with_axis_BCs(domain);
+      const auto ni2   = domain.mesh.n_active(in::x2);
+      if (g == gr_ampere::aux) {
+        Kokkos::parallel_for("Ampere",
+                             range,
+                             kernel::gr::Ampere_kernel<M>(domain.fields.em0,
+                                                          domain.fields.em0,
+                                                          domain.fields.aux,
+                                                          domain.mesh.metric,
+                                                          dT,
+                                                          ni2,
+                                                          domain.mesh.flds_bc()));
+      } else if (g == gr_ampere::main) {
+        Kokkos::parallel_for("Ampere",
+                             range,
+                             kernel::gr::Ampere_kernel<M>(domain.fields.em,
+                                                          domain.fields.em0,
+                                                          domain.fields.aux,
+                                                          domain.mesh.metric,
+                                                          dT,
+                                                          ni2,
+                                                          domain.mesh.flds_bc()));
+      } else {
+        raise::Error("Wrong option for `g`", HERE);
+      }
+    }
+
+    void ParticlePush(domain_t&      domain,
+                      species_t&     species,
+                      timer::Timers& timers) {
+      const auto eps = m_params.template get<real_t>("algorithms.gr.pusher_eps");
+      const auto niter = m_params.template get<unsigned short>(
+        "algorithms.gr.pusher_niter");
+      species.set_unsorted();
+      logger::Checkpoint(
+        [&]() {
+          return fmt::format(
+            "Launching particle pusher kernel for %d [%s] : %lu",
+            species.index(),
+            species.label().c_str(),
+            species.npart());
+        },
+        HERE);
+      // names of the per-species counters are only built if these are enabled
+      const auto prtl_timer = timers.countersEnabled()
+                                ? fmt::format("ParticlePusher[%s]",
+                                              species.label().c_str())
+                                : std::string {};
+      if (timers.countersEnabled()) {
+        timers.count(prtl_timer + ":npart", species.npart());
+        if (species.npart() == 0) {
+          // keeping the entry, so that all ranks report the same quantities
+          timers.count(prtl_timer, 0.0);
+        }
+      }
+      if (species.npart() == 0) {
+        return;
+      }
+      timers.startSub(prtl_timer);
+      const auto q_ovr_m = species.mass() > ZERO
+                             ? species.charge() / species.mass()
+                             : ZERO;
+      //  coeff = q / m (dt / 2) omegaB0
+      const auto coeff   = q_ovr_m * HALF * dt *
+                         m_params.template get<real_t>("scales.omegaB0");
+      // the coordinates before the push are only needed until the deposit
+      auto& prev = domain.prtl_prev;
+      prev.reserve(species.maxnpart());
+      // clang-format off
+      const auto pusher = kernel::gr::Pusher_kernel<M>(
+                            domain.fields.em,
+                            domain.fields.em0,
+                            species.i1,        species.i2,       species.i3,
+                            prev.i1,           prev.i2,          prev.i3,
+                            species.dx1,       species.dx2,      species.dx3,
+                            prev.dx1,          prev.dx2,         prev.dx3,
+                            species.ux1,       species.ux2,      species.ux3,
+                            species.phi,       species.tag,
+                            domain.mesh.metric,
+                            coeff, dt, step,
+                            domain.mesh.n_active(in::x1),
+                            domain.mesh.n_active(in::x2),
+                            domain.mesh.n_active(in::x3),
+                            eps, niter,
+                            domain.mesh.prtl_bc());
+      // clang-format on
+      if (species.pusher() == PrtlPusher::PHOTON) {
+        Kokkos::parallel_for(
+          "ParticlePusher",
+          Kokkos::RangePolicy<AccelExeSpace, kernel::gr::Massless_t>(
+            0,
+            species.npart()),
+          pusher);
+      } else if (species.pusher() == PrtlPusher::BORIS) {
+        Kokkos::parallel_for(
+          "ParticlePusher",
+          Kokkos::RangePolicy<AccelExeSpace, kernel::gr::Massive_t>(
+            0,
+            species.npart()),
+          pusher);
+      } else {
+        raise::Fatal("Invalid particle pusher for GRPIC", HERE);
+      }
+      timers.stopSub(prtl_timer);
+    }
+
+    void CurrentsDeposit(domain_t& domain, species_t& species) {
+      const auto tile_size = m_params.template get<unsigned short>(
+        "algorithms.deposit.tile_size");
+      if (tile_size > 0) {
+        CurrentsDepositTiled(domain, species, tile_size);
+        return;
+      }
+      logger::Checkpoint(
+        [&]() {
+          return fmt::format(
+            "Launching currents deposit kernel for %d [%s] : %lu %f",
+            species.index(),
+            species.label().c_str(),
+            species.npart(),
+            (double)species.charge());
+        },
+        HERE);
+      if (species.npart() == 0 || cmp::AlmostZero(species.charge())) {
+        return;
+      }
+      auto scatter_cur = Kokkos::Experimental::create_scatter_view(
+        domain.fields.cur);
+      Kokkos::parallel_for("CurrentsDeposit",
+                           species.rangeActiveParticles(),
+                           kernel::DepositCurrents_kernel<SimEngine::GRPIC, M>(
+                             scatter_cur,
+                             species.i1,
+                             species.i2,
+                             species.i3,
+                             domain.prtl_prev.i1,
+                             domain.prtl_prev.i2,
+                             domain.prtl_prev.i3,
+                             species.dx1,
+                             species.dx2,
+                             species.dx3,
+                             domain.prtl_prev.dx1,
+                             domain.prtl_prev.dx2,
+                             domain.prtl_prev.dx3,
+                             species.ux1,
+                             species.ux2,
+                             species.ux3,
+                             species.phi,
+                             species.weight,
+                             species.tag,
+                             domain.mesh.metric,
+                             (real_t)(species.charge()),
+                             dt));
+      Kokkos::Experimental::contribute(domain.fields.cur, scatter_cur);
+    }
+
+    void CurrentsDepositTiled(domain_t&      domain,
+                              species_t&     species,
+                              unsigned short tile_size) {
+      using deposit_t = kernel::DepositCurrentsTiled_kernel<SimEngine::GRPIC, M>;
+      const auto scratch_size = deposit_t::scratch_size(tile_size);
+      const auto scratch_max = static_cast<std::size_t>(
+        team_policy_t::scratch_size_max(0));
+      raise::ErrorIf(scratch_size > scratch_max,
+                     fmt::format("tile_size %d requires %lu bytes of scratch "
+                                 "memory per team, which exceeds the limit",
+                                 tile_size,
+                                 scratch_size),
+                     HERE);
+      const auto ncells = domain.mesh.n_active();
+      logger::Checkpoint(
+        [&]() {
+          return fmt::format(
+            "Launching tiled currents deposit kernel for %d [%s] : %lu %f",
+            species.index(),
+            species.label().c_str(),
+            species.npart(),
+            (double)species.charge());
+        },
+        HERE);
+      if (species.npart() == 0 || cmp::AlmostZero(species.charge())) {
+        return;
+      }
+      const auto [tile_offsets, tile_prtls] = species.TileIndex(ncells,
+                                                                tile_size);
+      const auto deposit = deposit_t(domain.fields.cur,
+                                     tile_offsets,
+                                     tile_prtls,
+                                     ncells,
+                                     tile_size,
+                                     species.i1,
+                                     species.i2,
+                                     species.i3,
+                                     domain.prtl_prev.i1,
+                                     domain.prtl_prev.i2,
+                                     domain.prtl_prev.i3,
+                                     species.dx1,
+                                     species.dx2,
+                                     species.dx3,
+                                     domain.prtl_prev.dx1,
+                                     domain.prtl_prev.dx2,
+                                     domain.prtl_prev.dx3,
+                                     species.ux1,
+                                     species.ux2,
+                                     species.ux3,
+                                     species.phi,
+                                     species.weight,
+                                     species.tag,
+                                     domain.mesh.metric,
+                                     (real_t)(species.charge()),
+                                     dt);
+      Kokkos::parallel_for(
+        "CurrentsDepositTiled",
+        team_policy_t(deposit.ntiles_tot(), Kokkos::AUTO)
+          .set_scratch_size(0, Kokkos::PerTeam(scratch_size)),
+        deposit);
+    }
+
+    void CurrentsAmpere(domain_t& domain, const ndfield_t<M::Dim, 3>& J) {
+      logger::Checkpoint("Launching Ampere kernel for adding currents", HERE);
+      const auto q0    = m_params.template get<real_t>("scales.q0");
+      const auto B0    = m_params.template get<real_t>("scales.B0");
+      const auto coeff = -dt * q0 / B0;
+      auto       range = range_with_axis_BCs(domain);
+      const auto ni2   = domain.mesh.n_active(in::x2);
+      Kokkos::parallel_for(
+        "Ampere",
+        range,
+        kernel::gr::CurrentsAmpere_kernel<M>(domain.fields.em0,
+                                             J,
+                                             domain.mesh.metric,
+                                             coeff,
+                                             ni2,
+                                             domain.mesh.flds_bc()));
+    }
+
+    void CurrentsFilter() {
+      logger::Checkpoint("Launching currents filtering kernels", HERE);
+      const auto nfilter = m_params.template get<unsigned short>(
+        "algorithms.current_filters");
+      /**
+       * one exchange fills enough ghost cells for N_GHOSTS passes: each pass
+       * also filters the ghost layers shared with the neighbors, one layer
+       * less than the previous pass, and the passes alternate between cur and
+       * buff (so no copy is needed in between)
+       */
+      for (unsigned short i = 0; i < nfilter; i += N_GHOSTS) {
+        const auto npasses = std::min<unsigned short>(N_GHOSTS, nfilter - i);
+        m_metadomain.runOnLocalDomains([&](auto& domain) {
+          tuple_t<std::size_t, M::Dim> size;
+          size[0] = domain.mesh.n_active(in::x1);
+          size[1] = domain.mesh.n_active(in::x2);
+          // ghost cells which are not exchanged are read from buff as well
+          if ((i == 0) or (npasses % 2 == 1)) {
+            Kokkos::deep_copy(domain.fields.buff, domain.fields.cur);
+          }
+          for (unsigned short p = 0; p < npasses; ++p) {
+            // odd # of passes starts from buff to finish in cur
+            const auto to_buff = ((npasses - p) % 2 == 0);
+            Kokkos::parallel_for(
+              "CurrentsFilter",
+              range_for_filter(domain, npasses - p - 1),
+              kernel::DigitalFilter_kernel<M::Dim, M::CoordType>(
+                to_buff ? domain.fields.buff : domain.fields.cur,
+                to_buff ? domain.fields.cur : domain.fields.buff,
+                size,
+                domain.mesh.flds_bc()));
+          }
+        });
+        m_metadomain.CommunicateFields(Comm::J);
+      }
+    }
+
+    void FieldBoundaries(domain_t& domain, BCTags tags, const gr_bc& g) {
+      for (auto& direction : dir::Directions<M::Dim>::orth) {
+        if (m_metadomain.mesh().flds_bc_in(direction) == FldsBC::ABSORB) {
+          if (g != gr_bc::aux) {
+            AbsorbFieldsIn(direction, domain, tags, g);
+          }
+        } else if (m_metadomain.mesh().flds_bc_in(direction) == FldsBC::AXIS) {
+          if (domain.mesh.flds_bc_in(direction) == FldsBC::AXIS) {
+            AxisFieldsIn(direction, domain, tags, g);
+          }
+        } else if (m_metadomain.mesh().flds_bc_in(direction) == FldsBC::HORIZON) {
+          if (domain.mesh.flds_bc_in(direction) == FldsBC::HORIZON) {
+            HorizonFieldsIn(direction, domain, tags, g);
+          }
+        } else if (m_metadomain.mesh().flds_bc_in(direction) == FldsBC::ATMOSPHERE) {
+          raise::Error("ATMOSPHERE BCs not implemented for GR", HERE);
+        } else if (m_metadomain.mesh().flds_bc_in(direction) == FldsBC::CONDUCTOR) {
+          raise::Error("CONDUCTOR BCs not implemented for GR", HERE);
+        } else if (m_metadomain.mesh().flds_bc_in(direction) == FldsBC::CUSTOM) {
+          raise::Error("CUSTOM BCs not implemented for GR", HERE);
+        }
+      } // loop over directions
+    }
+
+    void AbsorbFieldsIn(dir::direction_t<M::Dim> direction,
+                        domain_t&                domain,
+                        BCTags                   tags,
+                        const gr_bc&             g) {
+      /**
+       * absorbing boundaries
+       */
+      const auto ds = m_params.template get<real_t>(
+        "grid.boundaries.absorb.ds");
+      const auto dim = direction.get_dim();
+      real_t     xg_min, xg_max, xg_edge;
+      auto       sign = direction.get_sign();
+      if (sign > 0) { // + direction
+        xg_max  = m_metadomain.mesh().extent(dim).second;
+        xg_min  = xg_max - ds;
+        xg_edge = xg_max;
+      } else { // - direction
+        xg_min  = m_metadomain.mesh().extent(dim).first;
+        xg_max  = xg_min + ds;
+        xg_edge = xg_min;
+      }
+      boundaries_t<real_t> box;
+      boundaries_t<bool>   incl_ghosts;
+      for (unsigned short d { 0 }; d < M::Dim; ++d) {
+        if (d == static_cast<unsigned short>(dim)) {
+          box.push_back({ xg_min, xg_max });
+          if (sign > 0) {
+            incl_ghosts.push_back({ false, true });
+          } else {
+            incl_ghosts.push_back({ true, false });
+          }
+        } else {
+          box.push_back(Range::All);
+          incl_ghosts.push_back({ true, true });
+        }
+      }
+      if (not domain.mesh.Intersects(box)) {
+        return;
+      }
+      const auto intersect_range = domain.mesh.ExtentToRange(box, incl_ghosts);
+      tuple_t<std::size_t, M::Dim> range_min { 0 };
+      tuple_t<std::size_t, M::Dim> range_max { 0 };
+
+      for (unsigned short d { 0 }; d < M::Dim; ++d) {
+        range_min[d] = intersect_range[d].first;
+        range_max[d] = intersect_range[d].second;
+      }
+      auto& fld = (g == gr_bc::main) ? domain.fields.em : domain.fields.em0;
+      if (dim == in::x1) {
+        Kokkos::parallel_for(
+          "AbsorbFields",
+          CreateRangePolicy<M::Dim>(range_min, range_max),
+          kernel::AbsorbBoundaries_kernel<M, 1>(fld,
+                                                domain.mesh.metric,
+                                                xg_edge,
+                                                ds,
+                                                tags));
+      } else if (dim == in::x2) {
+        Kokkos::parallel_for(
+          "AbsorbFields",
+          CreateRangePolicy<M::Dim>(range_min, range_max),
+          kernel::AbsorbBoundaries_kernel<M, 2>(fld,
+                                                domain.mesh.metric,
+                                                xg_edge,
+                                                ds,
+                                                tags));
+      } else {
+        raise::Error("Invalid dimension", HERE);
+      }
+    }
+
+    void AxisFieldsIn(dir::direction_t<M::Dim> direction,
+                      domain_t&                domain,
+                      BCTags                   tags,
+                      const gr_bc&             g) {
+      /**
+       * axis boundaries
+       */
+      raise::ErrorIf(direction.get_dim() != in::x2,
+                     "Invalid axis direction, should be x2",
+                     HERE);
+      auto& fld = (g == gr_bc::main)
+                    ? domain.fields.em
+                    : ((g == gr_bc::backup) ? domain.fields.em0 : domain.fields.aux);
+      const auto i2_min = domain.mesh.i_min(in::x2);
+      const auto i2_max = domain.mesh.i_max(in::x2);
+      if (direction.get_sign() < 0) {
+        Kokkos::parallel_for(
+          "AxisBCFields",
+          domain.mesh.n_all(in::x1),
+          kernel::AxisBoundaries_kernel<M::Dim, false>(fld, i2_min, tags));
+      } else {
+        Kokkos::parallel_for(
+          "AxisBCFields",
+          domain.mesh.n_all(in::x1),
+          kernel::AxisBoundaries_kernel<M::Dim, true>(fld, i2_max, tags));
+      }
+    }
+
+    void HorizonFieldsIn(dir::direction_t<M::Dim> direction,
+                         domain_t&                domain,
+                         BCTags                   tags,
+                         const gr_bc&             g) {
+      /**
+       * inner (horizon) boundaries
+       */
+      raise::ErrorIf(direction.get_dim() != in::x1 or direction.get_sign() > 0,
+                     "HORIZON BCs only applicable in -x1",
+                     HERE);
+      auto& fld = (g == gr_bc::main)
+                    ? domain.fields.em
+                    : ((g == gr_bc::backup) ? domain.fields.em0 : domain.fields.aux);
+      Kokkos::parallel_for(
+        "HorizonBCFields",
+        domain.mesh.n_all(in::x2),
+        kernel::HorizonBoundaries_kernel<M::Dim>(fld, domain.mesh.i_min(in::x1), tags));
+    }
+
+  private:
+    auto range_with_axis_BCs(const domain_t& domain) -> range_t<M::Dim> {
+      auto range = domain.mesh.rangeActiveCells();
+      /**
+       * @brief taking one extra cell in the x2 direction if AXIS BCs
+       */
+      if constexpr (M::Dim == Dim::_2D) {
+        if (domain.mesh.flds_bc_in({ 0, +1 }) == FldsBC::AXIS) {
+          range = CreateRangePolicy<Dim::_2D>(
+            { domain.mesh.i_min(in::x1), domain.mesh.i_min(in::x2) },
+            { domain.mesh.i_max(in::x1), domain.mesh.i_max(in::x2) + 1 });
+        }
+      }
+      return range;
+    }
+
+    /**
+     * @brief Same cells as `range_with_axis_BCs`, extended by `ext` ghost
+     * layers in the directions with neighboring domains
+     */
+    auto range_for_filter(const domain_t& domain, unsigned short ext)
+      -> range_t<M::Dim> {
+      tuple_t<std::size_t, M::Dim> i_min, i_max;
+      for (auto d { 0u }; d < M::Dim; ++d) {
+        i_min[d] = domain.mesh.i_min(static_cast<in>(d));
+        i_max[d] = domain.mesh.i_max(static_cast<in>(d));
+      }
+      for (auto& direction : dir::Directions<M::Dim>::orth) {
+        const auto d  = static_cast<unsigned short>(direction.get_dim());
+        const auto bc = domain.mesh.flds_bc_in(direction);
+        if ((bc == FldsBC::PERIODIC) or (bc == FldsBC::SYNC)) {
+          if (direction.get_sign() > 0) {
+            i_max[d] += ext;
+          } else {
+            i_min[d] -= ext;
+          }
+        } else if ((bc == FldsBC::AXIS) and (direction.get_sign() > 0)) {
+          // taking one extra cell in the x2 direction if AXIS BCs
+          i_max[d] += 1;
+        }
+      }
+      return CreateRangePolicy<M::Dim>(i_min, i_max);
+    }
   };
 
 } // namespace ntt
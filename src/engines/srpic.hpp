@@ -41,17 +41,20 @@
 #include <Kokkos_Core.hpp>
 #include <Kokkos_ScatterView.hpp>
 
+#include <algorithm>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace ntt {
 
   template <class M>
   class SRPICEngine : public Engine<SimEngine::SRPIC, M> {
 
-    using base_t   = Engine<SimEngine::SRPIC, M>;
-    using pgen_t   = user::PGen<SimEngine::SRPIC, M>;
-    using domain_t = Domain<SimEngine::SRPIC, M>;
+    using base_t    = Engine<SimEngine::SRPIC, M>;
+    using pgen_t    = user::PGen<SimEngine::SRPIC, M>;
+    using domain_t  = Domain<SimEngine::SRPIC, M>;
+    using species_t = Particles<M::Dim, M::CoordType>;
     // constexprs
     using base_t::pgen_is_ok;
     // contents
@@ -74,103 +77,177 @@ namespace ntt {
 
     ~SRPICEngine() = default;
 
-    void step_forward(timer::Timers& timers, domain_t& dom) override {
+    void step_forward(timer::Timers& timers) override {
       const auto fieldsolver_enabled = m_params.template get<bool>(
         "algorithms.toggles.fieldsolver");
       const auto deposit_enabled = m_params.template get<bool>(
         "algorithms.toggles.deposit");
       const auto sort_interval = m_params.template get<std::size_t>(
         "particles.sort_interval");
+      const auto spatial_sort_interval = m_params.template get<std::size_t>(
+        "particles.spatial_sort_interval");
 
       if (step == 0) {
         // communicate fields and apply BCs on the first timestep
-        m_metadomain.CommunicateFields(dom, Comm::B | Comm::E);
-        FieldBoundaries(dom, BC::B | BC::E);
-        ParticleInjector(dom);
+        m_metadomain.CommunicateFields(Comm::B | Comm::E);
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          FieldBoundaries(dom, BC::B | BC::E);
+        });
+        ParticleInjector();
       }
 
       if (fieldsolver_enabled) {
         timers.start("FieldSolver");
-        Faraday(dom, HALF);
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          Faraday(dom, HALF);
+          // # of cells advanced by a full timestep
+          if (timers.countersEnabled()) {
+            timers.count("FieldSolver:ncells", dom.mesh.num_active());
+          }
+        });
         timers.stop("FieldSolver");
 
         timers.start("Communications");
-        m_metadomain.CommunicateFields(dom, Comm::B);
+        m_metadomain.CommunicateFields(Comm::B);
         timers.stop("Communications");
 
         timers.start("FieldBoundaries");
-        FieldBoundaries(dom, BC::B);
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          FieldBoundaries(dom, BC::B);
+        });
         timers.stop("FieldBoundaries");
       }
 
       {
-        timers.start("ParticlePusher");
-        ParticlePush(dom);
-        timers.stop("ParticlePusher");
-
         if (deposit_enabled) {
           timers.start("CurrentDeposit");
-          Kokkos::deep_copy(dom.fields.cur, ZERO);
-          CurrentsDeposit(dom);
+          m_metadomain.runOnLocalDomains([&](auto& dom) {
+            Kokkos::deep_copy(dom.fields.cur, ZERO);
+          });
           timers.stop("CurrentDeposit");
+        }
 
+        // each species is deposited right after it is pushed, so that the
+        // ... coordinates before the push are kept for one species at a time
+        for (auto s { 0u }; s < m_metadomain.species_params().size(); ++s) {
+          timers.start("ParticlePusher");
+          m_metadomain.runOnLocalDomains([&](auto& dom) {
+            ParticlePush(dom, dom.species[s], timers);
+          });
+          timers.stop("ParticlePusher");
+
+          if (deposit_enabled) {
+            timers.start("CurrentDeposit");
+            m_metadomain.runOnLocalDomains([&](auto& dom) {
+              CurrentsDeposit(dom, dom.species[s]);
+            });
+            timers.stop("CurrentDeposit");
+          }
+        }
+
+        if (deposit_enabled) {
           timers.start("Communications");
-          m_metadomain.SynchronizeFields(dom, Comm::J);
-          m_metadomain.CommunicateFields(dom, Comm::J);
+          m_metadomain.SynchronizeFields(Comm::J);
+          m_metadomain.CommunicateFields(Comm::J);
           timers.stop("Communications");
 
           timers.start("CurrentFiltering");
-          CurrentsFilter(dom);
+          CurrentsFilter();
           timers.stop("CurrentFiltering");
         }
 
         timers.start("Communications");
         if ((sort_interval > 0) and (step % sort_interval == 0)) {
-          m_metadomain.CommunicateParticles(dom, &timers);
+          m_metadomain.CommunicateParticles(&timers);
         }
         timers.stop("Communications");
+
+        if ((spatial_sort_interval > 0) and (step % spatial_sort_interval == 0)) {
+          timers.start("Sorting");
+          m_metadomain.runOnLocalDomains([&](auto& dom) {
+            SortParticlesByCells(dom);
+          });
+          timers.stop("Sorting");
+        }
       }
 
       if (fieldsolver_enabled) {
         timers.start("FieldSolver");
-        Faraday(dom, HALF);
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          Faraday(dom, HALF);
+        });
         timers.stop("FieldSolver");
 
         timers.start("Communications");
-        m_metadomain.CommunicateFields(dom, Comm::B);
+        m_metadomain.BeginCommunicateFields(Comm::B);
+        timers.stop("Communications");
+
+        // Ampere in the cells which do not depend on the ghost zones is
+        // ... performed while the B-field ghost zones are in flight
+        timers.start("FieldSolver");
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          if (overlap_ampere_with_comms(dom)) {
+            AmpereIn(dom, ampere_interior_range(dom), ONE);
+          }
+        });
+        timers.stop("FieldSolver");
+
+        timers.start("Communications");
+        m_metadomain.EndCommunicateFields();
         timers.stop("Communications");
 
         timers.start("FieldBoundaries");
-        FieldBoundaries(dom, BC::B);
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          FieldBoundaries(dom, BC::B);
+        });
         timers.stop("FieldBoundaries");
 
         timers.start("FieldSolver");
-        Ampere(dom, ONE);
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          if (overlap_ampere_with_comms(dom)) {
+            for (const auto& range : ampere_boundary_ranges(dom)) {
+              AmpereIn(dom, range, ONE);
+            }
+          } else {
+            Ampere(dom, ONE);
+          }
+        });
         timers.stop("FieldSolver");
 
         if (deposit_enabled) {
           timers.start("FieldSolver");
-          CurrentsAmpere(dom);
+          m_metadomain.runOnLocalDomains([&](auto& dom) {
+            CurrentsAmpere(dom);
+          });
           timers.stop("FieldSolver");
         }
 
         timers.start("Communications");
-        m_metadomain.CommunicateFields(dom, Comm::E | Comm::J);
+        m_metadomain.CommunicateFields(Comm::E | Comm::J);
         timers.stop("Communications");
 
         timers.start("FieldBoundaries");
-        FieldBoundaries(dom, BC::E);
+        m_metadomain.runOnLocalDomains([&](auto& dom) {
+          FieldBoundaries(dom, BC::E);
+        });
         timers.stop("FieldBoundaries");
       }
 
       {
         timers.start("Injector");
-        ParticleInjector(dom);
+        ParticleInjector();
         timers.stop("Injector");
       }
     }
 
     /* algorithm substeps --------------------------------------------------- */
+    void SortParticlesByCells(domain_t& domain) {
+      logger::Checkpoint("Sorting particles by cells", HERE);
+      for (auto& species : domain.species) {
+        species.SortByCells(domain.mesh.n_active());
+      }
+    }
+
     void Faraday(domain_t& domain, real_t fraction = ONE) {
       logger::Checkpoint("Launching Faraday kernel", HERE);
       const auto dT = fraction *
@@ -203,12 +280,17 @@ namespace ntt {
     }
 
     void Ampere(domain_t& domain, real_t fraction = ONE) {
+      AmpereIn(domain, range_with_axis_BCs(domain), fraction);
+    }
+
+    void AmpereIn(domain_t&              domain,
+                  const range_t<M::Dim>& range,
+                  real_t                 fraction = ONE) {
       logger::Checkpoint("Launching Ampere kernel", HERE);
       const auto dT = fraction *
                       m_params.template get<real_t>(
                         "algorithms.timestep.correction") *
                       dt;
-      auto range = range_with_axis_BCs(domain);
       if constexpr (M::CoordType == Coord::Cart) {
         // minkowski case
         const auto dx = math::sqrt(domain.mesh.metric.template h_<1, 1>({}));
@@ -237,7 +319,9 @@ namespace ntt {
       }
     }
 
-    void ParticlePush(domain_t& domain) {
+    void ParticlePush(domain_t&      domain,
+                      species_t&     species,
+                      timer::Timers& timers) {
       real_t gx1 { ZERO }, gx2 { ZERO }, gx3 { ZERO }, ds { ZERO };
       real_t x_surf { ZERO };
       bool   has_atmosphere = false;
@@ -273,91 +357,168 @@ namespace ntt {
           }
         }
       }
-      for (auto& species : domain.species) {
-        species.set_unsorted();
-        logger::Checkpoint(
-          fmt::format("Launching particle pusher kernel for %d [%s] : %lu",
-                      species.index(),
-                      species.label().c_str(),
-                      species.npart()),
-          HERE);
+      species.set_unsorted();
+      logger::Checkpoint(
+        [&]() {
+          return fmt::format(
+            "Launching particle pusher kernel for %d [%s] : %lu",
+            species.index(),
+            species.label().c_str(),
+            species.npart());
+        },
+        HERE);
+      // names of the per-species counters are only built if these are enabled
+      const auto prtl_timer = timers.countersEnabled()
+                                ? fmt::format("ParticlePusher[%s]",
+                                              species.label().c_str())
+                                : std::string {};
+      if (timers.countersEnabled()) {
+        timers.count(prtl_timer + ":npart", species.npart());
         if (species.npart() == 0) {
-          continue;
-        }
-        const auto q_ovr_m = species.mass() > ZERO
-                               ? species.charge() / species.mass()
-                               : ZERO;
-        //  coeff = q / m (dt / 2) omegaB0
-        const auto coeff   = q_ovr_m * HALF * dt *
-                           m_params.template get<real_t>("scales.omegaB0");
-        PrtlPusher::type pusher;
-        if (species.pusher() == PrtlPusher::PHOTON) {
-          pusher = PrtlPusher::PHOTON;
-        } else if (species.pusher() == PrtlPusher::BORIS) {
-          pusher = PrtlPusher::BORIS;
-        } else if (species.pusher() == PrtlPusher::VAY) {
-          pusher = PrtlPusher::VAY;
-        } else {
-          raise::Fatal("Invalid particle pusher", HERE);
-        }
-        const auto cooling = species.cooling();
-
-        // coefficients to be forwarded to the dispatcher
-        // gca
-        const auto has_gca         = species.use_gca();
-        const auto gca_larmor_max  = has_gca ? m_params.template get<real_t>(
-                                                "algorithms.gca.larmor_max")
-                                             : ZERO;
-        const auto gca_eovrb_max   = has_gca ? m_params.template get<real_t>(
-                                               "algorithms.gca.e_ovr_b_max")
-                                             : ZERO;
-        // cooling
-        const auto has_synchrotron = (cooling == Cooling::SYNCHROTRON);
-        const auto sync_grad       = has_synchrotron
-                                       ? m_params.template get<real_t>(
-                                     "algorithms.synchrotron.gamma_rad")
-                                       : ZERO;
-        const auto sync_coeff      = has_synchrotron
-                                       ? (real_t)(0.1) * dt *
-                                      m_params.template get<real_t>(
-                                        "scales.omegaB0") /
-                                      (SQR(sync_grad) * species.mass())
-                                       : ZERO;
-
-        // toggle to indicate whether pgen defines the external force
-        bool has_extforce = false;
-        if constexpr (traits::has_member<traits::pgen::ext_force_t, pgen_t>::value) {
-          has_extforce = true;
-          // toggle to indicate whether the ext force applies to current species
-          if (traits::has_member<traits::species_t, decltype(pgen_t::ext_force)>::value) {
-            has_extforce &= std::find(m_pgen.ext_force.species.begin(),
-                                      m_pgen.ext_force.species.end(),
-                                      species.index()) !=
-                            m_pgen.ext_force.species.end();
-          }
+          // keeping the entry, so that all ranks report the same quantities
+          timers.count(prtl_timer, 0.0);
         }
+      }
+      if (species.npart() == 0) {
+        return;
+      }
+      timers.startSub(prtl_timer);
+      const auto q_ovr_m = species.mass() > ZERO
+                             ? species.charge() / species.mass()
+                             : ZERO;
+      //  coeff = q / m (dt / 2) omegaB0
+      const auto coeff   = q_ovr_m * HALF * dt *
+                         m_params.template get<real_t>("scales.omegaB0");
+      PrtlPusher::type pusher;
+      if (species.pusher() == PrtlPusher::PHOTON) {
+        pusher = PrtlPusher::PHOTON;
+      } else if (species.pusher() == PrtlPusher::BORIS) {
+        pusher = PrtlPusher::BORIS;
+      } else if (species.pusher() == PrtlPusher::VAY) {
+        pusher = PrtlPusher::VAY;
+      } else {
+        raise::Fatal("Invalid particle pusher", HERE);
+      }
+      const auto cooling = species.cooling();
+
+      // coefficients to be forwarded to the dispatcher
+      // gca
+      const auto has_gca         = species.use_gca();
+      const auto gca_larmor_max  = has_gca ? m_params.template get<real_t>(
+                                              "algorithms.gca.larmor_max")
+                                           : ZERO;
+      const auto gca_eovrb_max   = has_gca ? m_params.template get<real_t>(
+                                             "algorithms.gca.e_ovr_b_max")
+                                           : ZERO;
+      // cooling
+      const auto has_synchrotron = (cooling == Cooling::SYNCHROTRON);
+      const auto sync_grad       = has_synchrotron
+                                     ? m_params.template get<real_t>(
+                                   "algorithms.synchrotron.gamma_rad")
+                                     : ZERO;
+      const auto sync_coeff      = has_synchrotron
+                                     ? (real_t)(0.1) * dt *
+                                    m_params.template get<real_t>(
+                                      "scales.omegaB0") /
+                                    (SQR(sync_grad) * species.mass())
+                                     : ZERO;
 
-        kernel::sr::CoolingTags cooling_tags = 0;
-        if (cooling == Cooling::SYNCHROTRON) {
-          cooling_tags = kernel::sr::Cooling::Synchrotron;
+      // toggle to indicate whether pgen defines the external force
+      bool has_extforce = false;
+      if constexpr (traits::has_member<traits::pgen::ext_force_t, pgen_t>::value) {
+        has_extforce = true;
+        // toggle to indicate whether the ext force applies to current species
+        if (traits::has_member<traits::species_t, decltype(pgen_t::ext_force)>::value) {
+          has_extforce &= std::find(m_pgen.ext_force.species.begin(),
+                                    m_pgen.ext_force.species.end(),
+                                    species.index()) !=
+                          m_pgen.ext_force.species.end();
         }
-        // clang-format off
-        if (not has_atmosphere and not has_extforce) {
+      }
+
+      kernel::sr::CoolingTags cooling_tags = 0;
+      if (cooling == Cooling::SYNCHROTRON) {
+        cooling_tags = kernel::sr::Cooling::Synchrotron;
+      }
+      // the coordinates before the push are only needed until the deposit
+      auto& prev = domain.prtl_prev;
+      prev.reserve(species.maxnpart());
+      // clang-format off
+      if (not has_atmosphere and not has_extforce) {
+        Kokkos::parallel_for(
+          "ParticlePusher",
+          species.rangeActiveParticles(),
+          kernel::sr::Pusher_kernel<M>(
+              pusher, has_gca, false,
+              cooling_tags,
+              domain.fields.em,
+              species.index(),
+              species.i1,        species.i2,       species.i3,
+              prev.i1,           prev.i2,          prev.i3,
+              species.dx1,       species.dx2,      species.dx3,
+              prev.dx1,          prev.dx2,         prev.dx3,
+              species.ux1,       species.ux2,      species.ux3,
+              species.phi,       species.tag,
+              domain.mesh.metric,
+              time, coeff, dt,
+              domain.mesh.n_active(in::x1),
+              domain.mesh.n_active(in::x2),
+              domain.mesh.n_active(in::x3),
+              domain.mesh.prtl_bc(),
+              gca_larmor_max, gca_eovrb_max, sync_coeff
+          ));
+      } else if (has_atmosphere and not has_extforce) {
+        const auto force =
+          kernel::sr::Force<M::PrtlDim, M::CoordType, kernel::sr::NoForce_t, true> {
+            {gx1, gx2, gx3},
+            x_surf,
+            ds
+          };
+        Kokkos::parallel_for(
+          "ParticlePusher",
+          species.rangeActiveParticles(),
+          kernel::sr::Pusher_kernel<M, decltype(force)>(
+              pusher, has_gca, false,
+              cooling_tags,
+              domain.fields.em,
+              species.index(),
+              species.i1,        species.i2,       species.i3,
+              prev.i1,           prev.i2,          prev.i3,
+              species.dx1,       species.dx2,      species.dx3,
+              prev.dx1,          prev.dx2,         prev.dx3,
+              species.ux1,       species.ux2,      species.ux3,
+              species.phi,       species.tag,
+              domain.mesh.metric,
+              force,
+              time, coeff, dt,
+              domain.mesh.n_active(in::x1),
+              domain.mesh.n_active(in::x2),
+              domain.mesh.n_active(in::x3),
+              domain.mesh.prtl_bc(),
+              gca_larmor_max, gca_eovrb_max, sync_coeff
+          ));
+      } else if (not has_atmosphere and has_extforce) {
+        if constexpr (traits::has_member<traits::pgen::ext_force_t, pgen_t>::value) {
+          const auto force =
+            kernel::sr::Force<M::PrtlDim, M::CoordType, decltype(m_pgen.ext_force), false> {
+              m_pgen.ext_force
+            };
           Kokkos::parallel_for(
             "ParticlePusher",
             species.rangeActiveParticles(),
-            kernel::sr::Pusher_kernel<M>(
-                pusher, has_gca, false,
+            kernel::sr::Pusher_kernel<M, decltype(force)>(
+                pusher, has_gca, true,
                 cooling_tags,
                 domain.fields.em,
                 species.index(),
                 species.i1,        species.i2,       species.i3,
-                species.i1_prev,   species.i2_prev,  species.i3_prev,
+                prev.i1,           prev.i2,          prev.i3,
                 species.dx1,       species.dx2,      species.dx3,
-                species.dx1_prev,  species.dx2_prev, species.dx3_prev,
+                prev.dx1,          prev.dx2,         prev.dx3,
                 species.ux1,       species.ux2,      species.ux3,
                 species.phi,       species.tag,
                 domain.mesh.metric,
+                force,
                 time, coeff, dt,
                 domain.mesh.n_active(in::x1),
                 domain.mesh.n_active(in::x2),
@@ -365,25 +526,27 @@ namespace ntt {
                 domain.mesh.prtl_bc(),
                 gca_larmor_max, gca_eovrb_max, sync_coeff
             ));
-        } else if (has_atmosphere and not has_extforce) {
+        } else {
+          raise::Error("External force not implemented", HERE);
+        }
+      } else { // has_atmosphere and has_extforce
+        if constexpr (traits::has_member<traits::pgen::ext_force_t, pgen_t>::value) {
           const auto force =
-            kernel::sr::Force<M::PrtlDim, M::CoordType, kernel::sr::NoForce_t, true> {
-              {gx1, gx2, gx3},
-              x_surf,
-              ds
+            kernel::sr::Force<M::PrtlDim, M::CoordType, decltype(m_pgen.ext_force), true> {
+              m_pgen.ext_force, {gx1, gx2, gx3}, x_surf, ds
             };
           Kokkos::parallel_for(
             "ParticlePusher",
             species.rangeActiveParticles(),
             kernel::sr::Pusher_kernel<M, decltype(force)>(
-                pusher, has_gca, false,
+                pusher, has_gca, true,
                 cooling_tags,
                 domain.fields.em,
                 species.index(),
                 species.i1,        species.i2,       species.i3,
-                species.i1_prev,   species.i2_prev,  species.i3_prev,
+                prev.i1,           prev.i2,          prev.i3,
                 species.dx1,       species.dx2,      species.dx3,
-                species.dx1_prev,  species.dx2_prev, species.dx3_prev,
+                prev.dx1,          prev.dx2,         prev.dx3,
                 species.ux1,       species.ux2,      species.ux3,
                 species.phi,       species.tag,
                 domain.mesh.metric,
@@ -395,126 +558,144 @@ namespace ntt {
                 domain.mesh.prtl_bc(),
                 gca_larmor_max, gca_eovrb_max, sync_coeff
             ));
-        } else if (not has_atmosphere and has_extforce) {
-          if constexpr (traits::has_member<traits::pgen::ext_force_t, pgen_t>::value) {
-            const auto force =
-              kernel::sr::Force<M::PrtlDim, M::CoordType, decltype(m_pgen.ext_force), false> {
-                m_pgen.ext_force
-              };
-            Kokkos::parallel_for(
-              "ParticlePusher",
-              species.rangeActiveParticles(),
-              kernel::sr::Pusher_kernel<M, decltype(force)>(
-                  pusher, has_gca, true,
-                  cooling_tags,
-                  domain.fields.em,
-                  species.index(),
-                  species.i1,        species.i2,       species.i3,
-                  species.i1_prev,   species.i2_prev,  species.i3_prev,
-                  species.dx1,       species.dx2,      species.dx3,
-                  species.dx1_prev,  species.dx2_prev, species.dx3_prev,
-                  species.ux1,       species.ux2,      species.ux3,
-                  species.phi,       species.tag,
-                  domain.mesh.metric,
-                  force,
-                  time, coeff, dt,
-                  domain.mesh.n_active(in::x1),
-                  domain.mesh.n_active(in::x2),
-                  domain.mesh.n_active(in::x3),
-                  domain.mesh.prtl_bc(),
-                  gca_larmor_max, gca_eovrb_max, sync_coeff
-              ));
-          } else {
-            raise::Error("External force not implemented", HERE);
-          }
-        } else { // has_atmosphere and has_extforce
-          if constexpr (traits::has_member<traits::pgen::ext_force_t, pgen_t>::value) {
-            const auto force =
-              kernel::sr::Force<M::PrtlDim, M::CoordType, decltype(m_pgen.ext_force), true> {
-                m_pgen.ext_force, {gx1, gx2, gx3}, x_surf, ds
-              };
-            Kokkos::parallel_for(
-              "ParticlePusher",
-              species.rangeActiveParticles(),
-              kernel::sr::Pusher_kernel<M, decltype(force)>(
-                  pusher, has_gca, true,
-                  cooling_tags,
-                  domain.fields.em,
-                  species.index(),
-                  species.i1,        species.i2,       species.i3,
-                  species.i1_prev,   species.i2_prev,  species.i3_prev,
-                  species.dx1,       species.dx2,      species.dx3,
-                  species.dx1_prev,  species.dx2_prev, species.dx3_prev,
-                  species.ux1,       species.ux2,      species.ux3,
-                  species.phi,       species.tag,
-                  domain.mesh.metric,
-                  force,
-                  time, coeff, dt,
-                  domain.mesh.n_active(in::x1),
-                  domain.mesh.n_active(in::x2),
-                  domain.mesh.n_active(in::x3),
-                  domain.mesh.prtl_bc(),
-                  gca_larmor_max, gca_eovrb_max, sync_coeff
-              ));
-          } else {
-            raise::Error("External force not implemented", HERE);
-          }          
-        }
-        // clang-format on
+        } else {
+          raise::Error("External force not implemented", HERE);
+        }          
       }
+      // clang-format on
+      timers.stopSub(prtl_timer);
     }
 
-    void ParticleInjector(domain_t& domain, InjTags tags = Inj::None) {
+    void ParticleInjector(InjTags tags = Inj::None) {
       for (auto& direction : dir::Directions<M::Dim>::orth) {
         if (m_metadomain.mesh().prtl_bc_in(direction) == PrtlBC::ATMOSPHERE) {
-          AtmosphereParticlesIn(direction, domain, tags);
+          // densities near the boundary are needed in all the local domains
+          // ... before the injection
+          m_metadomain.runOnLocalDomains([&](auto& domain) {
+            AtmosphereDensityIn(direction, domain, tags);
+          });
+          if (not(tags & Inj::AssumeEmpty)) {
+            m_metadomain.SynchronizeFields(Comm::Bckp, { 0, 1 });
+          }
+          m_metadomain.runOnLocalDomains([&](auto& domain) {
+            AtmosphereParticlesIn(direction, domain, tags);
+          });
         }
       }
     }
 
-    void CurrentsDeposit(domain_t& domain) {
+    void CurrentsDeposit(domain_t& domain, species_t& species) {
+      const auto tile_size = m_params.template get<unsigned short>(
+        "algorithms.deposit.tile_size");
+      if (tile_size > 0) {
+        CurrentsDepositTiled(domain, species, tile_size);
+        return;
+      }
+      logger::Checkpoint(
+        [&]() {
+          return fmt::format(
+            "Launching currents deposit kernel for %d [%s] : %lu %f",
+            species.index(),
+            species.label().c_str(),
+            species.npart(),
+            (double)species.charge());
+        },
+        HERE);
+      if (species.npart() == 0 || cmp::AlmostZero(species.charge())) {
+        return;
+      }
       auto scatter_cur = Kokkos::Experimental::create_scatter_view(
         domain.fields.cur);
-      for (auto& species : domain.species) {
-        logger::Checkpoint(
-          fmt::format("Launching currents deposit kernel for %d [%s] : %lu %f",
-                      species.index(),
-                      species.label().c_str(),
-                      species.npart(),
-                      (double)species.charge()),
-          HERE);
-        if (species.npart() == 0 || cmp::AlmostZero(species.charge())) {
-          continue;
-        }
-        Kokkos::parallel_for("CurrentsDeposit",
-                             species.rangeActiveParticles(),
-                             kernel::DepositCurrents_kernel<SimEngine::SRPIC, M>(
-                               scatter_cur,
-                               species.i1,
-                               species.i2,
-                               species.i3,
-                               species.i1_prev,
-                               species.i2_prev,
-                               species.i3_prev,
-                               species.dx1,
-                               species.dx2,
-                               species.dx3,
-                               species.dx1_prev,
-                               species.dx2_prev,
-                               species.dx3_prev,
-                               species.ux1,
-                               species.ux2,
-                               species.ux3,
-                               species.phi,
-                               species.weight,
-                               species.tag,
-                               domain.mesh.metric,
-                               (real_t)(species.charge()),
-                               dt));
-      }
+      Kokkos::parallel_for("CurrentsDeposit",
+                           species.rangeActiveParticles(),
+                           kernel::DepositCurrents_kernel<SimEngine::SRPIC, M>(
+                             scatter_cur,
+                             species.i1,
+                             species.i2,
+                             species.i3,
+                             domain.prtl_prev.i1,
+                             domain.prtl_prev.i2,
+                             domain.prtl_prev.i3,
+                             species.dx1,
+                             species.dx2,
+                             species.dx3,
+                             domain.prtl_prev.dx1,
+                             domain.prtl_prev.dx2,
+                             domain.prtl_prev.dx3,
+                             species.ux1,
+                             species.ux2,
+                             species.ux3,
+                             species.phi,
+                             species.weight,
+                             species.tag,
+                             domain.mesh.metric,
+                             (real_t)(species.charge()),
+                             dt));
       Kokkos::Experimental::contribute(domain.fields.cur, scatter_cur);
     }
 
+    void CurrentsDepositTiled(domain_t&      domain,
+                              species_t&     species,
+                              unsigned short tile_size) {
+      using deposit_t = kernel::DepositCurrentsTiled_kernel<SimEngine::SRPIC, M>;
+      const auto scratch_size = deposit_t::scratch_size(tile_size);
+      const auto scratch_max = static_cast<std::size_t>(
+        team_policy_t::scratch_size_max(0));
+      raise::ErrorIf(scratch_size > scratch_max,
+                     fmt::format("tile_size %d requires %lu bytes of scratch "
+                                 "memory per team, which exceeds the limit",
+                                 tile_size,
+                                 scratch_size),
+                     HERE);
+      const auto ncells = domain.mesh.n_active();
+      logger::Checkpoint(
+        [&]() {
+          return fmt::format(
+            "Launching tiled currents deposit kernel for %d [%s] : %lu %f",
+            species.index(),
+            species.label().c_str(),
+            species.npart(),
+            (double)species.charge());
+        },
+        HERE);
+      if (species.npart() == 0 || cmp::AlmostZero(species.charge())) {
+        return;
+      }
+      const auto [tile_offsets, tile_prtls] = species.TileIndex(ncells,
+                                                                tile_size);
+      const auto deposit = deposit_t(domain.fields.cur,
+                                     tile_offsets,
+                                     tile_prtls,
+                                     ncells,
+                                     tile_size,
+                                     species.i1,
+                                     species.i2,
+                                     species.i3,
+                                     domain.prtl_prev.i1,
+                                     domain.prtl_prev.i2,
+                                     domain.prtl_prev.i3,
+                                     species.dx1,
+                                     species.dx2,
+                                     species.dx3,
+                                     domain.prtl_prev.dx1,
+                                     domain.prtl_prev.dx2,
+                                     domain.prtl_prev.dx3,
+                                     species.ux1,
+                                     species.ux2,
+                                     species.ux3,
+                                     species.phi,
+                                     species.weight,
+                                     species.tag,
+                                     domain.mesh.metric,
+                                     (real_t)(species.charge()),
+                                     dt);
+      Kokkos::parallel_for(
+        "CurrentsDepositTiled",
+        team_policy_t(deposit.ntiles_tot(), Kokkos::AUTO)
+          .set_scratch_size(0, Kokkos::PerTeam(scratch_size)),
+        deposit);
+    }
+
     void CurrentsAmpere(domain_t& domain) {
       logger::Checkpoint("Launching Ampere kernel for adding currents", HERE);
       const auto q0    = m_params.template get<real_t>("scales.q0");
@@ -548,32 +729,48 @@ namespace ntt {
       }
     }
 
-    void CurrentsFilter(domain_t& domain) {
+    void CurrentsFilter() {
       logger::Checkpoint("Launching currents filtering kernels", HERE);
-      auto       range   = range_with_axis_BCs(domain);
       const auto nfilter = m_params.template get<unsigned short>(
         "algorithms.current_filters");
-      tuple_t<std::size_t, M::Dim> size;
-      if constexpr (M::Dim == Dim::_1D || M::Dim == Dim::_2D || M::Dim == Dim::_3D) {
-        size[0] = domain.mesh.n_active(in::x1);
-      }
-      if constexpr (M::Dim == Dim::_2D || M::Dim == Dim::_3D) {
-        size[1] = domain.mesh.n_active(in::x2);
-      }
-      if constexpr (M::Dim == Dim::_3D) {
-        size[2] = domain.mesh.n_active(in::x3);
-      }
-      // !TODO: this needs to be done more efficiently
-      for (unsigned short i = 0; i < nfilter; ++i) {
-        Kokkos::deep_copy(domain.fields.buff, domain.fields.cur);
-        Kokkos::parallel_for("CurrentsFilter",
-                             range,
-                             kernel::DigitalFilter_kernel<M::Dim, M::CoordType>(
-                               domain.fields.cur,
-                               domain.fields.buff,
-                               size,
-                               domain.mesh.flds_bc()));
-        m_metadomain.CommunicateFields(domain, Comm::J);
+      /**
+       * one exchange fills enough ghost cells for N_GHOSTS passes: each pass
+       * also filters the ghost layers shared with the neighbors, one layer
+       * less than the previous pass, and the passes alternate between cur and
+       * buff (so no copy is needed in between)
+       */
+      for (unsigned short i = 0; i < nfilter; i += N_GHOSTS) {
+        const auto npasses = std::min<unsigned short>(N_GHOSTS, nfilter - i);
+        m_metadomain.runOnLocalDomains([&](auto& domain) {
+          tuple_t<std::size_t, M::Dim> size;
+          if constexpr (M::Dim == Dim::_1D || M::Dim == Dim::_2D ||
+                        M::Dim == Dim::_3D) {
+            size[0] = domain.mesh.n_active(in::x1);
+          }
+          if constexpr (M::Dim == Dim::_2D || M::Dim == Dim::_3D) {
+            size[1] = domain.mesh.n_active(in::x2);
+          }
+          if constexpr (M::Dim == Dim::_3D) {
+            size[2] = domain.mesh.n_active(in::x3);
+          }
+          // ghost cells which are not exchanged are read from buff as well
+          if ((i == 0) or (npasses % 2 == 1)) {
+            Kokkos::deep_copy(domain.fields.buff, domain.fields.cur);
+          }
+          for (unsigned short p = 0; p < npasses; ++p) {
+            // odd # of passes starts from buff to finish in cur
+            const auto to_buff = ((npasses - p) % 2 == 0);
+            Kokkos::parallel_for(
+              "CurrentsFilter",
+              range_for_filter(domain, npasses - p - 1),
+              kernel::DigitalFilter_kernel<M::Dim, M::CoordType>(
+                to_buff ? domain.fields.buff : domain.fields.cur,
+                to_buff ? domain.fields.cur : domain.fields.buff,
+                size,
+                domain.mesh.flds_bc()));
+          }
+        });
+        m_metadomain.CommunicateFields(Comm::J);
       }
     }
 
@@ -928,23 +1125,15 @@ namespace ntt {
       // }
     }
 
-    void AtmosphereParticlesIn(const dir::direction_t<M::Dim>& direction,
-                               domain_t&                       domain,
-                               InjTags                         tags) {
-      const auto [sign, dim, xg_min, xg_max] = get_atm_extent(direction);
-
-      const auto x_surf = sign > 0 ? xg_min : xg_max;
-      const auto ds     = m_params.template get<real_t>(
-        "grid.boundaries.atmosphere.ds");
-      const auto temp = m_params.template get<real_t>(
-        "grid.boundaries.atmosphere.temperature");
-      const auto height = m_params.template get<real_t>(
-        "grid.boundaries.atmosphere.height");
+    /**
+     * @brief Computes the density of the atmosphere species (stored in bckp)
+     */
+    void AtmosphereDensityIn(const dir::direction_t<M::Dim>&,
+                             domain_t& domain,
+                             InjTags   tags) {
       const auto species =
         m_params.template get<std::pair<unsigned short, unsigned short>>(
           "grid.boundaries.atmosphere.species");
-      const auto nmax = m_params.template get<real_t>(
-        "grid.boundaries.atmosphere.density");
 
       Kokkos::deep_copy(domain.fields.bckp, ZERO);
       auto scatter_bckp = Kokkos::Experimental::create_scatter_view(
@@ -998,8 +1187,31 @@ namespace ntt {
           prtl_spec.set_unsorted();
         }
         Kokkos::Experimental::contribute(domain.fields.bckp, scatter_bckp);
-        m_metadomain.SynchronizeFields(domain, Comm::Bckp, { 0, 1 });
       }
+    }
+
+    /**
+     * @brief Injects the atmosphere particles given the (synchronized)
+     * density from `AtmosphereDensityIn`
+     */
+    void AtmosphereParticlesIn(const dir::direction_t<M::Dim>& direction,
+                               domain_t&                       domain,
+                               InjTags) {
+      const auto [sign, dim, xg_min, xg_max] = get_atm_extent(direction);
+
+      const auto x_surf = sign > 0 ? xg_min : xg_max;
+      const auto ds     = m_params.template get<real_t>(
+        "grid.boundaries.atmosphere.ds");
+      const auto temp = m_params.template get<real_t>(
+        "grid.boundaries.atmosphere.temperature");
+      const auto height = m_params.template get<real_t>(
+        "grid.boundaries.atmosphere.height");
+      const auto species =
+        m_params.template get<std::pair<unsigned short, unsigned short>>(
+          "grid.boundaries.atmosphere.species");
+      const auto nmax = m_params.template get<real_t>(
+        "grid.boundaries.atmosphere.density");
+      const auto use_weights = M::CoordType != Coord::Cart;
 
       if (dim == in::x1) {
         if (sign > 0) {
@@ -1217,6 +1429,91 @@ namespace ntt {
       }
       return range;
     }
+
+    /**
+     * @brief Same cells as `range_with_axis_BCs`, extended by `ext` ghost
+     * layers in the directions with neighboring domains
+     */
+    auto range_for_filter(const domain_t& domain, unsigned short ext)
+      -> range_t<M::Dim> {
+      tuple_t<std::size_t, M::Dim> i_min, i_max;
+      for (auto d { 0u }; d < M::Dim; ++d) {
+        i_min[d] = domain.mesh.i_min(static_cast<in>(d));
+        i_max[d] = domain.mesh.i_max(static_cast<in>(d));
+      }
+      for (auto& direction : dir::Directions<M::Dim>::orth) {
+        const auto d  = static_cast<unsigned short>(direction.get_dim());
+        const auto bc = domain.mesh.flds_bc_in(direction);
+        if ((bc == FldsBC::PERIODIC) or (bc == FldsBC::SYNC)) {
+          if (direction.get_sign() > 0) {
+            i_max[d] += ext;
+          } else {
+            i_min[d] -= ext;
+          }
+        } else if ((bc == FldsBC::AXIS) and (direction.get_sign() > 0)) {
+          // taking one extra cell in the x2 direction if AXIS BCs
+          i_max[d] += 1;
+        }
+      }
+      return CreateRangePolicy<M::Dim>(i_min, i_max);
+    }
+
+    /**
+     * @brief Whether Ampere can be split into the part independent of the
+     * B-field ghost zones (overlapped with the communication) and the rest
+     * @note Only done when the field boundaries do not modify the active cells
+     */
+    auto overlap_ampere_with_comms(const domain_t& domain) -> bool {
+      if constexpr (M::CoordType != Coord::Cart) {
+        return false;
+      } else {
+        for (auto& direction : dir::Directions<M::Dim>::orth) {
+          const auto global_bc = m_metadomain.mesh().flds_bc_in(direction);
+          const auto local_bc  = domain.mesh.flds_bc_in(direction);
+          if ((global_bc == FldsBC::ABSORB) or (global_bc == FldsBC::ATMOSPHERE) or
+              ((local_bc != FldsBC::PERIODIC) and (local_bc != FldsBC::SYNC))) {
+            return false;
+          }
+        }
+        return true;
+      }
+    }
+
+    /**
+     * @brief Active cells where the Ampere stencil (i - 1) stays within the
+     * active region
+     */
+    auto ampere_interior_range(const domain_t& domain) -> range_t<M::Dim> {
+      tuple_t<std::size_t, M::Dim> imin, imax;
+      for (unsigned short d { 0 }; d < (unsigned short)M::Dim; ++d) {
+        imin[d] = domain.mesh.i_min(static_cast<in>(d)) + 1;
+        imax[d] = domain.mesh.i_max(static_cast<in>(d));
+      }
+      return CreateRangePolicy<M::Dim>(imin, imax);
+    }
+
+    /**
+     * @brief Non-overlapping layers of active cells complementary to
+     * `ampere_interior_range` (one per dimension)
+     */
+    auto ampere_boundary_ranges(const domain_t& domain)
+      -> std::vector<range_t<M::Dim>> {
+      std::vector<range_t<M::Dim>> ranges;
+      for (unsigned short d { 0 }; d < (unsigned short)M::Dim; ++d) {
+        tuple_t<std::size_t, M::Dim> imin, imax;
+        for (unsigned short e { 0 }; e < (unsigned short)M::Dim; ++e) {
+          imin[e] = domain.mesh.i_min(static_cast<in>(e));
+          imax[e] = domain.mesh.i_max(static_cast<in>(e));
+          if (e < d) {
+            imin[e] += 1;
+          } else if (e == d) {
+            imax[e] = imin[e] + 1;
+          }
+        }
+        ranges.push_back(CreateRangePolicy<M::Dim>(imin, imax));
+      }
+      return ranges;
+    }
   };
 
 } // namespace ntt
@@ -3,6 +3,11 @@
 #include "enums.h"
 #include "global.h"
 
+#include "arch/kokkos_aliases.h"
+#include "utils/numeric.h"
+
+#include <Kokkos_Core.hpp>
+
 #include <vector>
 
 namespace ntt {
@@ -46,6 +51,27 @@ namespace ntt {
     }
   }
 
+  template <Dimension D, SimEngine::type S>
+  void Fields<D, S>::allocateAccumulators(std::size_t n) {
+    acc.clear();
+    for (std::size_t a { 0 }; a < n; ++a) {
+      if constexpr (D == Dim::_1D) {
+        acc.emplace_back("ACC", em.extent(0));
+      } else if constexpr (D == Dim::_2D) {
+        acc.emplace_back("ACC", em.extent(0), em.extent(1));
+      } else if constexpr (D == Dim::_3D) {
+        acc.emplace_back("ACC", em.extent(0), em.extent(1), em.extent(2));
+      }
+    }
+  }
+
+  template <Dimension D, SimEngine::type S>
+  void Fields<D, S>::resetAccumulators() {
+    for (auto& a : acc) {
+      Kokkos::deep_copy(a, ZERO);
+    }
+  }
+
   template struct Fields<Dim::_1D, SimEngine::type::SRPIC>;
   template struct Fields<Dim::_2D, SimEngine::type::SRPIC>;
   template struct Fields<Dim::_3D, SimEngine::type::SRPIC>;
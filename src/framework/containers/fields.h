@@ -9,6 +9,7 @@
  *   - ntt::
  * @note SRPIC engine allocates em(6), bckp(6), cur(3), buff(3)
  * @note GRPIC engine allocates em(6), bckp(6), cur(3), buff(3), aux(6), em0(6), cur0(3)
+ * @note Accumulators acc(3) of the time-averaged diagnostics are allocated on request
  * @note Each field has resolution + 2 * N_GHOSTS components in each direction
  * @note Vector field components are stored as the last index in corresponding field
  */
@@ -103,6 +104,16 @@ namespace ntt {
      */
     ndfield_t<D, 3> cur0;
 
+    /* Diagnostics ---------------------------------------------------------- */
+    /**
+     * Accumulators of the time-averaged (or integrated) field diagnostics
+     *
+     * @note Sizes are : resolution + 2 * N_GHOSTS in each direction x3 for
+     * each component of the cell-centered vector in the physical basis
+     * @note Address : acc[a](i, j, k, ***)
+     */
+    std::vector<ndfield_t<D, 3>> acc;
+
     /**
      * @brief Constructor for the fields container. Also sets the active cell sizes and ranges
      * @param res resolution vector of size D (dimension)
@@ -118,7 +129,8 @@ namespace ntt {
       , buff { std::move(other.buff) }
       , aux { std::move(other.aux) }
       , em0 { std::move(other.em0) }
-      , cur0 { std::move(other.cur0) } {}
+      , cur0 { std::move(other.cur0) }
+      , acc { std::move(other.acc) } {}
 
     Fields& operator=(Fields&& other) noexcept {
       if (this != &other) {
@@ -129,6 +141,7 @@ namespace ntt {
         aux  = std::move(other.aux);
         em0  = std::move(other.em0);
         cur0 = std::move(other.cur0);
+        acc  = std::move(other.acc);
       }
       return *this;
     }
@@ -138,6 +151,17 @@ namespace ntt {
 
     ~Fields() = default;
 
+    /**
+     * @brief (Re)allocates the zeroed accumulators of the field diagnostics
+     * @param n number of accumulators
+     */
+    void allocateAccumulators(std::size_t);
+
+    /**
+     * @brief Zeroes all the accumulators
+     */
+    void resetAccumulators();
+
     /* getters -------------------------------------------------------------- */
     [[nodiscard]]
     auto memory_footprint() const -> std::size_t {
@@ -148,6 +172,7 @@ namespace ntt {
       std::size_t aux_footprint  = 6;
       std::size_t em0_footprint  = 6;
       std::size_t cur0_footprint = 3;
+      std::size_t acc_footprint  = 3 * acc.size();
       for (auto d = 0; d < D; ++d) {
         em_footprint   *= em.extent(d);
         bckp_footprint *= bckp.extent(d);
@@ -156,10 +181,11 @@ namespace ntt {
         aux_footprint  *= aux.extent(d);
         em0_footprint  *= em0.extent(d);
         cur0_footprint *= cur0.extent(d);
+        acc_footprint  *= em.extent(d);
       }
       return (std::size_t)(sizeof(real_t)) *
              (em_footprint + bckp_footprint + cur_footprint + buff_footprint +
-              aux_footprint + em0_footprint + cur0_footprint);
+              aux_footprint + em0_footprint + cur0_footprint + acc_footprint);
     }
   };
 
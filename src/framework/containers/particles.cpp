@@ -4,6 +4,10 @@
 #include "global.h"
 
 #include "arch/kokkos_aliases.h"
+#include "utils/error.h"
+#include "utils/formatting.h"
+#include "utils/log.h"
+#include "utils/numeric.h"
 #include "utils/sorting.h"
 
 #include "framework/containers/species.h"
@@ -11,7 +15,10 @@
 #include <Kokkos_Core.hpp>
 #include <Kokkos_ScatterView.hpp>
 
+#include <algorithm>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace ntt {
@@ -24,16 +31,28 @@ namespace ntt {
                              const PrtlPusher&  pusher,
                              bool               use_gca,
                              const Cooling&     cooling,
-                             unsigned short     npld)
-    : ParticleSpecies(index, label, m, ch, maxnpart, pusher, use_gca, cooling, npld) {
+                             unsigned short     npld,
+                             bool               track_ids,
+                             float              growth_factor,
+                             float              shrink_threshold)
+    : ParticleSpecies(index,
+                      label,
+                      m,
+                      ch,
+                      maxnpart,
+                      pusher,
+                      use_gca,
+                      cooling,
+                      npld,
+                      track_ids,
+                      growth_factor,
+                      shrink_threshold)
+    , m_min_maxnpart { maxnpart } {
     i1    = array_t<int*> { label + "_i1", maxnpart };
     i1_h  = Kokkos::create_mirror_view(i1);
     dx1   = array_t<prtldx_t*> { label + "_dx1", maxnpart };
     dx1_h = Kokkos::create_mirror_view(dx1);
 
-    i1_prev  = array_t<int*> { label + "_i1_prev", maxnpart };
-    dx1_prev = array_t<prtldx_t*> { label + "_dx1_prev", maxnpart };
-
     ux1   = array_t<real_t*> { label + "_ux1", maxnpart };
     ux1_h = Kokkos::create_mirror_view(ux1);
     ux2   = array_t<real_t*> { label + "_ux2", maxnpart };
@@ -52,14 +71,17 @@ namespace ntt {
       pld_h.push_back(Kokkos::create_mirror_view(pld[n]));
     }
 
+    if (track_ids) {
+      // zero-initialized: none of the particles have an ID yet
+      id   = array_t<std::size_t*> { label + "_id", maxnpart };
+      id_h = Kokkos::create_mirror_view(id);
+    }
+
     if constexpr ((D == Dim::_2D) || (D == Dim::_3D)) {
       i2    = array_t<int*> { label + "_i2", maxnpart };
       i2_h  = Kokkos::create_mirror_view(i2);
       dx2   = array_t<prtldx_t*> { label + "_dx2", maxnpart };
       dx2_h = Kokkos::create_mirror_view(dx2);
-
-      i2_prev  = array_t<int*> { label + "_i2_prev", maxnpart };
-      dx2_prev = array_t<prtldx_t*> { label + "_dx2_prev", maxnpart };
     }
     if ((D == Dim::_2D) && (C != Coord::Cart)) {
       phi   = array_t<real_t*> { label + "_phi", maxnpart };
@@ -71,9 +93,6 @@ namespace ntt {
       i3_h  = Kokkos::create_mirror_view(i3);
       dx3   = array_t<prtldx_t*> { label + "_dx3", maxnpart };
       dx3_h = Kokkos::create_mirror_view(dx3);
-
-      i3_prev  = array_t<int*> { label + "_i3_prev", maxnpart };
-      dx3_prev = array_t<prtldx_t*> { label + "_dx3_prev", maxnpart };
     }
   }
 
@@ -102,57 +121,475 @@ namespace ntt {
     return npart_tag_vec;
   }
 
+  namespace {
+    /**
+     * @brief Apply a function to all the allocated particle arrays
+     */
+    template <Dimension D, Coord::type C, class F>
+    void ForEachArray(Particles<D, C>& prtls, const F& func) {
+      func(prtls.i1);
+      func(prtls.dx1);
+      func(prtls.ux1);
+      func(prtls.ux2);
+      func(prtls.ux3);
+
+      func(prtls.tag);
+      func(prtls.weight);
+
+      for (unsigned short n { 0 }; n < prtls.npld(); ++n) {
+        func(prtls.pld[n]);
+      }
+
+      if (prtls.track_ids()) {
+        func(prtls.id);
+      }
+
+      if constexpr ((D == Dim::_2D) || (D == Dim::_3D)) {
+        func(prtls.i2);
+        func(prtls.dx2);
+      }
+      if constexpr (D == Dim::_3D) {
+        func(prtls.i3);
+        func(prtls.dx3);
+      }
+
+      if ((D == Dim::_2D) && (C != Coord::Cart)) {
+        func(prtls.phi);
+      }
+    }
+
+    /**
+     * @brief Apply the permutation of a bin-sorter to all particle arrays
+     */
+    template <Dimension D, Coord::type C, class SorterT>
+    void PermuteArrays(Particles<D, C>&     prtls,
+                       SorterT&             Sorter,
+                       const range_tuple_t& slice) {
+      ForEachArray(prtls, [&](auto& arr) {
+        Sorter.sort(Kokkos::subview(arr, slice));
+      });
+    }
+
+    /**
+     * @brief Swap the entries `holes(n)` & `movers(n)` of the array for n < count
+     */
+    template <typename T>
+    void SwapEntries(const array_t<T*>&           arr,
+                     const array_t<std::size_t*>& holes,
+                     const array_t<std::size_t*>& movers,
+                     std::size_t                  count) {
+      Kokkos::parallel_for(
+        "SwapEntries",
+        count,
+        Lambda(index_t n) {
+          const auto tmp = arr(holes(n));
+          arr(holes(n))  = arr(movers(n));
+          arr(movers(n)) = tmp;
+        });
+    }
+
+    /**
+     * @brief Reset the IDs of the (sorted) dead particles, since their slots
+     * are reused for the new particles
+     */
+    template <Dimension D, Coord::type C>
+    void ResetDeadIDs(Particles<D, C>&                prtls,
+                      const std::vector<std::size_t>& np_per_tag) {
+      if (not prtls.track_ids()) {
+        return;
+      }
+      const auto nalive = np_per_tag[(short)(ParticleTag::alive)];
+      const auto ndead  = np_per_tag[(short)(ParticleTag::dead)];
+      if (ndead > 0) {
+        Kokkos::deep_copy(
+          Kokkos::subview(prtls.id, range_tuple_t(nalive, nalive + ndead)),
+          0);
+      }
+    }
+
+    /**
+     * @brief Reallocate the array & its host mirror, preserving the first
+     * `npreserve` entries (the rest are zero-initialized)
+     */
+    template <typename T>
+    void ReallocateArray(array_t<T*>&        arr,
+                         array_mirror_t<T*>& arr_h,
+                         std::size_t         maxnpart,
+                         std::size_t         npreserve) {
+      array_t<T*> new_arr { arr.label(), maxnpart };
+      if (npreserve > 0) {
+        const auto slice = range_tuple_t(0, npreserve);
+        Kokkos::deep_copy(Kokkos::subview(new_arr, slice),
+                          Kokkos::subview(arr, slice));
+      }
+      arr   = new_arr;
+      arr_h = Kokkos::create_mirror_view(arr);
+    }
+
+    /**
+     * @brief Makes sure the persistent buffer can hold at least `n` entries
+     * (never shrinks; newly allocated buffers are zero-initialized)
+     */
+    template <typename T>
+    void ReserveArray(array_t<T*>& arr, std::size_t n, const std::string& label) {
+      if (arr.extent(0) < n) {
+        // allocate with a margin to avoid reallocating every step
+        arr = array_t<T*> { label, n + n / 2 };
+      }
+    }
+  } // namespace
+
   template <Dimension D, Coord::type C>
   auto Particles<D, C>::SortByTags() -> std::vector<std::size_t> {
     if (npart() == 0 || is_sorted()) {
       return npart_per_tag();
     }
-    using KeyType = array_t<short*>;
-    using BinOp   = sort::BinTag<KeyType>;
-    BinOp bin_op(ntags());
-    auto  slice = range_tuple_t(0, npart());
-    Kokkos::BinSort<KeyType, BinOp> Sorter(Kokkos::subview(tag, slice), bin_op, false);
+    const auto np_per_tag = npart_per_tag();
+    const auto nalive     = np_per_tag[(short)(ParticleTag::alive)];
+    const auto nother     = npart() - nalive;
+    if (nother > 0) {
+      // only the particles with the wrong tag for their side of `nalive` are
+      // ... moved: alive ones from the tail fill the holes before `nalive`
+      array_t<std::size_t*> holes {
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "holes"),
+        nother
+      };
+      array_t<std::size_t*> movers {
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "movers"),
+        nother
+      };
+      const auto  this_tag = tag;
+      std::size_t nholes { 0 };
+      Kokkos::parallel_scan(
+        "FindHoles",
+        nalive,
+        Lambda(index_t p, std::size_t & n, const bool is_final) {
+          if (this_tag(p) != ParticleTag::alive) {
+            if (is_final) {
+              holes(n) = p;
+            }
+            ++n;
+          }
+        },
+        nholes);
+      Kokkos::parallel_scan(
+        "FindMovers",
+        Kokkos::RangePolicy<AccelExeSpace>(nalive, npart()),
+        Lambda(index_t p, std::size_t & n, const bool is_final) {
+          if (this_tag(p) == ParticleTag::alive) {
+            if (is_final) {
+              movers(n) = p;
+            }
+            ++n;
+          }
+        });
+      if (nholes > 0) {
+        ForEachArray(*this, [&](auto& arr) {
+          SwapEntries(arr, holes, movers, nholes);
+        });
+      }
+
+      // the tail is only bin-sorted if it has more than one kind of tags
+      std::size_t ntails { 0 };
+      for (std::size_t t { 0 }; t < ntags(); ++t) {
+        if ((t != (std::size_t)(ParticleTag::alive)) and (np_per_tag[t] > 0)) {
+          ++ntails;
+        }
+      }
+      if (ntails > 1) {
+        using KeyType = array_t<short*>;
+        using BinOp   = sort::BinTag<KeyType>;
+        BinOp bin_op(ntags());
+        auto  slice = range_tuple_t(nalive, npart());
+        Kokkos::BinSort<KeyType, BinOp> Sorter(Kokkos::subview(tag, slice),
+                                               bin_op,
+                                               false);
+        Sorter.create_permute_vector();
+
+        PermuteArrays(*this, Sorter, slice);
+      }
+    }
+
+    ResetDeadIDs(*this, np_per_tag);
+    set_npart(nalive);
+
+    m_is_sorted = true;
+    return np_per_tag;
+  }
+
+  template <Dimension D, Coord::type C>
+  auto Particles<D, C>::SortByCells(const std::vector<std::size_t>& ncells)
+    -> std::vector<std::size_t> {
+    raise::ErrorIf(ncells.size() != (std::size_t)D,
+                   "wrong number of dimensions in SortByCells",
+                   HERE);
+    if (npart() == 0) {
+      return npart_per_tag();
+    }
+    const int n1 = static_cast<int>(ncells[0]);
+    const int n2 = (D == Dim::_2D || D == Dim::_3D) ? static_cast<int>(ncells[1])
+                                                    : 1;
+    const int n3 = (D == Dim::_3D) ? static_cast<int>(ncells[2]) : 1;
+    // alive particles go to bins [0, ncells_tot), the rest are placed after
+    // ... in the same order as in `BinTag`: dead, then 2, 3, ..., ntags-1
+    const int  ncells_tot  = n1 * n2 * n3;
+    // consecutive particles should access consecutive memory in the fields
+    const bool layout_right = std::is_same<typename ndfield_t<D, 6>::array_layout,
+                                           Kokkos::LayoutRight>::value;
+
+    using KeyType = array_t<int*>;
+    using BinOp   = sort::BinIndex<KeyType>;
+    auto    slice = range_tuple_t(0, npart());
+    KeyType keys { "cell_keys", npart() };
+
+    const auto this_i1  = i1;
+    const auto this_i2  = i2;
+    const auto this_i3  = i3;
+    const auto this_tag = tag;
+    Kokkos::parallel_for(
+      "CellKeys",
+      npart(),
+      Lambda(index_t p) {
+        if (this_tag(p) != ParticleTag::alive) {
+          keys(p) = ncells_tot + ((this_tag(p) == ParticleTag::dead)
+                                    ? 0
+                                    : static_cast<int>(this_tag(p)) - 1);
+          return;
+        }
+        const int c1 = IMIN(IMAX(this_i1(p), 0), n1 - 1);
+        int       c2 = 0, c3 = 0;
+        if constexpr (D == Dim::_2D || D == Dim::_3D) {
+          c2 = IMIN(IMAX(this_i2(p), 0), n2 - 1);
+        }
+        if constexpr (D == Dim::_3D) {
+          c3 = IMIN(IMAX(this_i3(p), 0), n3 - 1);
+        }
+        if (layout_right) {
+          keys(p) = (c1 * n2 + c2) * n3 + c3;
+        } else {
+          keys(p) = c1 + n1 * (c2 + n2 * c3);
+        }
+      });
+
+    BinOp bin_op(ncells_tot + ntags() - 1);
+    Kokkos::BinSort<KeyType, BinOp> Sorter(keys, bin_op, false);
     Sorter.create_permute_vector();
 
-    Sorter.sort(Kokkos::subview(i1, slice));
-    Sorter.sort(Kokkos::subview(dx1, slice));
-    Sorter.sort(Kokkos::subview(i1_prev, slice));
-    Sorter.sort(Kokkos::subview(dx1_prev, slice));
-    Sorter.sort(Kokkos::subview(ux1, slice));
-    Sorter.sort(Kokkos::subview(ux2, slice));
-    Sorter.sort(Kokkos::subview(ux3, slice));
+    PermuteArrays(*this, Sorter, slice);
+
+    const auto np_per_tag = npart_per_tag();
+    ResetDeadIDs(*this, np_per_tag);
+    set_npart(np_per_tag[(short)(ParticleTag::alive)]);
 
-    Sorter.sort(Kokkos::subview(tag, slice));
-    Sorter.sort(Kokkos::subview(weight, slice));
+    m_is_sorted = true;
+    return np_per_tag;
+  }
+
+  template <Dimension D, Coord::type C>
+  auto Particles<D, C>::TileIndex(const std::vector<std::size_t>& ncells,
+                                  unsigned short                  tile_size)
+    -> std::pair<array_t<std::size_t*>, array_t<std::size_t*>> {
+    raise::ErrorIf(ncells.size() != (std::size_t)D,
+                   "wrong number of dimensions in TileIndex",
+                   HERE);
+    raise::ErrorIf(tile_size == 0, "tile_size must be positive", HERE);
+    const int tsize = static_cast<int>(tile_size);
+    int       nt1 { 1 }, nt2 { 1 }, nt3 { 1 };
+    nt1 = (static_cast<int>(ncells[0]) + tsize - 1) / tsize;
+    if constexpr (D == Dim::_2D || D == Dim::_3D) {
+      nt2 = (static_cast<int>(ncells[1]) + tsize - 1) / tsize;
+    }
+    if constexpr (D == Dim::_3D) {
+      nt3 = (static_cast<int>(ncells[2]) + tsize - 1) / tsize;
+    }
+    const std::size_t ntiles_tot = nt1 * nt2 * nt3;
+
+    // called every step: the buffers are reused (and only grow), and the
+    // ... first offset is never written, so it stays zero
+    ReserveArray(m_tile_offsets, ntiles_tot + 1, "tile_offsets");
+    ReserveArray(m_tile_npart, ntiles_tot, "tile_npart");
+    ReserveArray(m_tile_prtls, npart(), "tile_prtls");
+    ReserveArray(m_prtl_tile, npart(), "prtl_tile");
+    const auto tile_offsets = m_tile_offsets;
+    const auto tile_npart   = m_tile_npart;
+    const auto tile_prtls   = m_tile_prtls;
+    const auto prtl_tile    = m_prtl_tile;
+    Kokkos::deep_copy(
+      Kokkos::subview(tile_npart, std::make_pair((std::size_t)0, ntiles_tot)),
+      0);
+
+    const auto this_i1  = i1;
+    const auto this_i2  = i2;
+    const auto this_i3  = i3;
+    const auto this_tag = tag;
+    Kokkos::parallel_for(
+      "TileKeys",
+      rangeActiveParticles(),
+      Lambda(index_t p) {
+        // particles tagged to be sent still carry the current of this step
+        if (this_tag(p) == ParticleTag::dead) {
+          prtl_tile(p) = -1;
+          return;
+        }
+        const int t1 = IMIN(IMAX(this_i1(p) / tsize, 0), nt1 - 1);
+        int       t2 = 0, t3 = 0;
+        if constexpr (D == Dim::_2D || D == Dim::_3D) {
+          t2 = IMIN(IMAX(this_i2(p) / tsize, 0), nt2 - 1);
+        }
+        if constexpr (D == Dim::_3D) {
+          t3 = IMIN(IMAX(this_i3(p) / tsize, 0), nt3 - 1);
+        }
+        prtl_tile(p) = t1 + nt1 * (t2 + nt2 * t3);
+        Kokkos::atomic_increment(&tile_npart(prtl_tile(p)));
+      });
+
+    Kokkos::parallel_scan(
+      "TileOffsets",
+      ntiles_tot,
+      Lambda(index_t t, std::size_t & offset, const bool is_final) {
+        offset += tile_npart(t);
+        if (is_final) {
+          tile_offsets(t + 1) = offset;
+        }
+      });
+
+    // reuse the counters to fill each tile
+    Kokkos::deep_copy(
+      Kokkos::subview(tile_npart, std::make_pair((std::size_t)0, ntiles_tot)),
+      0);
+    Kokkos::parallel_for(
+      "TileFill",
+      rangeActiveParticles(),
+      Lambda(index_t p) {
+        const auto t = prtl_tile(p);
+        if (t < 0) {
+          return;
+        }
+        const auto n = Kokkos::atomic_fetch_add(&tile_npart(t), (std::size_t)1);
+        tile_prtls(tile_offsets(t) + n) = p;
+      });
+    return { tile_offsets, tile_prtls };
+  }
+
+  template <Dimension D, Coord::type C>
+  void Particles<D, C>::AssignIDs(unsigned int domain) {
+    if (not track_ids() or npart() == 0) {
+      return;
+    }
+    // lower bits: per-domain counter, upper bits: domain index
+    constexpr unsigned short counter_bits { 40 };
+    const auto  prefix   = static_cast<std::size_t>(domain) << counter_bits;
+    const auto  first    = m_next_id;
+    const auto  this_id  = id;
+    const auto  this_tag = tag;
+    std::size_t nassigned { 0 };
+    Kokkos::parallel_scan(
+      "AssignIDs",
+      rangeActiveParticles(),
+      Lambda(index_t p, std::size_t & n, const bool is_final) {
+        if ((this_id(p) == 0) and (this_tag(p) == ParticleTag::alive)) {
+          if (is_final) {
+            this_id(p) = prefix | (first + n);
+          }
+          ++n;
+        }
+      },
+      nassigned);
+    m_next_id += nassigned;
+    raise::ErrorIf(m_next_id >= (static_cast<std::size_t>(1) << counter_bits),
+                   "Particle ID counter overflow",
+                   HERE);
+  }
+
+  template <Dimension D, Coord::type C>
+  void Particles<D, C>::Reallocate(std::size_t new_maxnpart,
+                                   std::size_t npreserve) {
+    ReallocateArray(i1, i1_h, new_maxnpart, npreserve);
+    ReallocateArray(dx1, dx1_h, new_maxnpart, npreserve);
+    ReallocateArray(ux1, ux1_h, new_maxnpart, npreserve);
+    ReallocateArray(ux2, ux2_h, new_maxnpart, npreserve);
+    ReallocateArray(ux3, ux3_h, new_maxnpart, npreserve);
+
+    ReallocateArray(tag, tag_h, new_maxnpart, npreserve);
+    ReallocateArray(weight, weight_h, new_maxnpart, npreserve);
 
     for (unsigned short n { 0 }; n < npld(); ++n) {
-      Sorter.sort(Kokkos::subview(pld[n], slice));
+      ReallocateArray(pld[n], pld_h[n], new_maxnpart, npreserve);
     }
 
-    if constexpr ((D == Dim::_2D) || (D == Dim::_3D)) {
-      Sorter.sort(Kokkos::subview(i2, slice));
-      Sorter.sort(Kokkos::subview(dx2, slice));
+    if (track_ids()) {
+      ReallocateArray(id, id_h, new_maxnpart, npreserve);
+    }
 
-      Sorter.sort(Kokkos::subview(i2_prev, slice));
-      Sorter.sort(Kokkos::subview(dx2_prev, slice));
+    if constexpr ((D == Dim::_2D) || (D == Dim::_3D)) {
+      ReallocateArray(i2, i2_h, new_maxnpart, npreserve);
+      ReallocateArray(dx2, dx2_h, new_maxnpart, npreserve);
     }
     if constexpr (D == Dim::_3D) {
-      Sorter.sort(Kokkos::subview(i3, slice));
-      Sorter.sort(Kokkos::subview(dx3, slice));
-
-      Sorter.sort(Kokkos::subview(i3_prev, slice));
-      Sorter.sort(Kokkos::subview(dx3_prev, slice));
+      ReallocateArray(i3, i3_h, new_maxnpart, npreserve);
+      ReallocateArray(dx3, dx3_h, new_maxnpart, npreserve);
     }
 
     if ((D == Dim::_2D) && (C != Coord::Cart)) {
-      Sorter.sort(Kokkos::subview(phi, slice));
+      ReallocateArray(phi, phi_h, new_maxnpart, npreserve);
     }
+    m_maxnpart = new_maxnpart;
+  }
 
-    const auto np_per_tag = npart_per_tag();
-    set_npart(np_per_tag[(short)(ParticleTag::alive)]);
+  template <Dimension D, Coord::type C>
+  void Particles<D, C>::Reserve(std::size_t n) {
+    if ((n <= maxnpart()) or (growth_factor() <= 1.0f)) {
+      return;
+    }
+    // grow with some headroom, so that the number of reallocations stays
+    // ... logarithmic in the number of particles
+    const auto new_maxnpart = static_cast<std::size_t>(
+      static_cast<double>(growth_factor()) *
+      static_cast<double>(std::max(n, maxnpart())));
+    info::Print(fmt::format("Species #%d (%s): growing the capacity %lu -> %lu "
+                            "(npart = %lu, requested = %lu)",
+                            index(),
+                            label().c_str(),
+                            maxnpart(),
+                            new_maxnpart,
+                            npart(),
+                            n),
+                false,
+                false,
+                false);
+    // everything is preserved: the entries above `npart` may already be used
+    // ... (e.g., by the particles received in the middle of a communication)
+    Reallocate(new_maxnpart, maxnpart());
+  }
 
-    m_is_sorted = true;
-    return np_per_tag;
+  template <Dimension D, Coord::type C>
+  void Particles<D, C>::ShrinkToFit() {
+    if ((shrink_threshold() <= 0.0f) or (maxnpart() <= m_min_maxnpart) or
+        (static_cast<double>(npart()) >=
+         static_cast<double>(shrink_threshold()) *
+           static_cast<double>(maxnpart()))) {
+      return;
+    }
+    // leave the same headroom as when growing
+    const auto new_maxnpart = std::max(
+      m_min_maxnpart,
+      static_cast<std::size_t>(
+        static_cast<double>(std::max(growth_factor(), 1.0f)) *
+        static_cast<double>(npart())));
+    if (new_maxnpart >= maxnpart()) {
+      return;
+    }
+    info::Print(fmt::format("Species #%d (%s): shrinking the capacity %lu -> %lu "
+                            "(npart = %lu)",
+                            index(),
+                            label().c_str(),
+                            maxnpart(),
+                            new_maxnpart,
+                            npart()),
+                false,
+                false,
+                false);
+    Reallocate(new_maxnpart, npart());
   }
 
   template <Dimension D, Coord::type C>
@@ -170,6 +607,10 @@ namespace ntt {
       Kokkos::deep_copy(pld_h[n], pld[n]);
     }
 
+    if (track_ids()) {
+      Kokkos::deep_copy(id_h, id);
+    }
+
     if constexpr ((D == Dim::_2D) || (D == Dim::_3D)) {
       Kokkos::deep_copy(i2_h, i2);
       Kokkos::deep_copy(dx2_h, dx2);
@@ -3,10 +3,9 @@
  * @brief Definition of the particle container class
  * @implements
  *   - ntt::Particles<> : ntt::ParticleSpecies
+ *   - ntt::ParticlesPrev<>
  * @cpp:
  *   - particles.cpp
- * @macros:
- *   - MPI_ENABLED
  */
 
 #ifndef FRAMEWORK_CONTAINERS_PARTICLES_H
@@ -24,6 +23,7 @@
 #include <Kokkos_Core.hpp>
 
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace ntt {
@@ -39,12 +39,17 @@ namespace ntt {
     // Number of currently active (used) particles
     std::size_t m_npart { 0 };
     bool        m_is_sorted { false };
+    // Counter of the particle IDs assigned in this domain (0 = no ID)
+    std::size_t m_next_id { 1 };
+    // The capacity is never shrunk below the initial one
+    std::size_t m_min_maxnpart { 0 };
 
-#if !defined(MPI_ENABLED)
-    const std::size_t m_ntags { 2 };
-#else // MPI_ENABLED
+    // persistent buffers of `TileIndex` (only grow)
+    array_t<std::size_t*> m_tile_offsets, m_tile_npart, m_tile_prtls;
+    array_t<int*>         m_prtl_tile;
+
+    // dead, alive & one tag per direction of leaving the domain
     const std::size_t m_ntags { (std::size_t)(2 + math::pow(3, (int)D) - 1) };
-#endif
 
   public:
     // Cell indices of the current particle
@@ -55,15 +60,14 @@ namespace ntt {
     array_t<real_t*>              ux1, ux2, ux3;
     // Particle weights.
     array_t<real_t*>              weight;
-    // Previous timestep coordinates
-    array_t<int*>                 i1_prev, i2_prev, i3_prev;
-    array_t<prtldx_t*>            dx1_prev, dx2_prev, dx3_prev;
     // Array to tag the particles
     array_t<short*>               tag;
     // Array to store the particle load
     std::vector<array_t<real_t*>> pld;
     // phi coordinate (for axisymmetry)
     array_t<real_t*>              phi;
+    // Persistent unique IDs (only allocated if tracked, 0 = not assigned yet)
+    array_t<std::size_t*>         id;
 
     // host mirrors
     array_mirror_t<int*>                 i1_h, i2_h, i3_h;
@@ -72,6 +76,7 @@ namespace ntt {
     array_mirror_t<real_t*>              weight_h;
     array_mirror_t<real_t*>              phi_h;
     array_mirror_t<short*>               tag_h;
+    array_mirror_t<std::size_t*>         id_h;
     std::vector<array_mirror_t<real_t*>> pld_h;
 
     // for empty allocation
@@ -88,6 +93,9 @@ namespace ntt {
      * @param use_gca Use hybrid GCA pusher for the species
      * @param cooling The cooling mechanism assigned for the species
      * @param npld The number of payloads for the species
+     * @param track_ids Assign persistent unique IDs to the particles
+     * @param growth_factor Factor to grow the capacity by when exceeded
+     * @param shrink_threshold Occupancy below which the capacity is shrunk
      */
     Particles(unsigned short     index,
               const std::string& label,
@@ -97,7 +105,10 @@ namespace ntt {
               const PrtlPusher&  pusher,
               bool               use_gca,
               const Cooling&     cooling,
-              unsigned short     npld = 0);
+              unsigned short     npld             = 0,
+              bool               track_ids        = false,
+              float              growth_factor    = 1.0f,
+              float              shrink_threshold = 0.0f);
 
     /**
      * @brief Constructor for the particle container
@@ -113,7 +124,10 @@ namespace ntt {
                   spec.pusher(),
                   spec.use_gca(),
                   spec.cooling(),
-                  spec.npld()) {}
+                  spec.npld(),
+                  spec.track_ids(),
+                  spec.growth_factor(),
+                  spec.shrink_threshold()) {}
 
     Particles(const Particles&)            = delete;
     Particles& operator=(const Particles&) = delete;
@@ -158,6 +172,14 @@ namespace ntt {
       return m_ntags;
     }
 
+    /**
+     * @brief Get the counter of the next ID to be assigned in this domain
+     */
+    [[nodiscard]]
+    auto next_id() const -> std::size_t {
+      return m_next_id;
+    }
+
     [[nodiscard]]
     auto memory_footprint() const -> std::size_t {
       std::size_t footprint  = 0;
@@ -171,17 +193,12 @@ namespace ntt {
       footprint             += sizeof(real_t) * ux2.extent(0);
       footprint             += sizeof(real_t) * ux3.extent(0);
       footprint             += sizeof(real_t) * weight.extent(0);
-      footprint             += sizeof(int) * i1_prev.extent(0);
-      footprint             += sizeof(int) * i2_prev.extent(0);
-      footprint             += sizeof(int) * i3_prev.extent(0);
-      footprint             += sizeof(prtldx_t) * dx1_prev.extent(0);
-      footprint             += sizeof(prtldx_t) * dx2_prev.extent(0);
-      footprint             += sizeof(prtldx_t) * dx3_prev.extent(0);
       footprint             += sizeof(short) * tag.extent(0);
       for (auto& p : pld) {
         footprint += sizeof(real_t) * p.extent(0);
       }
       footprint += sizeof(real_t) * phi.extent(0);
+      footprint += sizeof(std::size_t) * id.extent(0);
       return footprint;
     }
 
@@ -212,16 +229,144 @@ namespace ntt {
       m_is_sorted = false;
     }
 
+    /**
+     * @brief Set the counter of the next ID (e.g., when restarting)
+     */
+    void set_next_id(std::size_t n) {
+      m_next_id = n;
+    }
+
     /**
      * @brief Sort particles by their tags.
      * @return The vector of counts per each tag.
+     * @note Alive particles are compacted (holes are filled from the tail), so
+     * only the particles which changed their tag are moved; the rest are then
+     * bin-sorted by their tags.
      */
     auto SortByTags() -> std::vector<std::size_t>;
 
+    /**
+     * @brief Sort alive particles by their cell index (following the memory
+     * layout of the fields), placing the rest after them in the order of tags.
+     * @param ncells The number of active cells in each dimension.
+     * @return The vector of counts per each tag.
+     * @note Just like `SortByTags` removes the dead particles.
+     */
+    auto SortByCells(const std::vector<std::size_t>&) -> std::vector<std::size_t>;
+
+    /**
+     * @brief Group all but the dead particles (incl. the ones tagged to be
+     * sent) by the tiles of cells they occupy (without moving the particle
+     * data).
+     * @param ncells The number of active cells in each dimension.
+     * @param tile_size The number of cells per tile in each dimension.
+     * @return Pair of arrays: offsets of each tile (first ntiles + 1 entries),
+     * and the indices of particles grouped by tiles (first npart entries).
+     * @note Same particles as in the non-tiled deposit (which skips the dead).
+     * @note The arrays are persistent buffers of the container (overwritten
+     * by the next call).
+     * @note Tiles are enumerated with x1 being the fastest; particles outside
+     * the active region are assigned to the nearest tile.
+     */
+    auto TileIndex(const std::vector<std::size_t>&, unsigned short)
+      -> std::pair<array_t<std::size_t*>, array_t<std::size_t*>>;
+
+    /**
+     * @brief Assign unique IDs to the alive particles which do not have one.
+     * @param domain The index of the domain the particles are in.
+     * @note IDs are assigned lazily (e.g., before the output): the domain index
+     * goes to the upper bits, so no communication is needed. IDs of the dead
+     * particles are reset by the sorting routines.
+     */
+    void AssignIDs(unsigned int);
+
+    /**
+     * @brief Make sure the arrays can fit `n` particles, growing them
+     * geometrically (by `growth_factor`) if needed.
+     * @param n The number of particles to fit.
+     * @note All the allocated entries are preserved, new ones are zeroed.
+     * @note Does nothing if the growth is disabled (`growth_factor` <= 1): the
+     * callers still have to check the capacity.
+     */
+    void Reserve(std::size_t);
+
+    /**
+     * @brief Shrink the arrays if the occupancy dropped below the
+     * `shrink_threshold` (never below the initial capacity).
+     * @note Only the active particles are preserved, so the dead ones have
+     * to be removed first (e.g., with `SortByTags`).
+     */
+    void ShrinkToFit();
+
     /**
      * @brief Copy particle data from device to host.
      */
     void SyncHostDevice();
+
+  private:
+    /**
+     * @brief Reallocate all the arrays (and their host mirrors).
+     * @param maxnpart The new capacity.
+     * @param npreserve The number of leading entries to preserve.
+     */
+    void Reallocate(std::size_t, std::size_t);
+  };
+
+  /**
+   * @brief Coordinates of the particles before the push (used in the deposit)
+   * @tparam D The dimension of the simulation
+   * @note Each species is deposited right after its push, so one buffer is
+   * shared by all the species of a domain; it is never sorted, communicated
+   * or written to checkpoints.
+   */
+  template <Dimension D>
+  struct ParticlesPrev {
+    array_t<int*>      i1, i2, i3;
+    array_t<prtldx_t*> dx1, dx2, dx3;
+
+    // for empty allocation
+    ParticlesPrev() {}
+
+    /**
+     * @param maxnpart The number of particles to fit (max over the species)
+     */
+    ParticlesPrev(std::size_t maxnpart) {
+      reserve(maxnpart);
+    }
+
+    /**
+     * @brief Get the # of particles the buffer can fit
+     */
+    [[nodiscard]]
+    auto capacity() const -> std::size_t {
+      return i1.extent(0);
+    }
+
+    /**
+     * @brief Reallocate the buffer if it cannot fit `npart` particles
+     * @note The contents are not preserved
+     */
+    void reserve(std::size_t npart) {
+      if (npart <= capacity()) {
+        return;
+      }
+      i1  = array_t<int*> { "i1_prev", npart };
+      dx1 = array_t<prtldx_t*> { "dx1_prev", npart };
+      if constexpr ((D == Dim::_2D) || (D == Dim::_3D)) {
+        i2  = array_t<int*> { "i2_prev", npart };
+        dx2 = array_t<prtldx_t*> { "dx2_prev", npart };
+      }
+      if constexpr (D == Dim::_3D) {
+        i3  = array_t<int*> { "i3_prev", npart };
+        dx3 = array_t<prtldx_t*> { "dx3_prev", npart };
+      }
+    }
+
+    [[nodiscard]]
+    auto memory_footprint() const -> std::size_t {
+      return (sizeof(int) + sizeof(prtldx_t)) *
+             (i1.extent(0) + i2.extent(0) + i3.extent(0));
+    }
   };
 
 } // namespace ntt
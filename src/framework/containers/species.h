@@ -27,7 +27,7 @@ namespace ntt {
     const float          m_mass;
     // Species charge in units of q0
     const float          m_charge;
-    // Max number of allocated particles for the species
+    // Number of allocated particles for the species (grows if allowed)
     std::size_t          m_maxnpart;
 
     // Pusher assigned for the species
@@ -42,6 +42,15 @@ namespace ntt {
     // Number of payloads for the species
     const unsigned short m_npld;
 
+    // Assign persistent unique IDs to the particles of the species
+    const bool m_track_ids;
+
+    // Factor to grow the capacity by when it is exceeded (<= 1: fixed)
+    const float m_growth_factor;
+
+    // Occupancy below which the capacity is shrunk (0: never)
+    const float m_shrink_threshold;
+
   public:
     ParticleSpecies()
       : m_index { 0 }
@@ -52,7 +61,10 @@ namespace ntt {
       , m_pusher { PrtlPusher::INVALID }
       , m_use_gca { false }
       , m_cooling { Cooling::INVALID }
-      , m_npld { 0 } {}
+      , m_npld { 0 }
+      , m_track_ids { false }
+      , m_growth_factor { 1.0f }
+      , m_shrink_threshold { 0.0f } {}
 
     /**
      * @brief Constructor for the particle species container.
@@ -63,6 +75,12 @@ namespace ntt {
      * @param ch The charge of the species.
      * @param maxnpart The maximum number of allocated particles for the species.
      * @param pusher The pusher assigned for the species.
+     * @param use_gca Use hybrid GCA pusher for the species.
+     * @param cooling The cooling mechanism assigned for the species.
+     * @param npld The number of payloads for the species.
+     * @param track_ids Assign persistent unique IDs to the particles.
+     * @param growth_factor Factor to grow the capacity by when exceeded.
+     * @param shrink_threshold Occupancy below which the capacity is shrunk.
      */
     ParticleSpecies(unsigned short     index,
                     const std::string& label,
@@ -72,7 +90,10 @@ namespace ntt {
                     const PrtlPusher&  pusher,
                     bool               use_gca,
                     const Cooling&     cooling,
-                    unsigned short     npld = 0)
+                    unsigned short     npld             = 0,
+                    bool               track_ids        = false,
+                    float              growth_factor    = 1.0f,
+                    float              shrink_threshold = 0.0f)
       : m_index { index }
       , m_label { std::move(label) }
       , m_mass { m }
@@ -81,7 +102,10 @@ namespace ntt {
       , m_pusher { pusher }
       , m_use_gca { use_gca }
       , m_cooling { cooling }
-      , m_npld { npld } {}
+      , m_npld { npld }
+      , m_track_ids { track_ids }
+      , m_growth_factor { growth_factor }
+      , m_shrink_threshold { shrink_threshold } {}
 
     ParticleSpecies(const ParticleSpecies&) = default;
 
@@ -134,6 +158,21 @@ namespace ntt {
     auto npld() const -> unsigned short {
       return m_npld;
     }
+
+    [[nodiscard]]
+    auto track_ids() const -> bool {
+      return m_track_ids;
+    }
+
+    [[nodiscard]]
+    auto growth_factor() const -> float {
+      return m_growth_factor;
+    }
+
+    [[nodiscard]]
+    auto shrink_threshold() const -> float {
+      return m_shrink_threshold;
+    }
   };
 } // namespace ntt
 
@@ -0,0 +1,356 @@
+#include "enums.h"
+#include "global.h"
+
+#include "arch/kokkos_aliases.h"
+#include "utils/error.h"
+#include "utils/formatting.h"
+#include "utils/log.h"
+#include "utils/numeric.h"
+
+#include "metrics/kerr_schild.h"
+#include "metrics/kerr_schild_0.h"
+#include "metrics/minkowski.h"
+#include "metrics/qkerr_schild.h"
+#include "metrics/qspherical.h"
+#include "metrics/spherical.h"
+
+#include "framework/containers/particles.h"
+#include "framework/domain/domain.h"
+#include "framework/domain/metadomain.h"
+#include "framework/parameters.h"
+
+#include "output/checkpoint.h"
+
+#include <Kokkos_Core.hpp>
+#include <adios2.h>
+
+#if defined(MPI_ENABLED)
+  #include "arch/mpi_aliases.h"
+
+  #include <mpi.h>
+#endif // MPI_ENABLED
+
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ntt {
+
+  namespace {
+    /**
+     * @brief Calls func(name, array) for each of the raw particle arrays
+     */
+    template <Dimension D, Coord::type C, class F>
+    void ForEachParticleArray(Particles<D, C>& species, F&& func) {
+      const auto prefix = fmt::format("s%d_", species.index());
+      func(prefix + "i1", species.i1);
+      func(prefix + "dx1", species.dx1);
+      if constexpr (D == Dim::_2D or D == Dim::_3D) {
+        func(prefix + "i2", species.i2);
+        func(prefix + "dx2", species.dx2);
+      }
+      if constexpr (D == Dim::_3D) {
+        func(prefix + "i3", species.i3);
+        func(prefix + "dx3", species.dx3);
+      }
+      func(prefix + "ux1", species.ux1);
+      func(prefix + "ux2", species.ux2);
+      func(prefix + "ux3", species.ux3);
+      func(prefix + "weight", species.weight);
+      func(prefix + "tag", species.tag);
+      if constexpr (D == Dim::_2D and C != Coord::Cart) {
+        func(prefix + "phi", species.phi);
+      }
+      for (auto p { 0u }; p < species.npld(); ++p) {
+        func(prefix + fmt::format("pld%d", p + 1), species.pld[p]);
+      }
+      if (species.track_ids()) {
+        func(prefix + "id", species.id);
+      }
+    }
+  } // namespace
+
+  template <SimEngine::type S, class M>
+  void Metadomain<S, M>::InitCheckpointWriter(const SimulationParams& params) {
+    g_checkpoint_writer.init(
+      params.template get<std::size_t>("checkpoint.interval"),
+      params.template get<long double>("checkpoint.interval_time"),
+      params.template get<std::size_t>("checkpoint.keep"),
+      params.template get<std::string>("checkpoint.write_path"));
+    if (not g_checkpoint_writer.enabled()) {
+      return;
+    }
+    raise::ErrorIf(
+      local_subdomain_indices().size() != 1,
+      "Checkpoints for now are only supported for one subdomain per rank",
+      HERE);
+    auto local_domain = subdomain_ptr(local_subdomain_indices()[0]);
+    raise::ErrorIf(local_domain->is_placeholder(),
+                   "local_domain is a placeholder",
+                   HERE);
+
+    // fields are saved together with the ghost zones
+    auto glob_shape = mesh().n_active();
+    auto loc_corner = local_domain->offset_ncells();
+    auto loc_shape  = local_domain->mesh.n_active();
+    for (auto d { 0 }; d < M::Dim; ++d) {
+      glob_shape[d] += 2 * N_GHOSTS * ndomains_per_dim()[d];
+      loc_corner[d] += 2 * N_GHOSTS * local_domain->offset_ndomains()[d];
+      loc_shape[d]  += 2 * N_GHOSTS;
+    }
+    g_checkpoint_writer.defineFieldVariable("em", glob_shape, loc_corner, loc_shape, 6);
+    g_checkpoint_writer.defineFieldVariable("cur", glob_shape, loc_corner, loc_shape, 3);
+    if constexpr (S == SimEngine::GRPIC) {
+      g_checkpoint_writer.defineFieldVariable("em0",
+                                              glob_shape,
+                                              loc_corner,
+                                              loc_shape,
+                                              6);
+    }
+    // decomposition is stored since it may be changed by the load balancer
+    for (auto d { 0 }; d < M::Dim; ++d) {
+      g_checkpoint_writer.definePerDomainVariable(fmt::format("ncells_x%d", d + 1),
+                                                  ndomains(),
+                                                  local_domain->index());
+    }
+
+    for (auto& species : local_domain->species) {
+      g_checkpoint_writer.definePerDomainVariable(
+        fmt::format("s%d_npart", species.index()),
+        ndomains(),
+        local_domain->index());
+      if (species.track_ids()) {
+        g_checkpoint_writer.definePerDomainVariable(
+          fmt::format("s%d_nextid", species.index()),
+          ndomains(),
+          local_domain->index());
+      }
+      ForEachParticleArray(species, [&](const std::string& name, const auto& arr) {
+        using T = typename std::decay_t<decltype(arr)>::value_type;
+        g_checkpoint_writer.template defineParticleVariable<T>(name);
+      });
+    }
+  }
+
+  template <SimEngine::type S, class M>
+  auto Metadomain<S, M>::WriteCheckpoint(const SimulationParams&,
+                                         std::size_t step,
+                                         long double time) -> bool {
+    if (not g_checkpoint_writer.shouldSave(step, time)) {
+      return false;
+    }
+    auto local_domain = subdomain_ptr(local_subdomain_indices()[0]);
+    logger::Checkpoint("Writing checkpoint", HERE);
+    g_checkpoint_writer.beginSaving(step, time);
+    g_checkpoint_writer.saveField<M::Dim, 6>("em", local_domain->fields.em);
+    g_checkpoint_writer.saveField<M::Dim, 3>("cur", local_domain->fields.cur);
+    if constexpr (S == SimEngine::GRPIC) {
+      g_checkpoint_writer.saveField<M::Dim, 6>("em0", local_domain->fields.em0);
+    }
+    for (auto d { 0 }; d < M::Dim; ++d) {
+      g_checkpoint_writer.savePerDomainValue(fmt::format("ncells_x%d", d + 1),
+                                             local_domain->mesh.n_active()[d]);
+    }
+    for (auto& species : local_domain->species) {
+      const std::size_t npart    = species.npart();
+      std::size_t       offset   = 0;
+      std::size_t       glob_tot = npart;
+#if defined(MPI_ENABLED)
+      auto glob_npart = std::vector<std::size_t>(g_ndomains);
+      MPI_Allgather(&npart,
+                    1,
+                    mpi::get_type<std::size_t>(),
+                    glob_npart.data(),
+                    1,
+                    mpi::get_type<std::size_t>(),
+                    MPI_COMM_WORLD);
+      glob_tot = 0;
+      for (auto r = 0; r < g_mpi_size; ++r) {
+        if (r < g_mpi_rank) {
+          offset += glob_npart[r];
+        }
+        glob_tot += glob_npart[r];
+      }
+#endif // MPI_ENABLED
+      g_checkpoint_writer.savePerDomainValue(
+        fmt::format("s%d_npart", species.index()),
+        npart);
+      if (species.track_ids()) {
+        g_checkpoint_writer.savePerDomainValue(
+          fmt::format("s%d_nextid", species.index()),
+          species.next_id());
+      }
+      ForEachParticleArray(species, [&](const std::string& name, const auto& arr) {
+        g_checkpoint_writer.saveParticleQuantity(name, glob_tot, offset, npart, arr);
+      });
+    }
+    g_checkpoint_writer.endSaving();
+    // the state of the random pool cannot be dumped, so instead it is reset
+    // ... to a step-dependent seed both here and upon restart
+    local_domain->random_pool = random_number_pool_t { constant::RandomSeed + step };
+    return true;
+  }
+
+  template <SimEngine::type S, class M>
+  auto Metadomain<S, M>::ContinueFromCheckpoint(const SimulationParams& params)
+    -> std::pair<std::size_t, long double> {
+    raise::ErrorIf(
+      local_subdomain_indices().size() != 1,
+      "Checkpoints for now are only supported for one subdomain per rank",
+      HERE);
+    auto local_domain = subdomain_ptr(local_subdomain_indices()[0]);
+    raise::ErrorIf(local_domain->is_placeholder(),
+                   "local_domain is a placeholder",
+                   HERE);
+
+    const auto path = params.template get<std::string>("checkpoint.read_path");
+    std::size_t step = params.template get<std::size_t>("checkpoint.start_step");
+    if (step == 0) {
+      step = out::FindLatestCheckpoint(path);
+    }
+#if defined(MPI_ENABLED)
+    MPI_Bcast(&step, 1, mpi::get_type<std::size_t>(), MPI_ROOT_RANK, MPI_COMM_WORLD);
+#endif
+    const auto fname = out::CheckpointFilename(path, step);
+    logger::Checkpoint(fmt::format("Reading checkpoint %s", fname.c_str()), HERE);
+
+#if !defined(MPI_ENABLED)
+    adios2::ADIOS adios;
+#else
+    adios2::ADIOS adios { MPI_COMM_WORLD };
+#endif
+    adios2::IO     io = adios.DeclareIO("Entity::CheckpointReader");
+    adios2::Engine reader;
+    io.SetEngine("BPFile");
+    try {
+      reader = io.Open(fname, adios2::Mode::Read);
+    } catch (std::exception& e) {
+      raise::Fatal(e.what(), HERE);
+    }
+    reader.BeginStep();
+
+    std::size_t step_read { 0 };
+    long double time { 0.0 };
+    reader.Get(io.InquireVariable<std::size_t>("Step"), step_read, adios2::Mode::Sync);
+    reader.Get(io.InquireVariable<long double>("Time"), time, adios2::Mode::Sync);
+    raise::ErrorIf(step_read != step,
+                   "Checkpoint step does not match the filename",
+                   HERE);
+
+    // restore the decomposition (if it was changed by the load balancer)
+    if (io.InquireVariable<std::size_t>("ncells_x1")) {
+      auto d_ncells = g_domain_ncells;
+      for (auto d { 0 }; d < M::Dim; ++d) {
+        const auto name = fmt::format("ncells_x%d", d + 1);
+        auto       var  = io.InquireVariable<std::size_t>(name);
+        raise::ErrorIf(not var or (var.Shape()[0] != ndomains()),
+                       "Checkpoint was written with a different number of domains",
+                       HERE);
+        std::vector<std::size_t> glob_ncells(ndomains());
+        reader.Get(var, glob_ncells.data(), adios2::Mode::Sync);
+        // domains are ordered with x1 being the fastest
+        std::size_t stride { 1 };
+        for (auto e { 0 }; e < d; ++e) {
+          stride *= ndomains_per_dim()[e];
+        }
+        for (auto k { 0u }; k < ndomains_per_dim()[d]; ++k) {
+          d_ncells[d][k] = glob_ncells[k * stride];
+        }
+      }
+      if (d_ncells != g_domain_ncells) {
+        logger::Checkpoint("Restoring the domain decomposition", HERE);
+        redecompose(d_ncells);
+        updateOutputLayouts(params);
+        local_domain = subdomain_ptr(local_subdomain_indices()[0]);
+      }
+    }
+
+    auto glob_shape = mesh().n_active();
+    auto loc_corner = local_domain->offset_ncells();
+    auto loc_shape  = local_domain->mesh.n_active();
+    for (auto d { 0 }; d < M::Dim; ++d) {
+      glob_shape[d] += 2 * N_GHOSTS * ndomains_per_dim()[d];
+      loc_corner[d] += 2 * N_GHOSTS * local_domain->offset_ndomains()[d];
+      loc_shape[d]  += 2 * N_GHOSTS;
+    }
+    out::ReadField<M::Dim, 6>(io,
+                              reader,
+                              "em",
+                              glob_shape,
+                              loc_corner,
+                              loc_shape,
+                              local_domain->fields.em);
+    out::ReadField<M::Dim, 3>(io,
+                              reader,
+                              "cur",
+                              glob_shape,
+                              loc_corner,
+                              loc_shape,
+                              local_domain->fields.cur);
+    if constexpr (S == SimEngine::GRPIC) {
+      out::ReadField<M::Dim, 6>(io,
+                                reader,
+                                "em0",
+                                glob_shape,
+                                loc_corner,
+                                loc_shape,
+                                local_domain->fields.em0);
+    }
+
+    for (auto& species : local_domain->species) {
+      const auto npart_name = fmt::format("s%d_npart", species.index());
+      auto       npart_var  = io.InquireVariable<std::size_t>(npart_name);
+      raise::ErrorIf(not npart_var,
+                     fmt::format("%s not found in the checkpoint", npart_name.c_str()),
+                     HERE);
+      raise::ErrorIf(npart_var.Shape()[0] != ndomains(),
+                     "Checkpoint was written with a different number of domains",
+                     HERE);
+      std::vector<std::size_t> glob_npart(ndomains());
+      reader.Get(npart_var, glob_npart.data(), adios2::Mode::Sync);
+      std::size_t offset = 0;
+      for (auto d { 0u }; d < local_domain->index(); ++d) {
+        offset += glob_npart[d];
+      }
+      const auto npart = glob_npart[local_domain->index()];
+      species.Reserve(npart);
+      raise::ErrorIf(npart > species.maxnpart(),
+                     fmt::format("npart from the checkpoint exceeds maxnpart "
+                                 "for species %d",
+                                 species.index()),
+                     HERE);
+      ForEachParticleArray(species, [&](const std::string& name, auto& arr) {
+        out::ReadParticleQuantity(io, reader, name, offset, npart, arr);
+      });
+      if (species.track_ids()) {
+        const auto nextid_name = fmt::format("s%d_nextid", species.index());
+        auto       nextid_var  = io.InquireVariable<std::size_t>(nextid_name);
+        raise::ErrorIf(not nextid_var,
+                       fmt::format("%s not found in the checkpoint",
+                                   nextid_name.c_str()),
+                       HERE);
+        std::vector<std::size_t> glob_nextid(ndomains());
+        reader.Get(nextid_var, glob_nextid.data(), adios2::Mode::Sync);
+        species.set_next_id(glob_nextid[local_domain->index()]);
+      }
+      species.set_npart(npart);
+      species.set_unsorted();
+    }
+    reader.EndStep();
+    reader.Close();
+
+    local_domain->random_pool = random_number_pool_t { constant::RandomSeed + step };
+    return { step, time };
+  }
+
+  template struct Metadomain<SimEngine::SRPIC, metric::Minkowski<Dim::_1D>>;
+  template struct Metadomain<SimEngine::SRPIC, metric::Minkowski<Dim::_2D>>;
+  template struct Metadomain<SimEngine::SRPIC, metric::Minkowski<Dim::_3D>>;
+  template struct Metadomain<SimEngine::SRPIC, metric::Spherical<Dim::_2D>>;
+  template struct Metadomain<SimEngine::SRPIC, metric::QSpherical<Dim::_2D>>;
+  template struct Metadomain<SimEngine::GRPIC, metric::KerrSchild<Dim::_2D>>;
+  template struct Metadomain<SimEngine::GRPIC, metric::QKerrSchild<Dim::_2D>>;
+  template struct Metadomain<SimEngine::GRPIC, metric::KerrSchild0<Dim::_2D>>;
+
+} // namespace ntt
@@ -0,0 +1,180 @@
+/**
+ * @file framework/domain/comm_local.hpp
+ * @brief Communication routines between the domains of the same rank
+ * @implements
+ *   - comm::CopyField<> -> void
+ *   - comm::ForEachCommunicatedArray<> -> void
+ *   - comm::CopyParticles<> -> void
+ * @namespaces:
+ *   - comm::
+ * @note Used both with and without MPI
+ */
+
+#ifndef FRAMEWORK_DOMAIN_COMM_LOCAL_HPP
+#define FRAMEWORK_DOMAIN_COMM_LOCAL_HPP
+
+#include "enums.h"
+#include "global.h"
+
+#include "arch/kokkos_aliases.h"
+#include "utils/error.h"
+
+#include "framework/containers/particles.h"
+
+#include <Kokkos_Core.hpp>
+
+#include <vector>
+
+namespace comm {
+  using namespace ntt;
+
+  /**
+   * @brief Copies (or adds) a slice of one field to a slice of another
+   * @note: `fld` and `fld_buff` may be the same (e.g., for periodic boundaries)
+   * @note: Both slices have to be of the same shape
+   */
+  template <Dimension D, int N>
+  inline void CopyField(const ndfield_t<D, N>&            fld,
+                        ndfield_t<D, N>&                  fld_buff,
+                        const std::vector<range_tuple_t>& send_slice,
+                        const std::vector<range_tuple_t>& recv_slice,
+                        const range_tuple_t&              comps,
+                        bool                              additive) {
+    if (not additive) {
+      // simply filling the ghost cells
+      if constexpr (D == Dim::_1D) {
+        Kokkos::deep_copy(Kokkos::subview(fld_buff, recv_slice[0], comps),
+                          Kokkos::subview(fld, send_slice[0], comps));
+      } else if constexpr (D == Dim::_2D) {
+        Kokkos::deep_copy(
+          Kokkos::subview(fld_buff, recv_slice[0], recv_slice[1], comps),
+          Kokkos::subview(fld, send_slice[0], send_slice[1], comps));
+      } else if constexpr (D == Dim::_3D) {
+        Kokkos::deep_copy(
+          Kokkos::subview(fld_buff, recv_slice[0], recv_slice[1], recv_slice[2], comps),
+          Kokkos::subview(fld, send_slice[0], send_slice[1], send_slice[2], comps));
+      }
+    } else {
+      // adding received fields to ghosts + active
+      if constexpr (D == Dim::_1D) {
+        const auto offset_x1 = (long int)(recv_slice[0].first) -
+                               (long int)(send_slice[0].first);
+        Kokkos::parallel_for(
+          "CommunicateField-extract",
+          Kokkos::MDRangePolicy<Kokkos::Rank<2>, AccelExeSpace>(
+            { recv_slice[0].first, comps.first },
+            { recv_slice[0].second, comps.second }),
+          Lambda(index_t i1, index_t ci) {
+            fld_buff(i1, ci) += fld(i1 - offset_x1, ci);
+          });
+      } else if constexpr (D == Dim::_2D) {
+        const auto offset_x1 = (long int)(recv_slice[0].first) -
+                               (long int)(send_slice[0].first);
+        const auto offset_x2 = (long int)(recv_slice[1].first) -
+                               (long int)(send_slice[1].first);
+        Kokkos::parallel_for(
+          "CommunicateField-extract",
+          Kokkos::MDRangePolicy<Kokkos::Rank<3>, AccelExeSpace>(
+            { recv_slice[0].first, recv_slice[1].first, comps.first },
+            { recv_slice[0].second, recv_slice[1].second, comps.second }),
+          Lambda(index_t i1, index_t i2, index_t ci) {
+            fld_buff(i1, i2, ci) += fld(i1 - offset_x1, i2 - offset_x2, ci);
+          });
+      } else if constexpr (D == Dim::_3D) {
+        const auto offset_x1 = (long int)(recv_slice[0].first) -
+                               (long int)(send_slice[0].first);
+        const auto offset_x2 = (long int)(recv_slice[1].first) -
+                               (long int)(send_slice[1].first);
+        const auto offset_x3 = (long int)(recv_slice[2].first) -
+                               (long int)(send_slice[2].first);
+        Kokkos::parallel_for(
+          "CommunicateField-extract",
+          Kokkos::MDRangePolicy<Kokkos::Rank<4>, AccelExeSpace>(
+            { recv_slice[0].first,
+              recv_slice[1].first,
+              recv_slice[2].first,
+              comps.first },
+            { recv_slice[0].second,
+              recv_slice[1].second,
+              recv_slice[2].second,
+              comps.second }),
+          Lambda(index_t i1, index_t i2, index_t i3, index_t ci) {
+            fld_buff(i1, i2, i3, ci) += fld(i1 - offset_x1,
+                                            i2 - offset_x2,
+                                            i3 - offset_x3,
+                                            ci);
+          });
+      }
+    }
+  }
+
+  /**
+   * @brief Calls func(array, others...) for each of the particle arrays to
+   * communicate, where `others` are the same arrays of the other containers
+   * @note The arrays are ordered by the decreasing size of their elements, so
+   * that each segment of the packed buffer is properly aligned
+   */
+  template <Dimension D, Coord::type C, class F, class... P>
+  void ForEachCommunicatedArray(F&& func, Particles<D, C>& species, P&... others) {
+    if (species.track_ids()) {
+      func(species.id, others.id...);
+    }
+    func(species.ux1, others.ux1...);
+    func(species.ux2, others.ux2...);
+    func(species.ux3, others.ux3...);
+    func(species.weight, others.weight...);
+    if constexpr (D == Dim::_2D and C != Coord::Cart) {
+      func(species.phi, others.phi...);
+    }
+    for (auto p { 0 }; p < species.npld(); ++p) {
+      func(species.pld[p], others.pld[p]...);
+    }
+    func(species.i1, others.i1...);
+    if constexpr (D == Dim::_2D || D == Dim::_3D) {
+      func(species.i2, others.i2...);
+    }
+    if constexpr (D == Dim::_3D) {
+      func(species.i3, others.i3...);
+    }
+    // prtldx_t is at most as large as int (see COMPACT_PRTL)
+    func(species.dx1, others.dx1...);
+    if constexpr (D == Dim::_2D || D == Dim::_3D) {
+      func(species.dx2, others.dx2...);
+    }
+    if constexpr (D == Dim::_3D) {
+      func(species.dx3, others.dx3...);
+    }
+  }
+
+  /**
+   * @brief Copies the particles from the slice of one container to another
+   * @param from container to copy from
+   * @param slice slice of particles to copy
+   * @param to container to copy to
+   * @param index_first index where the first copied particle is placed
+   * @note Tags are not copied
+   * @note The receiving container is grown if needed (and allowed)
+   */
+  template <Dimension D, Coord::type C>
+  void CopyParticles(Particles<D, C>&     from,
+                     const range_tuple_t& slice,
+                     Particles<D, C>&     to,
+                     std::size_t          index_first) {
+    const std::size_t count = slice.second - slice.first;
+    to.Reserve(index_first + count);
+    raise::FatalIf((index_first + count) > to.maxnpart(),
+                   "Too many particles to receive (cannot fit into maxptl)",
+                   HERE);
+    ForEachCommunicatedArray(
+      [&](auto& arr_from, auto& arr_to) {
+        Kokkos::deep_copy(
+          Kokkos::subview(arr_to, range_tuple_t { index_first, index_first + count }),
+          Kokkos::subview(arr_from, slice));
+      },
+      from,
+      to);
+  }
+
+} // namespace comm
+
+#endif // FRAMEWORK_DOMAIN_COMM_LOCAL_HPP
@@ -2,7 +2,16 @@
  * @file framework/domain/comm_mpi.hpp
  * @brief MPI communication routines
  * @implements
- *   - comm::CommunicateField<> -> void
+ *   - comm::FieldExchange
+ *   - comm::PostField<> -> void
+ *   - comm::PostLocalField<> -> void
+ *   - comm::WaitFields -> void
+ *   - comm::PackedParticleSize<> -> std::size_t
+ *   - comm::ReserveBuffer -> void
+ *   - comm::PackParticles<> -> void
+ *   - comm::UnpackParticles<> -> void
+ *   - comm::ParticleTransfer<>
+ *   - comm::CommunicateParticles<> -> std::vector<std::vector<std::size_t>>
  * @namespaces:
  *   - comm::
  * @note This should only be included if the MPI_ENABLED flag is set
@@ -19,426 +28,508 @@
 #include "utils/error.h"
 
 #include "framework/containers/particles.h"
+#include "framework/domain/comm_local.hpp"
 
 #include <Kokkos_Core.hpp>
 #include <mpi.h>
 
+#include <functional>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace comm {
   using namespace ntt;
 
+  /**
+   * @brief State of the non-blocking exchange of fields
+   * @note Buffers persist between the exchanges, and are only reallocated
+   * when they become too small
+   */
+  struct FieldExchange {
+    // one buffer per message tag
+    std::vector<array_t<real_t*>>      send_buffers, recv_buffers;
+    std::vector<MPI_Request>           requests;
+    // tasks to perform once all the messages have arrived
+    std::vector<std::function<void()>> on_arrival;
+
+    [[nodiscard]]
+    auto pending() const -> bool {
+      return not(requests.empty() and on_arrival.empty());
+    }
+  };
+
+  template <Dimension D>
+  using field_buffer_t =
+    Kokkos::View<typename ndarray_t<static_cast<unsigned short>(D) + 1>::data_type,
+                 AccelMemSpace,
+                 Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+
+  /**
+   * @brief Shapes a part of a persistent buffer as a (D + 1)-dim array
+   * @note Buffer is reallocated if it is too small
+   */
+  template <Dimension D>
+  inline auto FieldBuffer(array_t<real_t*>&                 buffer,
+                          const std::vector<range_tuple_t>& slice,
+                          const range_tuple_t&              comps,
+                          const std::string&                label)
+    -> field_buffer_t<D> {
+    std::size_t nelems { comps.second - comps.first };
+    for (short d { 0 }; d < (short)D; ++d) {
+      nelems *= (slice[d].second - slice[d].first);
+    }
+    if (buffer.extent(0) < nelems) {
+      buffer = array_t<real_t*> {
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, label),
+        nelems
+      };
+    }
+    if constexpr (D == Dim::_1D) {
+      return field_buffer_t<D> { buffer.data(),
+                                 slice[0].second - slice[0].first,
+                                 comps.second - comps.first };
+    } else if constexpr (D == Dim::_2D) {
+      return field_buffer_t<D> { buffer.data(),
+                                 slice[0].second - slice[0].first,
+                                 slice[1].second - slice[1].first,
+                                 comps.second - comps.first };
+    } else if constexpr (D == Dim::_3D) {
+      return field_buffer_t<D> { buffer.data(),
+                                 slice[0].second - slice[0].first,
+                                 slice[1].second - slice[1].first,
+                                 slice[2].second - slice[2].first,
+                                 comps.second - comps.first };
+    }
+  }
+
+  /**
+   * @brief Copies (or adds) the received buffer to the field
+   */
+  template <Dimension D, int N>
+  inline void UnpackField(const field_buffer_t<D>&          recv_fld,
+                          ndfield_t<D, N>&                  fld_buff,
+                          const std::vector<range_tuple_t>& recv_slice,
+                          const range_tuple_t&              comps,
+                          bool                              additive) {
+    if (not additive) {
+      if constexpr (D == Dim::_1D) {
+        Kokkos::deep_copy(Kokkos::subview(fld_buff, recv_slice[0], comps),
+                          recv_fld);
+      } else if constexpr (D == Dim::_2D) {
+        Kokkos::deep_copy(
+          Kokkos::subview(fld_buff, recv_slice[0], recv_slice[1], comps),
+          recv_fld);
+      } else if constexpr (D == Dim::_3D) {
+        Kokkos::deep_copy(
+          Kokkos::subview(fld_buff, recv_slice[0], recv_slice[1], recv_slice[2], comps),
+          recv_fld);
+      }
+    } else {
+      if constexpr (D == Dim::_1D) {
+        const auto offset_x1 = recv_slice[0].first;
+        const auto offset_c  = comps.first;
+        Kokkos::parallel_for(
+          "CommunicateField-extract",
+          Kokkos::MDRangePolicy<Kokkos::Rank<2>, AccelExeSpace>(
+            { recv_slice[0].first, comps.first },
+            { recv_slice[0].second, comps.second }),
+          Lambda(index_t i1, index_t ci) {
+            fld_buff(i1, ci) += recv_fld(i1 - offset_x1, ci - offset_c);
+          });
+      } else if constexpr (D == Dim::_2D) {
+        const auto offset_x1 = recv_slice[0].first;
+        const auto offset_x2 = recv_slice[1].first;
+        const auto offset_c  = comps.first;
+        Kokkos::parallel_for(
+          "CommunicateField-extract",
+          Kokkos::MDRangePolicy<Kokkos::Rank<3>, AccelExeSpace>(
+            { recv_slice[0].first, recv_slice[1].first, comps.first },
+            { recv_slice[0].second, recv_slice[1].second, comps.second }),
+          Lambda(index_t i1, index_t i2, index_t ci) {
+            fld_buff(i1, i2, ci) += recv_fld(i1 - offset_x1,
+                                             i2 - offset_x2,
+                                             ci - offset_c);
+          });
+      } else if constexpr (D == Dim::_3D) {
+        const auto offset_x1 = recv_slice[0].first;
+        const auto offset_x2 = recv_slice[1].first;
+        const auto offset_x3 = recv_slice[2].first;
+        const auto offset_c  = comps.first;
+        Kokkos::parallel_for(
+          "CommunicateField-extract",
+          Kokkos::MDRangePolicy<Kokkos::Rank<4>, AccelExeSpace>(
+            { recv_slice[0].first,
+              recv_slice[1].first,
+              recv_slice[2].first,
+              comps.first },
+            { recv_slice[0].second,
+              recv_slice[1].second,
+              recv_slice[2].second,
+              comps.second }),
+          Lambda(index_t i1, index_t i2, index_t i3, index_t ci) {
+            fld_buff(i1, i2, i3, ci) += recv_fld(i1 - offset_x1,
+                                                 i2 - offset_x2,
+                                                 i3 - offset_x3,
+                                                 ci - offset_c);
+          });
+      }
+    }
+  }
+
+  /**
+   * @brief Posts the non-blocking send/recv of a field in a single direction
+   * @note: Send `fld`, recv to `fld_buff` (upon `WaitFields`)
+   * @note: `fld` and `fld_buff` may be the same
+   * @note: `recv_tag` has to be unique for all the messages received by the
+   * rank within the exchange, and `send_tag` is the `recv_tag` used by the
+   * receiving domain
+   */
   template <Dimension D, int N>
-  inline void CommunicateField(unsigned int                      idx,
-                               ndfield_t<D, N>&                  fld,
-                               ndfield_t<D, N>&                  fld_buff,
-                               unsigned int                      send_idx,
-                               unsigned int                      recv_idx,
-                               int                               send_rank,
-                               int                               recv_rank,
-                               const std::vector<range_tuple_t>& send_slice,
-                               const std::vector<range_tuple_t>& recv_slice,
-                               const range_tuple_t&              comps,
-                               bool                              additive) {
+  inline void PostField(FieldExchange&                    xchg,
+                        unsigned int                      idx,
+                        ndfield_t<D, N>&                  fld,
+                        ndfield_t<D, N>&                  fld_buff,
+                        unsigned int                      send_idx,
+                        unsigned int                      recv_idx,
+                        int                               send_rank,
+                        int                               recv_rank,
+                        const std::vector<range_tuple_t>& send_slice,
+                        const std::vector<range_tuple_t>& recv_slice,
+                        const range_tuple_t&              comps,
+                        bool                              additive,
+                        int                               send_tag,
+                        int                               recv_tag) {
     raise::ErrorIf(send_rank < 0 && recv_rank < 0,
-                   "CommunicateField called with negative ranks",
+                   "PostField called with negative ranks",
                    HERE);
 
     int rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 
-    raise::ErrorIf(
-      (send_rank == rank && send_idx != idx) ||
-        (recv_rank == rank && recv_idx != idx),
-      "Multiple-domain single-rank communication not yet implemented",
-      HERE);
+    raise::ErrorIf((send_rank == rank && send_idx != idx) ||
+                     (recv_rank == rank && recv_idx != idx),
+                   "Exchanges between the domains of the same rank have to "
+                   "be posted with PostLocalField",
+                   HERE);
 
     if ((send_idx == idx) and (recv_idx == idx)) {
       //  trivial copy if sending to self and receiving from self
-      if (not additive) {
-        // simply filling the ghost cells
-        if constexpr (D == Dim::_1D) {
-          Kokkos::deep_copy(Kokkos::subview(fld, recv_slice[0], comps),
-                            Kokkos::subview(fld, send_slice[0], comps));
-        } else if constexpr (D == Dim::_2D) {
-          Kokkos::deep_copy(
-            Kokkos::subview(fld, recv_slice[0], recv_slice[1], comps),
-            Kokkos::subview(fld, send_slice[0], send_slice[1], comps));
-        } else if constexpr (D == Dim::_3D) {
-          Kokkos::deep_copy(
-            Kokkos::subview(fld, recv_slice[0], recv_slice[1], recv_slice[2], comps),
-            Kokkos::subview(fld, send_slice[0], send_slice[1], send_slice[2], comps));
-        }
-      } else {
-        // adding received fields to ghosts + active
-        if constexpr (D == Dim::_1D) {
-          const auto offset_x1 = (long int)(recv_slice[0].first) -
-                                 (long int)(send_slice[0].first);
-          Kokkos::parallel_for(
-            "CommunicateField-extract",
-            Kokkos::MDRangePolicy<Kokkos::Rank<2>, AccelExeSpace>(
-              { recv_slice[0].first, comps.first },
-              { recv_slice[0].second, comps.second }),
-            Lambda(index_t i1, index_t ci) {
-              fld_buff(i1, ci) += fld(i1 - offset_x1, ci);
-            });
-        } else if constexpr (D == Dim::_2D) {
-          const auto offset_x1 = (long int)(recv_slice[0].first) -
-                                 (long int)(send_slice[0].first);
-          const auto offset_x2 = (long int)(recv_slice[1].first) -
-                                 (long int)(send_slice[1].first);
-          Kokkos::parallel_for(
-            "CommunicateField-extract",
-            Kokkos::MDRangePolicy<Kokkos::Rank<3>, AccelExeSpace>(
-              { recv_slice[0].first, recv_slice[1].first, comps.first },
-              { recv_slice[0].second, recv_slice[1].second, comps.second }),
-            Lambda(index_t i1, index_t i2, index_t ci) {
-              fld_buff(i1, i2, ci) += fld(i1 - offset_x1, i2 - offset_x2, ci);
-            });
-        } else if constexpr (D == Dim::_3D) {
-          const auto offset_x1 = (long int)(recv_slice[0].first) -
-                                 (long int)(send_slice[0].first);
-          const auto offset_x2 = (long int)(recv_slice[1].first) -
-                                 (long int)(send_slice[1].first);
-          const auto offset_x3 = (long int)(recv_slice[2].first) -
-                                 (long int)(send_slice[2].first);
-          Kokkos::parallel_for(
-            "CommunicateField-extract",
-            Kokkos::MDRangePolicy<Kokkos::Rank<4>, AccelExeSpace>(
-              { recv_slice[0].first,
-                recv_slice[1].first,
-                recv_slice[2].first,
-                comps.first },
-              { recv_slice[0].second,
-                recv_slice[1].second,
-                recv_slice[2].second,
-                comps.second }),
-            Lambda(index_t i1, index_t i2, index_t i3, index_t ci) {
-              fld_buff(i1, i2, i3, ci) += fld(i1 - offset_x1,
-                                              i2 - offset_x2,
-                                              i3 - offset_x3,
-                                              ci);
-            });
-        }
-      }
-    } else {
-      std::size_t nsend { comps.second - comps.first },
-        nrecv { comps.second - comps.first };
-      ndarray_t<static_cast<unsigned short>(D) + 1> send_fld, recv_fld;
-
-      for (short d { 0 }; d < (short)D; ++d) {
-        if (send_rank >= 0) {
-          nsend *= (send_slice[d].second - send_slice[d].first);
-        }
-        if (recv_rank >= 0) {
-          nrecv *= (recv_slice[d].second - recv_slice[d].first);
-        }
-      }
-      if (send_rank >= 0) {
-        if constexpr (D == Dim::_1D) {
-          send_fld = ndarray_t<2>("send_fld",
-                                  send_slice[0].second - send_slice[0].first,
-                                  comps.second - comps.first);
-          Kokkos::deep_copy(send_fld, Kokkos::subview(fld, send_slice[0], comps));
-        } else if constexpr (D == Dim::_2D) {
-          send_fld = ndarray_t<3>("send_fld",
-                                  send_slice[0].second - send_slice[0].first,
-                                  send_slice[1].second - send_slice[1].first,
-                                  comps.second - comps.first);
-          Kokkos::deep_copy(
-            send_fld,
-            Kokkos::subview(fld, send_slice[0], send_slice[1], comps));
-        } else if constexpr (D == Dim::_3D) {
-          send_fld = ndarray_t<4>("send_fld",
-                                  send_slice[0].second - send_slice[0].first,
-                                  send_slice[1].second - send_slice[1].first,
-                                  send_slice[2].second - send_slice[2].first,
-                                  comps.second - comps.first);
-          Kokkos::deep_copy(
-            send_fld,
-            Kokkos::subview(fld, send_slice[0], send_slice[1], send_slice[2], comps));
-        }
-      }
-      if (recv_rank >= 0) {
-        if constexpr (D == Dim::_1D) {
-          recv_fld = ndarray_t<2>("recv_fld",
-                                  recv_slice[0].second - recv_slice[0].first,
-                                  comps.second - comps.first);
-        } else if constexpr (D == Dim::_2D) {
-          recv_fld = ndarray_t<3>("recv_fld",
-                                  recv_slice[0].second - recv_slice[0].first,
-                                  recv_slice[1].second - recv_slice[1].first,
-                                  comps.second - comps.first);
-        } else if constexpr (D == Dim::_3D) {
-          recv_fld = ndarray_t<4>("recv_fld",
-                                  recv_slice[0].second - recv_slice[0].first,
-                                  recv_slice[1].second - recv_slice[1].first,
-                                  recv_slice[2].second - recv_slice[2].first,
-                                  comps.second - comps.first);
-        }
-      }
-      if (send_rank >= 0 && recv_rank >= 0) {
-        MPI_Sendrecv(send_fld.data(),
-                     nsend,
-                     mpi::get_type<real_t>(),
-                     send_rank,
-                     0,
-                     recv_fld.data(),
-                     nrecv,
-                     mpi::get_type<real_t>(),
-                     recv_rank,
-                     0,
-                     MPI_COMM_WORLD,
-                     MPI_STATUS_IGNORE);
-      } else if (send_rank >= 0) {
-        MPI_Send(send_fld.data(),
-                 nsend,
-                 mpi::get_type<real_t>(),
-                 send_rank,
-                 0,
-                 MPI_COMM_WORLD);
-      } else if (recv_rank >= 0) {
-        MPI_Recv(recv_fld.data(),
-                 nrecv,
-                 mpi::get_type<real_t>(),
-                 recv_rank,
-                 0,
-                 MPI_COMM_WORLD,
-                 MPI_STATUS_IGNORE);
-      } else {
-        raise::Error("CommunicateField called with negative ranks", HERE);
-      }
-      if (recv_rank >= 0) {
-        // !TODO: perhaps directly recv to the fld?
-        if (not additive) {
-          if constexpr (D == Dim::_1D) {
-            Kokkos::deep_copy(Kokkos::subview(fld, recv_slice[0], comps), recv_fld);
-          } else if constexpr (D == Dim::_2D) {
-            Kokkos::deep_copy(
-              Kokkos::subview(fld, recv_slice[0], recv_slice[1], comps),
-              recv_fld);
-          } else if constexpr (D == Dim::_3D) {
-            Kokkos::deep_copy(
-              Kokkos::subview(fld, recv_slice[0], recv_slice[1], recv_slice[2], comps),
-              recv_fld);
-          }
-        } else {
-          if constexpr (D == Dim::_1D) {
-            const auto offset_x1 = recv_slice[0].first;
-            const auto offset_c  = comps.first;
-            Kokkos::parallel_for(
-              "CommunicateField-extract",
-              Kokkos::MDRangePolicy<Kokkos::Rank<2>, AccelExeSpace>(
-                { recv_slice[0].first, comps.first },
-                { recv_slice[0].second, comps.second }),
-              Lambda(index_t i1, index_t ci) {
-                fld_buff(i1, ci) += recv_fld(i1 - offset_x1, ci - offset_c);
-              });
-          } else if constexpr (D == Dim::_2D) {
-            const auto offset_x1 = recv_slice[0].first;
-            const auto offset_x2 = recv_slice[1].first;
-            const auto offset_c  = comps.first;
-            Kokkos::parallel_for(
-              "CommunicateField-extract",
-              Kokkos::MDRangePolicy<Kokkos::Rank<3>, AccelExeSpace>(
-                { recv_slice[0].first, recv_slice[1].first, comps.first },
-                { recv_slice[0].second, recv_slice[1].second, comps.second }),
-              Lambda(index_t i1, index_t i2, index_t ci) {
-                fld_buff(i1, i2, ci) += recv_fld(i1 - offset_x1,
-                                                 i2 - offset_x2,
-                                                 ci - offset_c);
-              });
-          } else if constexpr (D == Dim::_3D) {
-            const auto offset_x1 = recv_slice[0].first;
-            const auto offset_x2 = recv_slice[1].first;
-            const auto offset_x3 = recv_slice[2].first;
-            const auto offset_c  = comps.first;
-            Kokkos::parallel_for(
-              "CommunicateField-extract",
-              Kokkos::MDRangePolicy<Kokkos::Rank<4>, AccelExeSpace>(
-                { recv_slice[0].first,
-                  recv_slice[1].first,
-                  recv_slice[2].first,
-                  comps.first },
-                { recv_slice[0].second,
-                  recv_slice[1].second,
-                  recv_slice[2].second,
-                  comps.second }),
-              Lambda(index_t i1, index_t i2, index_t i3, index_t ci) {
-                fld_buff(i1, i2, i3, ci) += recv_fld(i1 - offset_x1,
-                                                     i2 - offset_x2,
-                                                     i3 - offset_x3,
-                                                     ci - offset_c);
-              });
-          }
-        }
+      CopyField<D, N>(fld, fld_buff, send_slice, recv_slice, comps, additive);
+      return;
+    }
+    // buffers are indexed by the tag of the receiving message, which is
+    // ... unique within the rank
+    const auto tag = recv_tag;
+    if (xchg.send_buffers.size() <= (std::size_t)tag) {
+      xchg.send_buffers.resize(tag + 1);
+      xchg.recv_buffers.resize(tag + 1);
+    }
+    if (recv_rank >= 0) {
+      const auto recv_fld = FieldBuffer<D>(xchg.recv_buffers[tag],
+                                           recv_slice,
+                                           comps,
+                                           "recv_fld");
+      xchg.requests.emplace_back();
+      MPI_Irecv(recv_fld.data(),
+                recv_fld.size(),
+                mpi::get_type<real_t>(),
+                recv_rank,
+                tag,
+                MPI_COMM_WORLD,
+                &xchg.requests.back());
+      xchg.on_arrival.emplace_back([=]() mutable {
+        UnpackField<D, N>(recv_fld, fld_buff, recv_slice, comps, additive);
+      });
+    }
+    if (send_rank >= 0) {
+      const auto send_fld = FieldBuffer<D>(xchg.send_buffers[tag],
+                                           send_slice,
+                                           comps,
+                                           "send_fld");
+      if constexpr (D == Dim::_1D) {
+        Kokkos::deep_copy(send_fld, Kokkos::subview(fld, send_slice[0], comps));
+      } else if constexpr (D == Dim::_2D) {
+        Kokkos::deep_copy(send_fld,
+                          Kokkos::subview(fld, send_slice[0], send_slice[1], comps));
+      } else if constexpr (D == Dim::_3D) {
+        Kokkos::deep_copy(
+          send_fld,
+          Kokkos::subview(fld, send_slice[0], send_slice[1], send_slice[2], comps));
       }
+      xchg.requests.emplace_back();
+      MPI_Isend(send_fld.data(),
+                send_fld.size(),
+                mpi::get_type<real_t>(),
+                send_rank,
+                send_tag,
+                MPI_COMM_WORLD,
+                &xchg.requests.back());
     }
   }
 
-  template <typename T>
-  void CommunicateParticleQuantity(array_t<T*>&         arr,
-                                   int                  send_rank,
-                                   int                  recv_rank,
-                                   const range_tuple_t& send_slice,
-                                   const range_tuple_t& recv_slice) {
-    const std::size_t send_count = send_slice.second - send_slice.first;
-    const std::size_t recv_count = recv_slice.second - recv_slice.first;
-    if ((send_rank >= 0) and (recv_rank >= 0) and (send_count > 0) and
-        (recv_count > 0)) {
-      MPI_Sendrecv(arr.data() + send_slice.first,
-                   send_count,
-                   mpi::get_type<T>(),
-                   send_rank,
-                   0,
-                   arr.data() + recv_slice.first,
-                   recv_count,
-                   mpi::get_type<T>(),
-                   recv_rank,
-                   0,
-                   MPI_COMM_WORLD,
-                   MPI_STATUS_IGNORE);
-    } else if ((send_rank >= 0) and (send_count > 0)) {
-      MPI_Send(arr.data() + send_slice.first,
-               send_count,
-               mpi::get_type<T>(),
-               send_rank,
-               0,
-               MPI_COMM_WORLD);
-    } else if ((recv_rank >= 0) and (recv_count > 0)) {
-      MPI_Recv(arr.data() + recv_slice.first,
-               recv_count,
-               mpi::get_type<T>(),
-               recv_rank,
-               0,
-               MPI_COMM_WORLD,
-               MPI_STATUS_IGNORE);
+  /**
+   * @brief Schedules the direct copy of a field from another domain of the
+   * same rank (performed upon `WaitFields`)
+   * @note: Copy `nghbr_fld[send_slice]` to `fld_buff[recv_slice]`
+   */
+  template <Dimension D, int N>
+  inline void PostLocalField(FieldExchange&                    xchg,
+                             const ndfield_t<D, N>&            nghbr_fld,
+                             ndfield_t<D, N>&                  fld_buff,
+                             const std::vector<range_tuple_t>& send_slice,
+                             const std::vector<range_tuple_t>& recv_slice,
+                             const range_tuple_t&              comps,
+                             bool                              additive) {
+    xchg.on_arrival.emplace_back([=]() mutable {
+      CopyField<D, N>(nghbr_fld, fld_buff, send_slice, recv_slice, comps, additive);
+    });
+  }
+
+  /**
+   * @brief Waits for all the messages of the exchange and unpacks them
+   */
+  inline void WaitFields(FieldExchange& xchg) {
+    MPI_Waitall((int)xchg.requests.size(), xchg.requests.data(), MPI_STATUSES_IGNORE);
+    xchg.requests.clear();
+    for (auto& task : xchg.on_arrival) {
+      task();
     }
+    xchg.on_arrival.clear();
   }
 
-  void ParticleSendRecvCount(int                send_rank,
-                             int                recv_rank,
-                             const std::size_t& send_count,
-                             std::size_t&       recv_count) {
-    if ((send_rank >= 0) && (recv_rank >= 0)) {
-      MPI_Sendrecv(&send_count,
-                   1,
-                   mpi::get_type<std::size_t>(),
-                   send_rank,
-                   0,
-                   &recv_count,
-                   1,
-                   mpi::get_type<std::size_t>(),
-                   recv_rank,
-                   0,
-                   MPI_COMM_WORLD,
-                   MPI_STATUS_IGNORE);
-    } else if (send_rank >= 0) {
-      MPI_Send(&send_count, 1, mpi::get_type<std::size_t>(), send_rank, 0, MPI_COMM_WORLD);
-    } else if (recv_rank >= 0) {
-      MPI_Recv(&recv_count,
-               1,
-               mpi::get_type<std::size_t>(),
-               recv_rank,
-               0,
-               MPI_COMM_WORLD,
-               MPI_STATUS_IGNORE);
-    } else {
-      raise::Error("ParticleSendRecvCount called with negative ranks", HERE);
+  /**
+   * @brief Number of bytes a single particle occupies in the packed buffer
+   */
+  template <Dimension D, Coord::type C>
+  auto PackedParticleSize(Particles<D, C>& species) -> std::size_t {
+    std::size_t nbytes { 0 };
+    ForEachCommunicatedArray(
+      [&](const auto& arr) {
+        nbytes += sizeof(typename std::decay_t<decltype(arr)>::value_type);
+      },
+      species);
+    return nbytes;
+  }
+
+  /**
+   * @brief Makes sure the buffer can hold at least `nbytes` (never shrinks)
+   */
+  inline void ReserveBuffer(array_t<char*>&    buffer,
+                            std::size_t        nbytes,
+                            const std::string& label) {
+    if (buffer.extent(0) < nbytes) {
+      // allocate with a margin to avoid reallocating every step
+      buffer = array_t<char*> {
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, label),
+        nbytes + nbytes / 2
+      };
     }
   }
 
+  /**
+   * @brief Packs the particles from the slice into a single buffer
+   * @note Each quantity is stored as a contiguous segment: [ ux1 | ux2 | ... ]
+   */
+  template <Dimension D, Coord::type C>
+  void PackParticles(Particles<D, C>&     species,
+                     const range_tuple_t& slice,
+                     array_t<char*>&      buffer) {
+    const std::size_t count = slice.second - slice.first;
+    std::size_t       offset { 0 };
+    ForEachCommunicatedArray(
+      [&](const auto& arr) {
+        using T = typename std::decay_t<decltype(arr)>::value_type;
+        Kokkos::View<T*, AccelMemSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>> segment {
+          reinterpret_cast<T*>(buffer.data() + offset),
+          count
+        };
+        Kokkos::deep_copy(segment, Kokkos::subview(arr, slice));
+        offset += count * sizeof(T);
+      },
+      species);
+  }
+
+  /**
+   * @brief Unpacks the particles from a buffer into the slice
+   */
+  template <Dimension D, Coord::type C>
+  void UnpackParticles(Particles<D, C>&      species,
+                       const range_tuple_t&  slice,
+                       const array_t<char*>& buffer) {
+    const std::size_t count = slice.second - slice.first;
+    std::size_t       offset { 0 };
+    ForEachCommunicatedArray(
+      [&](auto& arr) {
+        using T = typename std::decay_t<decltype(arr)>::value_type;
+        Kokkos::View<T*, AccelMemSpace, Kokkos::MemoryTraits<Kokkos::Unmanaged>> segment {
+          reinterpret_cast<T*>(buffer.data() + offset),
+          count
+        };
+        Kokkos::deep_copy(Kokkos::subview(arr, slice), segment);
+        offset += count * sizeof(T);
+      },
+      species);
+  }
+
+  /**
+   * @brief Particles of a single local domain to exchange with the neighbors
+   * @param species particle container
+   * @param send_ranks ranks to send to (one per direction, -1 if none)
+   * @param recv_ranks ranks to receive from (one per direction, -1 if none)
+   * @param send_tags message tags for sending (one per direction)
+   * @param recv_tags message tags for receiving (one per direction)
+   * @param send_slices slices of particles to send (one per direction)
+   * @param index_last index where the received particles will be placed
+   */
   template <Dimension D, Coord::type C>
-  auto CommunicateParticles(Particles<D, C>&     species,
-                            int                  send_rank,
-                            int                  recv_rank,
-                            const range_tuple_t& send_slice,
-                            std::size_t&         index_last) -> std::size_t {
-    if ((send_rank < 0) && (recv_rank < 0)) {
-      raise::Error("No send or recv in CommunicateParticles", HERE);
+  struct ParticleTransfer {
+    Particles<D, C>*           species;
+    std::vector<int>           send_ranks, recv_ranks;
+    std::vector<int>           send_tags, recv_tags;
+    std::vector<range_tuple_t> send_slices;
+    std::size_t                index_last;
+  };
+
+  /**
+   * @brief Exchanges particles of all the local domains with all of their
+   * neighbors at once
+   * @param transfers particles to exchange (one per local domain)
+   * @param send_buffers persistent buffers for sending (one per direction of
+   * each transfer)
+   * @param recv_buffers persistent buffers for receiving (one per direction
+   * of each transfer)
+   * @returns number of received particles per direction of each transfer
+   * @note Received particles are placed consecutively (in the order of the
+   * directions) starting from `index_last` of each transfer
+   * @note Each neighbor receives a single message containing all the
+   * quantities of all the particles, and all messages are posted at once, so
+   * that the domains of the same rank do not wait for each other
+   */
+  template <Dimension D, Coord::type C>
+  auto CommunicateParticles(const std::vector<ParticleTransfer<D, C>>& transfers,
+                            std::vector<array_t<char*>>& send_buffers,
+                            std::vector<array_t<char*>>& recv_buffers)
+    -> std::vector<std::vector<std::size_t>> {
+    const auto ntransfers = transfers.size();
+    const auto ndirs = ntransfers > 0 ? transfers[0].send_ranks.size() : 0;
+    for (const auto& xfer : transfers) {
+      raise::ErrorIf((xfer.send_ranks.size() != ndirs) or
+                       (xfer.recv_ranks.size() != ndirs) or
+                       (xfer.send_tags.size() != ndirs) or
+                       (xfer.recv_tags.size() != ndirs) or
+                       (xfer.send_slices.size() != ndirs),
+                     "Inconsistent number of directions in CommunicateParticles",
+                     HERE);
+    }
+    if (send_buffers.size() < ntransfers * ndirs) {
+      send_buffers.resize(ntransfers * ndirs);
+      recv_buffers.resize(ntransfers * ndirs);
     }
-    std::size_t recv_count { 0 };
-    ParticleSendRecvCount(send_rank,
-                          recv_rank,
-                          send_slice.second - send_slice.first,
-                          recv_count);
 
-    raise::FatalIf((index_last + recv_count) >= species.maxnpart(),
-                   "Too many particles to receive (cannot fit into maxptl)",
-                   HERE);
-    const auto recv_slice = range_tuple_t({ index_last, index_last + recv_count });
+    // exchange the counts
+    std::vector<std::vector<std::size_t>> send_counts(
+      ntransfers,
+      std::vector<std::size_t>(ndirs, 0));
+    std::vector<std::vector<std::size_t>> recv_counts(
+      ntransfers,
+      std::vector<std::size_t>(ndirs, 0));
+    std::vector<MPI_Request> requests;
+    requests.reserve(2 * ntransfers * ndirs);
+    for (auto l { 0u }; l < ntransfers; ++l) {
+      const auto& xfer = transfers[l];
+      for (auto d { 0u }; d < ndirs; ++d) {
+        send_counts[l][d] = xfer.send_slices[d].second - xfer.send_slices[d].first;
+        if (xfer.recv_ranks[d] >= 0) {
+          requests.emplace_back();
+          MPI_Irecv(&recv_counts[l][d],
+                    1,
+                    mpi::get_type<std::size_t>(),
+                    xfer.recv_ranks[d],
+                    xfer.recv_tags[d],
+                    MPI_COMM_WORLD,
+                    &requests.back());
+        }
+        if (xfer.send_ranks[d] >= 0) {
+          requests.emplace_back();
+          MPI_Isend(&send_counts[l][d],
+                    1,
+                    mpi::get_type<std::size_t>(),
+                    xfer.send_ranks[d],
+                    xfer.send_tags[d],
+                    MPI_COMM_WORLD,
+                    &requests.back());
+        }
+      }
+    }
+    MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    requests.clear();
 
-    CommunicateParticleQuantity(species.i1, send_rank, recv_rank, send_slice, recv_slice);
-    CommunicateParticleQuantity(species.dx1, send_rank, recv_rank, send_slice, recv_slice);
-    CommunicateParticleQuantity(species.i1_prev,
-                                send_rank,
-                                recv_rank,
-                                send_slice,
-                                recv_slice);
-    CommunicateParticleQuantity(species.dx1_prev,
-                                send_rank,
-                                recv_rank,
-                                send_slice,
-                                recv_slice);
-    if constexpr (D == Dim::_2D || D == Dim::_3D) {
-      CommunicateParticleQuantity(species.i2, send_rank, recv_rank, send_slice, recv_slice);
-      CommunicateParticleQuantity(species.dx2,
-                                  send_rank,
-                                  recv_rank,
-                                  send_slice,
-                                  recv_slice);
-      CommunicateParticleQuantity(species.i2_prev,
-                                  send_rank,
-                                  recv_rank,
-                                  send_slice,
-                                  recv_slice);
-      CommunicateParticleQuantity(species.dx2_prev,
-                                  send_rank,
-                                  recv_rank,
-                                  send_slice,
-                                  recv_slice);
+    for (auto l { 0u }; l < ntransfers; ++l) {
+      std::size_t recv_total { 0 };
+      for (const auto& n : recv_counts[l]) {
+        recv_total += n;
+      }
+      // grow before packing, so that all the arrays are taken after resizing
+      transfers[l].species->Reserve(transfers[l].index_last + recv_total);
+      raise::FatalIf((transfers[l].index_last + recv_total) >
+                       transfers[l].species->maxnpart(),
+                     "Too many particles to receive (cannot fit into maxptl)",
+                     HERE);
     }
-    if constexpr (D == Dim::_3D) {
-      CommunicateParticleQuantity(species.i3, send_rank, recv_rank, send_slice, recv_slice);
-      CommunicateParticleQuantity(species.dx3,
-                                  send_rank,
-                                  recv_rank,
-                                  send_slice,
-                                  recv_slice);
-      CommunicateParticleQuantity(species.i3_prev,
-                                  send_rank,
-                                  recv_rank,
-                                  send_slice,
-                                  recv_slice);
-      CommunicateParticleQuantity(species.dx3_prev,
-                                  send_rank,
-                                  recv_rank,
-                                  send_slice,
-                                  recv_slice);
+
+    // post all the receives first, then pack and send
+    for (auto l { 0u }; l < ntransfers; ++l) {
+      const auto& xfer      = transfers[l];
+      const auto  prtl_size = PackedParticleSize(*xfer.species);
+      for (auto d { 0u }; d < ndirs; ++d) {
+        auto& buffer = recv_buffers[l * ndirs + d];
+        if ((xfer.recv_ranks[d] >= 0) and (recv_counts[l][d] > 0)) {
+          ReserveBuffer(buffer, recv_counts[l][d] * prtl_size, "prtl_recv_buff");
+          requests.emplace_back();
+          MPI_Irecv(buffer.data(),
+                    (int)(recv_counts[l][d] * prtl_size),
+                    MPI_BYTE,
+                    xfer.recv_ranks[d],
+                    xfer.recv_tags[d],
+                    MPI_COMM_WORLD,
+                    &requests.back());
+        }
+      }
     }
-    CommunicateParticleQuantity(species.ux1, send_rank, recv_rank, send_slice, recv_slice);
-    CommunicateParticleQuantity(species.ux2, send_rank, recv_rank, send_slice, recv_slice);
-    CommunicateParticleQuantity(species.ux3, send_rank, recv_rank, send_slice, recv_slice);
-    CommunicateParticleQuantity(species.weight,
-                                send_rank,
-                                recv_rank,
-                                send_slice,
-                                recv_slice);
-    if constexpr (D == Dim::_2D and C != Coord::Cart) {
-      CommunicateParticleQuantity(species.phi,
-                                  send_rank,
-                                  recv_rank,
-                                  send_slice,
-                                  recv_slice);
+    for (auto l { 0u }; l < ntransfers; ++l) {
+      const auto& xfer      = transfers[l];
+      const auto  prtl_size = PackedParticleSize(*xfer.species);
+      for (auto d { 0u }; d < ndirs; ++d) {
+        auto& buffer = send_buffers[l * ndirs + d];
+        if ((xfer.send_ranks[d] >= 0) and (send_counts[l][d] > 0)) {
+          ReserveBuffer(buffer, send_counts[l][d] * prtl_size, "prtl_send_buff");
+          PackParticles(*xfer.species, xfer.send_slices[d], buffer);
+          requests.emplace_back();
+          MPI_Isend(buffer.data(),
+                    (int)(send_counts[l][d] * prtl_size),
+                    MPI_BYTE,
+                    xfer.send_ranks[d],
+                    xfer.send_tags[d],
+                    MPI_COMM_WORLD,
+                    &requests.back());
+        }
+      }
     }
-    for (auto p { 0 }; p < species.npld(); ++p) {
-      CommunicateParticleQuantity(species.pld[p],
-                                  send_rank,
-                                  recv_rank,
-                                  send_slice,
-                                  recv_slice);
+    MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+    for (auto l { 0u }; l < ntransfers; ++l) {
+      auto index_last = transfers[l].index_last;
+      for (auto d { 0u }; d < ndirs; ++d) {
+        if (recv_counts[l][d] > 0) {
+          UnpackParticles(*transfers[l].species,
+                          { index_last, index_last + recv_counts[l][d] },
+                          recv_buffers[l * ndirs + d]);
+          index_last += recv_counts[l][d];
+        }
+      }
     }
-    return recv_count;
+    return recv_counts;
   }
 
 } // namespace comm
@@ -3,6 +3,10 @@
  * @brief Communication routines without mpi
  * @implements
  *   - comm::CommunicateField<> -> void
+ *   - comm::FieldExchange
+ *   - comm::PostField<> -> void
+ *   - comm::PostLocalField<> -> void
+ *   - comm::WaitFields -> void
  * @namespaces:
  *   - comm::
  * @note This should only be included if the MPI_ENABLED flag is not set
@@ -16,10 +20,14 @@
 #include "arch/kokkos_aliases.h"
 #include "utils/error.h"
 
+#include "framework/domain/comm_local.hpp"
 #include "framework/domain/domain.h"
 
 #include <Kokkos_Core.hpp>
 
+#include <functional>
+#include <vector>
+
 namespace comm {
   using namespace ntt;
 
@@ -44,80 +52,77 @@ namespace comm {
                    HERE);
 
     //  trivial copy if sending to self and receiving from self
-    if ((send_idx == idx) || (recv_idx == idx)) {
-      raise::ErrorIf((recv_idx != idx) || (send_idx != idx),
-                     "Cannot send to self and receive from another domain",
-                     HERE);
-      // sending/recv to/from self
-      if (not additive) {
-        // simply filling the ghost cells
-        if constexpr (D == Dim::_1D) {
-          Kokkos::deep_copy(Kokkos::subview(fld, recv_slice[0], comps),
-                            Kokkos::subview(fld, send_slice[0], comps));
-        } else if constexpr (D == Dim::_2D) {
-          Kokkos::deep_copy(
-            Kokkos::subview(fld, recv_slice[0], recv_slice[1], comps),
-            Kokkos::subview(fld, send_slice[0], send_slice[1], comps));
-        } else if constexpr (D == Dim::_3D) {
-          Kokkos::deep_copy(
-            Kokkos::subview(fld, recv_slice[0], recv_slice[1], recv_slice[2], comps),
-            Kokkos::subview(fld, send_slice[0], send_slice[1], send_slice[2], comps));
-        }
-      } else {
-        // adding received fields to ghosts + active
-        if constexpr (D == Dim::_1D) {
-          const auto offset_x1 = (long int)(recv_slice[0].first) -
-                                 (long int)(send_slice[0].first);
-          Kokkos::parallel_for(
-            "CommunicateField-extract",
-            Kokkos::MDRangePolicy<Kokkos::Rank<2>, AccelExeSpace>(
-              { recv_slice[0].first, comps.first },
-              { recv_slice[0].second, comps.second }),
-            Lambda(index_t i1, index_t ci) {
-              fld_buff(i1, ci) += fld(i1 - offset_x1, ci);
-            });
-        } else if constexpr (D == Dim::_2D) {
-          const auto offset_x1 = (long int)(recv_slice[0].first) -
-                                 (long int)(send_slice[0].first);
-          const auto offset_x2 = (long int)(recv_slice[1].first) -
-                                 (long int)(send_slice[1].first);
-          Kokkos::parallel_for(
-            "CommunicateField-extract",
-            Kokkos::MDRangePolicy<Kokkos::Rank<3>, AccelExeSpace>(
-              { recv_slice[0].first, recv_slice[1].first, comps.first },
-              { recv_slice[0].second, recv_slice[1].second, comps.second }),
-            Lambda(index_t i1, index_t i2, index_t ci) {
-              fld_buff(i1, i2, ci) += fld(i1 - offset_x1, i2 - offset_x2, ci);
-            });
-        } else if constexpr (D == Dim::_3D) {
-          const auto offset_x1 = (long int)(recv_slice[0].first) -
-                                 (long int)(send_slice[0].first);
-          const auto offset_x2 = (long int)(recv_slice[1].first) -
-                                 (long int)(send_slice[1].first);
-          const auto offset_x3 = (long int)(recv_slice[2].first) -
-                                 (long int)(send_slice[2].first);
-          Kokkos::parallel_for(
-            "CommunicateField-extract",
-            Kokkos::MDRangePolicy<Kokkos::Rank<4>, AccelExeSpace>(
-              { recv_slice[0].first,
-                recv_slice[1].first,
-                recv_slice[2].first,
-                comps.first },
-              { recv_slice[0].second,
-                recv_slice[1].second,
-                recv_slice[2].second,
-                comps.second }),
-            Lambda(index_t i1, index_t i2, index_t i3, index_t ci) {
-              fld_buff(i1, i2, i3, ci) += fld(i1 - offset_x1,
-                                              i2 - offset_x2,
-                                              i3 - offset_x3,
-                                              ci);
-            });
-        }
-      }
-    } else {
-      raise::Error("Multi domain without MPI is not supported yet", HERE);
+    raise::ErrorIf((recv_idx != idx) || (send_idx != idx),
+                   "Exchanges between different domains have to be posted "
+                   "with PostLocalField",
+                   HERE);
+    CopyField<D, N>(fld, fld_buff, send_slice, recv_slice, comps, additive);
+  }
+
+  /**
+   * @brief Without MPI only the copies between the domains are deferred
+   */
+  struct FieldExchange {
+    // tasks to perform upon `WaitFields`
+    std::vector<std::function<void()>> on_arrival;
+
+    [[nodiscard]]
+    auto pending() const -> bool {
+      return not on_arrival.empty();
+    }
+  };
+
+  template <Dimension D, int N>
+  inline void PostField(FieldExchange&,
+                        unsigned int                      idx,
+                        ndfield_t<D, N>&                  fld,
+                        ndfield_t<D, N>&                  fld_buff,
+                        unsigned int                      send_idx,
+                        unsigned int                      recv_idx,
+                        int                               send_rank,
+                        int                               recv_rank,
+                        const std::vector<range_tuple_t>& send_slice,
+                        const std::vector<range_tuple_t>& recv_slice,
+                        const range_tuple_t&              comps,
+                        bool                              additive,
+                        int,
+                        int) {
+    CommunicateField<D, N>(idx,
+                           fld,
+                           fld_buff,
+                           send_idx,
+                           recv_idx,
+                           send_rank,
+                           recv_rank,
+                           send_slice,
+                           recv_slice,
+                           comps,
+                           additive);
+  }
+
+  /**
+   * @brief Schedules the direct copy of a field from another domain
+   * (performed upon `WaitFields`)
+   * @note: Copy `nghbr_fld[send_slice]` to `fld_buff[recv_slice]`
+   */
+  template <Dimension D, int N>
+  inline void PostLocalField(FieldExchange&                    xchg,
+                             const ndfield_t<D, N>&            nghbr_fld,
+                             ndfield_t<D, N>&                  fld_buff,
+                             const std::vector<range_tuple_t>& send_slice,
+                             const std::vector<range_tuple_t>& recv_slice,
+                             const range_tuple_t&              comps,
+                             bool                              additive) {
+    xchg.on_arrival.emplace_back([=]() mutable {
+      CopyField<D, N>(nghbr_fld, fld_buff, send_slice, recv_slice, comps, additive);
+    });
+  }
+
+  inline void WaitFields(FieldExchange& xchg) {
+    for (auto& task : xchg.on_arrival) {
+      task();
     }
+    xchg.on_arrival.clear();
   }
 
 } // namespace comm
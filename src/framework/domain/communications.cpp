@@ -2,6 +2,7 @@
 #include "global.h"
 
 #include "arch/directions.h"
+#include "arch/mpi_tags.h"
 #include "utils/error.h"
 #include "utils/formatting.h"
 #include "utils/log.h"
@@ -17,13 +18,12 @@
 #include "framework/domain/metadomain.h"
 
 #if defined(MPI_ENABLED)
-  #include "arch/mpi_tags.h"
-
   #include "framework/domain/comm_mpi.hpp"
 #else
   #include "framework/domain/comm_nompi.hpp"
 #endif
 
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -201,53 +201,209 @@ namespace ntt {
     };
   }
 
-  template <SimEngine::type S, class M>
-  void Metadomain<S, M>::CommunicateFields(Domain<S, M>& domain, CommTags tags) {
-    const auto comm_fields = (tags & Comm::E) || (tags & Comm::B) ||
-                             (tags & Comm::J) || (tags & Comm::D) ||
-                             (tags & Comm::D0) || (tags & Comm::B0);
-    const bool comm_em = (tags & Comm::E) || (tags & Comm::B) || (tags & Comm::D);
-    const bool comm_em0 = (tags & Comm::B0) || (tags & Comm::D0);
-    const bool comm_j   = (tags & Comm::J);
-    raise::ErrorIf(not comm_fields, "CommunicateFields called with no task", HERE);
+  namespace {
+    // number of fields which may be exchanged simultaneously
+    constexpr int n_fld_tags = 4;
+
+    // parameters of the exchange of a domain in a single direction
+    struct xchg_params_t {
+      unsigned int               idx;
+      unsigned int               send_ind, recv_ind;
+      int                        send_rank, recv_rank;
+      // exchanges with the domains of the same rank are direct copies
+      bool                       send_local, recv_local;
+      // exchanges with the other ranks (go through MPI)
+      bool                       send_remote, recv_remote;
+      std::vector<range_tuple_t> send_slice, recv_slice;
+      // slice the neighbor sends to the domain (if `recv_local`)
+      std::vector<range_tuple_t> nghbr_send_slice;
+      int                        send_tag, recv_tag;
+    };
+  } // namespace
 
-    std::string comms = "";
-    if (tags & Comm::E) {
-      comms += "E ";
+  template <SimEngine::type S, class M>
+  auto GetExchangeParams(Metadomain<S, M>*        metadomain,
+                         Domain<S, M>&            domain,
+                         dir::direction_t<M::Dim> direction,
+                         bool                     synchronize) -> xchg_params_t {
+    const auto [send_params,
+                recv_params] = GetSendRecvParams(metadomain,
+                                                 domain,
+                                                 direction,
+                                                 synchronize);
+    const auto [send_indrank, send_slice] = send_params;
+    const auto [recv_indrank, recv_slice] = recv_params;
+    const auto [send_ind, send_rank]      = send_indrank;
+    const auto [recv_ind, recv_rank]      = recv_indrank;
+#if defined(MPI_ENABLED)
+    const auto rank = domain.mpi_rank();
+#else
+    const auto rank = 0;
+#endif
+    xchg_params_t params { domain.index(),
+                           send_ind,
+                           recv_ind,
+                           send_rank,
+                           recv_rank,
+                           (send_rank == rank) and (send_ind != domain.index()),
+                           (recv_rank == rank) and (recv_ind != domain.index()),
+                           (send_rank >= 0) and (send_rank != rank),
+                           (recv_rank >= 0) and (recv_rank != rank),
+                           send_slice,
+                           recv_slice,
+                           {},
+                           0,
+                           0 };
+    if (params.recv_local) {
+      // the neighbor sends to this domain in the same direction
+      auto& nghbr             = *metadomain->subdomain_ptr(recv_ind);
+      params.nghbr_send_slice = GetSendRecvParams(metadomain,
+                                                  nghbr,
+                                                  direction,
+                                                  synchronize)
+                                  .first.second;
     }
-    if (tags & Comm::B) {
-      comms += "B ";
+    return params;
+  }
+
+  namespace {
+    // number of elements in a slice of a field
+    auto SliceSize(const std::vector<range_tuple_t>& slice,
+                   const range_tuple_t&              comps) -> std::size_t {
+      std::size_t size = comps.second - comps.first;
+      for (const auto& range : slice) {
+        size *= range.second - range.first;
+      }
+      return size;
     }
-    if (tags & Comm::J) {
-      comms += "J ";
+  } // namespace
+
+  /**
+   * @brief Posts the exchange of a single field in a single direction
+   * @param nghbr_fld same field of the neighbor (used only if `recv_local`)
+   * @param k index of the field among the simultaneously exchanged ones
+   * @param bytes bytes sent to/received from other ranks (accumulated)
+   */
+  template <Dimension D, int N>
+  void PostFieldExchange(comm::FieldExchange& xchg,
+                         const xchg_params_t& params,
+                         ndfield_t<D, N>&     fld,
+                         ndfield_t<D, N>&     fld_buff,
+                         const ndfield_t<D, N>& nghbr_fld,
+                         const range_tuple_t&   comps,
+                         bool                   additive,
+                         int                    k,
+                         std::pair<std::size_t, std::size_t>& bytes) {
+    if (params.send_remote) {
+      bytes.first += SliceSize(params.send_slice, comps) * sizeof(real_t);
     }
-    if (tags & Comm::D) {
-      comms += "D ";
+    if (params.recv_remote) {
+      bytes.second += SliceSize(params.recv_slice, comps) * sizeof(real_t);
     }
-    if (tags & Comm::D0) {
-      comms += "D0 ";
+    const auto send_rank = params.send_local ? -1 : params.send_rank;
+    const auto recv_rank = params.recv_local ? -1 : params.recv_rank;
+    if (send_rank >= 0 or recv_rank >= 0) {
+      comm::PostField<D, N>(xchg,
+                            params.idx,
+                            fld,
+                            fld_buff,
+                            params.send_ind,
+                            params.recv_ind,
+                            send_rank,
+                            recv_rank,
+                            params.send_slice,
+                            params.recv_slice,
+                            comps,
+                            additive,
+                            params.send_tag + k,
+                            params.recv_tag + k);
     }
-    if (tags & Comm::B0) {
-      comms += "B0 ";
+    if (params.recv_local) {
+      comm::PostLocalField<D, N>(xchg,
+                                 nghbr_fld,
+                                 fld_buff,
+                                 params.nghbr_send_slice,
+                                 params.recv_slice,
+                                 comps,
+                                 additive);
     }
-    logger::Checkpoint(fmt::format("Communicating %s\n", comms.c_str()), HERE);
+  }
+
+  template <SimEngine::type S, class M>
+  void Metadomain<S, M>::CommunicateFields(CommTags tags) {
+    BeginCommunicateFields(tags);
+    EndCommunicateFields();
+  }
+
+  template <SimEngine::type S, class M>
+  void Metadomain<S, M>::BeginCommunicateFields(CommTags tags) {
+    raise::ErrorIf(g_fld_exchange.pending(),
+                   "BeginCommunicateFields called before the previous "
+                   "exchange is finished",
+                   HERE);
+    const auto comm_fields = (tags & Comm::E) || (tags & Comm::B) ||
+                             (tags & Comm::J) || (tags & Comm::D) ||
+                             (tags & Comm::D0) || (tags & Comm::B0) ||
+                             (tags & Comm::H);
+    const bool comm_j = (tags & Comm::J);
+    raise::ErrorIf(not comm_fields, "CommunicateFields called with no task", HERE);
+
+    logger::Checkpoint(
+      [&]() {
+        std::string comms = "";
+        if (tags & Comm::E) {
+          comms += "E ";
+        }
+        if (tags & Comm::B) {
+          comms += "B ";
+        }
+        if (tags & Comm::J) {
+          comms += "J ";
+        }
+        if (tags & Comm::D) {
+          comms += "D ";
+        }
+        if (tags & Comm::D0) {
+          comms += "D0 ";
+        }
+        if (tags & Comm::B0) {
+          comms += "B0 ";
+        }
+        if (tags & Comm::H) {
+          comms += "H ";
+        }
+        return fmt::format("Communicating %s\n", comms.c_str());
+      },
+      HERE);
 
-    /**
-     * @note this block is designed to support in the future multiple domains
-     * on a single rank, however that is not yet implemented
-     */
     // establish the last index ranges for fields (i.e., components)
-    auto comp_range_fld = range_tuple_t {};
-    auto comp_range_cur = range_tuple_t {};
+    // ... in GR: em holds D & B, em0 holds D0 & B0, aux holds E & H
+    auto comp_range_fld  = range_tuple_t {};
+    auto comp_range_fld0 = range_tuple_t {};
+    auto comp_range_aux  = range_tuple_t {};
+    auto comp_range_cur  = range_tuple_t {};
     if constexpr (S == SimEngine::GRPIC) {
-      if (((tags & Comm::D) && (tags & Comm::B)) ||
-          ((tags & Comm::D0) && (tags & Comm::B0))) {
+      if ((tags & Comm::D) && (tags & Comm::B)) {
         comp_range_fld = range_tuple_t(em::dx1, em::bx3 + 1);
-      } else if ((tags & Comm::D) || (tags & Comm::D0)) {
+      } else if (tags & Comm::D) {
         comp_range_fld = range_tuple_t(em::dx1, em::dx3 + 1);
-      } else if ((tags & Comm::B) || (tags & Comm::B0)) {
+      } else if (tags & Comm::B) {
         comp_range_fld = range_tuple_t(em::bx1, em::bx3 + 1);
       }
+      if ((tags & Comm::D0) && (tags & Comm::B0)) {
+        comp_range_fld0 = range_tuple_t(em::dx1, em::bx3 + 1);
+      } else if (tags & Comm::D0) {
+        comp_range_fld0 = range_tuple_t(em::dx1, em::dx3 + 1);
+      } else if (tags & Comm::B0) {
+        comp_range_fld0 = range_tuple_t(em::bx1, em::bx3 + 1);
+      }
+      if ((tags & Comm::E) && (tags & Comm::H)) {
+        comp_range_aux = range_tuple_t(em::ex1, em::hx3 + 1);
+      } else if (tags & Comm::E) {
+        comp_range_aux = range_tuple_t(em::ex1, em::ex3 + 1);
+      } else if (tags & Comm::H) {
+        comp_range_aux = range_tuple_t(em::hx1, em::hx3 + 1);
+      }
     } else if constexpr (S == SimEngine::SRPIC) {
       if ((tags & Comm::E) && (tags & Comm::B)) {
         comp_range_fld = range_tuple_t(em::ex1, em::bx3 + 1);
@@ -262,61 +418,80 @@ namespace ntt {
     if (comm_j) {
       comp_range_cur = range_tuple_t(cur::jx1, cur::jx3 + 1);
     }
-    // traverse in all directions and send/recv the fields
-    for (auto& direction : dir::Directions<M::Dim>::all) {
-      const auto [send_params,
-                  recv_params] = GetSendRecvParams(this, domain, direction, false);
-      const auto [send_indrank, send_slice] = send_params;
-      const auto [recv_indrank, recv_slice] = recv_params;
-      const auto [send_ind, send_rank]      = send_indrank;
-      const auto [recv_ind, recv_rank]      = recv_indrank;
-      if (send_rank < 0 and recv_rank < 0) {
-        continue;
-      }
-      if (comm_em) {
-        comm::CommunicateField<M::Dim, 6>(domain.index(),
-                                          domain.fields.em,
-                                          domain.fields.em,
-                                          send_ind,
-                                          recv_ind,
-                                          send_rank,
-                                          recv_rank,
-                                          send_slice,
-                                          recv_slice,
-                                          comp_range_fld,
-                                          false);
-      }
-      if constexpr (S == SimEngine::GRPIC) {
-        if (comm_em0) {
-          comm::CommunicateField<M::Dim, 6>(domain.index(),
-                                            domain.fields.em0,
-                                            domain.fields.em0,
-                                            send_ind,
-                                            recv_ind,
-                                            send_rank,
-                                            recv_rank,
-                                            send_slice,
-                                            recv_slice,
-                                            comp_range_fld,
-                                            false);
+    const bool comm_em  = (comp_range_fld.second > comp_range_fld.first);
+    const bool comm_em0 = (comp_range_fld0.second > comp_range_fld0.first);
+    const bool comm_aux = (comp_range_aux.second > comp_range_aux.first);
+    const int  ndirs    = dir::Directions<M::Dim>::all.size();
+    // traverse all local domains in all directions and post the send/recv of
+    // ... the fields; message tags are unique per local domain, direction &
+    // ... field
+    for (const auto& ldidx : g_local_subdomain_indices) {
+      auto& domain  = g_subdomains[ldidx];
+      int   dir_tag = 0;
+      for (auto& direction : dir::Directions<M::Dim>::all) {
+        const auto d      = dir_tag++;
+        auto       params = GetExchangeParams(this, domain, direction, false);
+        if (params.send_rank < 0 and params.recv_rank < 0) {
+          continue;
+        }
+        params.recv_tag = n_fld_tags * ((int)local_position(domain.index()) * ndirs + d);
+        params.send_tag = n_fld_tags * ((int)local_position(params.send_ind) * ndirs + d);
+        const auto& nghbr = g_subdomains[params.recv_ind];
+        if (comm_em) {
+          PostFieldExchange<M::Dim, 6>(g_fld_exchange,
+                                       params,
+                                       domain.fields.em,
+                                       domain.fields.em,
+                                       nghbr.fields.em,
+                                       comp_range_fld,
+                                       false,
+                                       0,
+                                       g_comm_bytes[d]);
+        }
+        if constexpr (S == SimEngine::GRPIC) {
+          if (comm_em0) {
+            PostFieldExchange<M::Dim, 6>(g_fld_exchange,
+                                         params,
+                                         domain.fields.em0,
+                                         domain.fields.em0,
+                                         nghbr.fields.em0,
+                                         comp_range_fld0,
+                                         false,
+                                         1,
+                                         g_comm_bytes[d]);
+          }
+          if (comm_aux) {
+            PostFieldExchange<M::Dim, 6>(g_fld_exchange,
+                                         params,
+                                         domain.fields.aux,
+                                         domain.fields.aux,
+                                         nghbr.fields.aux,
+                                         comp_range_aux,
+                                         false,
+                                         3,
+                                         g_comm_bytes[d]);
+          }
+        }
+        if (comm_j) {
+          PostFieldExchange<M::Dim, 3>(g_fld_exchange,
+                                       params,
+                                       domain.fields.cur,
+                                       domain.fields.cur,
+                                       nghbr.fields.cur,
+                                       comp_range_cur,
+                                       false,
+                                       2,
+                                       g_comm_bytes[d]);
         }
-      }
-      if (comm_j) {
-        comm::CommunicateField<M::Dim, 3>(domain.index(),
-                                          domain.fields.cur,
-                                          domain.fields.cur,
-                                          send_ind,
-                                          recv_ind,
-                                          send_rank,
-                                          recv_rank,
-                                          send_slice,
-                                          recv_slice,
-                                          comp_range_cur,
-                                          false);
       }
     }
   }
 
+  template <SimEngine::type S, class M>
+  void Metadomain<S, M>::EndCommunicateFields() {
+    comm::WaitFields(g_fld_exchange);
+  }
+
   template <Dimension D, int N>
   void AddBufferedFields(ndfield_t<D, N>&     field,
                          ndfield_t<D, N>&     buffer,
@@ -356,9 +531,37 @@ namespace ntt {
     }
   }
 
+  /**
+   * @brief Zeroes a persistent buffer shaped as the field
+   * @note Buffer is reallocated only if the shape has changed (e.g., after
+   * the load balancing)
+   */
+  template <Dimension D, int N>
+  void ResetBufferLike(ndfield_t<D, N>&       buffer,
+                       const ndfield_t<D, N>& field,
+                       const std::string&     label) {
+    auto same_shape = buffer.is_allocated();
+    for (auto d { 0u }; d < static_cast<unsigned int>(D); ++d) {
+      same_shape = same_shape and (buffer.extent(d) == field.extent(d));
+    }
+    if (same_shape) {
+      Kokkos::deep_copy(buffer, ZERO);
+      return;
+    }
+    if constexpr (D == Dim::_1D) {
+      buffer = ndfield_t<D, N> { label, field.extent(0) };
+    } else if constexpr (D == Dim::_2D) {
+      buffer = ndfield_t<D, N> { label, field.extent(0), field.extent(1) };
+    } else if constexpr (D == Dim::_3D) {
+      buffer = ndfield_t<D, N> { label,
+                                 field.extent(0),
+                                 field.extent(1),
+                                 field.extent(2) };
+    }
+  }
+
   template <SimEngine::type S, class M>
-  void Metadomain<S, M>::SynchronizeFields(Domain<S, M>&        domain,
-                                           CommTags             tags,
+  void Metadomain<S, M>::SynchronizeFields(CommTags             tags,
                                            const range_tuple_t& components) {
     const bool comm_j    = (tags & Comm::J);
     const bool comm_bckp = (tags & Comm::Bckp);
@@ -371,278 +574,378 @@ namespace ntt {
                    HERE);
     const auto synchronize = true;
 
-    std::string comms = "";
-    if (comm_j) {
-      comms += "J ";
-    }
-    if (comm_bckp) {
-      comms += "Bckp ";
-    }
-    if (comm_buff) {
-      comms += "Buff ";
-    }
-    logger::Checkpoint(fmt::format("Synchronizing %s\n", comms.c_str()), HERE);
+    logger::Checkpoint(
+      [&]() {
+        std::string comms = "";
+        if (comm_j) {
+          comms += "J ";
+        }
+        if (comm_bckp) {
+          comms += "Bckp ";
+        }
+        if (comm_buff) {
+          comms += "Buff ";
+        }
+        return fmt::format("Synchronizing %s\n", comms.c_str());
+      },
+      HERE);
 
     auto comp_range_cur = range_tuple_t {};
     if (comm_j) {
       comp_range_cur = range_tuple_t(cur::jx1, cur::jx3 + 1);
-      Kokkos::deep_copy(domain.fields.buff, ZERO);
     }
-    ndfield_t<M::Dim, 6> bckp_recv;
-    ndfield_t<M::Dim, 3> buff_recv;
-    if (comm_bckp) {
-      if constexpr (M::Dim == Dim::_1D) {
-        bckp_recv = ndfield_t<M::Dim, 6> { "bckp_recv",
-                                           domain.fields.bckp.extent(0) };
-      } else if constexpr (M::Dim == Dim::_2D) {
-        bckp_recv = ndfield_t<M::Dim, 6> { "bckp_recv",
-                                           domain.fields.bckp.extent(0),
-                                           domain.fields.bckp.extent(1) };
-      } else if constexpr (M::Dim == Dim::_3D) {
-        bckp_recv = ndfield_t<M::Dim, 6> { "bckp_recv",
-                                           domain.fields.bckp.extent(0),
-                                           domain.fields.bckp.extent(1),
-                                           domain.fields.bckp.extent(2) };
+    // received values are accumulated in separate buffers (one per local
+    // ... domain), since the sent values of the neighbors have to stay intact
+    const auto nlocal    = g_local_subdomain_indices.size();
+    auto&      bckp_recv = g_bckp_recv;
+    auto&      buff_recv = g_buff_recv;
+    bckp_recv.resize(nlocal);
+    buff_recv.resize(nlocal);
+    for (auto l { 0u }; l < nlocal; ++l) {
+      auto& domain = g_subdomains[g_local_subdomain_indices[l]];
+      if (comm_j) {
+        Kokkos::deep_copy(domain.fields.buff, ZERO);
       }
-    }
-    if (comm_buff) {
-      if constexpr (M::Dim == Dim::_1D) {
-        buff_recv = ndfield_t<M::Dim, 3> { "buff_recv",
-                                           domain.fields.buff.extent(0) };
-      } else if constexpr (M::Dim == Dim::_2D) {
-        buff_recv = ndfield_t<M::Dim, 3> { "buff_recv",
-                                           domain.fields.buff.extent(0),
-                                           domain.fields.buff.extent(1) };
-      } else if constexpr (M::Dim == Dim::_3D) {
-        buff_recv = ndfield_t<M::Dim, 3> { "buff_recv",
-                                           domain.fields.buff.extent(0),
-                                           domain.fields.buff.extent(1),
-                                           domain.fields.buff.extent(2) };
+      if (comm_bckp) {
+        ResetBufferLike<M::Dim, 6>(bckp_recv[l], domain.fields.bckp, "bckp_recv");
+      }
+      if (comm_buff) {
+        ResetBufferLike<M::Dim, 3>(buff_recv[l], domain.fields.buff, "buff_recv");
       }
     }
-    // traverse in all directions and sync the fields
-    for (auto& direction : dir::Directions<M::Dim>::all) {
-      const auto [send_params,
-                  recv_params] = GetSendRecvParams(this, domain, direction, true);
-      const auto [send_indrank, send_slice] = send_params;
-      const auto [recv_indrank, recv_slice] = recv_params;
-      const auto [send_ind, send_rank]      = send_indrank;
-      const auto [recv_ind, recv_rank]      = recv_indrank;
-      if (send_rank < 0 and recv_rank < 0) {
-        continue;
+    raise::ErrorIf(g_fld_exchange.pending(),
+                   "SynchronizeFields called during an ongoing exchange",
+                   HERE);
+    // traverse all local domains in all directions and sync the fields
+    // ... all messages are posted at once, since the received values are
+    // ... accumulated in separate buffers
+    const int ndirs = dir::Directions<M::Dim>::all.size();
+    for (auto l { 0u }; l < nlocal; ++l) {
+      auto& domain  = g_subdomains[g_local_subdomain_indices[l]];
+      int   dir_tag = 0;
+      for (auto& direction : dir::Directions<M::Dim>::all) {
+        const auto d = dir_tag++;
+        auto params  = GetExchangeParams(this, domain, direction, synchronize);
+        if (params.send_rank < 0 and params.recv_rank < 0) {
+          continue;
+        }
+        params.recv_tag = n_fld_tags * ((int)local_position(domain.index()) * ndirs + d);
+        params.send_tag = n_fld_tags * ((int)local_position(params.send_ind) * ndirs + d);
+        const auto& nghbr = g_subdomains[params.recv_ind];
+        if (comm_j) {
+          PostFieldExchange<M::Dim, 3>(g_fld_exchange,
+                                       params,
+                                       domain.fields.cur,
+                                       domain.fields.buff,
+                                       nghbr.fields.cur,
+                                       comp_range_cur,
+                                       synchronize,
+                                       0,
+                                       g_comm_bytes[d]);
+        }
+        if (comm_bckp) {
+          PostFieldExchange<M::Dim, 6>(g_fld_exchange,
+                                       params,
+                                       domain.fields.bckp,
+                                       bckp_recv[l],
+                                       nghbr.fields.bckp,
+                                       components,
+                                       synchronize,
+                                       1,
+                                       g_comm_bytes[d]);
+        }
+        if (comm_buff) {
+          PostFieldExchange<M::Dim, 3>(g_fld_exchange,
+                                       params,
+                                       domain.fields.buff,
+                                       buff_recv[l],
+                                       nghbr.fields.buff,
+                                       components,
+                                       synchronize,
+                                       2,
+                                       g_comm_bytes[d]);
+        }
       }
+    }
+    comm::WaitFields(g_fld_exchange);
+    for (auto l { 0u }; l < nlocal; ++l) {
+      auto& domain = g_subdomains[g_local_subdomain_indices[l]];
       if (comm_j) {
-        comm::CommunicateField<M::Dim, 3>(domain.index(),
-                                          domain.fields.cur,
-                                          domain.fields.buff,
-                                          send_ind,
-                                          recv_ind,
-                                          send_rank,
-                                          recv_rank,
-                                          send_slice,
-                                          recv_slice,
-                                          comp_range_cur,
-                                          synchronize);
+        AddBufferedFields<M::Dim, 3>(domain.fields.cur,
+                                     domain.fields.buff,
+                                     domain.mesh.rangeActiveCells(),
+                                     comp_range_cur);
       }
       if (comm_bckp) {
-        comm::CommunicateField<M::Dim, 6>(domain.index(),
-                                          domain.fields.bckp,
-                                          bckp_recv,
-                                          send_ind,
-                                          recv_ind,
-                                          send_rank,
-                                          recv_rank,
-                                          send_slice,
-                                          recv_slice,
-                                          components,
-                                          synchronize);
+        AddBufferedFields<M::Dim, 6>(domain.fields.bckp,
+                                     bckp_recv[l],
+                                     domain.mesh.rangeActiveCells(),
+                                     components);
       }
       if (comm_buff) {
-        comm::CommunicateField<M::Dim, 3>(domain.index(),
-                                          domain.fields.buff,
-                                          buff_recv,
-                                          send_ind,
-                                          recv_ind,
-                                          send_rank,
-                                          recv_rank,
-                                          send_slice,
-                                          recv_slice,
-                                          components,
-                                          synchronize);
+        AddBufferedFields<M::Dim, 3>(domain.fields.buff,
+                                     buff_recv[l],
+                                     domain.mesh.rangeActiveCells(),
+                                     components);
       }
     }
-    if (comm_j) {
-      AddBufferedFields<M::Dim, 3>(domain.fields.cur,
-                                   domain.fields.buff,
-                                   domain.mesh.rangeActiveCells(),
-                                   comp_range_cur);
-    }
-    if (comm_bckp) {
-      AddBufferedFields<M::Dim, 6>(domain.fields.bckp,
-                                   bckp_recv,
-                                   domain.mesh.rangeActiveCells(),
-                                   components);
-    }
-    if (comm_buff) {
-      AddBufferedFields<M::Dim, 3>(domain.fields.buff,
-                                   buff_recv,
-                                   domain.mesh.rangeActiveCells(),
-                                   components);
-    }
   }
 
+  namespace {
+    // plan of the particle exchange of a single local domain
+    struct prtl_xchg_plan_t {
+      std::size_t                index_last;
+      std::vector<range_tuple_t> send_slices;
+      std::vector<unsigned int>  send_inds, recv_inds;
+      std::vector<int>           send_ranks, recv_ranks;
+      // particles from the domains of the same rank are copied directly
+      std::vector<bool>          recv_local;
+    };
+  } // namespace
+
   template <SimEngine::type S, class M>
-  void Metadomain<S, M>::CommunicateParticles(Domain<S, M>&  domain,
-                                              timer::Timers* timers) {
+  void Metadomain<S, M>::CommunicateParticles(timer::Timers* timers) {
     raise::ErrorIf(timers == nullptr,
                    "Timers not passed when Comm::Prtl called",
                    HERE);
     logger::Checkpoint("Communicating particles\n", HERE);
-    for (auto& species : domain.species) {
-      // at this point particles should already by tagged in the pusher
-      timers->start("Sorting");
-      const auto npart_per_tag = species.SortByTags();
-      timers->stop("Sorting");
+    const auto& directions = dir::Directions<D>::all;
+    const auto  ndirs      = directions.size();
+    const auto  nlocal     = g_local_subdomain_indices.size();
+    for (std::size_t s { 0 }; s < g_species_params.size(); ++s) {
+      auto plans = std::vector<prtl_xchg_plan_t>(nlocal);
+      for (auto l { 0u }; l < nlocal; ++l) {
+        auto& domain  = g_subdomains[g_local_subdomain_indices[l]];
+        auto& species = domain.species[s];
+        // at this point particles should already by tagged in the pusher
+        timers->start("Sorting");
+        const auto npart_per_tag = species.SortByTags();
+        timers->stop("Sorting");
+        /**
+         *                                                        index_last
+         *                                                            |
+         *    alive      new dead         tag1       tag2             v     dead
+         * [ 11111111   000000000    222222222    3333333 .... nnnnnnn  00000000 ... ]
+         *                           ^        ^
+         *                           |        |
+         *     tag_offset[tag1] -----+        +----- tag_offset[tag1] + npart_per_tag[tag1]
+         *          "send_pmin"                      "send_pmax" (after last element)
+         */
+        auto tag_offset { npart_per_tag };
+        for (std::size_t i { 1 }; i < tag_offset.size(); ++i) {
+          tag_offset[i] += tag_offset[i - 1];
+        }
+        for (std::size_t i { 0 }; i < tag_offset.size(); ++i) {
+          tag_offset[i] -= npart_per_tag[i];
+        }
+        auto& plan      = plans[l];
+        plan.index_last = tag_offset[tag_offset.size() - 1] +
+                          npart_per_tag[npart_per_tag.size() - 1];
+        plan.send_slices = std::vector<range_tuple_t>(ndirs, range_tuple_t { 0, 0 });
+        plan.send_inds  = std::vector<unsigned int>(ndirs, 0);
+        plan.recv_inds  = std::vector<unsigned int>(ndirs, 0);
+        plan.send_ranks = std::vector<int>(ndirs, -1);
+        plan.recv_ranks = std::vector<int>(ndirs, -1);
+        plan.recv_local = std::vector<bool>(ndirs, false);
+        for (auto d { 0u }; d < ndirs; ++d) {
+          const auto& direction = directions[d];
+          const auto [send_indrank,
+                      recv_indrank] = GetSendRecvRanks(this, domain, direction);
+          const auto [send_ind, send_rank] = send_indrank;
+          const auto [recv_ind, recv_rank] = recv_indrank;
+          if (send_rank < 0 and recv_rank < 0) {
+            continue;
+          }
 #if defined(MPI_ENABLED)
-      timers->start("Communications");
-      // only necessary when MPI is enabled
-      /**
-       *                                                        index_last
-       *                                                            |
-       *    alive      new dead         tag1       tag2             v     dead
-       * [ 11111111   000000000    222222222    3333333 .... nnnnnnn  00000000 ... ]
-       *                           ^        ^
-       *                           |        |
-       *     tag_offset[tag1] -----+        +----- tag_offset[tag1] + npart_per_tag[tag1]
-       *          "send_pmin"                      "send_pmax" (after last element)
-       */
-      auto tag_offset { npart_per_tag };
-      for (std::size_t i { 1 }; i < tag_offset.size(); ++i) {
-        tag_offset[i] += tag_offset[i - 1];
-      }
-      for (std::size_t i { 0 }; i < tag_offset.size(); ++i) {
-        tag_offset[i] -= npart_per_tag[i];
+          const auto rank = domain.mpi_rank();
+#else
+          const auto rank = 0;
+#endif
+          const auto send_dir_tag = mpi::PrtlSendTag<D>::dir2tag(direction);
+          const auto nsend        = npart_per_tag[send_dir_tag];
+          // particles sent within the rank are picked up by the receiver
+          plan.send_ranks[d]  = (send_rank == rank) ? -1 : send_rank;
+          plan.recv_ranks[d]  = (recv_rank == rank) ? -1 : recv_rank;
+          plan.recv_local[d]  = (recv_rank == rank);
+          plan.send_inds[d]   = send_ind;
+          plan.recv_inds[d]   = recv_ind;
+          plan.send_slices[d] = { tag_offset[send_dir_tag],
+                                  tag_offset[send_dir_tag] + nsend };
+        }
       }
-      auto index_last = tag_offset[tag_offset.size() - 1] +
-                        npart_per_tag[npart_per_tag.size() - 1];
-      for (auto& direction : dir::Directions<D>::all) {
-        const auto [send_params,
-                    recv_params] = GetSendRecvParams(this, domain, direction, true);
-        const auto [send_indrank, send_slice] = send_params;
-        const auto [recv_indrank, recv_slice] = recv_params;
-        const auto [send_ind, send_rank]      = send_indrank;
-        const auto [recv_ind, recv_rank]      = recv_indrank;
-        if (send_rank < 0 and recv_rank < 0) {
-          continue;
+
+      timers->start("Communications");
+      auto recv_counts = std::vector<std::vector<std::size_t>>(
+        nlocal,
+        std::vector<std::size_t>(ndirs, 0));
+#if defined(MPI_ENABLED)
+      {
+        // all the neighbors of all the local domains are communicated with
+        // ... at once (message tags are unique per receiving domain & direction)
+        auto transfers = std::vector<comm::ParticleTransfer<M::Dim, M::CoordType>> {};
+        for (auto l { 0u }; l < nlocal; ++l) {
+          auto& domain = g_subdomains[g_local_subdomain_indices[l]];
+          auto  send_tags = std::vector<int>(ndirs, 0);
+          auto  recv_tags = std::vector<int>(ndirs, 0);
+          for (auto d { 0u }; d < ndirs; ++d) {
+            recv_tags[d] = (int)(local_position(domain.index()) * ndirs + d);
+            send_tags[d] = (int)(local_position(plans[l].send_inds[d]) * ndirs + d);
+          }
+          transfers.push_back({ &domain.species[s],
+                                plans[l].send_ranks,
+                                plans[l].recv_ranks,
+                                send_tags,
+                                recv_tags,
+                                plans[l].send_slices,
+                                plans[l].index_last });
         }
-        const auto send_dir_tag = mpi::PrtlSendTag<D>::dir2tag(direction);
-        const auto nsend        = npart_per_tag[send_dir_tag];
-        const auto send_pmin    = tag_offset[send_dir_tag];
-        const auto send_pmax    = tag_offset[send_dir_tag] + nsend;
-        const auto recv_count = comm::CommunicateParticles<M::Dim, M::CoordType>(
-          species,
-          send_rank,
-          recv_rank,
-          { send_pmin, send_pmax },
-          index_last);
-        if (recv_count > 0) {
-          if constexpr (D == Dim::_1D) {
-            int shift_in_x1 { 0 };
-            if ((-direction)[0] == -1) {
-              shift_in_x1 = -subdomain(recv_ind).mesh.n_active(in::x1);
-            } else if ((-direction)[0] == 1) {
-              shift_in_x1 = domain.mesh.n_active(in::x1);
-            }
-            auto& this_tag     = species.tag;
-            auto& this_i1      = species.i1;
-            auto& this_i1_prev = species.i1_prev;
-            Kokkos::parallel_for(
-              "CommunicateParticles",
-              recv_count,
-              Lambda(index_t p) {
-                this_tag(index_last + p)      = ParticleTag::alive;
-                this_i1(index_last + p)      += shift_in_x1;
-                this_i1_prev(index_last + p) += shift_in_x1;
-              });
-          } else if constexpr (D == Dim::_2D) {
-            int shift_in_x1 { 0 }, shift_in_x2 { 0 };
-            if ((-direction)[0] == -1) {
-              shift_in_x1 = -subdomain(recv_ind).mesh.n_active(in::x1);
-            } else if ((-direction)[0] == 1) {
-              shift_in_x1 = domain.mesh.n_active()[0];
-            }
-            if ((-direction)[1] == -1) {
-              shift_in_x2 = -subdomain(recv_ind).mesh.n_active(in::x2);
-            } else if ((-direction)[1] == 1) {
-              shift_in_x2 = domain.mesh.n_active(in::x2);
-            }
-            auto& this_tag     = species.tag;
-            auto& this_i1      = species.i1;
-            auto& this_i2      = species.i2;
-            auto& this_i1_prev = species.i1_prev;
-            auto& this_i2_prev = species.i2_prev;
-            Kokkos::parallel_for(
-              "CommunicateParticles",
-              recv_count,
-              Lambda(index_t p) {
-                this_tag(index_last + p)      = ParticleTag::alive;
-                this_i1(index_last + p)      += shift_in_x1;
-                this_i2(index_last + p)      += shift_in_x2;
-                this_i1_prev(index_last + p) += shift_in_x1;
-                this_i2_prev(index_last + p) += shift_in_x2;
-              });
-          } else if constexpr (D == Dim::_3D) {
-            int shift_in_x1 { 0 }, shift_in_x2 { 0 }, shift_in_x3 { 0 };
-            if ((-direction)[0] == -1) {
-              shift_in_x1 = -subdomain(recv_ind).mesh.n_active(in::x1);
-            } else if ((-direction)[0] == 1) {
-              shift_in_x1 = domain.mesh.n_active(in::x1);
+        recv_counts = comm::CommunicateParticles<M::Dim, M::CoordType>(
+          transfers,
+          g_prtl_send_buffers,
+          g_prtl_recv_buffers);
+        for (auto l { 0u }; l < nlocal; ++l) {
+          const auto prtl_size = comm::PackedParticleSize(*transfers[l].species);
+          for (auto d { 0u }; d < ndirs; ++d) {
+            if (plans[l].send_ranks[d] >= 0) {
+              g_comm_bytes[d].first += prtl_size *
+                                       (plans[l].send_slices[d].second -
+                                        plans[l].send_slices[d].first);
             }
-            if ((-direction)[1] == -1) {
-              shift_in_x2 = -subdomain(recv_ind).mesh.n_active(in::x2);
-            } else if ((-direction)[1] == 1) {
-              shift_in_x2 = domain.mesh.n_active(in::x2);
-            }
-            if ((-direction)[2] == -1) {
-              shift_in_x3 = -subdomain(recv_ind).mesh.n_active(in::x3);
-            } else if ((-direction)[2] == 1) {
-              shift_in_x3 = domain.mesh.n_active(in::x3);
+            g_comm_bytes[d].second += prtl_size * recv_counts[l][d];
+          }
+        }
+      }
+#endif
+      for (auto l { 0u }; l < nlocal; ++l) {
+        auto& domain  = g_subdomains[g_local_subdomain_indices[l]];
+        auto& species = domain.species[s];
+        auto& plan    = plans[l];
+        // received particles are placed consecutively starting from
+        // ... `index_last`: first the ones received via MPI (in the order of
+        // ... the directions), then the ones copied from the same rank
+        auto recv_first = std::vector<std::size_t>(ndirs, 0);
+        auto index_last = plan.index_last;
+        for (auto d { 0u }; d < ndirs; ++d) {
+          recv_first[d]  = index_last;
+          index_last    += recv_counts[l][d];
+        }
+        for (auto d { 0u }; d < ndirs; ++d) {
+          if (not plan.recv_local[d]) {
+            continue;
+          }
+          const auto  recv_ind    = plan.recv_inds[d];
+          const auto& nghbr_slice = plans[local_position(recv_ind)].send_slices[d];
+          recv_counts[l][d] = nghbr_slice.second - nghbr_slice.first;
+          recv_first[d]     = index_last;
+          if (recv_counts[l][d] > 0) {
+            comm::CopyParticles<M::Dim, M::CoordType>(
+              g_subdomains[recv_ind].species[s],
+              nghbr_slice,
+              species,
+              index_last);
+            index_last += recv_counts[l][d];
+          }
+        }
+        for (auto d { 0u }; d < ndirs; ++d) {
+          const auto& direction   = directions[d];
+          const auto  recv_count  = recv_counts[l][d];
+          const auto  recv_ind    = plan.recv_inds[d];
+          const auto  index_first = recv_first[d];
+          if (recv_count > 0) {
+            if constexpr (D == Dim::_1D) {
+              int shift_in_x1 { 0 };
+              if ((-direction)[0] == -1) {
+                shift_in_x1 = -subdomain(recv_ind).mesh.n_active(in::x1);
+              } else if ((-direction)[0] == 1) {
+                shift_in_x1 = domain.mesh.n_active(in::x1);
+              }
+              auto& this_tag = species.tag;
+              auto& this_i1  = species.i1;
+              Kokkos::parallel_for(
+                "CommunicateParticles",
+                recv_count,
+                Lambda(index_t p) {
+                  this_tag(index_first + p)  = ParticleTag::alive;
+                  this_i1(index_first + p) += shift_in_x1;
+                });
+            } else if constexpr (D == Dim::_2D) {
+              int shift_in_x1 { 0 }, shift_in_x2 { 0 };
+              if ((-direction)[0] == -1) {
+                shift_in_x1 = -subdomain(recv_ind).mesh.n_active(in::x1);
+              } else if ((-direction)[0] == 1) {
+                shift_in_x1 = domain.mesh.n_active()[0];
+              }
+              if ((-direction)[1] == -1) {
+                shift_in_x2 = -subdomain(recv_ind).mesh.n_active(in::x2);
+              } else if ((-direction)[1] == 1) {
+                shift_in_x2 = domain.mesh.n_active(in::x2);
+              }
+              auto& this_tag = species.tag;
+              auto& this_i1  = species.i1;
+              auto& this_i2  = species.i2;
+              Kokkos::parallel_for(
+                "CommunicateParticles",
+                recv_count,
+                Lambda(index_t p) {
+                  this_tag(index_first + p)  = ParticleTag::alive;
+                  this_i1(index_first + p) += shift_in_x1;
+                  this_i2(index_first + p) += shift_in_x2;
+                });
+            } else if constexpr (D == Dim::_3D) {
+              int shift_in_x1 { 0 }, shift_in_x2 { 0 }, shift_in_x3 { 0 };
+              if ((-direction)[0] == -1) {
+                shift_in_x1 = -subdomain(recv_ind).mesh.n_active(in::x1);
+              } else if ((-direction)[0] == 1) {
+                shift_in_x1 = domain.mesh.n_active(in::x1);
+              }
+              if ((-direction)[1] == -1) {
+                shift_in_x2 = -subdomain(recv_ind).mesh.n_active(in::x2);
+              } else if ((-direction)[1] == 1) {
+                shift_in_x2 = domain.mesh.n_active(in::x2);
+              }
+              if ((-direction)[2] == -1) {
+                shift_in_x3 = -subdomain(recv_ind).mesh.n_active(in::x3);
+              } else if ((-direction)[2] == 1) {
+                shift_in_x3 = domain.mesh.n_active(in::x3);
+              }
+              auto& this_tag = species.tag;
+              auto& this_i1  = species.i1;
+              auto& this_i2  = species.i2;
+              auto& this_i3  = species.i3;
+              Kokkos::parallel_for(
+                "CommunicateParticles",
+                recv_count,
+                Lambda(index_t p) {
+                  this_tag(index_first + p)  = ParticleTag::alive;
+                  this_i1(index_first + p) += shift_in_x1;
+                  this_i2(index_first + p) += shift_in_x2;
+                  this_i3(index_first + p) += shift_in_x3;
+                });
             }
-            auto& this_tag     = species.tag;
-            auto& this_i1      = species.i1;
-            auto& this_i2      = species.i2;
-            auto& this_i3      = species.i3;
-            auto& this_i1_prev = species.i1_prev;
-            auto& this_i2_prev = species.i2_prev;
-            auto& this_i3_prev = species.i3_prev;
-            Kokkos::parallel_for(
-              "CommunicateParticles",
-              recv_count,
-              Lambda(index_t p) {
-                this_tag(index_last + p)      = ParticleTag::alive;
-                this_i1(index_last + p)      += shift_in_x1;
-                this_i2(index_last + p)      += shift_in_x2;
-                this_i3(index_last + p)      += shift_in_x3;
-                this_i1_prev(index_last + p) += shift_in_x1;
-                this_i2_prev(index_last + p) += shift_in_x2;
-                this_i3_prev(index_last + p) += shift_in_x3;
-              });
           }
-          index_last += recv_count;
-          species.set_npart(index_last);
         }
-
-        Kokkos::deep_copy(
-          Kokkos::subview(species.tag, std::make_pair(send_pmin, send_pmax)),
-          ParticleTag::dead);
+        species.set_npart(index_last);
+      }
+      // sent particles are only marked dead once all the copies are done
+      for (auto l { 0u }; l < nlocal; ++l) {
+        auto& species = g_subdomains[g_local_subdomain_indices[l]].species[s];
+        for (const auto& send_slice : plans[l].send_slices) {
+          if (send_slice.second > send_slice.first) {
+            Kokkos::deep_copy(Kokkos::subview(species.tag, send_slice),
+                              ParticleTag::dead);
+          }
+        }
       }
       timers->stop("Communications");
-      // !TODO: maybe there is a way to not sort twice
+      // cheap: the received particles fill the holes left by the sent ones
       timers->start("Sorting");
-      species.set_unsorted();
-      species.SortByTags();
+      for (auto l { 0u }; l < nlocal; ++l) {
+        auto& species = g_subdomains[g_local_subdomain_indices[l]].species[s];
+        species.set_unsorted();
+        species.SortByTags();
+        species.ShrinkToFit();
+      }
       timers->stop("Sorting");
-#endif
     }
   }
 
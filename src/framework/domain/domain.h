@@ -51,6 +51,7 @@
 #include "framework/containers/species.h"
 #include "framework/domain/mesh.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <map>
 #include <string>
@@ -65,6 +66,8 @@ namespace ntt {
     Mesh<M>                                 mesh;
     Fields<D, S>                            fields;
     std::vector<Particles<D, M::CoordType>> species;
+    // coordinates before the push (shared by all the species)
+    ParticlesPrev<D>                        prtl_prev;
     random_number_pool_t random_pool { constant::RandomSeed };
 
     /**
@@ -97,7 +100,13 @@ namespace ntt {
       , species { species_params.begin(), species_params.end() }
       , m_index { index }
       , m_offset_ndomains { offset_ndomains }
-      , m_offset_ncells { offset_ncells } {}
+      , m_offset_ncells { offset_ncells } {
+      std::size_t maxnpart { 0 };
+      for (const auto& sp : species_params) {
+        maxnpart = std::max(maxnpart, sp.maxnpart());
+      }
+      prtl_prev.reserve(maxnpart);
+    }
 
 #if defined(MPI_ENABLED)
     [[nodiscard]]
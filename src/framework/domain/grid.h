@@ -130,6 +130,18 @@ namespace ntt {
       return m_resolution;
     }
 
+    /**
+     * @brief Total number of active cells
+     */
+    [[nodiscard]]
+    auto num_active() const -> std::size_t {
+      std::size_t ncells = 1;
+      for (const auto& n : m_resolution) {
+        ncells *= n;
+      }
+      return ncells;
+    }
+
     [[nodiscard]]
     auto n_all(in i) const -> std::size_t {
       switch (i) {
@@ -0,0 +1,581 @@
+#include "enums.h"
+#include "global.h"
+
+#include "arch/kokkos_aliases.h"
+#include "utils/error.h"
+#include "utils/formatting.h"
+#include "utils/log.h"
+#include "utils/numeric.h"
+#include "utils/sorting.h"
+#include "utils/tools.h"
+
+#include "metrics/kerr_schild.h"
+#include "metrics/kerr_schild_0.h"
+#include "metrics/minkowski.h"
+#include "metrics/qkerr_schild.h"
+#include "metrics/qspherical.h"
+#include "metrics/spherical.h"
+
+#include "framework/containers/particles.h"
+#include "framework/domain/domain.h"
+#include "framework/domain/metadomain.h"
+#include "framework/parameters.h"
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_Sort.hpp>
+
+#if defined(MPI_ENABLED)
+  #include "arch/mpi_aliases.h"
+
+  #include <mpi.h>
+#endif // MPI_ENABLED
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace ntt {
+
+#if defined(MPI_ENABLED)
+  namespace {
+    /**
+     * @brief Region of the global grid owned by a domain (in cells)
+     * @note Ghost cells are included at the edges of the global grid
+     */
+    struct CellBox {
+      std::vector<long int> lo, hi, offset;
+    };
+
+    template <SimEngine::type S, class M>
+    auto CellBoxes(const std::vector<Domain<S, M>>& domains,
+                   const std::vector<std::size_t>&  glob_ncells)
+      -> std::vector<CellBox> {
+      std::vector<CellBox> boxes;
+      for (const auto& domain : domains) {
+        CellBox box;
+        for (auto d { 0u }; d < (unsigned int)(M::Dim); ++d) {
+          const auto offset = (long int)(domain.offset_ncells()[d]);
+          const auto ncells = (long int)(domain.mesh.n_active()[d]);
+          box.offset.push_back(offset);
+          box.lo.push_back(offset - ((offset == 0) ? (long int)N_GHOSTS : 0));
+          box.hi.push_back(offset + ncells +
+                           ((offset + ncells == (long int)glob_ncells[d])
+                              ? (long int)N_GHOSTS
+                              : 0));
+        }
+        boxes.push_back(box);
+      }
+      return boxes;
+    }
+
+    /**
+     * @brief Slice of the local field array corresponding to the overlap of
+     * two boxes (empty if the boxes do not overlap)
+     */
+    auto OverlapSlice(const CellBox& a, const CellBox& b, const CellBox& local)
+      -> std::vector<range_tuple_t> {
+      std::vector<range_tuple_t> slice;
+      for (std::size_t d { 0 }; d < a.lo.size(); ++d) {
+        const auto lo = std::max(a.lo[d], b.lo[d]);
+        const auto hi = std::min(a.hi[d], b.hi[d]);
+        if (lo >= hi) {
+          return {};
+        }
+        slice.emplace_back(lo - local.offset[d] + N_GHOSTS,
+                           hi - local.offset[d] + N_GHOSTS);
+      }
+      return slice;
+    }
+
+    template <Dimension D, int N>
+    auto FieldSlice(const ndfield_t<D, N>&            fld,
+                    const std::vector<range_tuple_t>& slice) {
+      if constexpr (D == Dim::_1D) {
+        return Kokkos::subview(fld, slice[0], Kokkos::ALL);
+      } else if constexpr (D == Dim::_2D) {
+        return Kokkos::subview(fld, slice[0], slice[1], Kokkos::ALL);
+      } else if constexpr (D == Dim::_3D) {
+        return Kokkos::subview(fld, slice[0], slice[1], slice[2], Kokkos::ALL);
+      }
+    }
+
+    /**
+     * @brief Copies the field from the old to the new decomposition
+     * @note Each rank sends the overlaps of its old domain with all the new
+     * domains, and receives the overlaps of its new domain with all the old ones
+     */
+    template <Dimension D, int N>
+    void MigrateField(int                         rank,
+                      const std::vector<CellBox>& old_boxes,
+                      const std::vector<CellBox>& new_boxes,
+                      const ndfield_t<D, N>&      old_fld,
+                      ndfield_t<D, N>&            new_fld,
+                      int                         tag) {
+      const auto                    nboxes = old_boxes.size();
+      const auto                    comps  = range_tuple_t(0, N);
+      std::vector<array_t<real_t*>> send_buffers(nboxes), recv_buffers(nboxes);
+      std::vector<std::vector<range_tuple_t>> recv_slices(nboxes);
+      std::vector<MPI_Request>                requests;
+      for (auto r { 0u }; r < nboxes; ++r) {
+        if ((int)r == rank) {
+          const auto old_slice = OverlapSlice(old_boxes[r],
+                                              new_boxes[r],
+                                              old_boxes[r]);
+          if (not old_slice.empty()) {
+            Kokkos::deep_copy(
+              FieldSlice<D, N>(new_fld,
+                               OverlapSlice(old_boxes[r], new_boxes[r], new_boxes[r])),
+              FieldSlice<D, N>(old_fld, old_slice));
+          }
+          continue;
+        }
+        recv_slices[r] = OverlapSlice(old_boxes[r], new_boxes[rank], new_boxes[rank]);
+        if (not recv_slices[r].empty()) {
+          const auto recv_fld = comm::FieldBuffer<D>(recv_buffers[r],
+                                                     recv_slices[r],
+                                                     comps,
+                                                     "migrate_recv");
+          requests.emplace_back();
+          MPI_Irecv(recv_fld.data(),
+                    recv_fld.size(),
+                    mpi::get_type<real_t>(),
+                    r,
+                    tag,
+                    MPI_COMM_WORLD,
+                    &requests.back());
+        }
+        const auto send_slice = OverlapSlice(old_boxes[rank],
+                                             new_boxes[r],
+                                             old_boxes[rank]);
+        if (not send_slice.empty()) {
+          const auto send_fld = comm::FieldBuffer<D>(send_buffers[r],
+                                                     send_slice,
+                                                     comps,
+                                                     "migrate_send");
+          Kokkos::deep_copy(send_fld, FieldSlice<D, N>(old_fld, send_slice));
+          requests.emplace_back();
+          MPI_Isend(send_fld.data(),
+                    send_fld.size(),
+                    mpi::get_type<real_t>(),
+                    r,
+                    tag,
+                    MPI_COMM_WORLD,
+                    &requests.back());
+        }
+      }
+      MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+      for (auto r { 0u }; r < nboxes; ++r) {
+        if (not recv_slices[r].empty()) {
+          Kokkos::deep_copy(FieldSlice<D, N>(new_fld, recv_slices[r]),
+                            comm::FieldBuffer<D>(recv_buffers[r],
+                                                 recv_slices[r],
+                                                 comps,
+                                                 "migrate_recv"));
+        }
+      }
+    }
+
+    /**
+     * @brief Moves the alive particles to their new domains
+     * @param owner index of the new slab for each global cell (per dimension)
+     */
+    template <Dimension D, Coord::type C>
+    void MigrateParticles(int                               rank,
+                          const std::vector<CellBox>&       old_boxes,
+                          const std::vector<CellBox>&       new_boxes,
+                          const std::vector<array_t<int*>>& owner,
+                          const std::vector<unsigned int>&  ndomains_per_dim,
+                          Particles<D, C>&                  old_species,
+                          Particles<D, C>&                  new_species,
+                          std::vector<array_t<char*>>&      send_buffers,
+                          std::vector<array_t<char*>>&      recv_buffers) {
+      const auto ndomains = old_boxes.size();
+      send_buffers.resize(ndomains);
+      recv_buffers.resize(ndomains);
+
+      // the target domain of each particle (dead ones go to the last bin)
+      std::vector<std::size_t> send_counts(ndomains, 0), recv_counts(ndomains, 0);
+      const auto               npart = old_species.npart();
+      if (npart > 0) {
+        using KeyType = array_t<int*>;
+        using BinOp   = sort::BinIndex<KeyType>;
+        KeyType    keys { "migrate_keys", npart };
+        const auto slice = range_tuple_t(0, npart);
+
+        const int  n1       = (int)ndomains_per_dim[0];
+        const int  n2       = (D == Dim::_1D) ? 1 : (int)ndomains_per_dim[1];
+        const long off1     = old_boxes[rank].offset[0];
+        const long off2     = (D == Dim::_1D) ? 0 : old_boxes[rank].offset[1];
+        const long off3     = (D == Dim::_3D) ? old_boxes[rank].offset[2] : 0;
+        const auto owner1   = owner[0];
+        const auto owner2   = (D == Dim::_1D) ? owner[0] : owner[1];
+        const auto owner3   = (D == Dim::_3D) ? owner[2] : owner[0];
+        const int  ndoms    = (int)ndomains;
+        const auto this_i1  = old_species.i1;
+        const auto this_i2  = old_species.i2;
+        const auto this_i3  = old_species.i3;
+        const auto this_tag = old_species.tag;
+        const int  nglob1   = (int)owner1.extent(0);
+        const int  nglob2   = (int)owner2.extent(0);
+        const int  nglob3   = (int)owner3.extent(0);
+        Kokkos::parallel_for(
+          "MigrateKeys",
+          npart,
+          Lambda(index_t p) {
+            if (this_tag(p) != ParticleTag::alive) {
+              keys(p) = ndoms;
+              return;
+            }
+            int k = owner1(IMIN(IMAX((int)(this_i1(p) + off1), 0), nglob1 - 1));
+            if constexpr (D == Dim::_2D || D == Dim::_3D) {
+              k += n1 *
+                   owner2(IMIN(IMAX((int)(this_i2(p) + off2), 0), nglob2 - 1));
+            }
+            if constexpr (D == Dim::_3D) {
+              k += n1 * n2 *
+                   owner3(IMIN(IMAX((int)(this_i3(p) + off3), 0), nglob3 - 1));
+            }
+            keys(p) = k;
+          });
+
+        BinOp bin_op(ndoms + 1);
+        Kokkos::BinSort<KeyType, BinOp> Sorter(keys, bin_op, false);
+        Sorter.create_permute_vector();
+        comm::ForEachCommunicatedArray(
+          [&](auto& arr) {
+            Sorter.sort(Kokkos::subview(arr, slice));
+          },
+          old_species);
+        auto bin_count = Kokkos::create_mirror_view(Sorter.get_bin_count());
+        Kokkos::deep_copy(bin_count, Sorter.get_bin_count());
+        for (auto r { 0u }; r < ndomains; ++r) {
+          send_counts[r] = bin_count(r);
+        }
+      }
+
+      // indices are shifted to the frame of the new domain before sending
+      std::vector<range_tuple_t> send_slices(ndomains);
+      std::size_t                offset { 0 };
+      for (auto r { 0u }; r < ndomains; ++r) {
+        send_slices[r] = { offset, offset + send_counts[r] };
+        offset        += send_counts[r];
+        if (send_counts[r] == 0) {
+          continue;
+        }
+        const int  shift1 = (int)(old_boxes[rank].offset[0] - new_boxes[r].offset[0]);
+        const int  shift2 = (D == Dim::_1D)
+                              ? 0
+                              : (int)(old_boxes[rank].offset[1] -
+                                      new_boxes[r].offset[1]);
+        const int  shift3 = (D == Dim::_3D)
+                              ? (int)(old_boxes[rank].offset[2] -
+                                      new_boxes[r].offset[2])
+                              : 0;
+        const auto i1     = old_species.i1;
+        const auto i2     = old_species.i2;
+        const auto i3     = old_species.i3;
+        Kokkos::parallel_for(
+          "MigrateShift",
+          Kokkos::RangePolicy<AccelExeSpace>(send_slices[r].first,
+                                             send_slices[r].second),
+          Lambda(index_t p) {
+            i1(p) += shift1;
+            if constexpr (D == Dim::_2D || D == Dim::_3D) {
+              i2(p) += shift2;
+            }
+            if constexpr (D == Dim::_3D) {
+              i3(p) += shift3;
+            }
+          });
+      }
+
+      MPI_Alltoall(send_counts.data(),
+                   1,
+                   mpi::get_type<std::size_t>(),
+                   recv_counts.data(),
+                   1,
+                   mpi::get_type<std::size_t>(),
+                   MPI_COMM_WORLD);
+      std::size_t recv_total { 0 };
+      for (const auto& n : recv_counts) {
+        recv_total += n;
+      }
+      new_species.Reserve(recv_total);
+      raise::FatalIf(recv_total > new_species.maxnpart(),
+                     "Too many particles to receive (cannot fit into maxptl)",
+                     HERE);
+
+      const auto               prtl_size = comm::PackedParticleSize(old_species);
+      std::vector<MPI_Request> requests;
+      for (auto r { 0u }; r < ndomains; ++r) {
+        if (((int)r != rank) and (recv_counts[r] > 0)) {
+          comm::ReserveBuffer(recv_buffers[r],
+                              recv_counts[r] * prtl_size,
+                              "prtl_recv_buff");
+          requests.emplace_back();
+          MPI_Irecv(recv_buffers[r].data(),
+                    (int)(recv_counts[r] * prtl_size),
+                    MPI_BYTE,
+                    r,
+                    0,
+                    MPI_COMM_WORLD,
+                    &requests.back());
+        }
+      }
+      for (auto r { 0u }; r < ndomains; ++r) {
+        if (send_counts[r] > 0) {
+          auto& buffer = ((int)r == rank) ? recv_buffers[r] : send_buffers[r];
+          comm::ReserveBuffer(buffer, send_counts[r] * prtl_size, "prtl_send_buff");
+          comm::PackParticles(old_species, send_slices[r], buffer);
+          if ((int)r != rank) {
+            requests.emplace_back();
+            MPI_Isend(buffer.data(),
+                      (int)(send_counts[r] * prtl_size),
+                      MPI_BYTE,
+                      r,
+                      0,
+                      MPI_COMM_WORLD,
+                      &requests.back());
+          }
+        }
+      }
+      MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+      // received particles are placed in the order of the sender ranks
+      std::size_t index_last { 0 };
+      for (auto r { 0u }; r < ndomains; ++r) {
+        if (recv_counts[r] > 0) {
+          comm::UnpackParticles(new_species,
+                                { index_last, index_last + recv_counts[r] },
+                                recv_buffers[r]);
+          index_last += recv_counts[r];
+        }
+      }
+      const auto this_tag = new_species.tag;
+      Kokkos::parallel_for(
+        "MigrateTags",
+        index_last,
+        Lambda(index_t p) { this_tag(p) = ParticleTag::alive; });
+      new_species.set_npart(index_last);
+      new_species.set_unsorted();
+    }
+  } // namespace
+#endif // MPI_ENABLED
+
+  template <SimEngine::type S, class M>
+  auto Metadomain<S, M>::Rebalance(const SimulationParams& params) -> bool {
+#if !defined(MPI_ENABLED)
+    (void)params;
+    return false;
+#else
+    if (g_ndomains == 1) {
+      return false;
+    }
+    raise::ErrorIf(
+      local_subdomain_indices().size() != 1,
+      "Load balancing for now is only supported for one subdomain per rank",
+      HERE);
+    const auto cell_weight = (double)(params.template get<real_t>(
+      "simulation.domain.load_balancing.cell_weight"));
+    const auto threshold = (double)(params.template get<real_t>(
+      "simulation.domain.load_balancing.threshold"));
+
+    const auto  local_idx    = local_subdomain_indices()[0];
+    auto&       local_domain = g_subdomains[local_idx];
+    const auto  glob_ncells  = g_mesh.n_active();
+    const auto  loc_ncells   = local_domain.mesh.n_active();
+    const auto  loc_offset   = local_domain.offset_ncells();
+    std::size_t loc_ncells_tot { 1 };
+    for (const auto& n : loc_ncells) {
+      loc_ncells_tot *= n;
+    }
+
+    // cost profile of the grid along each of the dimensions
+    std::vector<std::vector<double>> cost;
+    for (auto d { 0u }; d < (unsigned int)D; ++d) {
+      cost.emplace_back(glob_ncells[d], 0.0);
+      for (std::size_t i { 0 }; i < loc_ncells[d]; ++i) {
+        cost[d][loc_offset[d] + i] = cell_weight *
+                                     (double)(loc_ncells_tot / loc_ncells[d]);
+      }
+    }
+    double loc_cost = cell_weight * (double)loc_ncells_tot;
+    for (auto& species : local_domain.species) {
+      if (species.npart() == 0) {
+        continue;
+      }
+      const auto this_tag = species.tag;
+      for (auto d { 0u }; d < (unsigned int)D; ++d) {
+        const auto            i_d  = (d == 0) ? species.i1
+                                              : ((d == 1) ? species.i2 : species.i3);
+        const int             n_d  = (int)loc_ncells[d];
+        array_t<std::size_t*> hist { "prtl_hist", loc_ncells[d] };
+        Kokkos::parallel_for(
+          "LoadBalancingCost",
+          species.npart(),
+          Lambda(index_t p) {
+            if (this_tag(p) == ParticleTag::alive) {
+              Kokkos::atomic_increment(&hist(IMIN(IMAX(i_d(p), 0), n_d - 1)));
+            }
+          });
+        auto hist_h = Kokkos::create_mirror_view(hist);
+        Kokkos::deep_copy(hist_h, hist);
+        for (std::size_t i { 0 }; i < loc_ncells[d]; ++i) {
+          cost[d][loc_offset[d] + i] += (double)hist_h(i);
+          if (d == 0) {
+            loc_cost += (double)hist_h(i);
+          }
+        }
+      }
+    }
+
+    double max_cost { loc_cost }, tot_cost { loc_cost };
+    MPI_Allreduce(MPI_IN_PLACE, &max_cost, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    MPI_Allreduce(MPI_IN_PLACE, &tot_cost, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    const auto imbalance = (tot_cost > 0.0)
+                             ? max_cost * (double)g_ndomains / tot_cost
+                             : 1.0;
+    if (imbalance <= threshold) {
+      return false;
+    }
+    auto d_ncells = std::vector<std::vector<std::size_t>> {};
+    for (auto d { 0u }; d < (unsigned int)D; ++d) {
+      MPI_Allreduce(MPI_IN_PLACE,
+                    cost[d].data(),
+                    (int)cost[d].size(),
+                    MPI_DOUBLE,
+                    MPI_SUM,
+                    MPI_COMM_WORLD);
+      d_ncells.push_back(tools::decompose1DWeighted(g_ndomains_per_dim[d], cost[d]));
+    }
+    if (d_ncells == g_domain_ncells) {
+      return false;
+    }
+    logger::Checkpoint(fmt::format("Rebalancing domains (imbalance: %.2f)", imbalance),
+                       HERE);
+
+    /* redecompose & migrate ---------------------------------------------- */
+    const auto old_boxes      = CellBoxes(g_subdomains, glob_ncells);
+    auto       old_subdomains = std::move(g_subdomains);
+    g_subdomains.clear();
+    redecompose(d_ncells);
+    const auto new_boxes  = CellBoxes(g_subdomains, glob_ncells);
+    auto&      old_domain = old_subdomains[local_idx];
+    auto&      new_domain = g_subdomains[local_subdomain_indices()[0]];
+
+    MigrateField<M::Dim, 6>(g_mpi_rank,
+                            old_boxes,
+                            new_boxes,
+                            old_domain.fields.em,
+                            new_domain.fields.em,
+                            0);
+    if constexpr (S == SimEngine::GRPIC) {
+      MigrateField<M::Dim, 6>(g_mpi_rank,
+                              old_boxes,
+                              new_boxes,
+                              old_domain.fields.em0,
+                              new_domain.fields.em0,
+                              1);
+    }
+    // accumulated field diagnostics
+    new_domain.fields.allocateAccumulators(old_domain.fields.acc.size());
+    for (std::size_t a { 0 }; a < old_domain.fields.acc.size(); ++a) {
+      MigrateField<M::Dim, 3>(g_mpi_rank,
+                              old_boxes,
+                              new_boxes,
+                              old_domain.fields.acc[a],
+                              new_domain.fields.acc[a],
+                              2 + (int)a);
+    }
+
+    // index of the new slab for each of the global cells
+    std::vector<array_t<int*>> owner;
+    for (auto d { 0u }; d < (unsigned int)D; ++d) {
+      owner.emplace_back("slab_owner", glob_ncells[d]);
+      auto        owner_h = Kokkos::create_mirror_view(owner.back());
+      std::size_t i { 0 };
+      for (auto k { 0u }; k < d_ncells[d].size(); ++k) {
+        for (std::size_t c { 0 }; c < d_ncells[d][k]; ++c) {
+          owner_h(i++) = (int)k;
+        }
+      }
+      Kokkos::deep_copy(owner.back(), owner_h);
+    }
+    for (std::size_t s { 0 }; s < old_domain.species.size(); ++s) {
+      MigrateParticles<M::Dim, M::CoordType>(g_mpi_rank,
+                                             old_boxes,
+                                             new_boxes,
+                                             owner,
+                                             g_ndomains_per_dim,
+                                             old_domain.species[s],
+                                             new_domain.species[s],
+                                             g_prtl_send_buffers,
+                                             g_prtl_recv_buffers);
+      // IDs keep being counted from where the old domain stopped
+      new_domain.species[s].set_next_id(old_domain.species[s].next_id());
+    }
+    new_domain.random_pool = old_domain.random_pool;
+    old_subdomains.clear();
+
+    // ghost cells between the domains
+    if constexpr (S == SimEngine::GRPIC) {
+      CommunicateFields(Comm::D | Comm::B | Comm::D0 | Comm::B0);
+    } else {
+      CommunicateFields(Comm::E | Comm::B);
+    }
+  #if defined(OUTPUT_ENABLED)
+    updateOutputLayouts(params);
+  #endif
+    return true;
+#endif // MPI_ENABLED
+  }
+
+#if defined(OUTPUT_ENABLED)
+  template <SimEngine::type S, class M>
+  void Metadomain<S, M>::updateOutputLayouts(const SimulationParams& params) {
+    auto local_domain = subdomain_ptr(local_subdomain_indices()[0]);
+
+    selectOutputLayout(*local_domain,
+                       params.template get<bool>("output.debug.ghosts"));
+
+    if (g_checkpoint_writer.enabled()) {
+      auto glob_shape  = mesh().n_active();
+      auto ckpt_corner = local_domain->offset_ncells();
+      auto ckpt_shape  = local_domain->mesh.n_active();
+      for (auto d { 0 }; d < M::Dim; ++d) {
+        glob_shape[d]  += 2 * N_GHOSTS * ndomains_per_dim()[d];
+        ckpt_corner[d] += 2 * N_GHOSTS * local_domain->offset_ndomains()[d];
+        ckpt_shape[d]  += 2 * N_GHOSTS;
+      }
+      g_checkpoint_writer.updateFieldVariable("em",
+                                              glob_shape,
+                                              ckpt_corner,
+                                              ckpt_shape,
+                                              6);
+      g_checkpoint_writer.updateFieldVariable("cur",
+                                              glob_shape,
+                                              ckpt_corner,
+                                              ckpt_shape,
+                                              3);
+      if constexpr (S == SimEngine::GRPIC) {
+        g_checkpoint_writer.updateFieldVariable("em0",
+                                                glob_shape,
+                                                ckpt_corner,
+                                                ckpt_shape,
+                                                6);
+      }
+    }
+  }
+#endif // OUTPUT_ENABLED
+
+  template struct Metadomain<SimEngine::SRPIC, metric::Minkowski<Dim::_1D>>;
+  template struct Metadomain<SimEngine::SRPIC, metric::Minkowski<Dim::_2D>>;
+  template struct Metadomain<SimEngine::SRPIC, metric::Minkowski<Dim::_3D>>;
+  template struct Metadomain<SimEngine::SRPIC, metric::Spherical<Dim::_2D>>;
+  template struct Metadomain<SimEngine::SRPIC, metric::QSpherical<Dim::_2D>>;
+  template struct Metadomain<SimEngine::GRPIC, metric::KerrSchild<Dim::_2D>>;
+  template struct Metadomain<SimEngine::GRPIC, metric::QKerrSchild<Dim::_2D>>;
+  template struct Metadomain<SimEngine::GRPIC, metric::KerrSchild0<Dim::_2D>>;
+
+} // namespace ntt
@@ -90,26 +90,26 @@ namespace ntt {
     raise::ErrorIf((status != MPI_SUCCESS) || (init_flag != 1),
                    "MPI not initialized",
                    HERE);
-    raise::ErrorIf((unsigned int)g_mpi_size != g_ndomains,
-                   "ndomains != g_mpi_size is not implemented with MPI",
+    raise::ErrorIf((unsigned int)g_mpi_size > g_ndomains,
+                   "ndomains cannot be smaller than the number of MPI ranks",
                    HERE);
-
-#else // not MPI_ENABLED
-  #if !defined(DEBUG)
-    raise::ErrorIf(g_ndomains != 1,
-                   "ndomains > 1 is not implemented for non-DEBUG purposes",
-                   HERE);
-  #endif
 #endif // MPI_ENABLED
   }
 
   template <SimEngine::type S, class M>
-  void Metadomain<S, M>::createEmptyDomains() {
+  void Metadomain<S, M>::createEmptyDomains(
+    const std::vector<std::vector<std::size_t>>& domain_ncells_per_dim) {
     /* decompose and compute cell & domain offsets ------------------------ */
-    auto d_ncells = tools::Decompose(g_ndomains, g_mesh.n_active(), g_decomposition);
+    auto d_ncells = domain_ncells_per_dim.empty()
+                      ? tools::Decompose(g_ndomains, g_mesh.n_active(), g_decomposition)
+                      : domain_ncells_per_dim;
     raise::ErrorIf(d_ncells.size() != (std::size_t)D,
                    "Invalid number of dimensions received",
                    HERE);
+    g_domain_ncells = d_ncells;
+    g_ndomains_per_dim.clear();
+    g_local_subdomain_indices.clear();
+    g_domain_offset2index.clear();
     auto d_offset_ncells = std::vector<std::vector<std::size_t>> {};
     auto d_offset_ndoms  = std::vector<std::vector<unsigned int>> {};
     for (auto& d : d_ncells) {
@@ -159,9 +159,10 @@ namespace ntt {
       }
 
 #if defined(MPI_ENABLED)
-      // !TODO: need to change to support multiple domains per rank
-      // assuming ONE local subdomain
-      const auto local = ((int)idx == g_mpi_rank);
+      // each rank holds a contiguous block of domains
+      const auto rank  = (int)(((std::size_t)idx * (std::size_t)g_mpi_size) /
+                              g_ndomains);
+      const auto local = (rank == g_mpi_rank);
       if (not local) {
         g_subdomains.emplace_back(false,
                                   idx,
@@ -180,7 +181,7 @@ namespace ntt {
                                   g_metric_params,
                                   g_species_params);
       }
-      g_subdomains.back().set_mpi_rank(idx);
+      g_subdomains.back().set_mpi_rank(rank);
       if (g_subdomains.back().mpi_rank() == g_mpi_rank) {
         g_local_subdomain_indices.push_back(idx);
       }
@@ -198,6 +199,23 @@ namespace ntt {
     }
   }
 
+  template <SimEngine::type S, class M>
+  void Metadomain<S, M>::redecompose(
+    const std::vector<std::vector<std::size_t>>& d_ncells) {
+    raise::ErrorIf(d_ncells.size() != (std::size_t)D,
+                   "Invalid number of dimensions in the decomposition",
+                   HERE);
+    for (auto d { 0u }; d < (unsigned int)D; ++d) {
+      raise::ErrorIf(d_ncells[d].size() != g_ndomains_per_dim[d],
+                     "Number of domains cannot change upon redecomposition",
+                     HERE);
+    }
+    createEmptyDomains(d_ncells);
+    redefineNeighbors();
+    redefineBoundaries();
+    finalValidityCheck();
+  }
+
   template <SimEngine::type S, class M>
   void Metadomain<S, M>::redefineNeighbors() {
     for (unsigned int idx { 0 }; idx < g_ndomains; ++idx) {
@@ -388,7 +406,7 @@ namespace ntt {
         " " + std::to_string(dx_min_from_domains),
       HERE);
 #if defined(MPI_ENABLED)
-    auto dx_mins        = std::vector<real_t>(g_ndomains);
+    auto dx_mins        = std::vector<real_t>(g_mpi_size);
     dx_mins[g_mpi_rank] = dx_min;
     MPI_Allgather(&dx_min,
                   1,
@@ -405,6 +423,23 @@ namespace ntt {
 #endif
   }
 
+  template <SimEngine::type S, class M>
+  auto Metadomain<S, M>::local_position(unsigned int idx) const -> unsigned int {
+    raise::ErrorIf(idx >= g_subdomains.size(), "local_position() failed", HERE);
+    unsigned int position { 0 };
+#if defined(MPI_ENABLED)
+    // domains of each rank are contiguous
+    const auto rank = g_subdomains[idx].mpi_rank();
+    while ((position < idx) and
+           (g_subdomains[idx - position - 1].mpi_rank() == rank)) {
+      ++position;
+    }
+#else
+    position = idx;
+#endif
+    return position;
+  }
+
   template struct Metadomain<SimEngine::SRPIC, metric::Minkowski<Dim::_1D>>;
   template struct Metadomain<SimEngine::SRPIC, metric::Minkowski<Dim::_2D>>;
   template struct Metadomain<SimEngine::SRPIC, metric::Minkowski<Dim::_3D>>;
@@ -5,6 +5,10 @@
  *   - ntt::Metadomain<>
  * @cpp:
  *   - metadomain.cpp
+ *   - communications.cpp
+ *   - output.cpp
+ *   - checkpoint.cpp
+ *   - load_balancing.cpp
  * @namespaces:
  *   - ntt::
  * @macros:
@@ -18,6 +22,7 @@
 #include "enums.h"
 #include "global.h"
 
+#include "arch/directions.h"
 #include "arch/kokkos_aliases.h"
 #include "utils/timer.h"
 
@@ -27,10 +32,15 @@
 #include "framework/parameters.h"
 
 #if defined(MPI_ENABLED)
+  #include "framework/domain/comm_mpi.hpp"
+
   #include <mpi.h>
+#else
+  #include "framework/domain/comm_nompi.hpp"
 #endif // MPI_ENABLED
 
 #if defined OUTPUT_ENABLED
+  #include "output/checkpoint.h"
   #include "output/writer.h"
 #endif
 
@@ -55,8 +65,10 @@ namespace ntt {
     /**
      * @brief Populates the g_subdomains vector with ...
      * ... domains of proper shape, extent, index, and offset
+     * @param d_ncells number of cells of each domain in each dimension
+     * @note If `d_ncells` is empty, the grid is divided equally
      */
-    void createEmptyDomains();
+    void createEmptyDomains(const std::vector<std::vector<std::size_t>>& = {});
 
     /**
      * @brief Populates the neighbor-pointers of each domain in g_subdomains
@@ -82,9 +94,50 @@ namespace ntt {
       }
     }
 
-    void CommunicateFields(Domain<S, M>&, CommTags);
-    void SynchronizeFields(Domain<S, M>&, CommTags, const range_tuple_t& = { 0, 0 });
-    void CommunicateParticles(Domain<S, M>&, timer::Timers*);
+    /**
+     * @brief Fills the ghost cells of the requested fields of all local domains
+     * @note Exchanges between the domains of the same rank are done by direct
+     * device copies, and all the other ones are done via MPI
+     */
+    void CommunicateFields(CommTags);
+    /**
+     * @brief Non-blocking version of `CommunicateFields`
+     * @note Ghost cells of the requested fields are only valid after the
+     * matching `EndCommunicateFields`; in between, only the cells which are
+     * not being sent or received may be updated
+     */
+    void BeginCommunicateFields(CommTags);
+    void EndCommunicateFields();
+    void SynchronizeFields(CommTags, const range_tuple_t& = { 0, 0 });
+    void CommunicateParticles(timer::Timers*);
+
+    /**
+     * @brief Bytes sent to (first) and received from (second) other ranks in
+     * each direction (ordered as in `dir::Directions<D>::all`) since the last
+     * reset
+     * @note Only the MPI traffic is counted (not the copies within the rank)
+     */
+    [[nodiscard]]
+    auto comm_bytes() const -> const std::vector<std::pair<std::size_t, std::size_t>>& {
+      return g_comm_bytes;
+    }
+
+    void reset_comm_bytes() {
+      for (auto& bytes : g_comm_bytes) {
+        bytes = { 0, 0 };
+      }
+    }
+
+    /**
+     * @brief Redistributes the cells between the domains to even out their cost
+     * @note The cost of each domain is the number of particles plus the number
+     * of cells times `simulation.domain.load_balancing.cell_weight`; the new
+     * decomposition stays rectilinear (slab widths vary in each dimension)
+     * @note Fields and particles are migrated to the new domains, so any
+     * references to the local domains are invalidated
+     * @returns true if the domains have been redistributed
+     */
+    auto Rebalance(const SimulationParams&) -> bool;
 
     /**
      * @param global_ndomains total number of domains
@@ -120,6 +173,28 @@ namespace ntt {
                                   ndfield_t<M::Dim, 6>&,
                                   std::size_t,
                                   const Domain<S, M>&)> = {}) -> bool;
+
+    /**
+     * @brief Samples the accumulated field diagnostics (if it is time to do so)
+     * @note The accumulators are written & reset with the field output
+     */
+    void AccumulateFields(const SimulationParams&, std::size_t);
+
+    /**
+     * @brief Defines the checkpoint variables (does nothing if disabled)
+     */
+    void InitCheckpointWriter(const SimulationParams&);
+    /**
+     * @brief Saves the raw state of the local domains if it is time to do so
+     * @note The random pool is reseeded after each checkpoint
+     */
+    auto WriteCheckpoint(const SimulationParams&, std::size_t, long double) -> bool;
+    /**
+     * @brief Restores the raw state of the local domains from a checkpoint
+     * @returns the timestep and the time of the checkpoint
+     */
+    auto ContinueFromCheckpoint(const SimulationParams&)
+      -> std::pair<std::size_t, long double>;
 #endif
 
     Metadomain(const Metadomain&)            = delete;
@@ -140,6 +215,11 @@ namespace ntt {
       return g_ndomains_per_dim;
     }
 
+    [[nodiscard]]
+    auto domain_ncells() const -> const std::vector<std::vector<std::size_t>>& {
+      return g_domain_ncells;
+    }
+
     [[nodiscard]]
     auto subdomain(unsigned int idx) const -> const Domain<S, M>& {
       raise::ErrorIf(idx >= g_subdomains.size(), "subdomain() failed", HERE);
@@ -168,11 +248,38 @@ namespace ntt {
     }
 
   private:
+    /**
+     * @brief Position of the domain among the domains of the same rank
+     * @note Used to keep the MPI message tags unique
+     */
+    auto local_position(unsigned int) const -> unsigned int;
+
+    /**
+     * @brief Recreates all the (empty) domains with the given decomposition
+     * @param d_ncells number of cells of each domain in each dimension
+     */
+    void redecompose(const std::vector<std::vector<std::size_t>>&);
+
+#if defined(OUTPUT_ENABLED)
+    /**
+     * @brief Updates the local layout of the output after redecomposition
+     */
+    void updateOutputLayouts(const SimulationParams&);
+
+    /**
+     * @brief Selects the block of the output mesh written by the given domain
+     * @param domain local domain
+     * @param incl_ghosts whether the ghost cells are written
+     */
+    void selectOutputLayout(const Domain<S, M>&, bool);
+#endif
+
     // domain information
     unsigned int g_ndomains;
 
     std::vector<int>                                  g_decomposition;
     std::vector<unsigned int>                         g_ndomains_per_dim;
+    std::vector<std::vector<std::size_t>>             g_domain_ncells;
     std::vector<std::vector<unsigned int>>            g_domain_offsets;
     std::map<std::vector<unsigned int>, unsigned int> g_domain_offset2index;
 
@@ -184,11 +291,30 @@ namespace ntt {
     const std::vector<ParticleSpecies>  g_species_params;
 
 #if defined(OUTPUT_ENABLED)
-    out::Writer g_writer;
+    out::Writer           g_writer;
+    out::CheckpointWriter g_checkpoint_writer;
+    // # of samples in the accumulated field diagnostics
+    std::size_t           g_acc_nsamples { 0 };
 #endif
 
+    // state (and persistent buffers) of the field halo exchange
+    comm::FieldExchange g_fld_exchange;
+    // persistent buffers accumulating the synchronized fields (per local domain)
+    std::vector<ndfield_t<M::Dim, 6>> g_bckp_recv;
+    std::vector<ndfield_t<M::Dim, 3>> g_buff_recv;
+
+    // traffic to the other ranks in each direction
+    std::vector<std::pair<std::size_t, std::size_t>> g_comm_bytes =
+      std::vector<std::pair<std::size_t, std::size_t>>(
+        dir::Directions<M::Dim>::all.size(),
+        { 0, 0 });
+
 #if defined(MPI_ENABLED)
     int g_mpi_rank, g_mpi_size;
+
+    // persistent buffers for the particle exchange (one per direction of
+    // ... each local domain)
+    std::vector<array_t<char*>> g_prtl_send_buffers, g_prtl_recv_buffers;
 #endif
   };
 
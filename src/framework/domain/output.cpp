@@ -18,10 +18,17 @@
 #include "framework/domain/metadomain.h"
 #include "framework/parameters.h"
 
+#include "kernels/fields_accumulate.hpp"
 #include "kernels/fields_to_phys.hpp"
 #include "kernels/particle_moments.hpp"
+#include "kernels/prtl_histogram.hpp"
+#include "kernels/prtl_select.hpp"
 #include "kernels/prtls_to_phys.hpp"
 
+#include "output/accumulators.h"
+#include "output/fields.h"
+#include "output/histograms.h"
+
 #include <Kokkos_Core.hpp>
 #include <Kokkos_ScatterView.hpp>
 #include <Kokkos_StdAlgorithms.hpp>
@@ -32,16 +39,17 @@
 
 #include <algorithm>
 #include <iterator>
+#include <map>
+#include <string>
+#include <utility>
 #include <vector>
 
 namespace ntt {
 
   template <SimEngine::type S, class M>
   void Metadomain<S, M>::InitWriter(const SimulationParams& params) {
-    raise::ErrorIf(
-      local_subdomain_indices().size() != 1,
-      "Output for now is only supported for one subdomain per rank",
-      HERE);
+    // the layout is defined by the first local domain (others select their own
+    // blocks when writing)
     auto local_domain = subdomain_ptr(local_subdomain_indices()[0]);
     raise::ErrorIf(local_domain->is_placeholder(),
                    "local_domain is a placeholder",
@@ -61,11 +69,15 @@ namespace ntt {
       }
     }
 
-    g_writer.defineMeshLayout(glob_shape_with_ghosts,
-                              off_ncells_with_ghosts,
-                              loc_shape_with_ghosts,
-                              incl_ghosts,
-                              M::CoordType);
+    g_writer.defineMeshLayout(
+      glob_shape_with_ghosts,
+      off_ncells_with_ghosts,
+      loc_shape_with_ghosts,
+      incl_ghosts,
+      M::CoordType,
+      params.template get<std::vector<unsigned short>>("output.fields.stride"),
+      params.template get<std::string>("output.fields.downsampling") ==
+        "average");
     const auto fields_to_write = params.template get<std::vector<std::string>>(
       "output.fields.quantities");
     const auto custom_fields_to_write = params.template get<std::vector<std::string>>(
@@ -78,15 +90,50 @@ namespace ntt {
                std::back_inserter(all_fields_to_write));
     const auto species_to_write = params.template get<std::vector<unsigned short>>(
       "output.particles.species");
+    for (const auto& type : { "fields", "particles" }) {
+      const auto prefix = "output." + std::string(type) + ".";
+      g_writer.defineCompression(
+        type,
+        params.template get<std::string>(prefix + "compression"),
+        params.template get<real_t>(prefix + "compression_accuracy"),
+        params.template get<unsigned short>(prefix + "compression_precision"));
+    }
+    // IDs are written for the species which track them
+    std::vector<unsigned short> tracked_species {};
+    for (const auto& sp : species_params()) {
+      if (sp.track_ids()) {
+        tracked_species.push_back(sp.index());
+      }
+    }
     g_writer.defineFieldOutputs(S, all_fields_to_write);
-    g_writer.defineParticleOutputs(M::PrtlDim, species_to_write);
+    std::vector<out::OutputAccumulator> accs {};
+    for (const auto& mode : { "mean", "rms", "integral" }) {
+      for (const auto& q : params.template get<std::vector<std::string>>(
+             "output.fields." + std::string(mode))) {
+        accs.emplace_back(q, mode);
+      }
+    }
+    g_writer.defineAccumulatorOutputs(accs);
+    for (const auto& ldidx : local_subdomain_indices()) {
+      subdomain_ptr(ldidx)->fields.allocateAccumulators(accs.size());
+    }
+    g_acc_nsamples = 0;
+    g_writer.defineParticleOutputs(M::PrtlDim, species_to_write, tracked_species);
     // spectra write all particle species
     std::vector<unsigned short> spectra_species {};
     for (const auto& sp : species_params()) {
       spectra_species.push_back(sp.index());
     }
     g_writer.defineSpectraOutputs(spectra_species);
-    for (const auto& type : { "fields", "particles", "spectra" }) {
+    for (const auto& name : params.template get<std::vector<std::string>>(
+           "output.histograms.names")) {
+      const auto prefix = "output.histograms." + name + ".";
+      g_writer.defineHistogramOutputs(
+        name,
+        params.template get<std::vector<unsigned short>>(prefix + "species"),
+        params.template get<std::vector<std::size_t>>(prefix + "n_bins"));
+    }
+    for (const auto& type : { "fields", "particles", "spectra", "histograms" }) {
       g_writer.addTracker(type,
                           params.template get<std::size_t>(
                             "output." + std::string(type) + ".interval"),
@@ -94,22 +141,87 @@ namespace ntt {
                             "output." + std::string(type) + ".interval_time"));
     }
     g_writer.writeAttrs(params);
+
+    if (g_writer.isStreaming()) {
+      g_writer.setEngineParameter(
+        "RendezvousReaderCount",
+        std::to_string(params.template get<unsigned int>("output.stream.readers")));
+      g_writer.setEngineParameter(
+        "QueueLimit",
+        std::to_string(
+          params.template get<unsigned int>("output.stream.queue_limit")));
+      g_writer.setEngineParameter(
+        "QueueFullPolicy",
+        params.template get<std::string>("output.stream.queue_policy") == "block"
+          ? "Block"
+          : "Discard");
+    }
+
+    auto async = params.template get<bool>("output.async");
+#if defined(MPI_ENABLED)
+    int mpi_thread_support;
+    MPI_Query_thread(&mpi_thread_support);
+    if (async and mpi_thread_support < MPI_THREAD_MULTIPLE) {
+      raise::Warning("MPI_THREAD_MULTIPLE is not supported: output is synchronous",
+                     HERE);
+      async = false;
+    }
+#endif // MPI_ENABLED
+    if (async) {
+      g_writer.enableAsync(params.template get<std::size_t>("output.async_depth"));
+    }
   }
 
-  template <SimEngine::type S, class M, FldsID::type F>
-  void ComputeMoments(const SimulationParams& params,
-                      const Mesh<M>&          mesh,
-                      const std::vector<Particles<M::Dim, M::CoordType>>& prtl_species,
-                      const std::vector<unsigned short>& species,
-                      const std::vector<unsigned short>& components,
-                      ndfield_t<M::Dim, 6>&              buffer,
-                      unsigned short                     buff_idx) {
-    std::vector<unsigned short> specs = species;
-    if (specs.size() == 0) {
-      // if no species specified, take all massive species
-      for (auto& sp : prtl_species) {
-        if (sp.mass() > 0) {
-          specs.push_back(sp.index());
+  /**
+   * @brief Computes the moments requested by a group of output fields
+   * @param moments: moment fields & the components of the buffer they go to
+   * @note All the moments are deposited in a single pass over the particles of
+   * each species (the components of the group should fit into the buffer)
+   */
+  template <SimEngine::type S, class M>
+  void ComputeMoments(
+    const SimulationParams&                             params,
+    const Mesh<M>&                                      mesh,
+    const std::vector<Particles<M::Dim, M::CoordType>>& prtl_species,
+    const std::vector<std::pair<const out::OutputField*, std::vector<std::size_t>>>& moments,
+    ndfield_t<M::Dim, 6>& buffer) {
+    // moments to compute for each of the species
+    std::map<unsigned short, std::vector<kernel::moment_slot_t>> slots;
+    for (const auto& [fld, addresses] : moments) {
+      std::vector<unsigned short> specs = fld->species;
+      if (specs.size() == 0) {
+        // if no species specified, take all massive species
+        for (auto& sp : prtl_species) {
+          if (sp.mass() > 0) {
+            specs.push_back(sp.index());
+          }
+        }
+      }
+      kernel::moment_slot_t slot { FldsID::INVALID, 0, 0, 0 };
+      for (const auto& id :
+           { FldsID::T, FldsID::Rho, FldsID::Charge, FldsID::N, FldsID::Nppc }) {
+        if (fld->id() == id) {
+          slot.id = id;
+        }
+      }
+      raise::ErrorIf(slot.id == FldsID::INVALID,
+                     "Wrong moment requested for output",
+                     HERE);
+      raise::ErrorIf((slot.id == FldsID::T) &&
+                       (fld->comp.size() != addresses.size()),
+                     "Wrong # of components requested for T output",
+                     HERE);
+      for (std::size_t i { 0 }; i < addresses.size(); ++i) {
+        slot.buff_idx = static_cast<unsigned short>(addresses[i]);
+        if (slot.id == FldsID::T) {
+          raise::ErrorIf((addresses.size() > 1) && (fld->comp[i].size() != 2),
+                         "Wrong # of components requested for moment",
+                         HERE);
+          slot.c1 = (fld->comp[i].size() == 2) ? fld->comp[i][0] : 0;
+          slot.c2 = (fld->comp[i].size() == 2) ? fld->comp[i][1] : 0;
+        }
+        for (const auto& sp : specs) {
+          slots[sp].push_back(slot);
         }
       }
     }
@@ -122,21 +234,21 @@ namespace ntt {
     const auto window      = params.template get<unsigned short>(
       "output.fields.mom_smooth");
 
-    for (const auto& sp : specs) {
+    for (const auto& [sp, sp_slots] : slots) {
       auto& prtl_spec = prtl_species[sp - 1];
       // clang-format off
       Kokkos::parallel_for(
         "ComputeMoments",
         prtl_spec.rangeActiveParticles(),
-        kernel::ParticleMoments_kernel<S, M, F, 6>(components, scatter_buff, buff_idx,
-                                                   prtl_spec.i1, prtl_spec.i2, prtl_spec.i3,
-                                                   prtl_spec.dx1, prtl_spec.dx2, prtl_spec.dx3,
-                                                   prtl_spec.ux1, prtl_spec.ux2, prtl_spec.ux3,
-                                                   prtl_spec.phi, prtl_spec.weight, prtl_spec.tag,
-                                                   prtl_spec.mass(), prtl_spec.charge(),
-                                                   use_weights,
-                                                   mesh.metric, mesh.flds_bc(),
-                                                   ni2, inv_n0, window));
+        kernel::ParticleMultiMoments_kernel<S, M, 6>(sp_slots, scatter_buff,
+                                                     prtl_spec.i1, prtl_spec.i2, prtl_spec.i3,
+                                                     prtl_spec.dx1, prtl_spec.dx2, prtl_spec.dx3,
+                                                     prtl_spec.ux1, prtl_spec.ux2, prtl_spec.ux3,
+                                                     prtl_spec.phi, prtl_spec.weight, prtl_spec.tag,
+                                                     prtl_spec.mass(), prtl_spec.charge(),
+                                                     use_weights,
+                                                     mesh.metric, mesh.flds_bc(),
+                                                     ni2, inv_n0, window));
       // clang-format on
     }
     Kokkos::Experimental::contribute(buffer, scatter_buff);
@@ -167,6 +279,107 @@ namespace ntt {
     }
   }
 
+  template <SimEngine::type S, class M>
+  void Metadomain<S, M>::AccumulateFields(const SimulationParams& params,
+                                          std::size_t             step) {
+    const auto& accs     = g_writer.accumulatorWriters();
+    const auto  interval = params.template get<std::size_t>(
+      "output.fields.accumulate_interval");
+    if (accs.empty() or (step % interval != 0)) {
+      return;
+    }
+    // time-integrated quantities are weighted by the time between the samples
+    const auto dt_sample = static_cast<real_t>(interval) *
+                           params.template get<real_t>("algorithms.timestep.dt");
+    const auto to_phys_edges = PrepareOutput::InterpToCellCenterFromEdges |
+                               PrepareOutput::ConvertToHat;
+    const auto to_phys_faces = PrepareOutput::InterpToCellCenterFromFaces |
+                               PrepareOutput::ConvertToHat;
+    for (const auto& ldidx : local_subdomain_indices()) {
+      auto        local_domain = subdomain_ptr(ldidx);
+      auto&       fields       = local_domain->fields;
+      const auto& metric       = local_domain->mesh.metric;
+      const auto  range        = local_domain->mesh.rangeActiveCells();
+      // E & B are sampled into bckp(:, 0, 1, 2) & bckp(:, 3, 4, 5), then J into
+      // bckp(:, 0, 1, 2): all are cell-centered & in the physical basis
+      for (const auto electromagnetic : { true, false }) {
+        if (std::none_of(accs.begin(), accs.end(), [&](const auto& acc) {
+              return acc.is_electromagnetic() == electromagnetic;
+            })) {
+          continue;
+        }
+        if (electromagnetic) {
+          list_t<unsigned short, 3> e_from = { em::ex1, em::ex2, em::ex3 };
+          list_t<unsigned short, 3> b_from = { em::bx1, em::bx2, em::bx3 };
+          list_t<unsigned short, 3> e_to   = { 0, 1, 2 };
+          list_t<unsigned short, 3> b_to   = { 3, 4, 5 };
+          Kokkos::parallel_for(
+            "FieldsToPhys",
+            range,
+            kernel::FieldsToPhys_kernel<M, 6, 6>(fields.em,
+                                                 fields.bckp,
+                                                 e_from,
+                                                 e_to,
+                                                 to_phys_edges,
+                                                 metric));
+          Kokkos::parallel_for(
+            "FieldsToPhys",
+            range,
+            kernel::FieldsToPhys_kernel<M, 6, 6>(fields.em,
+                                                 fields.bckp,
+                                                 b_from,
+                                                 b_to,
+                                                 to_phys_faces,
+                                                 metric));
+        } else {
+          list_t<unsigned short, 3> j_from = { cur::jx1, cur::jx2, cur::jx3 };
+          list_t<unsigned short, 3> j_to   = { 0, 1, 2 };
+          Kokkos::parallel_for(
+            "FieldsToPhys",
+            range,
+            kernel::FieldsToPhys_kernel<M, 3, 6>(fields.cur,
+                                                 fields.bckp,
+                                                 j_from,
+                                                 j_to,
+                                                 to_phys_edges,
+                                                 metric));
+        }
+        for (std::size_t a { 0 }; a < accs.size(); ++a) {
+          if (accs[a].is_electromagnetic() != electromagnetic) {
+            continue;
+          }
+          const auto op = (accs[a].mode() == "rms") ? kernel::AccumOp::Square
+                          : (accs[a].quantity() == "S") ? kernel::AccumOp::Cross
+                                                        : kernel::AccumOp::Value;
+          Kokkos::parallel_for(
+            "AccumulateFields",
+            range,
+            kernel::AccumulateFields_kernel<M::Dim>(
+              fields.acc[a],
+              fields.bckp,
+              (accs[a].quantity() == "B") ? 3 : 0,
+              op,
+              (accs[a].mode() == "integral") ? dt_sample : ONE));
+        }
+      }
+    }
+    ++g_acc_nsamples;
+  }
+
+  template <SimEngine::type S, class M>
+  void Metadomain<S, M>::selectOutputLayout(const Domain<S, M>& domain,
+                                            bool                incl_ghosts) {
+    auto off_ncells = domain.offset_ncells();
+    auto loc_shape  = domain.mesh.n_active();
+    if (incl_ghosts) {
+      for (auto d { 0 }; d < M::Dim; ++d) {
+        off_ncells[d] += 2 * N_GHOSTS * domain.offset_ndomains()[d];
+        loc_shape[d]  += 2 * N_GHOSTS;
+      }
+    }
+    g_writer.updateMeshLayout(off_ncells, loc_shape);
+  }
+
   template <SimEngine::type S, class M>
   auto Metadomain<S, M>::Write(
     const SimulationParams& params,
@@ -175,10 +388,6 @@ namespace ntt {
     std::function<
       void(const std::string&, ndfield_t<M::Dim, 6>&, std::size_t, const Domain<S, M>&)>
       CustomFieldOutput) -> bool {
-    raise::ErrorIf(
-      local_subdomain_indices().size() != 1,
-      "Output for now is only supported for one subdomain per rank",
-      HERE);
     const auto write_fields = params.template get<bool>(
                                 "output.fields.enable") and
                               g_writer.shouldWrite("fields", step, time);
@@ -188,13 +397,18 @@ namespace ntt {
     const auto write_spectra = params.template get<bool>(
                                  "output.spectra.enable") and
                                g_writer.shouldWrite("spectra", step, time);
-    if (not(write_fields or write_particles or write_spectra)) {
+    const auto write_histograms = params.template get<bool>(
+                                    "output.histograms.enable") and
+                                  not g_writer.histogramWriters().empty() and
+                                  g_writer.shouldWrite("histograms", step, time);
+    if (not(write_fields or write_particles or write_spectra or write_histograms)) {
       return false;
     }
-    auto local_domain = subdomain_ptr(local_subdomain_indices()[0]);
-    raise::ErrorIf(local_domain->is_placeholder(),
-                   "local_domain is a placeholder",
-                   HERE);
+    for (const auto& ldidx : local_subdomain_indices()) {
+      raise::ErrorIf(subdomain_ptr(ldidx)->is_placeholder(),
+                     "local_domain is a placeholder",
+                     HERE);
+    }
     logger::Checkpoint("Writing output", HERE);
     g_writer.beginWriting(params.template get<std::string>("simulation.name"),
                           step,
@@ -203,145 +417,154 @@ namespace ntt {
     if (write_fields) {
       const auto incl_ghosts = params.template get<bool>("output.debug.ghosts");
 
-      for (unsigned short dim = 0; dim < M::Dim; ++dim) {
-        const auto is_last = local_domain->offset_ncells()[dim] +
-                               local_domain->mesh.n_active()[dim] ==
-                             mesh().n_active()[dim];
-        array_t<real_t*> xc { "Xc",
-                              local_domain->mesh.n_active()[dim] +
-                                (incl_ghosts ? 2 * N_GHOSTS : 0) };
-        array_t<real_t*> xe { "Xe",
-                              local_domain->mesh.n_active()[dim] +
-                                (incl_ghosts ? 2 * N_GHOSTS : 0) +
-                                (is_last ? 1 : 0) };
-        const auto       offset = (incl_ghosts ? N_GHOSTS : 0);
-        const auto       ncells = local_domain->mesh.n_active()[dim];
-        const auto&      metric = local_domain->mesh.metric;
-        Kokkos::parallel_for(
-          "GenerateMesh",
-          ncells,
-          Lambda(index_t i) {
-            const auto      i_ = static_cast<real_t>(i);
-            coord_t<M::Dim> x_Cd { ZERO }, x_Ph { ZERO };
-            x_Cd[dim] = i_ + HALF;
-            metric.template convert<Crd::Cd, Crd::Ph>(x_Cd, x_Ph);
-            xc(offset + i) = x_Ph[dim];
-            x_Cd[dim]      = i_;
-            metric.template convert<Crd::Cd, Crd::Ph>(x_Cd, x_Ph);
-            xe(offset + i) = x_Ph[dim];
-            if (is_last && i == ncells - 1) {
-              x_Cd[dim] = i_ + ONE;
+      // each local domain writes its own block of the mesh
+      for (const auto& ldidx : local_subdomain_indices()) {
+        auto local_domain = subdomain_ptr(ldidx);
+        selectOutputLayout(*local_domain, incl_ghosts);
+        for (unsigned short dim = 0; dim < M::Dim; ++dim) {
+          if (g_writer.writeCachedMesh(dim)) {
+            // the mesh of this block has already been generated
+            continue;
+          }
+          const auto is_last = local_domain->offset_ncells()[dim] +
+                                 local_domain->mesh.n_active()[dim] ==
+                               mesh().n_active()[dim];
+          array_t<real_t*> xc { "Xc",
+                                local_domain->mesh.n_active()[dim] +
+                                  (incl_ghosts ? 2 * N_GHOSTS : 0) };
+          array_t<real_t*> xe { "Xe",
+                                local_domain->mesh.n_active()[dim] +
+                                  (incl_ghosts ? 2 * N_GHOSTS : 0) +
+                                  (is_last ? 1 : 0) };
+          const auto       offset = (incl_ghosts ? N_GHOSTS : 0);
+          const auto       ncells = local_domain->mesh.n_active()[dim];
+          const auto&      metric = local_domain->mesh.metric;
+          Kokkos::parallel_for(
+            "GenerateMesh",
+            ncells,
+            Lambda(index_t i) {
+              const auto      i_ = static_cast<real_t>(i);
+              coord_t<M::Dim> x_Cd { ZERO }, x_Ph { ZERO };
+              x_Cd[dim] = i_ + HALF;
               metric.template convert<Crd::Cd, Crd::Ph>(x_Cd, x_Ph);
-              xe(offset + i + 1) = x_Ph[dim];
+              xc(offset + i) = x_Ph[dim];
+              x_Cd[dim]      = i_;
+              metric.template convert<Crd::Cd, Crd::Ph>(x_Cd, x_Ph);
+              xe(offset + i) = x_Ph[dim];
+              if (is_last && i == ncells - 1) {
+                x_Cd[dim] = i_ + ONE;
+                metric.template convert<Crd::Cd, Crd::Ph>(x_Cd, x_Ph);
+                xe(offset + i + 1) = x_Ph[dim];
+              }
+            });
+          g_writer.writeMesh(dim, xc, xe);
+        }
+      }
+
+      // particle moments are grouped so that each group fits into the backup
+      // buffer: all the moments of a group are deposited in a single pass
+      std::vector<
+        std::vector<std::pair<const out::OutputField*, std::vector<std::size_t>>>>
+                  moment_groups;
+      std::size_t ncomp_in_group { 6 };
+      for (const auto& fld : g_writer.fieldWriters()) {
+        if (not fld.is_moment()) {
+          continue;
+        }
+        const std::size_t ncomp = (fld.comp.size() == 0) ? 1 : fld.comp.size();
+        raise::ErrorIf(ncomp != 1 && ncomp != 3 && ncomp != 6,
+                       "Wrong # of components requested for output",
+                       HERE);
+        raise::ErrorIf(ncomp == 6 && fld.id() != FldsID::T,
+                       "Only T tensor has 6 components",
+                       HERE);
+        if (ncomp_in_group + ncomp > 6) {
+          moment_groups.push_back({});
+          ncomp_in_group = 0;
+        }
+        std::vector<std::size_t> addresses;
+        for (std::size_t i { 0 }; i < ncomp; ++i) {
+          addresses.push_back(ncomp_in_group + i);
+        }
+        moment_groups.back().push_back({ &fld, addresses });
+        ncomp_in_group += ncomp;
+      }
+      for (const auto& moments : moment_groups) {
+        for (const auto& ldidx : local_subdomain_indices()) {
+          auto local_domain = subdomain_ptr(ldidx);
+          Kokkos::deep_copy(local_domain->fields.bckp, ZERO);
+          ComputeMoments<S, M>(params,
+                               local_domain->mesh,
+                               local_domain->species,
+                               moments,
+                               local_domain->fields.bckp);
+        }
+        SynchronizeFields(Comm::Bckp, { 0, moments.back().second.back() + 1 });
+        for (const auto& ldidx : local_subdomain_indices()) {
+          auto local_domain = subdomain_ptr(ldidx);
+          selectOutputLayout(*local_domain, incl_ghosts);
+          for (const auto& [fld, addresses] : moments) {
+            std::vector<std::string> names;
+            if (addresses.size() == 1) {
+              names.push_back(fld->name());
+            } else {
+              for (std::size_t i { 0 }; i < addresses.size(); ++i) {
+                names.push_back(fld->name(i));
+              }
             }
-          });
-        g_writer.writeMesh(dim, xc, xe);
+            g_writer.writeField<M::Dim, 6>(names,
+                                           local_domain->fields.bckp,
+                                           addresses);
+          }
+        }
       }
 
       const auto output_asis = params.template get<bool>("output.debug.as_is");
-      // !TODO: this can probably be optimized to dump things at once
       for (auto& fld : g_writer.fieldWriters()) {
-        Kokkos::deep_copy(local_domain->fields.bckp, ZERO);
+        if (fld.is_moment()) {
+          // computed above
+          continue;
+        }
         std::vector<std::string> names;
         std::vector<std::size_t> addresses;
+        // components of bckp to synchronize between the domains (if any)
+        range_tuple_t            sync_comps { 0, 0 };
         if (fld.comp.size() == 0 || fld.comp.size() == 1) { // scalar
           names.push_back(fld.name());
           addresses.push_back(0);
-          if (fld.is_moment()) {
-            // output a particle distribution moment (single component)
-            // this includes T, Rho, Charge, N, Nppc
-            const auto c = static_cast<unsigned short>(addresses.back());
-            if (fld.id() == FldsID::T) {
-              raise::ErrorIf(fld.comp.size() != 1,
-                             "Wrong # of components requested for T output",
-                             HERE);
-              ComputeMoments<S, M, FldsID::T>(params,
-                                              local_domain->mesh,
-                                              local_domain->species,
-                                              fld.species,
-                                              fld.comp[0],
-                                              local_domain->fields.bckp,
-                                              c);
-            } else if (fld.id() == FldsID::Rho) {
-              ComputeMoments<S, M, FldsID::Rho>(params,
-                                                local_domain->mesh,
-                                                local_domain->species,
-                                                fld.species,
-                                                {},
-                                                local_domain->fields.bckp,
-                                                c);
-            } else if (fld.id() == FldsID::Charge) {
-              ComputeMoments<S, M, FldsID::Charge>(params,
-                                                   local_domain->mesh,
-                                                   local_domain->species,
-                                                   fld.species,
-                                                   {},
-                                                   local_domain->fields.bckp,
-                                                   c);
-            } else if (fld.id() == FldsID::N) {
-              ComputeMoments<S, M, FldsID::N>(params,
-                                              local_domain->mesh,
-                                              local_domain->species,
-                                              fld.species,
-                                              {},
-                                              local_domain->fields.bckp,
-                                              c);
-            } else if (fld.id() == FldsID::Nppc) {
-              ComputeMoments<S, M, FldsID::Nppc>(params,
-                                                 local_domain->mesh,
-                                                 local_domain->species,
-                                                 fld.species,
-                                                 {},
-                                                 local_domain->fields.bckp,
-                                                 c);
-            } else {
-              raise::Error("Wrong moment requested for output", HERE);
-            }
-          } else if (fld.is_custom()) {
-            if (CustomFieldOutput) {
-              CustomFieldOutput(fld.name().substr(1),
-                                local_domain->fields.bckp,
-                                addresses.back(),
-                                *local_domain);
-            } else {
-              raise::Error("Custom output requested but no function provided",
-                           HERE);
-            }
-          } else {
-            raise::Error("Wrong # of components requested for "
-                         "non-moment/non-custom output",
-                         HERE);
-          }
-          SynchronizeFields(*local_domain,
-                            Comm::Bckp,
-                            { addresses.back(), addresses.back() + 1 });
+          sync_comps = { addresses.back(), addresses.back() + 1 };
         } else if (fld.comp.size() == 3) { // vector
           for (auto i = 0; i < 3; ++i) {
             names.push_back(fld.name(i));
             addresses.push_back(i + 3);
           }
-          if (fld.is_moment()) {
-            for (auto i = 0; i < 3; ++i) {
-              const auto c = static_cast<unsigned short>(addresses[i]);
-              raise::ErrorIf(fld.comp[i].size() != 2,
-                             "Wrong # of components requested for moment",
+          raise::ErrorIf(addresses[1] - addresses[0] != addresses[2] - addresses[1],
+                         "Indices for the backup are not contiguous",
+                         HERE);
+        } else {
+          raise::Error("Wrong # of components requested for output", HERE);
+        }
+
+        for (const auto& ldidx : local_subdomain_indices()) {
+          auto local_domain = subdomain_ptr(ldidx);
+          Kokkos::deep_copy(local_domain->fields.bckp, ZERO);
+          if (fld.comp.size() == 0 || fld.comp.size() == 1) { // scalar
+            if (fld.is_custom()) {
+              if (CustomFieldOutput) {
+                CustomFieldOutput(fld.name().substr(1),
+                                  local_domain->fields.bckp,
+                                  addresses.back(),
+                                  *local_domain);
+              } else {
+                raise::Error("Custom output requested but no function provided",
                              HERE);
-              ComputeMoments<S, M, FldsID::T>(params,
-                                              local_domain->mesh,
-                                              local_domain->species,
-                                              fld.species,
-                                              fld.comp[i],
-                                              local_domain->fields.bckp,
-                                              c);
-            }
-            raise::ErrorIf(addresses[1] - addresses[0] !=
-                             addresses[2] - addresses[1],
-                           "Indices for the backup are not contiguous",
+              }
+            } else {
+              raise::Error("Wrong # of components requested for "
+                           "non-moment/non-custom output",
                            HERE);
-            SynchronizeFields(*local_domain,
-                              Comm::Bckp,
-                              { addresses[0], addresses[2] + 1 });
-          } else {
+            }
+          } else if (fld.comp.size() == 3) { // vector
             // copy fields to bckp (:, 0, 1, 2)
             // if as-is specified ==> copy directly to 3, 4, 5
             range_tuple_t copy_to = { 0, 3 };
@@ -406,83 +629,124 @@ namespace ntt {
                                      local_domain->mesh.metric));
             }
           }
-        } else if (fld.comp.size() == 6) { // tensor
-          raise::ErrorIf(not fld.is_moment() or fld.id() != FldsID::T,
-                         "Only T tensor has 6 components",
-                         HERE);
-          for (auto i = 0; i < 6; ++i) {
-            names.push_back(fld.name(i));
-            addresses.push_back(i);
-            const auto c = static_cast<unsigned short>(addresses.back());
-            raise::ErrorIf(fld.comp[i].size() != 2,
-                           "Wrong # of components requested for moment",
-                           HERE);
-            ComputeMoments<S, M, FldsID::T>(params,
-                                            local_domain->mesh,
-                                            local_domain->species,
-                                            fld.species,
-                                            fld.comp[i],
-                                            local_domain->fields.bckp,
-                                            c);
+        }
+        if (sync_comps.second > sync_comps.first) {
+          SynchronizeFields(Comm::Bckp, sync_comps);
+        }
+        for (const auto& ldidx : local_subdomain_indices()) {
+          auto local_domain = subdomain_ptr(ldidx);
+          selectOutputLayout(*local_domain, incl_ghosts);
+          g_writer.writeField<M::Dim, 6>(names, local_domain->fields.bckp, addresses);
+        }
+      }
+
+      // fields accumulated since the previous output (restarted afterwards)
+      const auto& accs = g_writer.accumulatorWriters();
+      if (not accs.empty()) {
+        const auto inv_nsamples = (g_acc_nsamples > 0)
+                                    ? ONE / static_cast<real_t>(g_acc_nsamples)
+                                    : ZERO;
+        for (std::size_t a { 0 }; a < accs.size(); ++a) {
+          const std::vector<std::string> names { accs[a].name(0),
+                                                 accs[a].name(1),
+                                                 accs[a].name(2) };
+          const auto coeff = (accs[a].mode() == "integral") ? ONE : inv_nsamples;
+          for (const auto& ldidx : local_subdomain_indices()) {
+            auto local_domain = subdomain_ptr(ldidx);
+            Kokkos::deep_copy(local_domain->fields.bckp, ZERO);
+            Kokkos::parallel_for("FinalizeAccumulator",
+                                 local_domain->mesh.rangeActiveCells(),
+                                 kernel::FinalizeAccumulator_kernel<M::Dim>(
+                                   local_domain->fields.acc[a],
+                                   local_domain->fields.bckp,
+                                   3,
+                                   coeff,
+                                   accs[a].mode() == "rms"));
+            selectOutputLayout(*local_domain, incl_ghosts);
+            g_writer.writeField<M::Dim, 6>(names,
+                                           local_domain->fields.bckp,
+                                           { 3, 4, 5 });
           }
-          SynchronizeFields(*local_domain,
-                            Comm::Bckp,
-                            { addresses[0], addresses[5] + 1 });
-        } else {
-          raise::Error("Wrong # of components requested for output", HERE);
         }
-        g_writer.writeField<M::Dim, 6>(names, local_domain->fields.bckp, addresses);
+        for (const auto& ldidx : local_subdomain_indices()) {
+          subdomain_ptr(ldidx)->fields.resetAccumulators();
+        }
+        g_acc_nsamples = 0;
       }
     } // end shouldWrite("fields", step, time)
 
     if (write_particles) {
       const auto prtl_stride = params.template get<std::size_t>(
         "output.particles.stride");
+      const auto prtl_ids = params.template get<std::vector<std::size_t>>(
+        "output.particles.ids");
+      const auto prtl_box = params.template get<boundaries_t<real_t>>(
+        "output.particles.box");
+      const auto prtl_emin = params.template get<real_t>(
+        "output.particles.energy_min");
+      // IDs to select (sorted when the parameters are read)
+      array_t<std::size_t*> ids_sel;
+      if (not prtl_ids.empty()) {
+        using ids_host_t = Kokkos::View<const std::size_t*,
+                                        Kokkos::HostSpace,
+                                        Kokkos::MemoryTraits<Kokkos::Unmanaged>>;
+        ids_sel = g_writer.particleIndexBuffer("ids_sel", prtl_ids.size());
+        Kokkos::deep_copy(ids_sel, ids_host_t { prtl_ids.data(), prtl_ids.size() });
+      }
       for (const auto& prtl : g_writer.speciesWriters()) {
-        auto& species = local_domain->species[prtl.species() - 1];
-        if (not species.is_sorted()) {
-          species.SortByTags();
-        }
-        const std::size_t nout = species.npart() / prtl_stride;
-        array_t<real_t*>  buff_x1, buff_x2, buff_x3;
-        array_t<real_t*>  buff_ux1, buff_ux2, buff_ux3;
-        array_t<real_t*>  buff_wei;
-        buff_wei = array_t<real_t*> { "w", nout };
-        buff_ux1 = array_t<real_t*> { "u1", nout };
-        buff_ux2 = array_t<real_t*> { "u2", nout };
-        buff_ux3 = array_t<real_t*> { "u3", nout };
-        if constexpr (M::Dim == Dim::_1D or M::Dim == Dim::_2D or
-                      M::Dim == Dim::_3D) {
-          buff_x1 = array_t<real_t*> { "x1", nout };
-        }
-        if constexpr (M::Dim == Dim::_2D or M::Dim == Dim::_3D) {
-          buff_x2 = array_t<real_t*> { "x2", nout };
-        }
-        if constexpr (M::Dim == Dim::_3D or
-                      ((D == Dim::_2D) and (M::CoordType != Coord::Cart))) {
-          buff_x3 = array_t<real_t*> { "x3", nout };
-        }
-        if (nout > 0) {
+        // number of particles to output from each local domain
+        std::vector<std::size_t> loc_nout;
+        // indices of the selected particles (empty if every `stride`-th)
+        std::vector<array_t<std::size_t*>> loc_indices;
+        for (std::size_t l { 0 }; l < local_subdomain_indices().size(); ++l) {
+          auto  local_domain = subdomain_ptr(local_subdomain_indices()[l]);
+          auto& species      = local_domain->species[prtl.species() - 1];
+          if (not species.is_sorted()) {
+            species.SortByTags();
+          }
+          if (species.track_ids()) {
+            species.AssignIDs(local_domain->index());
+          }
+          if (not species.track_ids() and prtl_box.empty() and
+              (prtl_emin <= ZERO)) {
+            loc_nout.push_back(species.npart() / prtl_stride);
+            loc_indices.emplace_back();
+            continue;
+          }
+          // selected particles are compacted on the device (the IDs are only
+          // ... selected for the species which track them)
+          auto indices = g_writer.particleIndexBuffer(
+            "indices" + std::to_string(l),
+            species.npart());
+          const auto  sp_ids_sel = species.track_ids() ? ids_sel
+                                                       : array_t<std::size_t*> {};
+          std::size_t nsel { 0 };
           // clang-format off
-          Kokkos::parallel_for(
-            "PrtlToPhys",
-            nout,
-            kernel::PrtlToPhys_kernel<S, M>(prtl_stride,
-                                            buff_x1, buff_x2, buff_x3,
-                                            buff_ux1, buff_ux2, buff_ux3,
-                                            buff_wei,
-                                            species.i1, species.i2, species.i3,
-                                            species.dx1, species.dx2, species.dx3,
-                                            species.ux1, species.ux2, species.ux3,
-                                            species.phi, species.weight,
-                                            local_domain->mesh.metric));
+          Kokkos::parallel_scan(
+            "SelectParticles",
+            species.npart(),
+            kernel::PrtlSelect_kernel<M>(indices, prtl_stride, sp_ids_sel,
+                                         prtl_box, prtl_emin,
+                                         species.mass() > 0.0f,
+                                         species.i1, species.i2, species.i3,
+                                         species.dx1, species.dx2, species.dx3,
+                                         species.ux1, species.ux2, species.ux3,
+                                         species.tag, species.id,
+                                         local_domain->mesh.metric),
+            nsel);
           // clang-format on
+          loc_nout.push_back(nsel);
+          loc_indices.push_back(indices);
         }
         std::size_t offset   = 0;
-        std::size_t glob_tot = nout;
+        std::size_t glob_tot = 0;
+        for (const auto& n : loc_nout) {
+          glob_tot += n;
+        }
 #if defined(MPI_ENABLED)
-        auto glob_nout = std::vector<std::size_t>(g_ndomains);
-        MPI_Allgather(&nout,
+        const std::size_t rank_nout = glob_tot;
+        auto glob_nout = std::vector<std::size_t>(g_mpi_size);
+        MPI_Allgather(&rank_nout,
                       1,
                       mpi::get_type<std::size_t>(),
                       glob_nout.data(),
@@ -497,20 +761,73 @@ namespace ntt {
           glob_tot += glob_nout[r];
         }
 #endif // MPI_ENABLED
-        g_writer.writeParticleQuantity(buff_wei, glob_tot, offset, prtl.name("W", 0));
-        g_writer.writeParticleQuantity(buff_ux1, glob_tot, offset, prtl.name("U", 1));
-        g_writer.writeParticleQuantity(buff_ux2, glob_tot, offset, prtl.name("U", 2));
-        g_writer.writeParticleQuantity(buff_ux3, glob_tot, offset, prtl.name("U", 3));
-        if constexpr (M::Dim == Dim::_1D or M::Dim == Dim::_2D or
-                      M::Dim == Dim::_3D) {
-          g_writer.writeParticleQuantity(buff_x1, glob_tot, offset, prtl.name("X", 1));
-        }
-        if constexpr (M::Dim == Dim::_2D or M::Dim == Dim::_3D) {
-          g_writer.writeParticleQuantity(buff_x2, glob_tot, offset, prtl.name("X", 2));
-        }
-        if constexpr (M::Dim == Dim::_3D or
-                      ((D == Dim::_2D) and (M::CoordType != Coord::Cart))) {
-          g_writer.writeParticleQuantity(buff_x3, glob_tot, offset, prtl.name("X", 3));
+        for (std::size_t l { 0 }; l < local_subdomain_indices().size(); ++l) {
+          auto  local_domain = subdomain_ptr(local_subdomain_indices()[l]);
+          auto& species      = local_domain->species[prtl.species() - 1];
+          const std::size_t nout    = loc_nout[l];
+          const auto&       indices = loc_indices[l];
+          // persistent buffers of the writer (reused for all the species)
+          array_t<real_t*>  buff_x1, buff_x2, buff_x3;
+          array_t<real_t*>  buff_ux1, buff_ux2, buff_ux3;
+          array_t<real_t*>  buff_wei;
+          buff_wei = g_writer.particleBuffer("w", nout);
+          buff_ux1 = g_writer.particleBuffer("u1", nout);
+          buff_ux2 = g_writer.particleBuffer("u2", nout);
+          buff_ux3 = g_writer.particleBuffer("u3", nout);
+          if constexpr (M::Dim == Dim::_1D or M::Dim == Dim::_2D or
+                        M::Dim == Dim::_3D) {
+            buff_x1 = g_writer.particleBuffer("x1", nout);
+          }
+          if constexpr (M::Dim == Dim::_2D or M::Dim == Dim::_3D) {
+            buff_x2 = g_writer.particleBuffer("x2", nout);
+          }
+          if constexpr (M::Dim == Dim::_3D or
+                        ((D == Dim::_2D) and (M::CoordType != Coord::Cart))) {
+            buff_x3 = g_writer.particleBuffer("x3", nout);
+          }
+          if (nout > 0) {
+            // clang-format off
+            Kokkos::parallel_for(
+              "PrtlToPhys",
+              nout,
+              kernel::PrtlToPhys_kernel<S, M>(prtl_stride,
+                                              buff_x1, buff_x2, buff_x3,
+                                              buff_ux1, buff_ux2, buff_ux3,
+                                              buff_wei,
+                                              species.i1, species.i2, species.i3,
+                                              species.dx1, species.dx2, species.dx3,
+                                              species.ux1, species.ux2, species.ux3,
+                                              species.phi, species.weight,
+                                              local_domain->mesh.metric,
+                                              indices));
+            // clang-format on
+          }
+          if (prtl.ids()) {
+            // IDs of the tracked species are always selected by index
+            auto       buff_id = g_writer.particleIndexBuffer("id", nout);
+            const auto this_id = species.id;
+            Kokkos::parallel_for(
+              "PrtlIDs",
+              nout,
+              Lambda(index_t p) { buff_id(p) = this_id(indices(p)); });
+            g_writer.writeParticleQuantity(buff_id, glob_tot, offset, prtl.name("ID", 0));
+          }
+          g_writer.writeParticleQuantity(buff_wei, glob_tot, offset, prtl.name("W", 0));
+          g_writer.writeParticleQuantity(buff_ux1, glob_tot, offset, prtl.name("U", 1));
+          g_writer.writeParticleQuantity(buff_ux2, glob_tot, offset, prtl.name("U", 2));
+          g_writer.writeParticleQuantity(buff_ux3, glob_tot, offset, prtl.name("U", 3));
+          if constexpr (M::Dim == Dim::_1D or M::Dim == Dim::_2D or
+                        M::Dim == Dim::_3D) {
+            g_writer.writeParticleQuantity(buff_x1, glob_tot, offset, prtl.name("X", 1));
+          }
+          if constexpr (M::Dim == Dim::_2D or M::Dim == Dim::_3D) {
+            g_writer.writeParticleQuantity(buff_x2, glob_tot, offset, prtl.name("X", 2));
+          }
+          if constexpr (M::Dim == Dim::_3D or
+                        ((D == Dim::_2D) and (M::CoordType != Coord::Cart))) {
+            g_writer.writeParticleQuantity(buff_x3, glob_tot, offset, prtl.name("X", 3));
+          }
+          offset += nout;
         }
       }
     } // end shouldWrite("particles", step, time)
@@ -538,49 +855,140 @@ namespace ntt {
           }
         });
       for (const auto& spec : g_writer.spectraWriters()) {
-        auto&            species = local_domain->species[spec.species() - 1];
+        // the spectrum is accumulated over all the local domains
         array_t<real_t*> dn { "dn", n_bins };
-        auto       dn_scatter = Kokkos::Experimental::create_scatter_view(dn);
-        auto       ux1        = species.ux1;
-        auto       ux2        = species.ux2;
-        auto       ux3        = species.ux3;
-        auto       weight     = species.weight;
-        auto       tag        = species.tag;
-        const auto is_massive = species.mass() > 0.0f;
-        Kokkos::parallel_for(
-          "ComputeSpectra",
-          species.rangeActiveParticles(),
-          Lambda(index_t p) {
-            if (tag(p) != ParticleTag::alive) {
-              return;
-            }
-            real_t en;
-            if (is_massive) {
-              en = U2GAMMA(ux1(p), ux2(p), ux3(p)) - ONE;
-            } else {
-              en = NORM(ux1(p), ux2(p), ux3(p));
-            }
-            if (log_bins) {
-              en = math::log10(en);
-            }
-            std::size_t e_ind = 0;
-            if (en <= e_min) {
-              e_ind = 0;
-            } else if (en >= e_max) {
-              e_ind = n_bins;
-            } else {
-              e_ind = static_cast<std::size_t>(
-                static_cast<real_t>(n_bins) * (en - e_min) / (e_max - e_min));
-            }
-            auto dn_acc    = dn_scatter.access();
-            dn_acc(e_ind) += weight(p);
-          });
+        auto dn_scatter = Kokkos::Experimental::create_scatter_view(dn);
+        for (const auto& ldidx : local_subdomain_indices()) {
+          auto&      species    = subdomain_ptr(ldidx)->species[spec.species() - 1];
+          auto       ux1        = species.ux1;
+          auto       ux2        = species.ux2;
+          auto       ux3        = species.ux3;
+          auto       weight     = species.weight;
+          auto       tag        = species.tag;
+          const auto is_massive = species.mass() > 0.0f;
+          Kokkos::parallel_for(
+            "ComputeSpectra",
+            species.rangeActiveParticles(),
+            Lambda(index_t p) {
+              if (tag(p) != ParticleTag::alive) {
+                return;
+              }
+              real_t en;
+              if (is_massive) {
+                en = U2GAMMA(ux1(p), ux2(p), ux3(p)) - ONE;
+              } else {
+                en = NORM(ux1(p), ux2(p), ux3(p));
+              }
+              if (log_bins) {
+                en = math::log10(en);
+              }
+              std::size_t e_ind = 0;
+              if (en <= e_min) {
+                e_ind = 0;
+              } else if (en >= e_max) {
+                e_ind = n_bins;
+              } else {
+                e_ind = static_cast<std::size_t>(
+                  static_cast<real_t>(n_bins) * (en - e_min) / (e_max - e_min));
+              }
+              auto dn_acc    = dn_scatter.access();
+              dn_acc(e_ind) += weight(p);
+            });
+        }
         Kokkos::Experimental::contribute(dn, dn_scatter);
         g_writer.writeSpectrum(dn, spec.name());
       }
       g_writer.writeSpectrumBins(energy, "sEbn");
     } // end shouldWrite("spectra", step, time)
 
+    if (write_histograms) {
+      for (const auto& name : params.template get<std::vector<std::string>>(
+             "output.histograms.names")) {
+        const auto prefix     = "output.histograms." + name + ".";
+        const auto quantities = params.template get<std::vector<std::string>>(
+          prefix + "quantities");
+        const auto ranges = params.template get<boundaries_t<real_t>>(
+          prefix + "ranges");
+        const auto n_bins = params.template get<std::vector<std::size_t>>(
+          prefix + "n_bins");
+        const auto log_bins = params.template get<std::vector<bool>>(
+          prefix + "log_bins");
+        const auto box = params.template get<boundaries_t<real_t>>(prefix + "box");
+        std::vector<kernel::hist_axis_t> axes;
+        std::size_t                      nbins_total { 1 };
+        for (std::size_t a { 0 }; a < quantities.size(); ++a) {
+          kernel::hist_axis_t axis { HistAxis::INVALID,
+                                     ranges[a].first,
+                                     ranges[a].second,
+                                     n_bins[a],
+                                     log_bins[a] };
+          for (const auto& q : HistAxis::variants) {
+            if (HistAxis::pick(quantities[a].c_str()) == q) {
+              axis.q = q;
+            }
+          }
+          axes.push_back(axis);
+          nbins_total *= n_bins[a];
+        }
+        const out::OutputHistogram* first_hist = nullptr;
+        for (const auto& hist : g_writer.histogramWriters()) {
+          if (hist.label() != name) {
+            continue;
+          }
+          if (first_hist == nullptr) {
+            first_hist = &hist;
+          }
+          // the histogram is accumulated over all the local domains
+          array_t<real_t*> counts { "counts", nbins_total };
+          auto counts_scatter = Kokkos::Experimental::create_scatter_view(counts);
+          for (const auto& ldidx : local_subdomain_indices()) {
+            auto  local_domain = subdomain_ptr(ldidx);
+            auto& species      = local_domain->species[hist.species() - 1];
+            // clang-format off
+            Kokkos::parallel_for(
+              "ComputeHistogram",
+              species.rangeActiveParticles(),
+              kernel::PrtlHistogram_kernel<S, M>(axes, counts_scatter, box,
+                                                 local_domain->fields.em,
+                                                 species.i1, species.i2, species.i3,
+                                                 species.dx1, species.dx2, species.dx3,
+                                                 species.ux1, species.ux2, species.ux3,
+                                                 species.phi, species.weight,
+                                                 species.tag,
+                                                 species.mass() > 0.0f,
+                                                 local_domain->mesh.metric));
+            // clang-format on
+          }
+          Kokkos::Experimental::contribute(counts, counts_scatter);
+          g_writer.writeHistogram(counts, n_bins, hist.name());
+        }
+        if (first_hist == nullptr) {
+          continue;
+        }
+        // bin edges along each axis
+        for (std::size_t a { 0 }; a < axes.size(); ++a) {
+          const auto       nb     = n_bins[a];
+          const auto       is_log = log_bins[a];
+          const auto       b_min  = is_log ? math::log10(ranges[a].first)
+                                           : ranges[a].first;
+          const auto       b_max  = is_log ? math::log10(ranges[a].second)
+                                           : ranges[a].second;
+          array_t<real_t*> edges { "edges", nb + 1 };
+          Kokkos::parallel_for(
+            "GenerateHistogramBins",
+            nb + 1,
+            Lambda(index_t e) {
+              if (is_log) {
+                edges(e) = math::pow(10.0, b_min + (b_max - b_min) * e / nb);
+              } else {
+                edges(e) = b_min + (b_max - b_min) * e / nb;
+              }
+            });
+          g_writer.writeSpectrumBins(edges, first_hist->binsName(a));
+        }
+      }
+    } // end shouldWrite("histograms", step, time)
+
     g_writer.endWriting();
     return true;
   }
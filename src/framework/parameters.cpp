@@ -24,6 +24,7 @@
   #include <mpi.h>
 #endif
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <utility>
@@ -98,6 +99,34 @@ namespace ntt {
                    HERE);
     set("simulation.domain.decomposition", decomposition);
 
+    set("simulation.domain.load_balancing.interval",
+        toml::find_or(raw_data,
+                      "simulation",
+                      "domain",
+                      "load_balancing",
+                      "interval",
+                      defaults::load_balancing::interval));
+    const auto lb_threshold = toml::find_or(raw_data,
+                                            "simulation",
+                                            "domain",
+                                            "load_balancing",
+                                            "threshold",
+                                            defaults::load_balancing::threshold);
+    raise::ErrorIf(lb_threshold < ONE,
+                   "`simulation.domain.load_balancing.threshold` must be >= 1",
+                   HERE);
+    set("simulation.domain.load_balancing.threshold", lb_threshold);
+    const auto lb_cell_weight = toml::find_or(raw_data,
+                                              "simulation",
+                                              "domain",
+                                              "load_balancing",
+                                              "cell_weight",
+                                              defaults::load_balancing::cell_weight);
+    raise::ErrorIf(lb_cell_weight < ZERO,
+                   "`simulation.domain.load_balancing.cell_weight` must be >= 0",
+                   HERE);
+    set("simulation.domain.load_balancing.cell_weight", lb_cell_weight);
+
     auto extent = toml::find<std::vector<std::vector<real_t>>>(raw_data,
                                                                "grid",
                                                                "extent");
@@ -249,6 +278,14 @@ namespace ntt {
     set("algorithms.toggles.deposit",
         toml::find_or(raw_data, "algorithms", "toggles", "deposit", true));
 
+    /* [algorithms.deposit] ------------------------------------------------- */
+    set("algorithms.deposit.tile_size",
+        toml::find_or(raw_data,
+                      "algorithms",
+                      "deposit",
+                      "tile_size",
+                      defaults::deposit::tile_size));
+
     /* [algorithms.timestep] ------------------------------------------------ */
     set("algorithms.timestep.CFL",
         toml::find_or(raw_data, "algorithms", "timestep", "CFL", defaults::cfl));
@@ -286,12 +323,40 @@ namespace ntt {
 #if defined(MPI_ENABLED)
     const std::size_t sort_interval = 1;
 #else
-    const std::size_t sort_interval = toml::find_or(raw_data,
-                                                    "particles",
-                                                    "sort_interval",
-                                                    defaults::sort_interval);
+    // particles leaving a local domain are tagged in the pusher and have to be
+    // ... handed over to the neighbor before the next push
+    const std::size_t sort_interval = (ndoms > 1)
+                                        ? 1
+                                        : toml::find_or(raw_data,
+                                                        "particles",
+                                                        "sort_interval",
+                                                        defaults::sort_interval);
 #endif
     set("particles.sort_interval", sort_interval);
+    set("particles.spatial_sort_interval",
+        toml::find_or(raw_data,
+                      "particles",
+                      "spatial_sort_interval",
+                      defaults::spatial_sort_interval));
+
+    const auto growth_factor = toml::find_or(raw_data,
+                                             "particles",
+                                             "growth_factor",
+                                             defaults::prtl_capacity::growth_factor);
+    raise::ErrorIf(growth_factor < 1.0f,
+                   "`particles.growth_factor` must be >= 1",
+                   HERE);
+    set("particles.growth_factor", growth_factor);
+    const auto shrink_threshold = toml::find_or(
+      raw_data,
+      "particles",
+      "shrink_threshold",
+      defaults::prtl_capacity::shrink_threshold);
+    raise::ErrorIf((shrink_threshold < 0.0f) or
+                     (shrink_threshold * growth_factor >= 1.0f),
+                   "`particles.shrink_threshold` must be in [0, 1 / growth_factor)",
+                   HERE);
+    set("particles.shrink_threshold", shrink_threshold);
 
     /* [particles.species] -------------------------------------------------- */
     std::vector<ParticleSpecies> species;
@@ -321,6 +386,7 @@ namespace ntt {
                                            "n_payloads",
                                            static_cast<unsigned short>(0));
       const auto cooling   = toml::find_or(sp, "cooling", std::string("None"));
+      const auto track_ids = toml::find_or(sp, "track_ids", false);
       raise::ErrorIf((fmt::toLower(cooling) != "none") && is_massless,
                      "cooling is only applicable to massive particles",
                      HERE);
@@ -360,7 +426,10 @@ namespace ntt {
                                            pusher_enum,
                                            use_gca,
                                            cooling_enum,
-                                           npayloads));
+                                           npayloads,
+                                           track_ids,
+                                           growth_factor,
+                                           shrink_threshold));
       idx += 1;
     }
     set("particles.species", species);
@@ -373,6 +442,13 @@ namespace ntt {
         toml::find_or(raw_data, "output", "interval", defaults::output::interval));
     set("output.interval_time",
         toml::find_or<long double>(raw_data, "output", "interval_time", -1.0));
+    set("output.async", toml::find_or(raw_data, "output", "async", false));
+    const auto async_depth = toml::find_or(raw_data,
+                                           "output",
+                                           "async_depth",
+                                           defaults::output::async_depth);
+    raise::ErrorIf(async_depth == 0, "`output.async_depth` must be positive", HERE);
+    set("output.async_depth", async_depth);
     promiseToDefine("output.fields.interval");
     promiseToDefine("output.fields.interval_time");
     promiseToDefine("output.fields.enable");
@@ -382,6 +458,9 @@ namespace ntt {
     promiseToDefine("output.spectra.interval");
     promiseToDefine("output.spectra.interval_time");
     promiseToDefine("output.spectra.enable");
+    promiseToDefine("output.histograms.interval");
+    promiseToDefine("output.histograms.interval_time");
+    promiseToDefine("output.histograms.enable");
 
     const auto flds_out        = toml::find_or(raw_data,
                                         "output",
@@ -404,8 +483,76 @@ namespace ntt {
                       "fields",
                       "mom_smooth",
                       defaults::output::mom_smooth));
-    set("output.fields.stride",
-        toml::find_or(raw_data, "output", "fields", "stride", defaults::output::flds_stride));
+    // stride is either the same for all dimensions or defined per dimension
+    const auto flds_stride_raw = toml::find_or(raw_data,
+                                               "output",
+                                               "fields",
+                                               "stride",
+                                               toml::value {});
+    auto       flds_stride     = std::vector<unsigned short>(
+      dim,
+      defaults::output::flds_stride);
+    if (flds_stride_raw.is_array()) {
+      flds_stride = toml::get<std::vector<unsigned short>>(flds_stride_raw);
+      raise::ErrorIf(flds_stride.size() != dim,
+                     "`output.fields.stride` must have an entry for each dimension",
+                     HERE);
+    } else if (flds_stride_raw.is_integer()) {
+      flds_stride = std::vector<unsigned short>(
+        dim,
+        toml::get<unsigned short>(flds_stride_raw));
+    }
+    for (const auto& st : flds_stride) {
+      raise::ErrorIf(st == 0, "`output.fields.stride` must be positive", HERE);
+    }
+    set("output.fields.stride", flds_stride);
+    const auto flds_downsampling = fmt::toLower(
+      toml::find_or(raw_data,
+                    "output",
+                    "fields",
+                    "downsampling",
+                    defaults::output::flds_downsampling));
+    raise::ErrorIf((flds_downsampling != "pick") and
+                     (flds_downsampling != "average"),
+                   "invalid `output.fields.downsampling`",
+                   HERE);
+    set("output.fields.downsampling", flds_downsampling);
+    // fields accumulated on the device between the outputs
+    bool use_accumulators { false };
+    for (const auto& mode : { "mean", "rms", "integral" }) {
+      const auto accs = toml::find_or(raw_data,
+                                      "output",
+                                      "fields",
+                                      mode,
+                                      std::vector<std::string> {});
+      for (auto a { 0u }; a < accs.size(); ++a) {
+        const auto& q = accs[a];
+        raise::ErrorIf(
+          (q != "E") and (q != "B") and (q != "J") and
+            ((q != "S") or (std::string(mode) == "rms")),
+          "invalid `output.fields." + std::string(mode) + "` quantity: " + q,
+          HERE);
+        raise::ErrorIf(
+          std::find(accs.begin() + a + 1, accs.end(), q) != accs.end(),
+          "duplicate `output.fields." + std::string(mode) + "` quantity: " + q,
+          HERE);
+      }
+      use_accumulators = use_accumulators or not accs.empty();
+      set("output.fields." + std::string(mode), accs);
+    }
+    raise::ErrorIf(use_accumulators and (engine_enum != SimEngine::SRPIC),
+                   "accumulated field diagnostics are only supported for SRPIC",
+                   HERE);
+    const auto flds_acc_interval = toml::find_or(
+      raw_data,
+      "output",
+      "fields",
+      "accumulate_interval",
+      defaults::output::flds_acc_interval);
+    raise::ErrorIf(flds_acc_interval == 0,
+                   "`output.fields.accumulate_interval` must be positive",
+                   HERE);
+    set("output.fields.accumulate_interval", flds_acc_interval);
 
     // particles
     auto prtl_out = toml::find_or(raw_data,
@@ -425,6 +572,79 @@ namespace ntt {
                       "particles",
                       "stride",
                       defaults::output::prtl_stride));
+    // particles selected by the IDs (sorted for the search on the device)
+    auto prtl_ids = toml::find_or(raw_data,
+                                  "output",
+                                  "particles",
+                                  "ids",
+                                  std::vector<std::size_t> {});
+    std::sort(prtl_ids.begin(), prtl_ids.end());
+    prtl_ids.erase(std::unique(prtl_ids.begin(), prtl_ids.end()), prtl_ids.end());
+    set("output.particles.ids", prtl_ids);
+    // ... within the box in physical coordinates
+    const auto to_box = [&dim](const std::vector<std::vector<real_t>>& box,
+                               const std::string& key) -> boundaries_t<real_t> {
+      raise::ErrorIf((box.size() != 0) and (box.size() != dim),
+                     "`" + key + "` must have an entry for each dimension",
+                     HERE);
+      boundaries_t<real_t> box_pairwise;
+      for (const auto& b : box) {
+        raise::ErrorIf((b.size() != 2) or (b[0] >= b[1]),
+                       "invalid `" + key + "`",
+                       HERE);
+        box_pairwise.push_back({ b[0], b[1] });
+      }
+      return box_pairwise;
+    };
+    set("output.particles.box",
+        to_box(toml::find_or(raw_data,
+                             "output",
+                             "particles",
+                             "box",
+                             std::vector<std::vector<real_t>> {}),
+               "output.particles.box"));
+    // ... & above the energy threshold
+    set("output.particles.energy_min",
+        toml::find_or(raw_data,
+                      "output",
+                      "particles",
+                      "energy_min",
+                      defaults::output::prtl_emin));
+
+    // compression
+    for (const auto& type : { "fields", "particles" }) {
+      const auto prefix      = "output." + std::string(type) + ".";
+      const auto compression = fmt::toLower(
+        toml::find_or(raw_data,
+                      "output",
+                      std::string(type),
+                      "compression",
+                      defaults::output::compression));
+      raise::ErrorIf((compression != "none") and (compression != "blosc") and
+                       (compression != "bzip2") and (compression != "zfp") and
+                       (compression != "sz"),
+                     "invalid `" + prefix + "compression`",
+                     HERE);
+      const auto accuracy  = toml::find_or<real_t>(raw_data,
+                                                  "output",
+                                                  std::string(type),
+                                                  "compression_accuracy",
+                                                  ZERO);
+      const auto precision = toml::find_or<unsigned short>(raw_data,
+                                                           "output",
+                                                           std::string(type),
+                                                           "compression_precision",
+                                                           0);
+      raise::ErrorIf(((compression == "zfp") and (accuracy <= ZERO) and
+                      (precision == 0)) or
+                       ((compression == "sz") and (accuracy <= ZERO)),
+                     "lossy `" + prefix +
+                       "compression` requires a positive `compression_accuracy`",
+                     HERE);
+      set(prefix + "compression", compression);
+      set(prefix + "compression_accuracy", accuracy);
+      set(prefix + "compression_precision", precision);
+    }
 
     // spectra
     set("output.spectra.e_min",
@@ -440,8 +660,122 @@ namespace ntt {
     set("output.spectra.n_bins",
         toml::find_or(raw_data, "output", "spectra", "n_bins", defaults::output::spec_nbins));
 
+    // histograms
+    const auto hist_tab = toml::find_or<toml::array>(raw_data,
+                                                     "output",
+                                                     "histograms",
+                                                     "list",
+                                                     toml::array {});
+    std::vector<std::string> hist_names;
+    for (const auto& hist : hist_tab) {
+      const auto name = toml::find<std::string>(hist, "name");
+      raise::ErrorIf(std::find(hist_names.begin(), hist_names.end(), name) !=
+                       hist_names.end(),
+                     "duplicate histogram name: " + name,
+                     HERE);
+      const auto prefix = "output.histograms." + name + ".";
+      auto quantities = toml::find<std::vector<std::string>>(hist, "quantities");
+      const auto naxes = quantities.size();
+      raise::ErrorIf((naxes < 2) or (naxes > 3),
+                     "`" + prefix + "quantities` must have 2 or 3 entries",
+                     HERE);
+      for (auto& q : quantities) {
+        q = fmt::toLower(q);
+        raise::ErrorIf(not HistAxis::contains(q.c_str()),
+                       "invalid histogram quantity: " + q,
+                       HERE);
+        raise::ErrorIf(((q == "upar") or (q == "uperp") or (q == "mu")) and
+                         (engine_enum != SimEngine::SRPIC),
+                       "histograms w.r.t. the magnetic field are only "
+                       "supported for SRPIC",
+                       HERE);
+        raise::ErrorIf(((q == "x2") and (dim == Dim::_1D)) or
+                         ((q == "x3") and (dim != Dim::_3D) and
+                          not((dim == Dim::_2D) and (coord_enum != Coord::Cart))),
+                       "histogram quantity " + q + " is not defined",
+                       HERE);
+      }
+      const auto ranges   = toml::find<std::vector<std::vector<real_t>>>(hist,
+                                                                     "ranges");
+      const auto n_bins   = toml::find_or(
+        hist,
+        "n_bins",
+        std::vector<std::size_t>(naxes, defaults::output::hist_nbins));
+      const auto log_bins = toml::find_or(hist,
+                                          "log_bins",
+                                          std::vector<bool>(naxes, false));
+      raise::ErrorIf((ranges.size() != naxes) or (n_bins.size() != naxes) or
+                       (log_bins.size() != naxes),
+                     "`" + prefix +
+                       "ranges`, `n_bins` & `log_bins` must have an entry for "
+                       "each quantity",
+                     HERE);
+      boundaries_t<real_t> ranges_pairwise;
+      for (auto a { 0u }; a < naxes; ++a) {
+        raise::ErrorIf((ranges[a].size() != 2) or (ranges[a][0] >= ranges[a][1]) or
+                         (log_bins[a] and (ranges[a][0] <= ZERO)),
+                       "invalid `" + prefix + "ranges`",
+                       HERE);
+        raise::ErrorIf(n_bins[a] == 0, "invalid `" + prefix + "n_bins`", HERE);
+        ranges_pairwise.push_back({ ranges[a][0], ranges[a][1] });
+      }
+      // all the species by default
+      auto hist_species = toml::find_or(hist,
+                                        "species",
+                                        std::vector<unsigned short> {});
+      if (hist_species.empty()) {
+        for (const auto& sp : species) {
+          hist_species.push_back(sp.index());
+        }
+      }
+      for (const auto& sp : hist_species) {
+        raise::ErrorIf((sp == 0) or (sp > species.size()),
+                       "invalid species in `" + prefix + "species`",
+                       HERE);
+      }
+      set(prefix + "quantities", quantities);
+      set(prefix + "ranges", ranges_pairwise);
+      set(prefix + "n_bins", n_bins);
+      set(prefix + "log_bins", log_bins);
+      set(prefix + "species", hist_species);
+      set(prefix + "box",
+          to_box(toml::find_or(hist,
+                               "box",
+                               std::vector<std::vector<real_t>> {}),
+                 prefix + "box"));
+      hist_names.push_back(name);
+    }
+    set("output.histograms.names", hist_names);
+
+    // streaming
+    set("output.stream.readers",
+        toml::find_or(raw_data,
+                      "output",
+                      "stream",
+                      "readers",
+                      defaults::output::stream_readers));
+    const auto stream_queue = toml::find_or(raw_data,
+                                            "output",
+                                            "stream",
+                                            "queue_limit",
+                                            defaults::output::stream_queue);
+    raise::ErrorIf(stream_queue == 0,
+                   "`output.stream.queue_limit` must be positive",
+                   HERE);
+    set("output.stream.queue_limit", stream_queue);
+    const auto stream_policy = fmt::toLower(
+      toml::find_or(raw_data,
+                    "output",
+                    "stream",
+                    "queue_policy",
+                    defaults::output::stream_policy));
+    raise::ErrorIf((stream_policy != "block") and (stream_policy != "discard"),
+                   "invalid `output.stream.queue_policy`",
+                   HERE);
+    set("output.stream.queue_policy", stream_policy);
+
     // intervals
-    for (const auto& type : { "fields", "particles", "spectra" }) {
+    for (const auto& type : { "fields", "particles", "spectra", "histograms" }) {
       const auto q_int      = toml::find_or<std::size_t>(raw_data,
                                                     "output",
                                                     std::string(type),
@@ -471,6 +805,26 @@ namespace ntt {
     set("output.debug.ghosts",
         toml::find_or(raw_data, "output", "debug", "ghosts", false));
 
+    /* [checkpoint] --------------------------------------------------------- */
+    set("checkpoint.interval",
+        toml::find_or(raw_data, "checkpoint", "interval", defaults::checkpoint::interval));
+    set("checkpoint.interval_time",
+        toml::find_or<long double>(raw_data, "checkpoint", "interval_time", -1.0));
+    set("checkpoint.keep",
+        toml::find_or(raw_data, "checkpoint", "keep", defaults::checkpoint::keep));
+    const auto checkpoint_path = toml::find_or<std::string>(
+      raw_data,
+      "checkpoint",
+      "write_path",
+      get<std::string>("simulation.name") + ".ckpt");
+    set("checkpoint.write_path", checkpoint_path);
+    set("checkpoint.read_path",
+        toml::find_or<std::string>(raw_data, "checkpoint", "read_path", checkpoint_path));
+    set("checkpoint.start_step",
+        toml::find_or<std::size_t>(raw_data, "checkpoint", "start_step", 0));
+    // overriden from the command line (`-continue`)
+    set("checkpoint.is_resuming", false);
+
     /* [diagnostics] -------------------------------------------------------- */
     set("diagnostics.interval",
         toml::find_or(raw_data, "diagnostics", "interval", defaults::diag::interval));
@@ -478,6 +832,26 @@ namespace ntt {
         toml::find_or(raw_data, "diagnostics", "blocking_timers", false));
     set("diagnostics.colored_stdout",
         toml::find_or(raw_data, "diagnostics", "colored_stdout", false));
+    const auto report = fmt::toLower(
+      toml::find_or(raw_data, "diagnostics", "report", defaults::diag::report));
+    raise::ErrorIf((report != "disabled") and (report != "csv") and
+                     (report != "json"),
+                   "invalid `diagnostics.report`",
+                   HERE);
+    set("diagnostics.report", report);
+    const auto log_level = fmt::toLower(
+      toml::find_or(raw_data, "diagnostics", "log_level", defaults::diag::log_level));
+    raise::ErrorIf((log_level != "verbose") and (log_level != "info") and
+                     (log_level != "warning"),
+                   "invalid `diagnostics.log_level`",
+                   HERE);
+    set("diagnostics.log_level", log_level);
+    set("diagnostics.report_path",
+        toml::find_or<std::string>(raw_data,
+                                   "diagnostics",
+                                   "report_path",
+                                   get<std::string>("simulation.name") +
+                                     ".perf." + report));
 
     /* inferred variables --------------------------------------------------- */
     // extent
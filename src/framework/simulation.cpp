@@ -17,8 +17,6 @@
 namespace ntt {
 
   Simulation::Simulation(int argc, char* argv[]) {
-    GlobalInitialize(argc, argv);
-
     cargs::CommandLineArguments cl_args;
     cl_args.readCommandLineArguments(argc, argv);
     const auto inputfname = static_cast<std::string>(
@@ -27,10 +25,23 @@ namespace ntt {
       cl_args.getArgument("-output", defaults::output_path));
 
     const auto inputdata = toml::parse(inputfname);
+    // MPI is initialized with threads only if the output is asynchronous
+    GlobalInitialize(argc,
+                     argv,
+                     toml::find_or(inputdata, "output", "async", false));
+
     const auto sim_name = toml::find<std::string>(inputdata, "simulation", "name");
-    logger::initPlog<files::LogFile, files::InfoFile, files::ErrFile>(sim_name);
+    const auto log_level = fmt::toLower(toml::find_or(inputdata,
+                                                      "diagnostics",
+                                                      "log_level",
+                                                      defaults::diag::log_level));
+    logger::initPlog<files::LogFile, files::InfoFile, files::ErrFile>(sim_name,
+                                                                      log_level);
 
     params = SimulationParams(inputdata);
+    if (cl_args.isSpecified("-continue")) {
+      params.set("checkpoint.is_resuming", true);
+    }
   }
 
   Simulation::~Simulation() {
@@ -4,7 +4,13 @@
 #include "global.h"
 
 #include "arch/directions.h"
+#include "arch/kokkos_aliases.h"
+#include "arch/mpi_tags.h"
 #include "utils/error.h"
+#include "utils/numeric.h"
+#include "utils/timer.h"
+
+#include "framework/containers/species.h"
 
 #include "metrics/minkowski.h"
 #include "metrics/qspherical.h"
@@ -196,6 +202,115 @@ auto main(int argc, char* argv[]) -> int {
       raise::ErrorIf(nx1 != 2 * res[0], "Mesh::n_active() failed", HERE);
       raise::ErrorIf(nx2 != 2 * res[1], "Mesh::n_active() failed", HERE);
     }
+    {
+      // particles pushed across the boundaries of the local domains (no MPI)
+      const std::vector<std::size_t> res { 32, 16 };
+      const boundaries_t<real_t>     extent {
+            {0.0, 2.0},
+            {0.0, 1.0}
+      };
+      const boundaries_t<FldsBC> fldsbc {
+        {FldsBC::PERIODIC, FldsBC::PERIODIC},
+        {FldsBC::PERIODIC, FldsBC::PERIODIC}
+      };
+      const boundaries_t<PrtlBC> prtlbc {
+        {PrtlBC::PERIODIC, PrtlBC::PERIODIC},
+        {PrtlBC::PERIODIC, PrtlBC::PERIODIC}
+      };
+      const std::vector<ParticleSpecies> species {
+        ParticleSpecies(1, "e-", 1.0, -1.0, 10, PrtlPusher::BORIS, false, Cooling::NONE)
+      };
+#if defined(OUTPUT_ENABLED)
+      Metadomain<SimEngine::SRPIC, Minkowski<Dim::_2D>> metadomain {
+        2, { 2, 1 },
+         res, extent, fldsbc, prtlbc, {}, species, "disabled"
+      };
+#else
+      Metadomain<SimEngine::SRPIC, Minkowski<Dim::_2D>> metadomain {
+        2, { 2, 1 },
+         res, extent, fldsbc, prtlbc, {}, species
+      };
+#endif
+      timer::Timers timers { "Sorting", "Communications" };
+
+      // one particle next to the +x1 edge of the first domain
+      const auto ni1_0 = static_cast<int>(
+        metadomain.subdomain(0).mesh.n_active(in::x1));
+      {
+        auto& prtls = metadomain.subdomain_ptr(0)->species[0];
+        auto  i1    = prtls.i1;
+        auto  i2    = prtls.i2;
+        auto  dx1   = prtls.dx1;
+        auto  dx2   = prtls.dx2;
+        auto  wei   = prtls.weight;
+        auto  tag   = prtls.tag;
+        Kokkos::parallel_for(
+          "Inject",
+          1,
+          Lambda(index_t p) {
+            i1(p)  = ni1_0 - 1;
+            i2(p)  = 4;
+            dx1(p) = to_prtldx(HALF);
+            dx2(p) = to_prtldx(HALF);
+            wei(p) = ONE;
+            tag(p) = ParticleTag::alive;
+          });
+        prtls.set_npart(1);
+      }
+
+      // push by 0.3 cells per step, exchanging the particles every step
+      const real_t      vx     = 0.3;
+      const std::size_t nsteps = 10;
+      for (std::size_t step { 0 }; step < nsteps; ++step) {
+        for (unsigned int idx = 0; idx < 2; ++idx) {
+          auto&      prtls = metadomain.subdomain_ptr(idx)->species[0];
+          const auto ni1   = static_cast<int>(
+            metadomain.subdomain(idx).mesh.n_active(in::x1));
+          const auto ni2 = static_cast<int>(
+            metadomain.subdomain(idx).mesh.n_active(in::x2));
+          auto i1  = prtls.i1;
+          auto i2  = prtls.i2;
+          auto dx1 = prtls.dx1;
+          auto tag = prtls.tag;
+          Kokkos::parallel_for(
+            "Push",
+            prtls.rangeActiveParticles(),
+            Lambda(index_t p) {
+              if (tag(p) != ParticleTag::alive) {
+                return;
+              }
+              const auto x  = from_prtldx(dx1(p)) + vx;
+              const auto di = static_cast<int>(x);
+              i1(p)        += di;
+              dx1(p)        = to_prtldx(x - static_cast<real_t>(di));
+
+              tag(p) = mpi::SendTag(tag(p),
+                                    i1(p) < 0,
+                                    i1(p) >= ni1,
+                                    i2(p) < 0,
+                                    i2(p) >= ni2);
+            });
+        }
+        metadomain.CommunicateParticles(&timers);
+      }
+
+      // (ni1 - 0.5) + 10 * 0.3 = ni1 + 2.5: the 3rd cell of the second domain
+      raise::ErrorIf(metadomain.subdomain(0).species[0].npart() != 0,
+                     "particle not sent from the first domain",
+                     HERE);
+      raise::ErrorIf(metadomain.subdomain(1).species[0].npart() != 1,
+                     "particle not received by the second domain",
+                     HERE);
+      const auto& recv  = metadomain.subdomain(1).species[0];
+      auto        i1_h  = Kokkos::create_mirror_view(recv.i1);
+      auto        tag_h = Kokkos::create_mirror_view(recv.tag);
+      Kokkos::deep_copy(i1_h, recv.i1);
+      Kokkos::deep_copy(tag_h, recv.tag);
+      raise::ErrorIf(tag_h(0) != ParticleTag::alive,
+                     "received particle is not alive",
+                     HERE);
+      raise::ErrorIf(i1_h(0) != 2, "received particle is misplaced", HERE);
+    }
   } catch (const std::exception& e) {
     std::cerr << e.what() << std::endl;
     Kokkos::finalize();
@@ -80,6 +80,9 @@ const auto mink_1d = u8R"(
   fields_stride = 1
   prtl_stride = 100
   interval_time = 0.01
+
+[diagnostics]
+  log_level = "Warning"
 )"_toml;
 
 const auto sph_2d = u8R"(
@@ -154,6 +157,23 @@ const auto sph_2d = u8R"(
     mass = 0.0
     charge = 0.0
     maxnpart = 1e2
+
+[output]
+  [output.fields]
+    mean = ["E", "S"]
+    rms = ["B"]
+    accumulate_interval = 5
+
+  [output.histograms]
+    interval = 10
+
+    [[output.histograms.list]]
+      name = "eMu"
+      quantities = ["E", "Mu"]
+      ranges = [[1e-2, 1e2], [-1.0, 1.0]]
+      n_bins = [40, 20]
+      log_bins = [true, false]
+      species = [1, 2]
     
 [setup]
 
@@ -165,6 +185,9 @@ const auto qks_2d = u8R"(
   engine = "grpic"
   runtime = 1000.0
 
+  [simulation.domain]
+    number = 2
+
 [grid]
   resolution = [128, 64]
   extent = [[0.8, 100.0]]
@@ -311,6 +334,10 @@ auto main(int argc, char* argv[]) -> int {
       assert_equal<std::string>(params_mink_1d.get<std::string>("setup.mystr"),
                                 "hi",
                                 "setup.mystr");
+      assert_equal<std::string>(
+        params_mink_1d.get<std::string>("diagnostics.log_level"),
+        "warning",
+        "diagnostics.log_level");
     }
 
     {
@@ -375,6 +402,9 @@ auto main(int argc, char* argv[]) -> int {
       assert_equal(params_sph_2d.get<bool>("particles.use_weights"),
                    true,
                    "particles.use_weights");
+      assert_equal(params_sph_2d.get<std::size_t>("particles.sort_interval"),
+                   (std::size_t)50,
+                   "particles.sort_interval");
 
       assert_equal(params_sph_2d.get<real_t>("algorithms.gca.e_ovr_b_max"),
                    (real_t)0.95,
@@ -424,6 +454,67 @@ auto main(int argc, char* argv[]) -> int {
                                PrtlPusher::PHOTON,
                                "species[2].pusher");
       assert_equal<unsigned short>(species[2].npld(), 0, "species[2].npld");
+
+      const auto hist_names = params_sph_2d.get<std::vector<std::string>>(
+        "output.histograms.names");
+      assert_equal<std::size_t>(hist_names.size(), 1, "output.histograms.names");
+      assert_equal<std::string>(hist_names[0], "eMu", "output.histograms.names");
+      assert_equal<std::size_t>(
+        params_sph_2d.get<std::size_t>("output.histograms.interval"),
+        10,
+        "output.histograms.interval");
+      const auto quantities = params_sph_2d.get<std::vector<std::string>>(
+        "output.histograms.eMu.quantities");
+      assert_equal<std::string>(quantities[0],
+                                "e",
+                                "output.histograms.eMu.quantities");
+      assert_equal<std::string>(quantities[1],
+                                "mu",
+                                "output.histograms.eMu.quantities");
+      const auto ranges = params_sph_2d.get<boundaries_t<real_t>>(
+        "output.histograms.eMu.ranges");
+      assert_equal<real_t>(ranges[0].first,
+                           (real_t)(1e-2),
+                           "output.histograms.eMu.ranges");
+      assert_equal<real_t>(ranges[1].second,
+                           (real_t)(1.0),
+                           "output.histograms.eMu.ranges");
+      assert_equal<std::size_t>(
+        params_sph_2d.get<std::vector<std::size_t>>(
+          "output.histograms.eMu.n_bins")[1],
+        20,
+        "output.histograms.eMu.n_bins");
+      assert_equal<bool>(
+        params_sph_2d.get<std::vector<bool>>("output.histograms.eMu.log_bins")[0],
+        true,
+        "output.histograms.eMu.log_bins");
+      assert_equal<std::size_t>(
+        params_sph_2d
+          .get<std::vector<unsigned short>>("output.histograms.eMu.species")
+          .size(),
+        2,
+        "output.histograms.eMu.species");
+      assert_equal<std::size_t>(
+        params_sph_2d.get<boundaries_t<real_t>>("output.histograms.eMu.box").size(),
+        0,
+        "output.histograms.eMu.box");
+
+      const auto flds_mean = params_sph_2d.get<std::vector<std::string>>(
+        "output.fields.mean");
+      assert_equal<std::size_t>(flds_mean.size(), 2, "output.fields.mean");
+      assert_equal<std::string>(flds_mean[1], "S", "output.fields.mean");
+      assert_equal<std::size_t>(
+        params_sph_2d.get<std::vector<std::string>>("output.fields.rms").size(),
+        1,
+        "output.fields.rms");
+      assert_equal<std::size_t>(
+        params_sph_2d.get<std::vector<std::string>>("output.fields.integral").size(),
+        0,
+        "output.fields.integral");
+      assert_equal<std::size_t>(
+        params_sph_2d.get<std::size_t>("output.fields.accumulate_interval"),
+        5,
+        "output.fields.accumulate_interval");
     }
 
     {
@@ -451,6 +542,11 @@ auto main(int argc, char* argv[]) -> int {
       assert_equal<real_t>(params_qks_2d.get<real_t>("grid.metric.ks_a"),
                            (real_t)(0.99),
                            "grid.metric.ks_a");
+
+      // several local domains exchange the particles every step
+      assert_equal(params_qks_2d.get<std::size_t>("particles.sort_interval"),
+                   (std::size_t)1,
+                   "particles.sort_interval");
       assert_equal<real_t>(params_qks_2d.get<real_t>("grid.metric.ks_rh"),
                            (real_t)((1.0 + std::sqrt(1 - 0.99 * 0.99))),
                            "grid.metric.ks_rh");
@@ -33,12 +33,6 @@ void testParticles(const int&             index,
 
   raise::ErrorIf(p.i1.extent(0) != maxnpart, "i1 incorrectly allocated", HERE);
   raise::ErrorIf(p.dx1.extent(0) != maxnpart, "dx1 incorrectly allocated", HERE);
-  raise::ErrorIf(p.i1_prev.extent(0) != maxnpart,
-                 "i1_prev incorrectly allocated",
-                 HERE);
-  raise::ErrorIf(p.dx1_prev.extent(0) != maxnpart,
-                 "dx1_prev incorrectly allocated",
-                 HERE);
   raise::ErrorIf(p.ux1.extent(0) != maxnpart, "ux1 incorrectly allocated", HERE);
   raise::ErrorIf(p.ux2.extent(0) != maxnpart, "ux2 incorrectly allocated", HERE);
   raise::ErrorIf(p.ux3.extent(0) != maxnpart, "ux3 incorrectly allocated", HERE);
@@ -54,36 +48,16 @@ void testParticles(const int&             index,
   if constexpr ((D == Dim::_2D) || (D == Dim::_3D)) {
     raise::ErrorIf(p.i2.extent(0) != maxnpart, "i2 incorrectly allocated", HERE);
     raise::ErrorIf(p.dx2.extent(0) != maxnpart, "dx2 incorrectly allocated", HERE);
-
-    raise::ErrorIf(p.i2_prev.extent(0) != maxnpart,
-                   "i2_prev incorrectly allocated",
-                   HERE);
-    raise::ErrorIf(p.dx2_prev.extent(0) != maxnpart,
-                   "dx2_prev incorrectly allocated",
-                   HERE);
   } else {
     raise::ErrorIf(p.i2.extent(0) != 0, "i2 incorrectly allocated", HERE);
     raise::ErrorIf(p.dx2.extent(0) != 0, "dx2 incorrectly allocated", HERE);
-
-    raise::ErrorIf(p.i2_prev.extent(0) != 0, "i2_prev incorrectly allocated", HERE);
-    raise::ErrorIf(p.dx2_prev.extent(0) != 0, "dx2_prev incorrectly allocated", HERE);
   }
   if constexpr (D == Dim::_3D) {
     raise::ErrorIf(p.i3.extent(0) != maxnpart, "i3 incorrectly allocated", HERE);
     raise::ErrorIf(p.dx3.extent(0) != maxnpart, "dx3 incorrectly allocated", HERE);
-
-    raise::ErrorIf(p.i3_prev.extent(0) != maxnpart,
-                   "i3_prev incorrectly allocated",
-                   HERE);
-    raise::ErrorIf(p.dx3_prev.extent(0) != maxnpart,
-                   "dx3_prev incorrectly allocated",
-                   HERE);
   } else {
     raise::ErrorIf(p.i3.extent(0) != 0, "i3 incorrectly allocated", HERE);
     raise::ErrorIf(p.dx3.extent(0) != 0, "dx3 incorrectly allocated", HERE);
-
-    raise::ErrorIf(p.i3_prev.extent(0) != 0, "i3_prev incorrectly allocated", HERE);
-    raise::ErrorIf(p.dx3_prev.extent(0) != 0, "dx3_prev incorrectly allocated", HERE);
   }
 
   if ((D == Dim::_2D) && (C != Coord::Cart)) {
@@ -93,6 +67,214 @@ void testParticles(const int&             index,
   }
 }
 
+template <Dimension D>
+void testParticlesPrev(const std::size_t& maxnpart) {
+  using namespace ntt;
+  auto prev = ParticlesPrev<D>(maxnpart);
+  raise::ErrorIf(prev.capacity() != maxnpart, "Wrong capacity", HERE);
+  raise::ErrorIf(prev.i1.extent(0) != maxnpart, "i1 incorrectly allocated", HERE);
+  raise::ErrorIf(prev.dx1.extent(0) != maxnpart, "dx1 incorrectly allocated", HERE);
+  const std::size_t ni2 = ((D == Dim::_2D) || (D == Dim::_3D)) ? maxnpart : 0;
+  const std::size_t ni3 = (D == Dim::_3D) ? maxnpart : 0;
+  raise::ErrorIf(prev.i2.extent(0) != ni2, "i2 incorrectly allocated", HERE);
+  raise::ErrorIf(prev.dx2.extent(0) != ni2, "dx2 incorrectly allocated", HERE);
+  raise::ErrorIf(prev.i3.extent(0) != ni3, "i3 incorrectly allocated", HERE);
+  raise::ErrorIf(prev.dx3.extent(0) != ni3, "dx3 incorrectly allocated", HERE);
+
+  // smaller requests reuse the buffer
+  const auto i1 = prev.i1;
+  prev.reserve(maxnpart / 2);
+  raise::ErrorIf(prev.i1.data() != i1.data(), "Buffer is reallocated", HERE);
+  prev.reserve(2 * maxnpart);
+  raise::ErrorIf(prev.capacity() != 2 * maxnpart, "Buffer is not grown", HERE);
+}
+
+void testParticlesResize() {
+  using namespace ntt;
+  const std::size_t maxnpart = 100;
+  auto              p        = Particles<Dim::_2D, Coord::Sph>(1,
+                                                  "e-",
+                                                  1.0,
+                                                  -1.0,
+                                                  maxnpart,
+                                                  PrtlPusher::BORIS,
+                                                  false,
+                                                  Cooling::NONE,
+                                                  1,
+                                                  true,
+                                                  2.0,
+                                                  0.25);
+  auto i1_h = Kokkos::create_mirror_view(p.i1);
+  for (std::size_t n { 0 }; n < maxnpart; ++n) {
+    i1_h(n) = static_cast<int>(n);
+  }
+  Kokkos::deep_copy(p.i1, i1_h);
+  Kokkos::deep_copy(p.tag, ParticleTag::alive);
+  p.set_npart(maxnpart);
+
+  // fits: nothing happens
+  p.Reserve(maxnpart);
+  raise::ErrorIf(p.maxnpart() != maxnpart, "Capacity changed", HERE);
+
+  // grows geometrically, preserving the contents
+  p.Reserve(maxnpart + 1);
+  raise::ErrorIf(p.maxnpart() != 2 * (maxnpart + 1), "Capacity is not grown", HERE);
+  raise::ErrorIf((p.i1.extent(0) != p.maxnpart()) or
+                   (p.i2.extent(0) != p.maxnpart()) or
+                   (p.phi.extent(0) != p.maxnpart()) or
+                   (p.pld[0].extent(0) != p.maxnpart()) or
+                   (p.id.extent(0) != p.maxnpart()) or
+                   (p.i1_h.extent(0) != p.maxnpart()),
+                 "Arrays are not grown",
+                 HERE);
+  Kokkos::deep_copy(p.i1_h, p.i1);
+  for (std::size_t n { 0 }; n < maxnpart; ++n) {
+    raise::ErrorIf(p.i1_h(n) != static_cast<int>(n), "i1 is not preserved", HERE);
+  }
+  auto id_h = Kokkos::create_mirror_view(p.id);
+  Kokkos::deep_copy(id_h, p.id);
+  raise::ErrorIf(id_h(p.maxnpart() - 1) != 0, "New entries are not zeroed", HERE);
+
+  // no shrinking above the threshold
+  p.ShrinkToFit();
+  raise::ErrorIf(p.maxnpart() != 2 * (maxnpart + 1), "Capacity is shrunk", HERE);
+
+  // shrinks after large deletions, but never below the initial capacity
+  p.set_npart(10);
+  p.ShrinkToFit();
+  raise::ErrorIf(p.maxnpart() != maxnpart, "Capacity is not shrunk", HERE);
+  Kokkos::deep_copy(p.i1_h, p.i1);
+  for (std::size_t n { 0 }; n < p.npart(); ++n) {
+    raise::ErrorIf(p.i1_h(n) != static_cast<int>(n), "i1 is not preserved", HERE);
+  }
+
+  // fixed capacity
+  auto q = Particles<Dim::_1D, Coord::Cart>(2,
+                                            "e+",
+                                            1.0,
+                                            1.0,
+                                            maxnpart,
+                                            PrtlPusher::BORIS,
+                                            false,
+                                            Cooling::NONE);
+  q.Reserve(2 * maxnpart);
+  raise::ErrorIf(q.maxnpart() != maxnpart, "Fixed capacity is grown", HERE);
+}
+
+void testSortByTags() {
+  using namespace ntt;
+  const std::size_t npart = 20;
+  auto              p     = Particles<Dim::_1D, Coord::Cart>(1,
+                                                  "e-",
+                                                  1.0,
+                                                  -1.0,
+                                                  100,
+                                                  PrtlPusher::BORIS,
+                                                  false,
+                                                  Cooling::NONE);
+  // i1 encodes the original tag, so the particles can be followed
+  auto i1_h  = Kokkos::create_mirror_view(p.i1);
+  auto tag_h = Kokkos::create_mirror_view(p.tag);
+  for (std::size_t n { 0 }; n < npart; ++n) {
+    tag_h(n) = ParticleTag::alive;
+  }
+  tag_h(2)  = ParticleTag::dead;
+  tag_h(5)  = 2;
+  tag_h(7)  = ParticleTag::dead;
+  tag_h(19) = 2;
+  tag_h(18) = 3;
+  for (std::size_t n { 0 }; n < npart; ++n) {
+    i1_h(n) = static_cast<int>(tag_h(n));
+  }
+  Kokkos::deep_copy(p.i1, i1_h);
+  Kokkos::deep_copy(p.tag, tag_h);
+  p.set_npart(npart);
+
+  const auto np_per_tag = p.SortByTags();
+  raise::ErrorIf(p.npart() != npart - 5, "Wrong number of alive particles", HERE);
+  raise::ErrorIf((np_per_tag[ParticleTag::dead] != 2) or (np_per_tag[2] != 2) or
+                   (np_per_tag[3] != 1),
+                 "Wrong number of particles per tag",
+                 HERE);
+  Kokkos::deep_copy(i1_h, p.i1);
+  Kokkos::deep_copy(tag_h, p.tag);
+  const std::vector<short> expected { ParticleTag::dead, ParticleTag::dead, 2, 2, 3 };
+  for (std::size_t n { 0 }; n < npart; ++n) {
+    const auto tag_exp = (n < npart - 5) ? (short)(ParticleTag::alive)
+                                         : expected[n - (npart - 5)];
+    raise::ErrorIf(tag_h(n) != tag_exp, "Wrong tag after sorting", HERE);
+    raise::ErrorIf(i1_h(n) != tag_h(n), "Particle data is not moved", HERE);
+  }
+}
+
+void testParticleIDs() {
+  using namespace ntt;
+  const std::size_t  maxnpart = 100, npart = 10;
+  const unsigned int domain   = 3;
+  const std::size_t  prefix   = static_cast<std::size_t>(domain) << 40;
+  auto               p        = Particles<Dim::_2D, Coord::Cart>(1,
+                                                    "e-",
+                                                    1.0,
+                                                    -1.0,
+                                                    maxnpart,
+                                                    PrtlPusher::BORIS,
+                                                    false,
+                                                    Cooling::NONE,
+                                                    0,
+                                                    true);
+  raise::ErrorIf(not p.track_ids(), "IDs are not tracked", HERE);
+  raise::ErrorIf(p.id.extent(0) != maxnpart, "id incorrectly allocated", HERE);
+
+  Kokkos::deep_copy(p.tag, ParticleTag::alive);
+  p.set_npart(npart);
+  p.AssignIDs(domain);
+  raise::ErrorIf(p.next_id() != npart + 1, "Wrong ID counter", HERE);
+  auto id_h = Kokkos::create_mirror_view(p.id);
+  Kokkos::deep_copy(id_h, p.id);
+  for (std::size_t n { 0 }; n < npart; ++n) {
+    raise::ErrorIf(id_h(n) != (prefix | (n + 1)), "Wrong ID assigned", HERE);
+  }
+
+  // already assigned IDs are kept
+  p.AssignIDs(domain);
+  raise::ErrorIf(p.next_id() != npart + 1, "IDs are reassigned", HERE);
+
+  // dead particles lose their IDs after sorting, alive ones keep them
+  auto tag_h = Kokkos::create_mirror_view(p.tag);
+  Kokkos::deep_copy(tag_h, p.tag);
+  tag_h(0) = ParticleTag::dead;
+  tag_h(5) = ParticleTag::dead;
+  Kokkos::deep_copy(p.tag, tag_h);
+  p.set_unsorted();
+  p.SortByTags();
+  raise::ErrorIf(p.npart() != npart - 2, "Wrong number of alive particles", HERE);
+  Kokkos::deep_copy(id_h, p.id);
+  std::size_t checksum { 0 };
+  for (std::size_t n { 0 }; n < npart; ++n) {
+    if (n < npart - 2) {
+      raise::ErrorIf((id_h(n) & prefix) != prefix, "Wrong ID after sorting", HERE);
+      checksum += id_h(n) - prefix;
+    } else {
+      raise::ErrorIf(id_h(n) != 0, "ID of a dead particle is not reset", HERE);
+    }
+  }
+  raise::ErrorIf(checksum != (npart * (npart + 1)) / 2 - 1 - 6,
+                 "IDs are not preserved by sorting",
+                 HERE);
+
+  // new particles get the next IDs
+  Kokkos::deep_copy(Kokkos::subview(p.tag, range_tuple_t(npart - 2, npart)),
+                    ParticleTag::alive);
+  p.set_npart(npart);
+  p.AssignIDs(domain);
+  raise::ErrorIf(p.next_id() != npart + 3, "Wrong ID counter", HERE);
+  Kokkos::deep_copy(id_h, p.id);
+  raise::ErrorIf((id_h(npart - 2) != (prefix | (npart + 1))) or
+                   (id_h(npart - 1) != (prefix | (npart + 2))),
+                 "Wrong ID of the new particles",
+                 HERE);
+}
+
 auto main(int argc, char** argv) -> int {
   Kokkos::initialize(argc, argv);
   try {
@@ -132,6 +314,12 @@ auto main(int argc, char** argv) -> int {
                                          100,
                                          PrtlPusher::BORIS,
                                          Cooling::NONE);
+    testParticlesPrev<Dim::_1D>(100);
+    testParticlesPrev<Dim::_2D>(100);
+    testParticlesPrev<Dim::_3D>(100);
+    testParticlesResize();
+    testSortByTags();
+    testParticleIDs();
   } catch (const std::exception& e) {
     std::cerr << "Error: " << e.what() << std::endl;
     Kokkos::finalize();
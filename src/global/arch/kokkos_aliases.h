@@ -6,6 +6,8 @@
  *   - array_t, array_mirror_t, scatter_array_t
  *   - ndarray_t, ndfield_t
  *   - ndfield_mirror_t, scatter_ndfield_t
+ *   - atomic_ndfield_t, scratch_ndfield_t
+ *   - team_policy_t, team_member_t, scratch_space_t
  *   - range_t, range_h_t
  *   - CreateRangePolicy, CreateRangePolicyOnHost
  *   - random_number_pool_t, random_generator_t
@@ -164,6 +166,76 @@ template <Dimension D, unsigned short N>
 using randacc_ndfield_t =
   typename kokkos_aliases_hidden::randacc_ndfield_impl<D, N>::type;
 
+// D x N dimensional array with atomic access (for accumulating into fields)
+namespace kokkos_aliases_hidden {
+  // c++ magic
+  template <Dimension D, unsigned short N>
+  struct atomic_ndfield_impl {
+    using type = void;
+  };
+
+  template <unsigned short N>
+  struct atomic_ndfield_impl<Dim::_1D, N> {
+    using type =
+      Kokkos::View<real_t* [N], AccelMemSpace, Kokkos::MemoryTraits<Kokkos::Atomic>>;
+  };
+
+  template <unsigned short N>
+  struct atomic_ndfield_impl<Dim::_2D, N> {
+    using type =
+      Kokkos::View<real_t** [N], AccelMemSpace, Kokkos::MemoryTraits<Kokkos::Atomic>>;
+  };
+
+  template <unsigned short N>
+  struct atomic_ndfield_impl<Dim::_3D, N> {
+    using type =
+      Kokkos::View<real_t*** [N], AccelMemSpace, Kokkos::MemoryTraits<Kokkos::Atomic>>;
+  };
+} // namespace kokkos_aliases_hidden
+
+template <Dimension D, unsigned short N>
+using atomic_ndfield_t =
+  typename kokkos_aliases_hidden::atomic_ndfield_impl<D, N>::type;
+
+// Team policy & per-team scratch (shared) memory for hierarchical kernels
+using team_policy_t   = Kokkos::TeamPolicy<AccelExeSpace>;
+using team_member_t   = typename team_policy_t::member_type;
+using scratch_space_t = typename AccelExeSpace::scratch_memory_space;
+
+// D x N dimensional array in the scratch memory (atomic access within a team)
+namespace kokkos_aliases_hidden {
+  // c++ magic
+  template <Dimension D, unsigned short N>
+  struct scratch_ndfield_impl {
+    using type = void;
+  };
+
+  template <unsigned short N>
+  struct scratch_ndfield_impl<Dim::_1D, N> {
+    using type = Kokkos::View<real_t* [N],
+                              scratch_space_t,
+                              Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::Atomic>>;
+  };
+
+  template <unsigned short N>
+  struct scratch_ndfield_impl<Dim::_2D, N> {
+    using type = Kokkos::View<real_t** [N],
+                              scratch_space_t,
+                              Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::Atomic>>;
+  };
+
+  template <unsigned short N>
+  struct scratch_ndfield_impl<Dim::_3D, N> {
+    using type = Kokkos::View<real_t*** [N],
+                              scratch_space_t,
+                              Kokkos::MemoryTraits<Kokkos::Unmanaged | Kokkos::Atomic>>;
+  };
+} // namespace kokkos_aliases_hidden
+
+template <Dimension D, unsigned short N>
+using scratch_ndfield_t =
+  typename kokkos_aliases_hidden::scratch_ndfield_impl<D, N>::type;
+
 // Defining aliases for `RangePolicy` and `MDRangePolicy` for the device space
 namespace kokkos_aliases_hidden {
   // c++ magic
@@ -6,8 +6,12 @@
  *   - mpi::SendTag<> -> short
  * @namespaces:
  *   - mpi::
+ * @note Used without MPI as well (for the exchange between local domains)
  */
 
+#ifndef GLOBAL_ARCH_MPI_TAGS_H
+#define GLOBAL_ARCH_MPI_TAGS_H
+
 #include "global.h"
 
 #include "arch/directions.h"
@@ -226,3 +230,5 @@ namespace mpi {
            tag;
   }
 } // namespace mpi
+
+#endif // GLOBAL_ARCH_MPI_TAGS_H
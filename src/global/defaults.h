@@ -27,6 +27,23 @@ namespace ntt::defaults {
   const std::string ph_pusher     = "Photon";
   const std::size_t sort_interval = 100;
 
+  const std::size_t spatial_sort_interval = 0;
+
+  namespace prtl_capacity {
+    const float growth_factor    = 1.5;
+    const float shrink_threshold = 0.25;
+  } // namespace prtl_capacity
+
+  namespace load_balancing {
+    const std::size_t interval    = 0;
+    const real_t      threshold   = 1.2;
+    const real_t      cell_weight = 1.0;
+  } // namespace load_balancing
+
+  namespace deposit {
+    const unsigned short tile_size = 0;
+  } // namespace deposit
+
   namespace qsph {
     const real_t r0 = 0.0;
     const real_t h  = 0.0;
@@ -49,19 +66,39 @@ namespace ntt::defaults {
   }   // namespace bc
 
   namespace output {
-    const std::string    format      = "hdf5";
-    const std::size_t    interval    = 100;
-    const unsigned short mom_smooth  = 0;
-    const unsigned short flds_stride = 1;
-    const std::size_t    prtl_stride = 100;
-    const real_t         spec_emin   = 1e-3;
-    const real_t         spec_emax   = 1e3;
-    const bool           spec_log    = true;
-    const std::size_t    spec_nbins  = 200;
+    const std::string    format            = "hdf5";
+    const std::size_t    interval          = 100;
+    const std::size_t    async_depth       = 1;
+    const unsigned short mom_smooth        = 0;
+    const unsigned short flds_stride       = 1;
+    const std::string    flds_downsampling = "pick";
+    const std::size_t    flds_acc_interval = 1;
+    const std::string    compression       = "none";
+    const std::size_t    prtl_stride       = 100;
+    const real_t         prtl_emin         = 0.0;
+    const real_t         spec_emin         = 1e-3;
+    const real_t         spec_emax         = 1e3;
+    const bool           spec_log          = true;
+    const std::size_t    spec_nbins        = 200;
+    const std::size_t    hist_nbins        = 100;
+    const unsigned int   stream_readers    = 1;
+    const unsigned int   stream_queue      = 1;
+    const std::string    stream_policy     = "block";
   } // namespace output
 
+  namespace checkpoint {
+    const std::size_t interval = 0;
+    const std::size_t keep     = 2;
+  } // namespace checkpoint
+
   namespace diag {
     const std::size_t interval = 1;
+    const std::string report   = "disabled";
+#if defined(DEBUG)
+    const std::string log_level = "verbose";
+#else
+    const std::string log_level = "info";
+#endif
   } // namespace diag
 
   namespace gca {
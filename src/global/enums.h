@@ -14,6 +14,7 @@
  *   - enum ntt::Cooling           // synchrotron, none
  *   - enum ntt::FldsID            // e, dive, d, divd, b, h, j,
  *                                    a, t, rho, charge, n, nppc, custom
+ *   - enum ntt::HistAxis          // x1, x2, x3, u1, u2, u3, e, upar, uperp, mu
  * @namespaces:
  *   - ntt::
  * @note Enums of the same type can be compared with each other and with strings
@@ -302,6 +303,32 @@ namespace ntt {
     static constexpr std::size_t total = sizeof(variants) / sizeof(variants[0]);
   };
 
+  struct HistAxis : public enums_hidden::BaseEnum<HistAxis> {
+    static constexpr const char* label = "hist_axis";
+
+    enum type : uint8_t {
+      INVALID = 0,
+      X1      = 1,
+      X2      = 2,
+      X3      = 3,
+      U1      = 4,
+      U2      = 5,
+      U3      = 6,
+      E       = 7,
+      Upar    = 8,
+      Uperp   = 9,
+      Mu      = 10,
+    };
+
+    constexpr HistAxis(uint8_t c) : enums_hidden::BaseEnum<HistAxis> { c } {}
+
+    static constexpr type variants[] = { X1, X2, X3,   U1,    U2,
+                                         U3, E,  Upar, Uperp, Mu };
+    static constexpr const char* lookup[] = { "x1", "x2", "x3",   "u1",    "u2",
+                                              "u3", "e",  "upar", "uperp", "mu" };
+    static constexpr std::size_t total = sizeof(variants) / sizeof(variants[0]);
+  };
+
 } // namespace ntt
 
 #endif // GLOBAL_ENUMS_H
@@ -6,10 +6,18 @@
   #include <mpi.h>
 #endif // MPI_ENABLED
 
-void ntt::GlobalInitialize(int argc, char* argv[]) {
+void ntt::GlobalInitialize(int argc, char* argv[], bool mpi_thread_multiple) {
   Kokkos::initialize(argc, argv);
 #if defined(MPI_ENABLED)
-  MPI_Init(&argc, &argv);
+  if (mpi_thread_multiple) {
+    // the provided level is checked when the (asynchronous) output is set up
+    int mpi_thread_support;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &mpi_thread_support);
+  } else {
+    MPI_Init(&argc, &argv);
+  }
+#else
+  (void)mpi_thread_multiple;
 #endif // MPI_ENABLED
 }
 
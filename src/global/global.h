@@ -33,6 +33,8 @@
  *   - files::
  * @macros:
  *   - MPI_ENABLED
+ *   - SINGLE_PRECISION
+ *   - COMPACT_PRTL
  * @note
  * CellLayer enum:
  *
@@ -88,6 +90,7 @@
 #ifndef GLOBAL_GLOBAL_H
 #define GLOBAL_GLOBAL_H
 
+#include <cstdint>
 #include <limits>
 #include <utility>
 #include <vector>
@@ -138,7 +141,8 @@ namespace ntt {
     alive
   };
 
-  void GlobalInitialize(int argc, char* argv[]);
+  // MPI_THREAD_MULTIPLE is only requested for the asynchronous output
+  void GlobalInitialize(int argc, char* argv[], bool mpi_thread_multiple = false);
 
   void GlobalFinalize();
 
@@ -264,9 +268,13 @@ namespace BC {
     Dx1  = 1 << 0,
     Dx2  = 1 << 1,
     Dx3  = 1 << 2,
+    Hx1  = 1 << 3,
+    Hx2  = 1 << 4,
+    Hx3  = 1 << 5,
     B    = Bx1 | Bx2 | Bx3,
     E    = Ex1 | Ex2 | Ex3,
     D    = Dx1 | Dx2 | Dx3,
+    H    = Hx1 | Hx2 | Hx3,
   };
 } // namespace BC
 
@@ -286,7 +294,12 @@ typedef int InjTags;
 using Dim = Dimension;
 
 // Defining precision-based constants and types
+#if defined(COMPACT_PRTL)
+// displacement within the cell as a 16-bit fixed-point fraction
+using prtldx_t = std::uint16_t;
+#else
 using prtldx_t = float;
+#endif
 #if defined(SINGLE_PRECISION)
 using real_t = float;
 #else
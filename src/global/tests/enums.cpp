@@ -69,6 +69,8 @@ auto main() -> int {
   enum_str_t all_out_flds = { "e",      "dive", "d",    "divd",  "b",
                               "h",      "j",    "a",    "t",     "rho",
                               "charge", "n",    "nppc", "custom" };
+  enum_str_t all_hist_axes = { "x1", "x2", "x3",   "u1",    "u2",
+                               "u3", "e",  "upar", "uperp", "mu" };
 
   checkEnum<Coord>(all_coords);
   checkEnum<Metric>(all_metrics);
@@ -78,6 +80,7 @@ auto main() -> int {
   checkEnum<PrtlPusher>(all_particle_pushers);
   checkEnum<Cooling>(all_coolings);
   checkEnum<FldsID>(all_out_flds);
+  checkEnum<HistAxis>(all_hist_axes);
 
   return 0;
 }
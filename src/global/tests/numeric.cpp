@@ -57,6 +57,52 @@ void testVec() {
           "DOT of b and c != 0");
 }
 
+void testPrtldx() {
+  // resolution of the stored displacement within the cell
+  constexpr bool is_compact = (sizeof(prtldx_t) < sizeof(float));
+  const auto     res        = is_compact ? static_cast<real_t>(1.0 / 65536.0)
+                                         : static_cast<real_t>(1e-6);
+  for (auto n { 0 }; n < 1000; ++n) {
+    const auto dx     = static_cast<real_t>(n) / static_cast<real_t>(1000);
+    const auto stored = to_prtldx(dx);
+    errorIf(math::abs(from_prtldx(stored) - dx) > res,
+            "from_prtldx(to_prtldx(dx)) != dx");
+    errorIf((from_prtldx(stored) < ZERO) or (from_prtldx(stored) >= ONE),
+            "stored dx is outside [0, 1)");
+    if constexpr (is_compact) {
+      // reflecting twice returns the same stored displacement
+      const auto reflected = to_prtldx(ONE - from_prtldx(stored));
+      errorIf(to_prtldx(ONE - from_prtldx(reflected)) != stored,
+              "reflection of dx is not reversible");
+    }
+  }
+}
+
+void testSlowPrtldx() {
+  // particle moving by less than half of the compact resolution per step
+  const auto        v      = static_cast<real_t>(1e-6);
+  const std::size_t nsteps = 10000;
+  int               i      = 0;
+  prtldx_t          dx     = to_prtldx(HALF);
+  const auto        x0     = static_cast<real_t>(i) + from_prtldx(dx);
+  for (std::size_t step { 0 }; step < nsteps; ++step) {
+    const auto x = static_cast<real_t>(i) + from_prtldx(dx) + v;
+    i            = static_cast<int>(x);
+    dx           = to_prtldx(x - static_cast<real_t>(i), prtldx_dither(0, step, 0));
+  }
+  const auto moved    = static_cast<real_t>(i) + from_prtldx(dx) - x0;
+  const auto expected = v * static_cast<real_t>(nsteps);
+  errorIf(moved <= ZERO, "slow particle does not move");
+  errorIf(math::abs(moved - expected) > static_cast<real_t>(0.3) * expected,
+          "slow particle moves by a wrong distance");
+
+  // dither is in [0, 1)
+  for (std::size_t p { 0 }; p < 1000; ++p) {
+    const auto u = prtldx_dither(p, 7, 1);
+    errorIf((u < ZERO) or (u >= ONE), "prtldx_dither is outside [0, 1)");
+  }
+}
+
 auto main() -> int {
   errorIf(IMIN(1, 2) != 1, "IMIN(1, 2) != 1");
   errorIf(IMIN(2, 1) != 1, "IMIN(2, 1) != 1");
@@ -76,5 +122,8 @@ auto main() -> int {
   // dot product of perp 3D vectors
   testVec<float>();
   testVec<double>();
+
+  testPrtldx();
+  testSlowPrtldx();
   return 0;
 }
\ No newline at end of file
@@ -105,6 +105,35 @@ auto main(int argc, char* argv[]) -> int {
           raise::KernelError(HERE, "Short sort failed");
         }
       });
+
+    // sort with precomputed indices
+    auto keys_index = Kokkos::View<int*>("keys_index", n);
+    Kokkos::parallel_for(
+      n,
+      KOKKOS_LAMBDA(const std::size_t i) {
+        keys_index(i) = static_cast<int>((n - 1 - i) % 10);
+        values(i)     = static_cast<int>(i);
+      });
+    using KeyType_index = Kokkos::View<int*>;
+    using BinOp_index   = sort::BinIndex<KeyType_index>;
+    BinOp_index bin_op_index(10);
+    Kokkos::BinSort<KeyType_index, BinOp_index> sorter_index(keys_index,
+                                                             bin_op_index,
+                                                             false);
+    sorter_index.create_permute_vector();
+    sorter_index.sort(keys_index);
+    sorter_index.sort(values);
+
+    Kokkos::parallel_for(
+      n,
+      KOKKOS_LAMBDA(const std::size_t i) {
+        auto should_raise = (keys_index(i) != static_cast<int>(i / 10));
+        should_raise = should_raise ||
+                       (static_cast<int>((n - 1 - values(i)) % 10) != keys_index(i));
+        if (should_raise) {
+          raise::KernelError(HERE, "Index sort failed");
+        }
+      });
   } catch (const std::exception& e) {
     std::cerr << e.what() << std::endl;
     Kokkos::finalize();
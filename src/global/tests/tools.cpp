@@ -0,0 +1,55 @@
+#include "utils/tools.h"
+
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+void errorIf(bool condition, const std::string& message) {
+  if (condition) {
+    throw std::runtime_error(message);
+  }
+}
+
+auto main() -> int {
+  try {
+    {
+      // uniform cost reproduces the uniform decomposition
+      const auto cost     = std::vector<double>(100, 1.0);
+      const auto weighted = tools::decompose1DWeighted(4, cost);
+      const auto uniform  = tools::decompose1D(4, 100);
+      errorIf(weighted != uniform, "uniform cost gives non-uniform domains");
+    }
+    {
+      // cost concentrated in the first quarter of the grid
+      auto cost = std::vector<double>(100, 1.0);
+      for (std::size_t i { 0 }; i < 25; ++i) {
+        cost[i] = 100.0;
+      }
+      const auto ncells = tools::decompose1DWeighted(4, cost);
+      errorIf(ncells.size() != 4, "wrong number of domains");
+      errorIf(std::accumulate(ncells.begin(), ncells.end(), (std::size_t)0) != 100,
+              "sum of ncells != 100");
+      errorIf(ncells[0] >= 25, "first domain is not narrowed");
+      errorIf(ncells[3] <= 25, "last domain is not widened");
+      for (const auto& n : ncells) {
+        errorIf(n < 5, "domain narrower than the minimum");
+      }
+    }
+    {
+      // all the cost in a single cell: every domain still gets min_ncells
+      auto cost = std::vector<double>(40, 0.0);
+      cost[0]   = 1.0;
+      const auto ncells = tools::decompose1DWeighted(4, cost, 5);
+      errorIf(ncells[0] != 5, "first domain is not minimal");
+      errorIf(ncells[1] != 5, "second domain is not minimal");
+      errorIf(ncells[2] != 5, "third domain is not minimal");
+      errorIf(ncells[3] != 25, "last domain does not take the rest");
+    }
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
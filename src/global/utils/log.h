@@ -4,6 +4,7 @@
  * @implements
  *   - macro HERE
  *   - raise::Warning -> void
+ *   - logger::CheckpointsEnabled -> bool
  *   - logger::Checkpoint -> void
  *   - info::Print -> void
  * @namespaces:
@@ -28,6 +29,7 @@
 
 #include <iostream>
 #include <string>
+#include <type_traits>
 
 #if defined(MPI_ENABLED)
   #include <mpi.h>
@@ -75,13 +77,25 @@ namespace raise {
 namespace logger {
   using namespace files;
 
-  inline void Checkpoint(const std::string& file, const std::string& func, int line) {
+  /**
+   * @brief Whether the checkpoints are recorded (log file at the verbose level)
+   * @note Cheap enough to be checked in the hot paths
+   */
+  inline auto CheckpointsEnabled() -> bool {
+    const auto log = plog::get<LogFile>();
+    return (log != nullptr) && log->checkSeverity(plog::verbose);
+  }
+
+  inline void Checkpoint(const char* file, const char* func, int line) {
 #if defined(DEBUG)
     Kokkos::fence();
   #if defined(MPI_ENABLED)
     MPI_Barrier(MPI_COMM_WORLD);
   #endif
 #endif
+    if (!CheckpointsEnabled()) {
+      return;
+    }
     CallOnce(
       [](auto& file, auto& func, auto& line) {
         PLOGV_(LogFile) << "Checkpoint: " << file << ":" << line << " @ " << func;
@@ -92,8 +106,8 @@ namespace logger {
   }
 
   inline void Checkpoint(const std::string& msg,
-                         const std::string& file,
-                         const std::string& func,
+                         const char*        file,
+                         const char*        func,
                          int                line) {
 #if defined(DEBUG)
     Kokkos::fence();
@@ -101,6 +115,9 @@ namespace logger {
     MPI_Barrier(MPI_COMM_WORLD);
   #endif
 #endif
+    if (!CheckpointsEnabled()) {
+      return;
+    }
     CallOnce(
       [](auto& msg, auto& file, auto& func, auto& line) {
         PLOGV_(LogFile) << "Checkpoint: " << file << ":" << line << " @ " << func;
@@ -112,6 +129,34 @@ namespace logger {
       line);
   }
 
+  /**
+   * @brief Checkpoint with a deferred message
+   * @param msg callable returning the message: only called (on the root rank)
+   * if the checkpoints are recorded, e.g., `[&]() { return fmt::format(...); }`
+   */
+  template <class F,
+            typename = std::enable_if_t<std::is_invocable_r_v<std::string, F>>>
+  inline void Checkpoint(const F& msg, const char* file, const char* func, int line) {
+#if defined(DEBUG)
+    Kokkos::fence();
+  #if defined(MPI_ENABLED)
+    MPI_Barrier(MPI_COMM_WORLD);
+  #endif
+#endif
+    if (!CheckpointsEnabled()) {
+      return;
+    }
+    CallOnce(
+      [](auto& msg, auto& file, auto& func, auto& line) {
+        PLOGV_(LogFile) << "Checkpoint: " << file << ":" << line << " @ " << func;
+        PLOGV_(LogFile) << " : message : " << msg();
+      },
+      msg,
+      file,
+      func,
+      line);
+  }
+
 } // namespace logger
 
 namespace info {
@@ -15,10 +15,14 @@
  *   - macro CROSS_x2
  *   - macro CROSS_x3
  *   - literal real-valued numbers
+ *   - to_prtldx -> prtldx_t
+ *   - from_prtldx -> real_t
+ *   - prtldx_dither -> real_t
  * @namespaces:
  *   - constant::
  * @macros:
  *   - SINGLE_PRECISION
+ *   - COMPACT_PRTL
  * !TODO:
  *   - potentially use math::signbit instead of SIGN
  */
@@ -28,6 +32,7 @@
 
 #include "arch/kokkos_aliases.h"
 
+#include <cstddef>
 #include <cstdint>
 
 #if defined(SINGLE_PRECISION)
@@ -77,6 +82,54 @@ inline constexpr double INV_64 = 0.015625;
 #define CROSS_x2(ax1, ax2, ax3, bx1, bx2, bx3) ((ax3) * (bx1) - (ax1) * (bx3))
 #define CROSS_x3(ax1, ax2, ax3, bx1, bx2, bx3) ((ax1) * (bx2) - (ax2) * (bx1))
 
+/**
+ * @brief Converts the displacement of a particle within the cell to the
+ * storage type (and back)
+ * @note With COMPACT_PRTL, [0, 1) is split into 2^16 intervals, and the
+ * stored displacement is read back as the middle of its interval (so that
+ * the reflection dx -> 1 - dx is exact)
+ * @note With the default `dither` = 1/2 the displacement is rounded to the
+ * nearest stored value, so a particle moving by less than 2^-17 of a cell
+ * per step would never move; the pusher instead passes a pseudo-random
+ * `dither` in [0, 1) (see `prtldx_dither`), which makes the rounding
+ * unbiased on average
+ */
+Inline auto to_prtldx(real_t dx, real_t dither = HALF) -> prtldx_t {
+#if defined(COMPACT_PRTL)
+  const auto q = static_cast<int>(dx * static_cast<real_t>(65536) + (dither - HALF));
+  return static_cast<prtldx_t>(IMAX(0, IMIN(q, 65535)));
+#else
+  (void)dither;
+  return static_cast<prtldx_t>(dx);
+#endif
+}
+
+Inline auto from_prtldx(prtldx_t dx) -> real_t {
+#if defined(COMPACT_PRTL)
+  return (static_cast<real_t>(dx) + HALF) / static_cast<real_t>(65536);
+#else
+  return static_cast<real_t>(dx);
+#endif
+}
+
+/**
+ * @brief Stateless pseudo-random number in [0, 1) used for the stochastic
+ * rounding of the compact displacements
+ * @param p index of the particle
+ * @param step timestep
+ * @param d coordinate (0, 1 or 2)
+ * @note splitmix64 hash of the (particle, step, coordinate) counter
+ */
+Inline auto prtldx_dither(std::size_t p, std::size_t step, unsigned short d)
+  -> real_t {
+  auto z = static_cast<std::uint64_t>(p) * 0x9e3779b97f4a7c15ull +
+           ((static_cast<std::uint64_t>(step) << 2) | d);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  z = z ^ (z >> 31);
+  return static_cast<real_t>(z >> 40) / static_cast<real_t>(1u << 24);
+}
+
 namespace constant {
   inline constexpr std::uint64_t RandomSeed = 0x123456789abcdef0;
   inline constexpr double        HALF_PI    = 1.57079632679489661923;
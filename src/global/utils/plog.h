@@ -56,8 +56,14 @@ namespace plog {
 
 namespace logger {
 
+  /**
+   * @param fname base name of the log files
+   * @param log_level severity of the `.log` file: "verbose" (with checkpoints),
+   * "info" or "warning"
+   */
   template <int log_tag, int info_tag, int err_tag>
-  inline void initPlog(const std::string& fname) {
+  inline void initPlog(const std::string& fname,
+                       const std::string& log_level = "verbose") {
     // setup logging
     const auto logfile_name  = fname + ".log";
     const auto infofile_name = fname + ".info";
@@ -77,7 +83,10 @@ namespace logger {
       infofile_name.c_str());
     static plog::RollingFileAppender<plog::NttInfoFormatter> errfileAppender(
       errfile_name.c_str());
-    plog::init<log_tag>(plog::verbose, &logfileAppender);
+    const auto log_severity = (log_level == "warning") ? plog::warning
+                              : (log_level == "info")    ? plog::info
+                                                         : plog::verbose;
+    plog::init<log_tag>(log_severity, &logfileAppender);
     plog::init<info_tag>(plog::verbose, &infofileAppender);
     plog::init<err_tag>(plog::verbose, &errfileAppender);
 
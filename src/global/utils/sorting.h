@@ -4,10 +4,12 @@
  * @implements
  *   - sort::BinBool<>
  *   - sort::BinTag<>
+ *   - sort::BinIndex<>
  * @namespaces:
  *   - sort::
  * @note BinBool sorts by boolean values "true" then "false"
  * @note BinTag sorts by tag values "1" then "0" then "2" ... "n"
+ * @note BinIndex uses precomputed keys as bin indices "0" ... "n-1"
  */
 
 #ifndef GLOBAL_UTILS_SORTING_H
@@ -58,6 +60,28 @@ namespace sort {
     const int m_max_bins;
   };
 
+  template <class KeyViewType>
+  struct BinIndex {
+    BinIndex(const int& max_bins) : m_max_bins { max_bins } {}
+
+    template <class ViewType>
+    Inline auto bin(ViewType& keys, const int& i) const -> int {
+      return keys(i);
+    }
+
+    Inline auto max_bins() const -> int {
+      return m_max_bins;
+    }
+
+    template <class ViewType, typename iT1, typename iT2>
+    Inline auto operator()(ViewType&, iT1&, iT2&) const -> bool {
+      return false;
+    }
+
+  private:
+    const int m_max_bins;
+  };
+
 } // namespace sort
 
 #endif // GLOBAL_UTILS_SORTING_H
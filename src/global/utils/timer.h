@@ -54,6 +54,12 @@ namespace timer {
     const bool                                               m_blocking;
     const std::function<void(void)>                          m_synchronize;
 
+    // auxiliary counters (e.g., per-species timings, amount of work done)
+    // ... which are not printed, but collected for the performance report
+    std::map<std::string, long double> m_counters;
+    std::map<std::string, timestamp>   m_subtimers;
+    bool                               m_counting { false };
+
   public:
     Timers(std::initializer_list<std::string> names,
            const std::function<void(void)>&   synchronize = nullptr,
@@ -100,6 +106,70 @@ namespace timer {
       for (auto& [name, _] : m_timers) {
         reset(name);
       }
+      // counters are kept (zeroed), so each report has the same entries
+      for (auto& [_, value] : m_counters) {
+        value = 0.0;
+      }
+    }
+
+    /**
+     * @brief Enables the auxiliary counters (disabled by default, since the
+     * sub-timers have to synchronize the device)
+     */
+    void enableCounters() {
+      raise::ErrorIf(m_synchronize == nullptr,
+                     "Synchronize function not provided",
+                     HERE);
+      m_counting = true;
+    }
+
+    [[nodiscard]]
+    auto countersEnabled() const -> bool {
+      return m_counting;
+    }
+
+    /**
+     * @brief Adds `value` to the counter `name` (does nothing if disabled)
+     */
+    void count(const std::string& name, long double value) {
+      if (m_counting) {
+        m_counters[name] += value;
+      }
+    }
+
+    /**
+     * @brief Starts a synchronized sub-timer (e.g., for a single kernel)
+     * @note The duration [us] is added to the counter of the same name
+     */
+    void startSub(const std::string& name) {
+      if (m_counting) {
+        m_synchronize();
+        m_subtimers[name] = std::chrono::system_clock::now();
+      }
+    }
+
+    void stopSub(const std::string& name) {
+      if (m_counting) {
+        m_synchronize();
+        raise::ErrorIf(m_subtimers.find(name) == m_subtimers.end(),
+                       "Sub-timer not started",
+                       HERE);
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                               std::chrono::system_clock::now() -
+                               m_subtimers[name])
+                               .count();
+        m_counters[name] += elapsed;
+      }
+    }
+
+    [[nodiscard]]
+    auto names() const -> const std::vector<std::string>& {
+      return m_names;
+    }
+
+    [[nodiscard]]
+    auto counters() const -> const std::map<std::string, long double>& {
+      return m_counters;
     }
 
     [[nodiscard]]
@@ -4,6 +4,7 @@
  * @implements
  *   - tools::TensorProduct<> -> boundaries_t<T>
  *   - tools::decompose1D -> std::vector<std::size_t>
+ *   - tools::decompose1DWeighted -> std::vector<std::size_t>
  *   - tools::divideInProportions2D -> std::tuple<unsigned int, unsigned int>
  *   - tools::divideInProportions3D -> std::tuple<unsigned int, unsigned int, unsigned int>
  *   - tools::Decompose -> std::vector<std::vector<std::size_t>>
@@ -19,6 +20,7 @@
 #include "utils/error.h"
 #include "utils/numeric.h"
 
+#include <algorithm>
 #include <cmath>
 #include <numeric>
 #include <tuple>
@@ -73,6 +75,53 @@ namespace tools {
     return ncells_domain;
   }
 
+  /**
+   * @brief Decompose a 1D domain into ndomains domains with roughly equal cost
+   * @param ndomains Number of domains
+   * @param cost Cost of each of the cells
+   * @param min_ncells Minimum number of cells per domain
+   * @note Boundaries are placed where the cumulative cost crosses the multiples
+   * of the average cost per domain
+   */
+  inline auto decompose1DWeighted(unsigned int               ndomains,
+                                  const std::vector<double>& cost,
+                                  std::size_t                min_ncells = 5)
+    -> std::vector<std::size_t> {
+    const auto ncells = cost.size();
+    raise::ErrorIf(ndomains == 0, "Decomposition error: ndomains == 0", HERE);
+    raise::ErrorIf(ncells < min_ncells * ndomains,
+                   "Decomposition error: not enough cells",
+                   HERE);
+    auto cumulative = std::vector<double>(ncells + 1, 0.0);
+    for (std::size_t i { 0 }; i < ncells; ++i) {
+      raise::ErrorIf(cost[i] < 0.0, "Decomposition error: cost < 0", HERE);
+      cumulative[i + 1] = cumulative[i] + cost[i];
+    }
+    if (cumulative[ncells] <= 0.0) {
+      return decompose1D(ndomains, ncells);
+    }
+    auto        ncells_domain = std::vector<std::size_t>(ndomains, 0);
+    std::size_t left { 0 };
+    for (unsigned int d { 0 }; d < ndomains - 1; ++d) {
+      const auto target = cumulative[ncells] * (double)(d + 1) / (double)ndomains;
+      auto       right  = (std::size_t)(std::lower_bound(cumulative.begin(),
+                                                  cumulative.end(),
+                                                  target) -
+                                 cumulative.begin());
+      if ((right > 0) and
+          (target - cumulative[right - 1] < cumulative[right] - target)) {
+        --right;
+      }
+      // leave at least min_ncells for this and each of the remaining domains
+      right = std::max(right, left + min_ncells);
+      right = std::min(right, ncells - min_ncells * (ndomains - 1 - d));
+      ncells_domain[d] = right - left;
+      left             = right;
+    }
+    ncells_domain[ndomains - 1] = ncells - left;
+    return ncells_domain;
+  }
+
   /**
    * @brief Distribute a 2D domain into ntot domains with rough proportions s1 and s2
    * @param ntot Number of domains
@@ -4,6 +4,8 @@
  * @implements
  *   - kernel::gr::ComputeAuxE_kernel<>
  *   - kernel::gr::ComputeAuxH_kernel<>
+ *   - kernel::gr::TimeAverageDB_kernel<>
+ *   - kernel::gr::TimeAverageJ_kernel<>
  * @namespaces:
  *   - kernel::gr::
  * !TODO:
@@ -230,6 +232,88 @@ namespace kernel::gr {
       }
     }
   };
+
+  /**
+   * @brief Kernel for averaging the fields of the two time levels
+   * @brief `D0 <- (D0 + D) / 2`, `B0 <- (B0 + B) / 2`
+   * @tparam M Metric
+   */
+  template <class M>
+  class TimeAverageDB_kernel {
+    static_assert(M::is_metric, "M must be a metric class");
+    static constexpr auto D = M::Dim;
+
+    const ndfield_t<D, 6> DB;
+    ndfield_t<D, 6>       DB0;
+
+  public:
+    TimeAverageDB_kernel(const ndfield_t<D, 6>& DB, const ndfield_t<D, 6>& DB0)
+      : DB { DB }
+      , DB0 { DB0 } {}
+
+    Inline void operator()(index_t i1, index_t i2) const {
+      if constexpr (D == Dim::_2D) {
+        for (auto comp { 0u }; comp < 6u; ++comp) {
+          DB0(i1, i2, comp) = HALF * (DB0(i1, i2, comp) + DB(i1, i2, comp));
+        }
+      } else {
+        raise::KernelError(
+          HERE,
+          "TimeAverageDB_kernel: 2D implementation called for D != 2");
+      }
+    }
+
+    Inline void operator()(index_t, index_t, index_t) const {
+      if constexpr (D == Dim::_3D) {
+        raise::KernelNotImplementedError(HERE);
+      } else {
+        raise::KernelError(
+          HERE,
+          "TimeAverageDB_kernel: 3D implementation called for D != 3");
+      }
+    }
+  };
+
+  /**
+   * @brief Kernel for averaging the currents of the two time levels
+   * @brief `J0 <- (J0 + J) / 2`
+   * @tparam M Metric
+   */
+  template <class M>
+  class TimeAverageJ_kernel {
+    static_assert(M::is_metric, "M must be a metric class");
+    static constexpr auto D = M::Dim;
+
+    const ndfield_t<D, 3> J;
+    ndfield_t<D, 3>       J0;
+
+  public:
+    TimeAverageJ_kernel(const ndfield_t<D, 3>& J, const ndfield_t<D, 3>& J0)
+      : J { J }
+      , J0 { J0 } {}
+
+    Inline void operator()(index_t i1, index_t i2) const {
+      if constexpr (D == Dim::_2D) {
+        for (auto comp { 0u }; comp < 3u; ++comp) {
+          J0(i1, i2, comp) = HALF * (J0(i1, i2, comp) + J(i1, i2, comp));
+        }
+      } else {
+        raise::KernelError(
+          HERE,
+          "TimeAverageJ_kernel: 2D implementation called for D != 2");
+      }
+    }
+
+    Inline void operator()(index_t, index_t, index_t) const {
+      if constexpr (D == Dim::_3D) {
+        raise::KernelNotImplementedError(HERE);
+      } else {
+        raise::KernelError(
+          HERE,
+          "TimeAverageJ_kernel: 3D implementation called for D != 3");
+      }
+    }
+  };
 } // namespace kernel::gr
 
 #endif // KERNELS_AUX_FIELDS_GR_HPP
@@ -2,7 +2,9 @@
  * @file kernels/current_deposit.hpp
  * @brief Covariant algorithms for the current deposition
  * @implements
- *   - kernel::DepositCurrents_kernel<>
+ *   - kernel::DepositCurrentsBase<>
+ *   - kernel::DepositCurrents_kernel<> : kernel::DepositCurrentsBase<>
+ *   - kernel::DepositCurrentsTiled_kernel<> : kernel::DepositCurrentsBase<>
  * @namespaces:
  *   - kernel::
  */
@@ -18,20 +20,23 @@
 
 #include <Kokkos_Core.hpp>
 
-#define i_di_to_Xi(I, DI) static_cast<real_t>((I)) + static_cast<real_t>((DI))
+#include <vector>
+
+#define i_di_to_Xi(I, DI) static_cast<real_t>((I)) + from_prtldx((DI))
 
 namespace kernel {
   using namespace ntt;
 
   /**
-   * @brief Algorithm for the current deposition
+   * @brief Particle-side routines shared by the current deposition algorithms
    */
   template <SimEngine::type S, class M>
-  class DepositCurrents_kernel {
+  class DepositCurrentsBase {
     static_assert(M::is_metric, "M must be a metric class");
+
+  protected:
     static constexpr auto D = M::Dim;
 
-    scatter_ndfield_t<D, 3>  J;
     const array_t<int*>      i1, i2, i3;
     const array_t<int*>      i1_prev, i2_prev, i3_prev;
     const array_t<prtldx_t*> dx1, dx2, dx3;
@@ -44,33 +49,28 @@ namespace kernel {
     const real_t             charge, inv_dt;
 
   public:
-    /**
-     * @brief explicit constructor.
-     */
-    DepositCurrents_kernel(const scatter_ndfield_t<D, 3>& scatter_cur,
-                           const array_t<int*>&           i1,
-                           const array_t<int*>&           i2,
-                           const array_t<int*>&           i3,
-                           const array_t<int*>&           i1_prev,
-                           const array_t<int*>&           i2_prev,
-                           const array_t<int*>&           i3_prev,
-                           const array_t<prtldx_t*>&      dx1,
-                           const array_t<prtldx_t*>&      dx2,
-                           const array_t<prtldx_t*>&      dx3,
-                           const array_t<prtldx_t*>&      dx1_prev,
-                           const array_t<prtldx_t*>&      dx2_prev,
-                           const array_t<prtldx_t*>&      dx3_prev,
-                           const array_t<real_t*>&        ux1,
-                           const array_t<real_t*>&        ux2,
-                           const array_t<real_t*>&        ux3,
-                           const array_t<real_t*>&        phi,
-                           const array_t<real_t*>&        weight,
-                           const array_t<short*>&         tag,
-                           const M&                       metric,
-                           const real_t&                  charge,
-                           const real_t&                  dt)
-      : J { scatter_cur }
-      , i1 { i1 }
+    DepositCurrentsBase(const array_t<int*>&      i1,
+                        const array_t<int*>&      i2,
+                        const array_t<int*>&      i3,
+                        const array_t<int*>&      i1_prev,
+                        const array_t<int*>&      i2_prev,
+                        const array_t<int*>&      i3_prev,
+                        const array_t<prtldx_t*>& dx1,
+                        const array_t<prtldx_t*>& dx2,
+                        const array_t<prtldx_t*>& dx3,
+                        const array_t<prtldx_t*>& dx1_prev,
+                        const array_t<prtldx_t*>& dx2_prev,
+                        const array_t<prtldx_t*>& dx3_prev,
+                        const array_t<real_t*>&   ux1,
+                        const array_t<real_t*>&   ux2,
+                        const array_t<real_t*>&   ux3,
+                        const array_t<real_t*>&   phi,
+                        const array_t<real_t*>&   weight,
+                        const array_t<short*>&    tag,
+                        const M&                  metric,
+                        const real_t&             charge,
+                        const real_t&             dt)
+      : i1 { i1 }
       , i2 { i2 }
       , i3 { i3 }
       , i1_prev { i1_prev }
@@ -92,29 +92,10 @@ namespace kernel {
       , charge { charge }
       , inv_dt { ONE / dt } {}
 
-    /**
-     * @brief Iteration of the loop over particles.
-     * @param p index.
-     */
-    Inline auto operator()(index_t p) const -> void {
-      if (tag(p) == ParticleTag::dead) {
-        return;
-      }
-      // _f = final, _i = initial
-      tuple_t<int, D> Ip_f, Ip_i;
-      coord_t<D>      xp_f, xp_i, xp_r;
-      vec_t<Dim::_3D> vp { ZERO };
-
-      // get [i, di]_init and [i, di]_final (per dimension)
-      getDepositInterval(p, Ip_f, Ip_i, xp_f, xp_i, xp_r);
-      // recover particle velocity to deposit in unsimulated direction
-      getPrtl3Vel(p, vp);
-      const real_t coeff { weight(p) * charge };
-      depositCurrentsFromParticle(coeff, vp, Ip_f, Ip_i, xp_f, xp_i, xp_r);
-    }
-
     /**
      * @brief Deposit currents from a single particle.
+     * @param[in] J_acc Accessor to the array to deposit to.
+     * @param[in] shift Offset of the cell indices in the array (per dimension).
      * @param[in] coeff Particle weight x charge.
      * @param[in] vp Particle 3-velocity.
      * @param[in] Ip_f Final position of the particle (cell index).
@@ -123,7 +104,10 @@ namespace kernel {
      * @param[in] xp_i Previous step position.
      * @param[in] xp_r Intermediate point used in zig-zag deposit.
      */
-    Inline auto depositCurrentsFromParticle(const real_t&          coeff,
+    template <class J_t>
+    Inline auto depositCurrentsFromParticle(const J_t&             J_acc,
+                                            const tuple_t<int, D>& shift,
+                                            const real_t&          coeff,
                                             const vec_t<Dim::_3D>& vp,
                                             const tuple_t<int, D>& Ip_f,
                                             const tuple_t<int, D>& Ip_i,
@@ -137,8 +121,6 @@ namespace kernel {
       const real_t Fx1_1 { (xp_r[0] - xp_i[0]) * coeff * inv_dt };
       const real_t Fx1_2 { (xp_f[0] - xp_r[0]) * coeff * inv_dt };
 
-      auto J_acc = J.access();
-
       if constexpr (D == Dim::_1D) {
         const real_t Fx2_1 { HALF * vp[1] * coeff };
         const real_t Fx2_2 { HALF * vp[1] * coeff };
@@ -146,18 +128,18 @@ namespace kernel {
         const real_t Fx3_1 { HALF * vp[2] * coeff };
         const real_t Fx3_2 { HALF * vp[2] * coeff };
 
-        J_acc(Ip_i[0] + N_GHOSTS, cur::jx1) += Fx1_1;
-        J_acc(Ip_f[0] + N_GHOSTS, cur::jx1) += Fx1_2;
+        J_acc(Ip_i[0] + shift[0], cur::jx1) += Fx1_1;
+        J_acc(Ip_f[0] + shift[0], cur::jx1) += Fx1_2;
 
-        J_acc(Ip_i[0] + N_GHOSTS, cur::jx2)     += Fx2_1 * (ONE - Wx1_1);
-        J_acc(Ip_i[0] + N_GHOSTS + 1, cur::jx2) += Fx2_1 * Wx1_1;
-        J_acc(Ip_f[0] + N_GHOSTS, cur::jx2)     += Fx2_2 * (ONE - Wx1_2);
-        J_acc(Ip_f[0] + N_GHOSTS + 1, cur::jx2) += Fx2_2 * Wx1_2;
+        J_acc(Ip_i[0] + shift[0], cur::jx2)     += Fx2_1 * (ONE - Wx1_1);
+        J_acc(Ip_i[0] + shift[0] + 1, cur::jx2) += Fx2_1 * Wx1_1;
+        J_acc(Ip_f[0] + shift[0], cur::jx2)     += Fx2_2 * (ONE - Wx1_2);
+        J_acc(Ip_f[0] + shift[0] + 1, cur::jx2) += Fx2_2 * Wx1_2;
 
-        J_acc(Ip_i[0] + N_GHOSTS, cur::jx3)     += Fx3_1 * (ONE - Wx1_1);
-        J_acc(Ip_i[0] + N_GHOSTS + 1, cur::jx3) += Fx3_1 * Wx1_1;
-        J_acc(Ip_f[0] + N_GHOSTS, cur::jx3)     += Fx3_2 * (ONE - Wx1_2);
-        J_acc(Ip_f[0] + N_GHOSTS + 1, cur::jx3) += Fx3_2 * Wx1_2;
+        J_acc(Ip_i[0] + shift[0], cur::jx3)     += Fx3_1 * (ONE - Wx1_1);
+        J_acc(Ip_i[0] + shift[0] + 1, cur::jx3) += Fx3_1 * Wx1_1;
+        J_acc(Ip_f[0] + shift[0], cur::jx3)     += Fx3_2 * (ONE - Wx1_2);
+        J_acc(Ip_f[0] + shift[0] + 1, cur::jx3) += Fx3_2 * Wx1_2;
       } else if constexpr (D == Dim::_2D || D == Dim::_3D) {
         const real_t Wx2_1 { HALF * (xp_i[1] + xp_r[1]) -
                              static_cast<real_t>(Ip_i[1]) };
@@ -170,48 +152,48 @@ namespace kernel {
           const real_t Fx3_1 { HALF * vp[2] * coeff };
           const real_t Fx3_2 { HALF * vp[2] * coeff };
 
-          J_acc(Ip_i[0] + N_GHOSTS, Ip_i[1] + N_GHOSTS, cur::jx1) += Fx1_1 *
+          J_acc(Ip_i[0] + shift[0], Ip_i[1] + shift[1], cur::jx1) += Fx1_1 *
                                                                      (ONE - Wx2_1);
-          J_acc(Ip_i[0] + N_GHOSTS, Ip_i[1] + N_GHOSTS + 1, cur::jx1) += Fx1_1 *
+          J_acc(Ip_i[0] + shift[0], Ip_i[1] + shift[1] + 1, cur::jx1) += Fx1_1 *
                                                                          Wx2_1;
-          J_acc(Ip_f[0] + N_GHOSTS, Ip_f[1] + N_GHOSTS, cur::jx1) += Fx1_2 *
+          J_acc(Ip_f[0] + shift[0], Ip_f[1] + shift[1], cur::jx1) += Fx1_2 *
                                                                      (ONE - Wx2_2);
-          J_acc(Ip_f[0] + N_GHOSTS, Ip_f[1] + N_GHOSTS + 1, cur::jx1) += Fx1_2 *
+          J_acc(Ip_f[0] + shift[0], Ip_f[1] + shift[1] + 1, cur::jx1) += Fx1_2 *
                                                                          Wx2_2;
 
-          J_acc(Ip_i[0] + N_GHOSTS, Ip_i[1] + N_GHOSTS, cur::jx2) += Fx2_1 *
+          J_acc(Ip_i[0] + shift[0], Ip_i[1] + shift[1], cur::jx2) += Fx2_1 *
                                                                      (ONE - Wx1_1);
-          J_acc(Ip_i[0] + N_GHOSTS + 1, Ip_i[1] + N_GHOSTS, cur::jx2) += Fx2_1 *
+          J_acc(Ip_i[0] + shift[0] + 1, Ip_i[1] + shift[1], cur::jx2) += Fx2_1 *
                                                                          Wx1_1;
-          J_acc(Ip_f[0] + N_GHOSTS, Ip_f[1] + N_GHOSTS, cur::jx2) += Fx2_2 *
+          J_acc(Ip_f[0] + shift[0], Ip_f[1] + shift[1], cur::jx2) += Fx2_2 *
                                                                      (ONE - Wx1_2);
-          J_acc(Ip_f[0] + N_GHOSTS + 1, Ip_f[1] + N_GHOSTS, cur::jx2) += Fx2_2 *
+          J_acc(Ip_f[0] + shift[0] + 1, Ip_f[1] + shift[1], cur::jx2) += Fx2_2 *
                                                                          Wx1_2;
 
-          J_acc(Ip_i[0] + N_GHOSTS,
-                Ip_i[1] + N_GHOSTS,
+          J_acc(Ip_i[0] + shift[0],
+                Ip_i[1] + shift[1],
                 cur::jx3) += Fx3_1 * (ONE - Wx1_1) * (ONE - Wx2_1);
-          J_acc(Ip_i[0] + N_GHOSTS + 1,
-                Ip_i[1] + N_GHOSTS,
+          J_acc(Ip_i[0] + shift[0] + 1,
+                Ip_i[1] + shift[1],
                 cur::jx3) += Fx3_1 * Wx1_2 * (ONE - Wx2_1);
-          J_acc(Ip_i[0] + N_GHOSTS,
-                Ip_i[1] + N_GHOSTS + 1,
+          J_acc(Ip_i[0] + shift[0],
+                Ip_i[1] + shift[1] + 1,
                 cur::jx3) += Fx3_1 * (ONE - Wx1_1) * Wx2_1;
-          J_acc(Ip_i[0] + N_GHOSTS + 1,
-                Ip_i[1] + N_GHOSTS + 1,
+          J_acc(Ip_i[0] + shift[0] + 1,
+                Ip_i[1] + shift[1] + 1,
                 cur::jx3) += Fx3_1 * Wx1_1 * Wx2_1;
 
-          J_acc(Ip_f[0] + N_GHOSTS,
-                Ip_f[1] + N_GHOSTS,
+          J_acc(Ip_f[0] + shift[0],
+                Ip_f[1] + shift[1],
                 cur::jx3) += Fx3_2 * (ONE - Wx1_2) * (ONE - Wx2_2);
-          J_acc(Ip_f[0] + N_GHOSTS + 1,
-                Ip_f[1] + N_GHOSTS,
+          J_acc(Ip_f[0] + shift[0] + 1,
+                Ip_f[1] + shift[1],
                 cur::jx3) += Fx3_2 * Wx1_2 * (ONE - Wx2_2);
-          J_acc(Ip_f[0] + N_GHOSTS,
-                Ip_f[1] + N_GHOSTS + 1,
+          J_acc(Ip_f[0] + shift[0],
+                Ip_f[1] + shift[1] + 1,
                 cur::jx3) += Fx3_2 * (ONE - Wx1_2) * Wx2_2;
-          J_acc(Ip_f[0] + N_GHOSTS + 1,
-                Ip_f[1] + N_GHOSTS + 1,
+          J_acc(Ip_f[0] + shift[0] + 1,
+                Ip_f[1] + shift[1] + 1,
                 cur::jx3) += Fx3_2 * Wx1_2 * Wx2_2;
         } else {
           const real_t Wx3_1 { HALF * (xp_i[2] + xp_r[2]) -
@@ -221,106 +203,106 @@ namespace kernel {
           const real_t Fx3_1 { (xp_r[2] - xp_i[2]) * coeff * inv_dt };
           const real_t Fx3_2 { (xp_f[2] - xp_r[2]) * coeff * inv_dt };
 
-          J_acc(Ip_i[0] + N_GHOSTS,
-                Ip_i[1] + N_GHOSTS,
-                Ip_i[2] + N_GHOSTS,
+          J_acc(Ip_i[0] + shift[0],
+                Ip_i[1] + shift[1],
+                Ip_i[2] + shift[2],
                 cur::jx1) += Fx1_1 * (ONE - Wx2_1) * (ONE - Wx3_1);
-          J_acc(Ip_i[0] + N_GHOSTS,
-                Ip_i[1] + N_GHOSTS + 1,
-                Ip_i[2] + N_GHOSTS,
+          J_acc(Ip_i[0] + shift[0],
+                Ip_i[1] + shift[1] + 1,
+                Ip_i[2] + shift[2],
                 cur::jx1) += Fx1_1 * Wx2_1 * (ONE - Wx3_1);
-          J_acc(Ip_i[0] + N_GHOSTS,
-                Ip_i[1] + N_GHOSTS,
-                Ip_i[2] + N_GHOSTS + 1,
+          J_acc(Ip_i[0] + shift[0],
+                Ip_i[1] + shift[1],
+                Ip_i[2] + shift[2] + 1,
                 cur::jx1) += Fx1_1 * (ONE - Wx2_1) * Wx3_1;
-          J_acc(Ip_i[0] + N_GHOSTS,
-                Ip_i[1] + N_GHOSTS + 1,
-                Ip_i[2] + N_GHOSTS + 1,
+          J_acc(Ip_i[0] + shift[0],
+                Ip_i[1] + shift[1] + 1,
+                Ip_i[2] + shift[2] + 1,
                 cur::jx1) += Fx1_1 * Wx2_1 * Wx3_1;
 
-          J_acc(Ip_f[0] + N_GHOSTS,
-                Ip_f[1] + N_GHOSTS,
-                Ip_f[2] + N_GHOSTS,
+          J_acc(Ip_f[0] + shift[0],
+                Ip_f[1] + shift[1],
+                Ip_f[2] + shift[2],
                 cur::jx1) += Fx1_2 * (ONE - Wx2_2) * (ONE - Wx3_2);
-          J_acc(Ip_f[0] + N_GHOSTS,
-                Ip_f[1] + N_GHOSTS + 1,
-                Ip_f[2] + N_GHOSTS,
+          J_acc(Ip_f[0] + shift[0],
+                Ip_f[1] + shift[1] + 1,
+                Ip_f[2] + shift[2],
                 cur::jx1) += Fx1_2 * Wx2_2 * (ONE - Wx3_2);
-          J_acc(Ip_f[0] + N_GHOSTS,
-                Ip_f[1] + N_GHOSTS,
-                Ip_f[2] + N_GHOSTS + 1,
+          J_acc(Ip_f[0] + shift[0],
+                Ip_f[1] + shift[1],
+                Ip_f[2] + shift[2] + 1,
                 cur::jx1) += Fx1_2 * (ONE - Wx2_2) * Wx3_2;
-          J_acc(Ip_f[0] + N_GHOSTS,
-                Ip_f[1] + N_GHOSTS + 1,
-                Ip_f[2] + N_GHOSTS + 1,
+          J_acc(Ip_f[0] + shift[0],
+                Ip_f[1] + shift[1] + 1,
+                Ip_f[2] + shift[2] + 1,
                 cur::jx1) += Fx1_2 * Wx2_2 * Wx3_2;
 
-          J_acc(Ip_i[0] + N_GHOSTS,
-                Ip_i[1] + N_GHOSTS,
-                Ip_i[2] + N_GHOSTS,
+          J_acc(Ip_i[0] + shift[0],
+                Ip_i[1] + shift[1],
+                Ip_i[2] + shift[2],
                 cur::jx2) += Fx2_1 * (ONE - Wx1_1) * (ONE - Wx3_1);
-          J_acc(Ip_i[0] + N_GHOSTS + 1,
-                Ip_i[1] + N_GHOSTS,
-                Ip_i[2] + N_GHOSTS,
+          J_acc(Ip_i[0] + shift[0] + 1,
+                Ip_i[1] + shift[1],
+                Ip_i[2] + shift[2],
                 cur::jx2) += Fx2_1 * Wx1_1 * (ONE - Wx3_1);
-          J_acc(Ip_i[0] + N_GHOSTS,
-                Ip_i[1] + N_GHOSTS,
-                Ip_i[2] + N_GHOSTS + 1,
+          J_acc(Ip_i[0] + shift[0],
+                Ip_i[1] + shift[1],
+                Ip_i[2] + shift[2] + 1,
                 cur::jx2) += Fx2_1 * (ONE - Wx1_1) * Wx3_1;
-          J_acc(Ip_i[0] + N_GHOSTS + 1,
-                Ip_i[1] + N_GHOSTS,
-                Ip_i[2] + N_GHOSTS + 1,
+          J_acc(Ip_i[0] + shift[0] + 1,
+                Ip_i[1] + shift[1],
+                Ip_i[2] + shift[2] + 1,
                 cur::jx2) += Fx2_1 * Wx1_1 * Wx3_1;
 
-          J_acc(Ip_f[0] + N_GHOSTS,
-                Ip_f[1] + N_GHOSTS,
-                Ip_f[2] + N_GHOSTS,
+          J_acc(Ip_f[0] + shift[0],
+                Ip_f[1] + shift[1],
+                Ip_f[2] + shift[2],
                 cur::jx2) += Fx2_2 * (ONE - Wx1_2) * (ONE - Wx3_2);
-          J_acc(Ip_f[0] + N_GHOSTS + 1,
-                Ip_f[1] + N_GHOSTS,
-                Ip_f[2] + N_GHOSTS,
+          J_acc(Ip_f[0] + shift[0] + 1,
+                Ip_f[1] + shift[1],
+                Ip_f[2] + shift[2],
                 cur::jx2) += Fx2_2 * Wx1_2 * (ONE - Wx3_2);
-          J_acc(Ip_f[0] + N_GHOSTS,
-                Ip_f[1] + N_GHOSTS,
-                Ip_f[2] + N_GHOSTS + 1,
+          J_acc(Ip_f[0] + shift[0],
+                Ip_f[1] + shift[1],
+                Ip_f[2] + shift[2] + 1,
                 cur::jx2) += Fx2_2 * (ONE - Wx1_2) * Wx3_2;
-          J_acc(Ip_f[0] + N_GHOSTS + 1,
-                Ip_f[1] + N_GHOSTS,
-                Ip_f[2] + N_GHOSTS + 1,
+          J_acc(Ip_f[0] + shift[0] + 1,
+                Ip_f[1] + shift[1],
+                Ip_f[2] + shift[2] + 1,
                 cur::jx2) += Fx2_2 * Wx1_2 * Wx3_2;
 
-          J_acc(Ip_i[0] + N_GHOSTS,
-                Ip_i[1] + N_GHOSTS,
-                Ip_i[2] + N_GHOSTS,
+          J_acc(Ip_i[0] + shift[0],
+                Ip_i[1] + shift[1],
+                Ip_i[2] + shift[2],
                 cur::jx3) += Fx3_1 * (ONE - Wx1_1) * (ONE - Wx2_1);
-          J_acc(Ip_i[0] + N_GHOSTS + 1,
-                Ip_i[1] + N_GHOSTS,
-                Ip_i[2] + N_GHOSTS,
+          J_acc(Ip_i[0] + shift[0] + 1,
+                Ip_i[1] + shift[1],
+                Ip_i[2] + shift[2],
                 cur::jx3) += Fx3_1 * Wx1_1 * (ONE - Wx2_1);
-          J_acc(Ip_i[0] + N_GHOSTS,
-                Ip_i[1] + N_GHOSTS + 1,
-                Ip_i[2] + N_GHOSTS,
+          J_acc(Ip_i[0] + shift[0],
+                Ip_i[1] + shift[1] + 1,
+                Ip_i[2] + shift[2],
                 cur::jx3) += Fx3_1 * (ONE - Wx1_1) * Wx2_1;
-          J_acc(Ip_i[0] + N_GHOSTS + 1,
-                Ip_i[1] + N_GHOSTS + 1,
-                Ip_i[2] + N_GHOSTS,
+          J_acc(Ip_i[0] + shift[0] + 1,
+                Ip_i[1] + shift[1] + 1,
+                Ip_i[2] + shift[2],
                 cur::jx3) += Fx3_1 * Wx1_1 * Wx2_1;
 
-          J_acc(Ip_f[0] + N_GHOSTS,
-                Ip_f[1] + N_GHOSTS,
-                Ip_f[2] + N_GHOSTS,
+          J_acc(Ip_f[0] + shift[0],
+                Ip_f[1] + shift[1],
+                Ip_f[2] + shift[2],
                 cur::jx3) += Fx3_2 * (ONE - Wx1_2) * (ONE - Wx2_2);
-          J_acc(Ip_f[0] + N_GHOSTS + 1,
-                Ip_f[1] + N_GHOSTS,
-                Ip_f[2] + N_GHOSTS,
+          J_acc(Ip_f[0] + shift[0] + 1,
+                Ip_f[1] + shift[1],
+                Ip_f[2] + shift[2],
                 cur::jx3) += Fx3_2 * Wx1_2 * (ONE - Wx2_2);
-          J_acc(Ip_f[0] + N_GHOSTS,
-                Ip_f[1] + N_GHOSTS + 1,
-                Ip_f[2] + N_GHOSTS,
+          J_acc(Ip_f[0] + shift[0],
+                Ip_f[1] + shift[1] + 1,
+                Ip_f[2] + shift[2],
                 cur::jx3) += Fx3_2 * (ONE - Wx1_2) * Wx2_2;
-          J_acc(Ip_f[0] + N_GHOSTS + 1,
-                Ip_f[1] + N_GHOSTS + 1,
-                Ip_f[2] + N_GHOSTS,
+          J_acc(Ip_f[0] + shift[0] + 1,
+                Ip_f[1] + shift[1] + 1,
+                Ip_f[2] + shift[2],
                 cur::jx3) += Fx3_2 * Wx1_2 * Wx2_2;
         }
       }
@@ -407,6 +389,346 @@ namespace kernel {
     }
   };
 
+  /**
+   * @brief Algorithm for the current deposition
+   */
+  template <SimEngine::type S, class M>
+  class DepositCurrents_kernel : public DepositCurrentsBase<S, M> {
+    using base_t = DepositCurrentsBase<S, M>;
+    using base_t::charge;
+    using base_t::tag;
+    using base_t::weight;
+    static constexpr auto D = M::Dim;
+
+    scatter_ndfield_t<D, 3> J;
+
+  public:
+    /**
+     * @brief explicit constructor.
+     */
+    DepositCurrents_kernel(const scatter_ndfield_t<D, 3>& scatter_cur,
+                           const array_t<int*>&           i1,
+                           const array_t<int*>&           i2,
+                           const array_t<int*>&           i3,
+                           const array_t<int*>&           i1_prev,
+                           const array_t<int*>&           i2_prev,
+                           const array_t<int*>&           i3_prev,
+                           const array_t<prtldx_t*>&      dx1,
+                           const array_t<prtldx_t*>&      dx2,
+                           const array_t<prtldx_t*>&      dx3,
+                           const array_t<prtldx_t*>&      dx1_prev,
+                           const array_t<prtldx_t*>&      dx2_prev,
+                           const array_t<prtldx_t*>&      dx3_prev,
+                           const array_t<real_t*>&        ux1,
+                           const array_t<real_t*>&        ux2,
+                           const array_t<real_t*>&        ux3,
+                           const array_t<real_t*>&        phi,
+                           const array_t<real_t*>&        weight,
+                           const array_t<short*>&         tag,
+                           const M&                       metric,
+                           const real_t&                  charge,
+                           const real_t&                  dt)
+      : base_t(i1,
+               i2,
+               i3,
+               i1_prev,
+               i2_prev,
+               i3_prev,
+               dx1,
+               dx2,
+               dx3,
+               dx1_prev,
+               dx2_prev,
+               dx3_prev,
+               ux1,
+               ux2,
+               ux3,
+               phi,
+               weight,
+               tag,
+               metric,
+               charge,
+               dt)
+      , J { scatter_cur } {}
+
+    /**
+     * @brief Iteration of the loop over particles.
+     * @param p index.
+     */
+    Inline auto operator()(index_t p) const -> void {
+      if (tag(p) == ParticleTag::dead) {
+        return;
+      }
+      // _f = final, _i = initial
+      tuple_t<int, D> Ip_f, Ip_i;
+      coord_t<D>      xp_f, xp_i, xp_r;
+      vec_t<Dim::_3D> vp { ZERO };
+
+      // get [i, di]_init and [i, di]_final (per dimension)
+      this->getDepositInterval(p, Ip_f, Ip_i, xp_f, xp_i, xp_r);
+      // recover particle velocity to deposit in unsimulated direction
+      this->getPrtl3Vel(p, vp);
+      const real_t coeff { weight(p) * charge };
+      tuple_t<int, D> shift;
+      for (auto i = 0u; i < D; ++i) {
+        shift[i] = N_GHOSTS;
+      }
+      auto J_acc = J.access();
+      this->depositCurrentsFromParticle(J_acc,
+                                        shift,
+                                        coeff,
+                                        vp,
+                                        Ip_f,
+                                        Ip_i,
+                                        xp_f,
+                                        xp_i,
+                                        xp_r);
+    }
+  };
+
+  /**
+   * @brief Tiled algorithm for the current deposition
+   * @note Each team takes the particles of a single tile (see
+   * `Particles::TileIndex`) and accumulates their currents in the scratch
+   * memory, which covers the tile together with the guard cells. The result
+   * is then added to the global array, so the atomic operations on the
+   * global array are only done once per cell of each tile.
+   * @note Particles which do not fit into the guard cells of their tile are
+   * deposited directly into the global array.
+   */
+  template <SimEngine::type S, class M>
+  class DepositCurrentsTiled_kernel : public DepositCurrentsBase<S, M> {
+    using base_t = DepositCurrentsBase<S, M>;
+    using base_t::charge;
+    using base_t::tag;
+    using base_t::weight;
+    static constexpr auto D = M::Dim;
+
+    // particle at cell i (initial or final) deposits into cells i and i + 1
+    // ... while the initial and final cells differ by at most one
+    static constexpr int n_guard_lo = 1, n_guard_hi = 2;
+
+    atomic_ndfield_t<D, 3>      J;
+    const array_t<std::size_t*> tile_offsets, tile_prtls;
+    const int                   tile_size;
+    tuple_t<int, D>             ntiles;
+
+  public:
+    /**
+     * @brief explicit constructor.
+     * @param cur The global current array.
+     * @param tile_offsets Offsets of each tile in `tile_prtls`.
+     * @param tile_prtls Indices of particles grouped by tiles.
+     * @param ncells The number of active cells in each dimension.
+     * @param tile_size The number of cells per tile in each dimension.
+     */
+    DepositCurrentsTiled_kernel(const ndfield_t<D, 3>&          cur,
+                                const array_t<std::size_t*>&    tile_offsets,
+                                const array_t<std::size_t*>&    tile_prtls,
+                                const std::vector<std::size_t>& ncells,
+                                unsigned short                  tile_size,
+                                const array_t<int*>&            i1,
+                                const array_t<int*>&            i2,
+                                const array_t<int*>&            i3,
+                                const array_t<int*>&            i1_prev,
+                                const array_t<int*>&            i2_prev,
+                                const array_t<int*>&            i3_prev,
+                                const array_t<prtldx_t*>&       dx1,
+                                const array_t<prtldx_t*>&       dx2,
+                                const array_t<prtldx_t*>&       dx3,
+                                const array_t<prtldx_t*>&       dx1_prev,
+                                const array_t<prtldx_t*>&       dx2_prev,
+                                const array_t<prtldx_t*>&       dx3_prev,
+                                const array_t<real_t*>&         ux1,
+                                const array_t<real_t*>&         ux2,
+                                const array_t<real_t*>&         ux3,
+                                const array_t<real_t*>&         phi,
+                                const array_t<real_t*>&         weight,
+                                const array_t<short*>&          tag,
+                                const M&                        metric,
+                                const real_t&                   charge,
+                                const real_t&                   dt)
+      : base_t(i1,
+               i2,
+               i3,
+               i1_prev,
+               i2_prev,
+               i3_prev,
+               dx1,
+               dx2,
+               dx3,
+               dx1_prev,
+               dx2_prev,
+               dx3_prev,
+               ux1,
+               ux2,
+               ux3,
+               phi,
+               weight,
+               tag,
+               metric,
+               charge,
+               dt)
+      , J { cur }
+      , tile_offsets { tile_offsets }
+      , tile_prtls { tile_prtls }
+      , tile_size { static_cast<int>(tile_size) } {
+      for (auto i = 0u; i < D; ++i) {
+        ntiles[i] = (static_cast<int>(ncells[i]) + this->tile_size - 1) /
+                    this->tile_size;
+      }
+    }
+
+    /**
+     * @brief Number of tiles (i.e., the league size).
+     */
+    auto ntiles_tot() const -> std::size_t {
+      std::size_t n = 1;
+      for (auto i = 0u; i < D; ++i) {
+        n *= static_cast<std::size_t>(ntiles[i]);
+      }
+      return n;
+    }
+
+    /**
+     * @brief Size of the scratch memory required per team (in bytes).
+     */
+    static auto scratch_size(unsigned short tile_size) -> std::size_t {
+      const auto ext = static_cast<std::size_t>(tile_size) + n_guard_lo + n_guard_hi;
+      if constexpr (D == Dim::_1D) {
+        return scratch_ndfield_t<D, 3>::shmem_size(ext);
+      } else if constexpr (D == Dim::_2D) {
+        return scratch_ndfield_t<D, 3>::shmem_size(ext, ext);
+      } else {
+        return scratch_ndfield_t<D, 3>::shmem_size(ext, ext, ext);
+      }
+    }
+
+    /**
+     * @brief Deposit all the particles of a single tile.
+     * @param team Team member (league rank = tile index).
+     */
+    Inline auto operator()(const team_member_t& team) const -> void {
+      const int       tile = team.league_rank();
+      const int       ext  = tile_size + n_guard_lo + n_guard_hi;
+      tuple_t<int, D> corner, shift_tile, shift_glob;
+      int             t = tile;
+      for (auto i = 0u; i < D; ++i) {
+        corner[i]      = (t % ntiles[i]) * tile_size;
+        t             /= ntiles[i];
+        shift_tile[i]  = n_guard_lo - corner[i];
+        shift_glob[i]  = N_GHOSTS;
+      }
+
+      int                     ncells_tile { ext };
+      scratch_ndfield_t<D, 3> J_tile;
+      if constexpr (D == Dim::_1D) {
+        J_tile = scratch_ndfield_t<D, 3>(team.team_scratch(0), ext);
+      } else if constexpr (D == Dim::_2D) {
+        J_tile       = scratch_ndfield_t<D, 3>(team.team_scratch(0), ext, ext);
+        ncells_tile *= ext;
+      } else {
+        J_tile = scratch_ndfield_t<D, 3>(team.team_scratch(0), ext, ext, ext);
+        ncells_tile *= ext * ext;
+      }
+      auto J_tile_raw = J_tile.data();
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(team, 3 * ncells_tile),
+                           [&](const int n) {
+                             J_tile_raw[n] = ZERO;
+                           });
+      team.team_barrier();
+
+      Kokkos::parallel_for(
+        Kokkos::TeamThreadRange(team, tile_offsets(tile), tile_offsets(tile + 1)),
+        [&](const std::size_t n) {
+          const std::size_t p = tile_prtls(n);
+          // _f = final, _i = initial
+          tuple_t<int, D>   Ip_f, Ip_i;
+          coord_t<D>        xp_f, xp_i, xp_r;
+          vec_t<Dim::_3D>   vp { ZERO };
+
+          this->getDepositInterval(p, Ip_f, Ip_i, xp_f, xp_i, xp_r);
+          this->getPrtl3Vel(p, vp);
+          const real_t coeff { weight(p) * charge };
+
+          bool fits_tile = true;
+          for (auto i = 0u; i < D; ++i) {
+            fits_tile = fits_tile and
+                        (IMIN(Ip_i[i], Ip_f[i]) + shift_tile[i] >= 0) and
+                        (IMAX(Ip_i[i], Ip_f[i]) + 1 + shift_tile[i] < ext);
+          }
+          if (fits_tile) {
+            this->depositCurrentsFromParticle(J_tile,
+                                              shift_tile,
+                                              coeff,
+                                              vp,
+                                              Ip_f,
+                                              Ip_i,
+                                              xp_f,
+                                              xp_i,
+                                              xp_r);
+          } else {
+            this->depositCurrentsFromParticle(J,
+                                              shift_glob,
+                                              coeff,
+                                              vp,
+                                              Ip_f,
+                                              Ip_i,
+                                              xp_f,
+                                              xp_i,
+                                              xp_r);
+          }
+        });
+      team.team_barrier();
+
+      // add the tile to the global array (tiles overlap in the guard cells)
+      Kokkos::parallel_for(Kokkos::TeamThreadRange(team, ncells_tile), [&](const int n) {
+        if constexpr (D == Dim::_1D) {
+          const int g1 = n - n_guard_lo + corner[0] + N_GHOSTS;
+          if (g1 >= static_cast<int>(J.extent(0))) {
+            return;
+          }
+          for (auto c = 0; c < 3; ++c) {
+            const real_t j = J_tile(n, c);
+            if (j != ZERO) {
+              J(g1, c) += j;
+            }
+          }
+        } else if constexpr (D == Dim::_2D) {
+          const int l1 = n % ext, l2 = n / ext;
+          const int g1 = l1 - n_guard_lo + corner[0] + N_GHOSTS;
+          const int g2 = l2 - n_guard_lo + corner[1] + N_GHOSTS;
+          if ((g1 >= static_cast<int>(J.extent(0))) or
+              (g2 >= static_cast<int>(J.extent(1)))) {
+            return;
+          }
+          for (auto c = 0; c < 3; ++c) {
+            const real_t j = J_tile(l1, l2, c);
+            if (j != ZERO) {
+              J(g1, g2, c) += j;
+            }
+          }
+        } else {
+          const int l1 = n % ext, l2 = (n / ext) % ext, l3 = n / (ext * ext);
+          const int g1 = l1 - n_guard_lo + corner[0] + N_GHOSTS;
+          const int g2 = l2 - n_guard_lo + corner[1] + N_GHOSTS;
+          const int g3 = l3 - n_guard_lo + corner[2] + N_GHOSTS;
+          if ((g1 >= static_cast<int>(J.extent(0))) or
+              (g2 >= static_cast<int>(J.extent(1))) or
+              (g3 >= static_cast<int>(J.extent(2)))) {
+            return;
+          }
+          for (auto c = 0; c < 3; ++c) {
+            const real_t j = J_tile(l1, l2, l3, c);
+            if (j != ZERO) {
+              J(g1, g2, g3, c) += j;
+            }
+          }
+        }
+      });
+    }
+  };
+
 } // namespace kernel
 
 #undef i_di_to_Xi
@@ -0,0 +1,216 @@
+/**
+ * @file kernels/fields_accumulate.hpp
+ * @brief Time-accumulated field diagnostics
+ * @implements
+ *   - kernel::AccumOp
+ *   - kernel::AccumulateFields_kernel<>
+ *   - kernel::FinalizeAccumulator_kernel<>
+ * @namespaces:
+ *   - kernel::
+ * @note
+ * The accumulated fields are cell-centered vectors in the physical basis,
+ * prepared with the FieldsToPhys_kernel before each sample
+ */
+
+#ifndef KERNELS_FIELDS_ACCUMULATE_HPP
+#define KERNELS_FIELDS_ACCUMULATE_HPP
+
+#include "global.h"
+
+#include "arch/kokkos_aliases.h"
+#include "utils/error.h"
+#include "utils/numeric.h"
+
+namespace kernel {
+  using namespace ntt;
+
+  /**
+   * @brief Quantity added to the accumulator at each sample
+   * @note Value: f, Square: f * f (per component), Cross: f x g
+   */
+  enum class AccumOp : uint8_t {
+    Value,
+    Square,
+    Cross
+  };
+
+  /**
+   * @brief Adds `coeff` times the sampled quantity to the accumulator
+   * @tparam D Dimension
+   * @note For AccumOp::Cross, the two vectors are at (cf, cf+1, cf+2) &
+   * (cf+3, cf+4, cf+5) of the sampled field
+   */
+  template <Dimension D>
+  class AccumulateFields_kernel {
+    ndfield_t<D, 3>       Acc;
+    const ndfield_t<D, 6> Fld;
+    const unsigned short  cf;
+    const AccumOp         op;
+    const real_t          coeff;
+
+  public:
+    AccumulateFields_kernel(ndfield_t<D, 3>&       acc,
+                            const ndfield_t<D, 6>& fld,
+                            unsigned short         cf,
+                            AccumOp                op,
+                            real_t                 coeff)
+      : Acc { acc }
+      , Fld { fld }
+      , cf { cf }
+      , op { op }
+      , coeff { coeff } {
+      raise::ErrorIf((op == AccumOp::Cross) ? (cf + 6 > 6) : (cf + 3 > 6),
+                     "AccumulateFields_kernel: Invalid component index",
+                     HERE);
+    }
+
+    Inline void operator()(index_t i1) const {
+      if constexpr (D == Dim::_1D) {
+        vec_t<Dim::_3D> f { ZERO };
+        sample({ Fld(i1, cf), Fld(i1, cf + 1), Fld(i1, cf + 2) },
+               { (op == AccumOp::Cross) ? Fld(i1, cf + 3) : ZERO,
+                 (op == AccumOp::Cross) ? Fld(i1, cf + 4) : ZERO,
+                 (op == AccumOp::Cross) ? Fld(i1, cf + 5) : ZERO },
+               f);
+        Acc(i1, 0) += f[0];
+        Acc(i1, 1) += f[1];
+        Acc(i1, 2) += f[2];
+      } else {
+        raise::KernelError(
+          HERE,
+          "AccumulateFields_kernel: 1D implementation called for D != 1");
+      }
+    }
+
+    Inline void operator()(index_t i1, index_t i2) const {
+      if constexpr (D == Dim::_2D) {
+        vec_t<Dim::_3D> f { ZERO };
+        sample({ Fld(i1, i2, cf), Fld(i1, i2, cf + 1), Fld(i1, i2, cf + 2) },
+               { (op == AccumOp::Cross) ? Fld(i1, i2, cf + 3) : ZERO,
+                 (op == AccumOp::Cross) ? Fld(i1, i2, cf + 4) : ZERO,
+                 (op == AccumOp::Cross) ? Fld(i1, i2, cf + 5) : ZERO },
+               f);
+        Acc(i1, i2, 0) += f[0];
+        Acc(i1, i2, 1) += f[1];
+        Acc(i1, i2, 2) += f[2];
+      } else {
+        raise::KernelError(
+          HERE,
+          "AccumulateFields_kernel: 2D implementation called for D != 2");
+      }
+    }
+
+    Inline void operator()(index_t i1, index_t i2, index_t i3) const {
+      if constexpr (D == Dim::_3D) {
+        vec_t<Dim::_3D> f { ZERO };
+        sample({ Fld(i1, i2, i3, cf),
+                 Fld(i1, i2, i3, cf + 1),
+                 Fld(i1, i2, i3, cf + 2) },
+               { (op == AccumOp::Cross) ? Fld(i1, i2, i3, cf + 3) : ZERO,
+                 (op == AccumOp::Cross) ? Fld(i1, i2, i3, cf + 4) : ZERO,
+                 (op == AccumOp::Cross) ? Fld(i1, i2, i3, cf + 5) : ZERO },
+               f);
+        Acc(i1, i2, i3, 0) += f[0];
+        Acc(i1, i2, i3, 1) += f[1];
+        Acc(i1, i2, i3, 2) += f[2];
+      } else {
+        raise::KernelError(
+          HERE,
+          "AccumulateFields_kernel: 3D implementation called for D != 3");
+      }
+    }
+
+  private:
+    Inline void sample(const vec_t<Dim::_3D>& a,
+                       const vec_t<Dim::_3D>& b,
+                       vec_t<Dim::_3D>&       f) const {
+      if (op == AccumOp::Value) {
+        f[0] = coeff * a[0];
+        f[1] = coeff * a[1];
+        f[2] = coeff * a[2];
+      } else if (op == AccumOp::Square) {
+        f[0] = coeff * SQR(a[0]);
+        f[1] = coeff * SQR(a[1]);
+        f[2] = coeff * SQR(a[2]);
+      } else {
+        f[0] = coeff * (a[1] * b[2] - a[2] * b[1]);
+        f[1] = coeff * (a[2] * b[0] - a[0] * b[2]);
+        f[2] = coeff * (a[0] * b[1] - a[1] * b[0]);
+      }
+    }
+  };
+
+  /**
+   * @brief Prepares the accumulator for the output: `coeff` * acc, or
+   * sqrt(`coeff` * acc) if `take_sqrt` (for the rms)
+   * @tparam D Dimension
+   */
+  template <Dimension D>
+  class FinalizeAccumulator_kernel {
+    const ndfield_t<D, 3> Acc;
+    ndfield_t<D, 6>       Fto;
+    const unsigned short  ct;
+    const real_t          coeff;
+    const bool            take_sqrt;
+
+  public:
+    FinalizeAccumulator_kernel(const ndfield_t<D, 3>& acc,
+                               ndfield_t<D, 6>&       to,
+                               unsigned short         ct,
+                               real_t                 coeff,
+                               bool                   take_sqrt)
+      : Acc { acc }
+      , Fto { to }
+      , ct { ct }
+      , coeff { coeff }
+      , take_sqrt { take_sqrt } {
+      raise::ErrorIf(ct + 3 > 6,
+                     "FinalizeAccumulator_kernel: Invalid component index",
+                     HERE);
+    }
+
+    Inline void operator()(index_t i1) const {
+      if constexpr (D == Dim::_1D) {
+        for (unsigned short c { 0 }; c < 3; ++c) {
+          Fto(i1, ct + c) = finalize(Acc(i1, c));
+        }
+      } else {
+        raise::KernelError(
+          HERE,
+          "FinalizeAccumulator_kernel: 1D implementation called for D != 1");
+      }
+    }
+
+    Inline void operator()(index_t i1, index_t i2) const {
+      if constexpr (D == Dim::_2D) {
+        for (unsigned short c { 0 }; c < 3; ++c) {
+          Fto(i1, i2, ct + c) = finalize(Acc(i1, i2, c));
+        }
+      } else {
+        raise::KernelError(
+          HERE,
+          "FinalizeAccumulator_kernel: 2D implementation called for D != 2");
+      }
+    }
+
+    Inline void operator()(index_t i1, index_t i2, index_t i3) const {
+      if constexpr (D == Dim::_3D) {
+        for (unsigned short c { 0 }; c < 3; ++c) {
+          Fto(i1, i2, i3, ct + c) = finalize(Acc(i1, i2, i3, c));
+        }
+      } else {
+        raise::KernelError(
+          HERE,
+          "FinalizeAccumulator_kernel: 3D implementation called for D != 3");
+      }
+    }
+
+  private:
+    Inline auto finalize(real_t a) const -> real_t {
+      return take_sqrt ? math::sqrt(coeff * a) : coeff * a;
+    }
+  };
+
+} // namespace kernel
+
+#endif // KERNELS_FIELDS_ACCUMULATE_HPP
@@ -216,6 +216,44 @@ namespace kernel {
     }
   };
 
+  /**
+   * @brief Fills the ghost cells behind the inner (horizon) boundary with the
+   * values from the first active cell
+   * @note The region is causally disconnected, so the values there only need
+   * to be finite for the stencils of the active cells
+   */
+  template <Dimension D>
+  struct HorizonBoundaries_kernel {
+    ndfield_t<D, 6>   Fld;
+    const std::size_t i1_min;
+    const bool        setE, setB;
+
+    HorizonBoundaries_kernel(ndfield_t<D, 6> Fld, std::size_t i1_min, BCTags tags)
+      : Fld { Fld }
+      , i1_min { i1_min }
+      , setE { tags & BC::Ex1 or tags & BC::Ex2 or tags & BC::Ex3 }
+      , setB { tags & BC::Bx1 or tags & BC::Bx2 or tags & BC::Bx3 } {}
+
+    Inline void operator()(index_t i2) const {
+      if constexpr (D == Dim::_2D) {
+        for (std::size_t i1 { 0 }; i1 < i1_min; ++i1) {
+          if (setE) {
+            Fld(i1, i2, em::ex1) = Fld(i1_min, i2, em::ex1);
+            Fld(i1, i2, em::ex2) = Fld(i1_min, i2, em::ex2);
+            Fld(i1, i2, em::ex3) = Fld(i1_min, i2, em::ex3);
+          }
+          if (setB) {
+            Fld(i1, i2, em::bx1) = Fld(i1_min, i2, em::bx1);
+            Fld(i1, i2, em::bx2) = Fld(i1_min, i2, em::bx2);
+            Fld(i1, i2, em::bx3) = Fld(i1_min, i2, em::bx3);
+          }
+        }
+      } else {
+        raise::KernelError(HERE, "HorizonBoundaries_kernel: D != 2");
+      }
+    }
+  };
+
   template <class I, class M, bool P, in O>
   struct AtmosphereBoundaries_kernel {
     static constexpr Dimension D = M::Dim;
@@ -144,13 +144,13 @@ namespace kernel {
       }
       // inject
       i1s_1(p + offset1)  = static_cast<int>(x_Cd[0]);
-      dx1s_1(p + offset1) = static_cast<prtldx_t>(
+      dx1s_1(p + offset1) = to_prtldx(
         x_Cd[0] - static_cast<real_t>(i1s_1(p + offset1)));
       i1s_2(p + offset2)  = i1s_1(p + offset1);
       dx1s_2(p + offset2) = dx1s_1(p + offset1);
       if constexpr (M::Dim == Dim::_2D or M::Dim == Dim::_3D) {
         i2s_1(p + offset1)  = static_cast<int>(x_Cd[1]);
-        dx2s_1(p + offset1) = static_cast<prtldx_t>(
+        dx2s_1(p + offset1) = to_prtldx(
           x_Cd[1] - static_cast<real_t>(i2s_1(p + offset1)));
         i2s_2(p + offset2)  = i2s_1(p + offset1);
         dx2s_2(p + offset2) = dx2s_1(p + offset1);
@@ -161,7 +161,7 @@ namespace kernel {
       }
       if constexpr (M::Dim == Dim::_3D) {
         i3s_1(p + offset1)  = static_cast<int>(x_Cd[2]);
-        dx3s_1(p + offset1) = static_cast<prtldx_t>(
+        dx3s_1(p + offset1) = to_prtldx(
           x_Cd[2] - static_cast<real_t>(i3s_1(p + offset1)));
         i3s_2(p + offset2)  = i3s_1(p + offset1);
         dx3s_2(p + offset2) = dx3s_1(p + offset1);
@@ -299,7 +299,7 @@ namespace kernel {
 
           const auto i1 = static_cast<int>(
             static_cast<std::size_t>(x_Cd[0]) - i1_offset);
-          const auto dx1 = static_cast<prtldx_t>(
+          const auto dx1 = to_prtldx(
             x_Cd[0] - static_cast<real_t>(i1 + i1_offset));
 
           i1s(index)  = i1;
@@ -341,11 +341,11 @@ namespace kernel {
           }
           const auto i1 = static_cast<int>(
             static_cast<std::size_t>(x_Cd[0]) - i1_offset);
-          const auto dx1 = static_cast<prtldx_t>(
+          const auto dx1 = to_prtldx(
             x_Cd[0] - static_cast<real_t>(i1 + i1_offset));
           const auto i2 = static_cast<int>(
             static_cast<std::size_t>(x_Cd[1]) - i2_offset);
-          const auto dx2 = static_cast<prtldx_t>(
+          const auto dx2 = to_prtldx(
             x_Cd[1] - static_cast<real_t>(i2 + i2_offset));
 
           i1s(index)  = i1;
@@ -386,15 +386,15 @@ namespace kernel {
           }
           const auto i1 = static_cast<int>(
             static_cast<std::size_t>(x_Cd[0]) - i1_offset);
-          const auto dx1 = static_cast<prtldx_t>(
+          const auto dx1 = to_prtldx(
             x_Cd[0] - static_cast<real_t>(i1 + i1_offset));
           const auto i2 = static_cast<int>(
             static_cast<std::size_t>(x_Cd[1]) - i2_offset);
-          const auto dx2 = static_cast<prtldx_t>(
+          const auto dx2 = to_prtldx(
             x_Cd[1] - static_cast<real_t>(i2 + i2_offset));
           const auto i3 = static_cast<int>(
             static_cast<std::size_t>(x_Cd[2]) - i3_offset);
-          const auto dx3 = static_cast<prtldx_t>(
+          const auto dx3 = to_prtldx(
             x_Cd[2] - static_cast<real_t>(i3 + i3_offset));
 
           i1s(index)  = i1;
@@ -515,7 +515,7 @@ namespace kernel {
         auto rand_gen = random_pool.get_state();
         for (auto p { 0u }; p < ppc; ++p) {
           const auto index = Kokkos::atomic_fetch_add(&idx(), 1);
-          const auto dx1   = Random<prtldx_t>(rand_gen);
+          const auto dx1   = to_prtldx(Random<real_t>(rand_gen));
 
           i1s_1(index + offset1)  = static_cast<int>(i1) - N_GHOSTS;
           dx1s_1(index + offset1) = dx1;
@@ -571,8 +571,8 @@ namespace kernel {
         auto rand_gen = random_pool.get_state();
         for (auto p { 0u }; p < ppc; ++p) {
           const auto index = Kokkos::atomic_fetch_add(&idx(), 1);
-          const auto dx1   = Random<prtldx_t>(rand_gen);
-          const auto dx2   = Random<prtldx_t>(rand_gen);
+          const auto dx1   = to_prtldx(Random<real_t>(rand_gen));
+          const auto dx2   = to_prtldx(Random<real_t>(rand_gen));
 
           i1s_1(index + offset1)  = static_cast<int>(i1) - N_GHOSTS;
           dx1s_1(index + offset1) = dx1;
@@ -638,9 +638,9 @@ namespace kernel {
         auto rand_gen = random_pool.get_state();
         for (auto p { 0u }; p < ppc; ++p) {
           const auto index = Kokkos::atomic_fetch_add(&idx(), 1);
-          const auto dx1   = Random<prtldx_t>(rand_gen);
-          const auto dx2   = Random<prtldx_t>(rand_gen);
-          const auto dx3   = Random<prtldx_t>(rand_gen);
+          const auto dx1   = to_prtldx(Random<real_t>(rand_gen));
+          const auto dx2   = to_prtldx(Random<real_t>(rand_gen));
+          const auto dx3   = to_prtldx(Random<real_t>(rand_gen));
 
           i1s_1(index + offset1)  = static_cast<int>(i1) - N_GHOSTS;
           dx1s_1(index + offset1) = dx1;
@@ -2,6 +2,8 @@
  * @file kernels/particle_moments.hpp
  * @brief Algorithm for computing different moments from particle distribution
  * @implements
+ *   - kernel::moment_slot_t
+ *   - kernel::ParticleMultiMoments_kernel<>
  *   - kernel::ParticleMoments_kernel<>
  * @namespaces:
  *   - kernel::
@@ -24,29 +26,29 @@
 namespace kernel {
   using namespace ntt;
 
-  template <FldsID::type F>
-  auto get_contrib(float mass, float charge) -> real_t {
-    if constexpr (F == FldsID::Rho) {
-      return mass;
-    } else if constexpr (F == FldsID::Charge) {
-      return charge;
-    } else {
-      return ONE;
-    }
-  }
+  /**
+   * @brief Single moment component deposited by `ParticleMultiMoments_kernel`
+   * @param id: moment type (T, Rho, Charge, N or Nppc)
+   * @param c1, c2: components of the stress-energy tensor (only for T)
+   * @param buff_idx: component of the buffer to deposit to
+   */
+  struct moment_slot_t {
+    FldsID::type   id;
+    unsigned short c1, c2;
+    unsigned short buff_idx;
+  };
 
-  template <SimEngine::type S, class M, FldsID::type F, unsigned short N>
-  class ParticleMoments_kernel {
+  /**
+   * @brief Computes several moments of a particle species in a single pass
+   * @note Each particle deposits all the requested moments (up to N) at once;
+   * the energy & the 4-velocity needed for T are computed only once per particle
+   */
+  template <SimEngine::type S, class M, unsigned short N>
+  class ParticleMultiMoments_kernel {
     static_assert(M::is_metric, "M must be a metric class");
     static constexpr auto D = M::Dim;
 
-    static_assert((F == FldsID::Rho) || (F == FldsID::Charge) ||
-                    (F == FldsID::N) || (F == FldsID::Nppc) || (F == FldsID::T),
-                  "Invalid field ID");
-
-    const unsigned short     c1, c2;
     scatter_ndfield_t<D, N>  Buff;
-    const unsigned short     buff_idx;
     const array_t<int*>      i1, i2, i3;
     const array_t<prtldx_t*> dx1, dx2, dx3;
     const array_t<real_t*>   ux1, ux2, ux3;
@@ -61,40 +63,39 @@ namespace kernel {
     const real_t             inv_n0;
     const unsigned short     window;
 
-    const real_t contrib;
     const real_t smooth;
     bool         is_axis_i2min { false }, is_axis_i2max { false };
 
+    unsigned short            nslots { 0 };
+    list_t<FldsID::type, N>   slot_id;
+    list_t<unsigned short, N> slot_c1, slot_c2, slot_idx;
+    list_t<real_t, N>         slot_contrib;
+    bool                      compute_T { false };
+
   public:
-    ParticleMoments_kernel(const std::vector<unsigned short>& components,
-                           const scatter_ndfield_t<D, N>&     scatter_buff,
-                           unsigned short                     buff_idx,
-                           const array_t<int*>&               i1,
-                           const array_t<int*>&               i2,
-                           const array_t<int*>&               i3,
-                           const array_t<prtldx_t*>&          dx1,
-                           const array_t<prtldx_t*>&          dx2,
-                           const array_t<prtldx_t*>&          dx3,
-                           const array_t<real_t*>&            ux1,
-                           const array_t<real_t*>&            ux2,
-                           const array_t<real_t*>&            ux3,
-                           const array_t<real_t*>&            phi,
-                           const array_t<real_t*>&            weight,
-                           const array_t<short*>&             tag,
-                           float                              mass,
-                           float                              charge,
-                           bool                               use_weights,
-                           const M&                           metric,
-                           const boundaries_t<FldsBC>&        boundaries,
-                           std::size_t                        ni2,
-                           real_t                             inv_n0,
-                           unsigned short                     window)
-      : c1 { (components.size() == 2) ? components[0]
-                                      : static_cast<unsigned short>(0) }
-      , c2 { (components.size() == 2) ? components[1]
-                                      : static_cast<unsigned short>(0) }
-      , Buff { scatter_buff }
-      , buff_idx { buff_idx }
+    ParticleMultiMoments_kernel(const std::vector<moment_slot_t>& slots,
+                                const scatter_ndfield_t<D, N>&    scatter_buff,
+                                const array_t<int*>&              i1,
+                                const array_t<int*>&              i2,
+                                const array_t<int*>&              i3,
+                                const array_t<prtldx_t*>&         dx1,
+                                const array_t<prtldx_t*>&         dx2,
+                                const array_t<prtldx_t*>&         dx3,
+                                const array_t<real_t*>&           ux1,
+                                const array_t<real_t*>&           ux2,
+                                const array_t<real_t*>&           ux3,
+                                const array_t<real_t*>&           phi,
+                                const array_t<real_t*>&           weight,
+                                const array_t<short*>&            tag,
+                                float                             mass,
+                                float                             charge,
+                                bool                              use_weights,
+                                const M&                          metric,
+                                const boundaries_t<FldsBC>&       boundaries,
+                                std::size_t                       ni2,
+                                real_t                            inv_n0,
+                                unsigned short                    window)
+      : Buff { scatter_buff }
       , i1 { i1 }
       , i2 { i2 }
       , i3 { i3 }
@@ -114,14 +115,35 @@ namespace kernel {
       , ni2 { static_cast<int>(ni2) }
       , inv_n0 { inv_n0 }
       , window { window }
-      , contrib { get_contrib<F>(mass, charge) }
       , smooth { ONE / (real_t)(math::pow(TWO * (real_t)window + ONE,
                                           static_cast<int>(D))) } {
-      raise::ErrorIf(buff_idx >= N, "Invalid buffer index", HERE);
+      raise::ErrorIf(slots.size() > N, "Too many moments requested", HERE);
       raise::ErrorIf(window > N_GHOSTS, "Window size too large", HERE);
-      raise::ErrorIf(((F == FldsID::Rho) || (F == FldsID::Charge)) && (mass == ZERO),
-                     "Rho & Charge for massless particles not defined",
-                     HERE);
+      for (const auto& slot : slots) {
+        raise::ErrorIf((slot.id != FldsID::Rho) && (slot.id != FldsID::Charge) &&
+                         (slot.id != FldsID::N) && (slot.id != FldsID::Nppc) &&
+                         (slot.id != FldsID::T),
+                       "Invalid field ID",
+                       HERE);
+        raise::ErrorIf(slot.buff_idx >= N, "Invalid buffer index", HERE);
+        raise::ErrorIf(((slot.id == FldsID::Rho) || (slot.id == FldsID::Charge)) &&
+                         (mass == ZERO),
+                       "Rho & Charge for massless particles not defined",
+                       HERE);
+        slot_id[nslots]  = slot.id;
+        slot_c1[nslots]  = slot.c1;
+        slot_c2[nslots]  = slot.c2;
+        slot_idx[nslots] = slot.buff_idx;
+        if (slot.id == FldsID::Rho) {
+          slot_contrib[nslots] = mass;
+        } else if (slot.id == FldsID::Charge) {
+          slot_contrib[nslots] = charge;
+        } else {
+          slot_contrib[nslots] = ONE;
+        }
+        compute_T = compute_T || (slot.id == FldsID::T);
+        ++nslots;
+      }
       if constexpr ((M::CoordType != Coord::Cart) &&
                     ((D == Dim::_2D) || (D == Dim::_3D))) {
         raise::ErrorIf(boundaries.size() < 2, "boundaries defined incorrectly", HERE);
@@ -134,11 +156,10 @@ namespace kernel {
       if (tag(p) == ParticleTag::dead) {
         return;
       }
-      real_t coeff { ZERO };
-      if constexpr (F == FldsID::T) {
-        real_t          energy { ZERO };
-        // for stress-energy tensor
-        vec_t<Dim::_3D> u_Phys { ZERO };
+      real_t          energy { ZERO };
+      // for stress-energy tensor
+      vec_t<Dim::_3D> u_Phys { ZERO };
+      if (compute_T) {
         if constexpr (S == SimEngine::SRPIC) {
           // SR
           // stress-energy tensor for SR is computed in the tetrad (hatted) basis
@@ -149,10 +170,10 @@ namespace kernel {
           } else {
             static_assert(D != Dim::_1D, "non-Cartesian SRPIC 1D");
             coord_t<M::PrtlDim> x_Code { ZERO };
-            x_Code[0] = static_cast<real_t>(i1(p)) + static_cast<real_t>(dx1(p));
-            x_Code[1] = static_cast<real_t>(i2(p)) + static_cast<real_t>(dx2(p));
+            x_Code[0] = static_cast<real_t>(i1(p)) + from_prtldx(dx1(p));
+            x_Code[1] = static_cast<real_t>(i2(p)) + from_prtldx(dx2(p));
             if constexpr (D == Dim::_3D) {
-              x_Code[2] = static_cast<real_t>(i3(p)) + static_cast<real_t>(dx3(p));
+              x_Code[2] = static_cast<real_t>(i3(p)) + from_prtldx(dx3(p));
             } else {
               x_Code[2] = phi(p);
             }
@@ -172,10 +193,10 @@ namespace kernel {
           // stress-energy tensor for GR is computed in contravariant basis
           static_assert(D != Dim::_1D, "GRPIC 1D");
           coord_t<D> x_Code { ZERO };
-          x_Code[0] = static_cast<real_t>(i1(p)) + static_cast<real_t>(dx1(p));
-          x_Code[1] = static_cast<real_t>(i2(p)) + static_cast<real_t>(dx2(p));
+          x_Code[0] = static_cast<real_t>(i1(p)) + from_prtldx(dx1(p));
+          x_Code[1] = static_cast<real_t>(i2(p)) + from_prtldx(dx2(p));
           if constexpr (D == Dim::_3D) {
-            x_Code[2] = static_cast<real_t>(i3(p)) + static_cast<real_t>(dx3(p));
+            x_Code[2] = static_cast<real_t>(i3(p)) + from_prtldx(dx3(p));
           }
           vec_t<Dim::_3D> u_Cntrv { ZERO };
           // compute u_i u^i for energy
@@ -190,98 +211,89 @@ namespace kernel {
           }
           metric.template transform<Idx::U, Idx::PU>(x_Code, u_Cntrv, u_Phys);
         }
-        // compute the corresponding moment
-        coeff = ONE / energy;
+      }
+
+      // volume, weight & smoothing factor (shared by all the moments except nppc)
+      real_t norm { ZERO };
+      if constexpr (D == Dim::_1D) {
+        norm = inv_n0 / metric.sqrt_det_h({ static_cast<real_t>(i1(p)) + HALF });
+      } else if constexpr (D == Dim::_2D) {
+        norm = inv_n0 / metric.sqrt_det_h({ static_cast<real_t>(i1(p)) + HALF,
+                                            static_cast<real_t>(i2(p)) + HALF });
+      } else if constexpr (D == Dim::_3D) {
+        norm = inv_n0 / metric.sqrt_det_h({ static_cast<real_t>(i1(p)) + HALF,
+                                            static_cast<real_t>(i2(p)) + HALF,
+                                            static_cast<real_t>(i3(p)) + HALF });
+      }
+      norm *= weight(p) * smooth;
+
+      list_t<real_t, N> coeff;
+      for (auto s { 0 }; s < nslots; ++s) {
+        if (slot_id[s] == FldsID::T) {
+          // compute the corresponding moment
+          coeff[s] = ONE / energy;
 #pragma unroll
-        for (const auto& c : { c1, c2 }) {
-          if (c == 0) {
-            coeff *= energy;
-          } else {
-            coeff *= u_Phys[c - 1];
+          for (const auto& c : { slot_c1[s], slot_c2[s] }) {
+            if (c == 0) {
+              coeff[s] *= energy;
+            } else {
+              coeff[s] *= u_Phys[c - 1];
+            }
           }
+        } else {
+          // for other cases, use the `contrib` defined in the constructor
+          coeff[s] = slot_contrib[s];
         }
-      } else {
-        // for other cases, use the `contrib` defined above
-        coeff = contrib;
-      }
-
-      if constexpr (F != FldsID::Nppc) {
-        // for nppc calculation ...
-        // ... do not take volume, weights or smoothing into account
-        if constexpr (D == Dim::_1D) {
-          coeff *= inv_n0 /
-                   metric.sqrt_det_h({ static_cast<real_t>(i1(p)) + HALF });
-        } else if constexpr (D == Dim::_2D) {
-          coeff *= inv_n0 /
-                   metric.sqrt_det_h({ static_cast<real_t>(i1(p)) + HALF,
-                                       static_cast<real_t>(i2(p)) + HALF });
-        } else if constexpr (D == Dim::_3D) {
-          coeff *= inv_n0 /
-                   metric.sqrt_det_h({ static_cast<real_t>(i1(p)) + HALF,
-                                       static_cast<real_t>(i2(p)) + HALF,
-                                       static_cast<real_t>(i3(p)) + HALF });
+        if (slot_id[s] != FldsID::Nppc) {
+          // for nppc calculation ...
+          // ... do not take volume, weights or smoothing into account
+          coeff[s] *= norm;
         }
-        coeff *= weight(p) * smooth;
       }
 
       auto buff_access = Buff.access();
       if constexpr (D == Dim::_1D) {
         for (auto di1 { -window }; di1 <= window; ++di1) {
-          buff_access(i1(p) + di1 + N_GHOSTS, buff_idx) += coeff;
+          for (auto s { 0 }; s < nslots; ++s) {
+            buff_access(i1(p) + di1 + N_GHOSTS, slot_idx[s]) += coeff[s];
+          }
         }
       } else if constexpr (D == Dim::_2D) {
         for (auto di2 { -window }; di2 <= window; ++di2) {
           for (auto di1 { -window }; di1 <= window; ++di1) {
-            if constexpr (M::CoordType == Coord::Cart) {
-              buff_access(i1(p) + di1 + N_GHOSTS,
-                          i2(p) + di2 + N_GHOSTS,
-                          buff_idx) += coeff;
-            } else {
+            const int j1 = i1(p) + di1 + N_GHOSTS;
+            int       j2 = i2(p) + di2 + N_GHOSTS;
+            if constexpr (M::CoordType != Coord::Cart) {
               // reflect contribution at axes
               if (is_axis_i2min && (i2(p) + di2 < 0)) {
-                buff_access(i1(p) + di1 + N_GHOSTS,
-                            N_GHOSTS - (i2(p) + di2),
-                            buff_idx) += coeff;
+                j2 = N_GHOSTS - (i2(p) + di2);
               } else if (is_axis_i2max && (i2(p) + di2 >= ni2)) {
-                buff_access(i1(p) + di1 + N_GHOSTS,
-                            2 * ni2 - (i2(p) + di2) + N_GHOSTS,
-                            buff_idx) += coeff;
-              } else {
-                buff_access(i1(p) + di1 + N_GHOSTS,
-                            i2(p) + di2 + N_GHOSTS,
-                            buff_idx) += coeff;
+                j2 = 2 * ni2 - (i2(p) + di2) + N_GHOSTS;
               }
             }
+            for (auto s { 0 }; s < nslots; ++s) {
+              buff_access(j1, j2, slot_idx[s]) += coeff[s];
+            }
           }
         }
       } else if constexpr (D == Dim::_3D) {
         for (auto di3 { -window }; di3 <= window; ++di3) {
           for (auto di2 { -window }; di2 <= window; ++di2) {
             for (auto di1 { -window }; di1 <= window; ++di1) {
-              if constexpr (M::CoordType == Coord::Cart) {
-                buff_access(i1(p) + di1 + N_GHOSTS,
-                            i2(p) + di2 + N_GHOSTS,
-                            i3(p) + di3 + N_GHOSTS,
-                            buff_idx) += coeff;
-              } else {
+              const int j1 = i1(p) + di1 + N_GHOSTS;
+              int       j2 = i2(p) + di2 + N_GHOSTS;
+              const int j3 = i3(p) + di3 + N_GHOSTS;
+              if constexpr (M::CoordType != Coord::Cart) {
                 // reflect contribution at axes
                 if (is_axis_i2min && (i2(p) + di2 < 0)) {
-                  buff_access(i1(p) + di1 + N_GHOSTS,
-                              N_GHOSTS - (i2(p) + di2),
-                              i3(p) + di3 + N_GHOSTS,
-                              buff_idx) += coeff;
+                  j2 = N_GHOSTS - (i2(p) + di2);
                 } else if (is_axis_i2max && (i2(p) + di2 >= ni2)) {
-                  buff_access(i1(p) + di1 + N_GHOSTS,
-                              2 * ni2 - (i2(p) + di2) + N_GHOSTS,
-                              i3(p) + di3 + N_GHOSTS,
-                              buff_idx) += coeff;
-                } else {
-                  buff_access(i1(p) + di1 + N_GHOSTS,
-                              i2(p) + di2 + N_GHOSTS,
-                              i3(p) + di3 + N_GHOSTS,
-                              buff_idx) += coeff;
+                  j2 = 2 * ni2 - (i2(p) + di2) + N_GHOSTS;
                 }
               }
+              for (auto s { 0 }; s < nslots; ++s) {
+                buff_access(j1, j2, j3, slot_idx[s]) += coeff[s];
+              }
             }
           }
         }
@@ -289,6 +301,70 @@ namespace kernel {
     }
   };
 
+  /**
+   * @brief Computes a single moment F of a particle species
+   * @note Special case of `ParticleMultiMoments_kernel` with one moment
+   */
+  template <SimEngine::type S, class M, FldsID::type F, unsigned short N>
+  class ParticleMoments_kernel : public ParticleMultiMoments_kernel<S, M, N> {
+    static_assert((F == FldsID::Rho) || (F == FldsID::Charge) ||
+                    (F == FldsID::N) || (F == FldsID::Nppc) || (F == FldsID::T),
+                  "Invalid field ID");
+
+  public:
+    ParticleMoments_kernel(const std::vector<unsigned short>&  components,
+                           const scatter_ndfield_t<M::Dim, N>& scatter_buff,
+                           unsigned short                      buff_idx,
+                           const array_t<int*>&                i1,
+                           const array_t<int*>&                i2,
+                           const array_t<int*>&                i3,
+                           const array_t<prtldx_t*>&           dx1,
+                           const array_t<prtldx_t*>&           dx2,
+                           const array_t<prtldx_t*>&           dx3,
+                           const array_t<real_t*>&             ux1,
+                           const array_t<real_t*>&             ux2,
+                           const array_t<real_t*>&             ux3,
+                           const array_t<real_t*>&             phi,
+                           const array_t<real_t*>&             weight,
+                           const array_t<short*>&              tag,
+                           float                               mass,
+                           float                               charge,
+                           bool                                use_weights,
+                           const M&                            metric,
+                           const boundaries_t<FldsBC>&         boundaries,
+                           std::size_t                         ni2,
+                           real_t                              inv_n0,
+                           unsigned short                      window)
+      : ParticleMultiMoments_kernel<S, M, N> {
+        { moment_slot_t {
+          F,
+          (components.size() == 2) ? components[0] : static_cast<unsigned short>(0),
+          (components.size() == 2) ? components[1] : static_cast<unsigned short>(0),
+          buff_idx } },
+        scatter_buff,
+        i1,
+        i2,
+        i3,
+        dx1,
+        dx2,
+        dx3,
+        ux1,
+        ux2,
+        ux3,
+        phi,
+        weight,
+        tag,
+        mass,
+        charge,
+        use_weights,
+        metric,
+        boundaries,
+        ni2,
+        inv_n0,
+        window
+      } {}
+  };
+
 } // namespace kernel
 
 #endif // KERNELS_PARTICLE_MOMENTS_HPP
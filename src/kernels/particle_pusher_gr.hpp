@@ -5,8 +5,6 @@
  *   - kernel::gr::Pusher_kernel<>
  * @namespaces:
  *   - kernel::gr::
- * @macros:
- *   - MPI_ENABLED
  * !TODO:
  *   - 3D implementation
  */
@@ -18,26 +16,23 @@
 #include "global.h"
 
 #include "arch/kokkos_aliases.h"
+#include "arch/mpi_tags.h"
 #include "utils/error.h"
 #include "utils/numeric.h"
 
-#if defined(MPI_ENABLED)
-  #include "arch/mpi_tags.h"
-#endif
-
 /* -------------------------------------------------------------------------- */
 /* Local macros                                                               */
 /* -------------------------------------------------------------------------- */
 #define from_Xi_to_i(XI, I)                                                    \
   { I = static_cast<int>((XI)); }
 
-#define from_Xi_to_i_di(XI, I, DI)                                             \
+#define from_Xi_to_i_di(XI, I, DI, DITHER)                                     \
   {                                                                            \
     from_Xi_to_i((XI), (I));                                                   \
-    DI = static_cast<prtldx_t>((XI)) - static_cast<prtldx_t>(I);               \
+    DI = to_prtldx((XI) - static_cast<real_t>(I), (DITHER));                   \
   }
 
-#define i_di_to_Xi(I, DI) static_cast<real_t>((I)) + static_cast<real_t>((DI))
+#define i_di_to_Xi(I, DI) static_cast<real_t>((I)) + from_prtldx((DI))
 
 #define DERIVATIVE_IN_R(func, x)                                               \
   ((func({ x[0] + epsilon, x[1] }) - func({ x[0] - epsilon, x[1] })) /         \
@@ -76,44 +71,47 @@ namespace kernel::gr {
     array_t<short*>               tag;
     const M                       metric;
 
-    const real_t coeff, dt;
-    const int    ni1, ni2, ni3;
-    const real_t epsilon;
-    const int    niter;
-    const int    i1_absorb;
+    const real_t      coeff, dt;
+    // index of the timestep (seeds the rounding of the compact displacements)
+    const std::size_t step;
+    const int         ni1, ni2, ni3;
+    const real_t      epsilon;
+    const int         niter;
+    const int         i1_absorb;
 
     bool is_axis_i2min { false }, is_axis_i2max { false };
     bool is_absorb_i1min { false }, is_absorb_i1max { false };
 
   public:
-    Pusher_kernel(const ndfield_t<D, 6>&            DB,
-                  const ndfield_t<D, 6>&            DB0,
-                  const array_t<int*>&              i1,
-                  const array_t<int*>&              i2,
-                  const array_t<int*>&              i3,
-                  const array_t<int*>&              i1_prev,
-                  const array_t<int*>&              i2_prev,
-                  const array_t<int*>&              i3_prev,
-                  const array_t<prtldx_t*>&         dx1,
-                  const array_t<prtldx_t*>&         dx2,
-                  const array_t<prtldx_t*>&         dx3,
-                  const array_t<prtldx_t*>&         dx1_prev,
-                  const array_t<prtldx_t*>&         dx2_prev,
-                  const array_t<prtldx_t*>&         dx3_prev,
-                  const array_t<real_t*>&           ux1,
-                  const array_t<real_t*>&           ux2,
-                  const array_t<real_t*>&           ux3,
-                  const array_t<real_t*>&           phi,
-                  const array_t<short*>&            tag,
-                  const M&                          metric,
-                  const real_t&                     coeff,
-                  const real_t&                     dt,
-                  const int&                        ni1,
-                  const int&                        ni2,
-                  const int&                        ni3,
-                  const real_t&                     epsilon,
-                  const int&                        niter,
-                  const boundaries_t<PrtlBC::type>& boundaries)
+    Pusher_kernel(const ndfield_t<D, 6>&      DB,
+                  const ndfield_t<D, 6>&      DB0,
+                  const array_t<int*>&        i1,
+                  const array_t<int*>&        i2,
+                  const array_t<int*>&        i3,
+                  const array_t<int*>&        i1_prev,
+                  const array_t<int*>&        i2_prev,
+                  const array_t<int*>&        i3_prev,
+                  const array_t<prtldx_t*>&   dx1,
+                  const array_t<prtldx_t*>&   dx2,
+                  const array_t<prtldx_t*>&   dx3,
+                  const array_t<prtldx_t*>&   dx1_prev,
+                  const array_t<prtldx_t*>&   dx2_prev,
+                  const array_t<prtldx_t*>&   dx3_prev,
+                  const array_t<real_t*>&     ux1,
+                  const array_t<real_t*>&     ux2,
+                  const array_t<real_t*>&     ux3,
+                  const array_t<real_t*>&     phi,
+                  const array_t<short*>&      tag,
+                  const M&                    metric,
+                  const real_t&               coeff,
+                  const real_t&               dt,
+                  const std::size_t&          step,
+                  const int&                  ni1,
+                  const int&                  ni2,
+                  const int&                  ni3,
+                  const real_t&               epsilon,
+                  const int&                  niter,
+                  const boundaries_t<PrtlBC>& boundaries)
       : DB { DB }
       , DB0 { DB0 }
       , i1 { i1 }
@@ -136,6 +134,7 @@ namespace kernel::gr {
       , metric { metric }
       , coeff { coeff }
       , dt { dt }
+      , step { step }
       , ni1 { ni1 }
       , ni2 { ni2 }
       , ni3 { ni3 }
@@ -351,8 +350,8 @@ namespace kernel::gr {
         vp_upd[1] =
           vp[1] +
           dt *
-            (-metric.alpha(xp) * u0 * DERIVATIVE_IN_TH(alpha, xp) +
-             vp_mid[1] * DERIVATIVE_IN_TH(beta1, xp) -
+            (-metric.alpha(xp) * u0 * DERIVATIVE_IN_TH(metric.alpha, xp) +
+             vp_mid[1] * DERIVATIVE_IN_TH(metric.beta1, xp) -
              (HALF / u0) *
                (DERIVATIVE_IN_TH((metric.template h<1, 1>), xp) * SQR(vp_mid[0]) +
                 DERIVATIVE_IN_TH((metric.template h<2, 2>), xp) * SQR(vp_mid[1]) +
@@ -509,8 +508,8 @@ namespace kernel::gr {
 
       const int  i { i1(p) + static_cast<int>(N_GHOSTS) };
       const int  j { i2(p) + static_cast<int>(N_GHOSTS) };
-      const auto dx1_ { static_cast<real_t>(dx1(p)) };
-      const auto dx2_ { static_cast<real_t>(dx2(p)) };
+      const auto dx1_ { from_prtldx(dx1(p)) };
+      const auto dx2_ { from_prtldx(dx2(p)) };
 
       // first order
       real_t c000, c100, c010, c110, c00, c10;
@@ -617,8 +616,8 @@ namespace kernel::gr {
       // update coordinate
       int      i1_, i2_;
       prtldx_t dx1_, dx2_;
-      from_Xi_to_i_di(xp_upd[0], i1_, dx1_);
-      from_Xi_to_i_di(xp_upd[1], i2_, dx2_);
+      from_Xi_to_i_di(xp_upd[0], i1_, dx1_, prtldx_dither(p, step, 0));
+      from_Xi_to_i_di(xp_upd[1], i2_, dx2_, prtldx_dither(p, step, 1));
       i1(p)  = i1_;
       dx1(p) = dx1_;
       i2(p)  = i2_;
@@ -695,8 +694,8 @@ namespace kernel::gr {
       // update coordinate
       int      i1_, i2_;
       prtldx_t dx1_, dx2_;
-      from_Xi_to_i_di(xp_upd[0], i1_, dx1_);
-      from_Xi_to_i_di(xp_upd[1], i2_, dx2_);
+      from_Xi_to_i_di(xp_upd[0], i1_, dx1_, prtldx_dither(p, step, 0));
+      from_Xi_to_i_di(xp_upd[1], i2_, dx2_, prtldx_dither(p, step, 1));
       i1(p)  = i1_;
       dx1(p) = dx1_;
       i2(p)  = i2_;
@@ -730,7 +729,7 @@ namespace kernel::gr {
           ux2(p) = -ux2(p);
         }
       } else if (i2(p) >= ni2 - 1) {
-        if (is_axis_i2min) {
+        if (is_axis_i2max) {
           ux2(p) = -ux2(p);
         }
       }
@@ -738,7 +737,6 @@ namespace kernel::gr {
     if constexpr (D == Dim::_3D) {
       raise::KernelNotImplementedError(HERE);
     }
-#if defined(MPI_ENABLED)
     if constexpr (D == Dim::_1D) {
       tag(p) = mpi::SendTag(tag(p), i1(p) < 0, i1(p) >= ni1);
     } else if constexpr (D == Dim::_2D) {
@@ -752,7 +750,6 @@ namespace kernel::gr {
                             i3(p) < 0,
                             i3(p) >= ni3);
     }
-#endif
   }
 
 } // namespace kernel::gr
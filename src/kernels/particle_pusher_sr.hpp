@@ -5,11 +5,9 @@
  *   - kernel::sr::Pusher_kernel<>
  * @namespaces:
  *   - kernel::sr::
- * @macros:
- *   - MPI_ENABLED
  * @note
- * At the end of the boundary condition call, if MPI is enabled particles
- * are additionally tagged depending on which direction they are leaving
+ * At the end of the boundary condition call, particles are additionally
+ * tagged depending on which direction they are leaving
  */
 
 #ifndef KERNELS_PARTICLE_PUSHER_SR_HPP
@@ -19,26 +17,23 @@
 #include "global.h"
 
 #include "arch/kokkos_aliases.h"
+#include "arch/mpi_tags.h"
 #include "utils/error.h"
 #include "utils/numeric.h"
 
-#if defined(MPI_ENABLED)
-  #include "arch/mpi_tags.h"
-#endif
-
 /* -------------------------------------------------------------------------- */
 /* Local macros                                                               */
 /* -------------------------------------------------------------------------- */
 #define from_Xi_to_i(XI, I)                                                    \
   { I = static_cast<int>((XI + 1)) - 1; }
 
-#define from_Xi_to_i_di(XI, I, DI)                                             \
+#define from_Xi_to_i_di(XI, I, DI, DITHER)                                     \
   {                                                                            \
     from_Xi_to_i((XI), (I));                                                   \
-    DI = static_cast<prtldx_t>((XI)) - static_cast<prtldx_t>(I);               \
+    DI = to_prtldx((XI) - static_cast<real_t>(I), (DITHER));                   \
   }
 
-#define i_di_to_Xi(I, DI) static_cast<real_t>((I)) + static_cast<real_t>((DI))
+#define i_di_to_Xi(I, DI) static_cast<real_t>((I)) + from_prtldx((DI))
 
 /* -------------------------------------------------------------------------- */
 
@@ -226,6 +221,9 @@ namespace kernel::sr {
     // synchrotron cooling parameters
     const real_t coeff_sync;
 
+    // index of the timestep (seeds the rounding of the compact displacements)
+    const std::size_t step;
+
   public:
     Pusher_kernel(const PrtlPusher::type&     pusher,
                   bool                        GCA,
@@ -295,7 +293,8 @@ namespace kernel::sr {
       , ni3 { ni3 }
       , gca_larmor { gca_larmor_max }
       , gca_EovrB_sqr { SQR(gca_eovrb_max) }
-      , coeff_sync { coeff_sync } {
+      , coeff_sync { coeff_sync }
+      , step { (dt > ZERO) ? static_cast<std::size_t>(time / dt + HALF) : 0 } {
       raise::ErrorIf(boundaries.size() < 1, "boundaries defined incorrectly", HERE);
       is_absorb_i1min = (boundaries[0].first == PrtlBC::ATMOSPHERE) ||
                         (boundaries[0].first == PrtlBC::ABSORB);
@@ -583,14 +582,14 @@ namespace kernel::sr {
       if constexpr (D == Dim::_1D || D == Dim::_2D || D == Dim::_3D) {
         i1_prev(p)  = i1(p);
         dx1_prev(p) = dx1(p);
-        from_Xi_to_i_di(xp[0], i1(p), dx1(p));
+        from_Xi_to_i_di(xp[0], i1(p), dx1(p), prtldx_dither(p, step, 0));
       }
 
       // update x2 & phi
       if constexpr (D == Dim::_2D || D == Dim::_3D) {
         i2_prev(p)  = i2(p);
         dx2_prev(p) = dx2(p);
-        from_Xi_to_i_di(xp[1], i2(p), dx2(p));
+        from_Xi_to_i_di(xp[1], i2(p), dx2(p), prtldx_dither(p, step, 1));
         if constexpr (D == Dim::_2D && M::PrtlDim == Dim::_3D) {
           phi(p) = xp[2];
         }
@@ -600,7 +599,7 @@ namespace kernel::sr {
       if constexpr (D == Dim::_3D) {
         i3_prev(p)  = i3(p);
         dx3_prev(p) = dx3(p);
-        from_Xi_to_i_di(xp[2], i3(p), dx3(p));
+        from_Xi_to_i_di(xp[2], i3(p), dx3(p), prtldx_dither(p, step, 2));
       }
       boundaryConditions(p, xp);
     }
@@ -789,7 +788,7 @@ namespace kernel::sr {
                               vec_t<Dim::_3D>& b0) const {
       if constexpr (D == Dim::_1D) {
         const int  i { i1(p) + static_cast<int>(N_GHOSTS) };
-        const auto dx1_ { static_cast<real_t>(dx1(p)) };
+        const auto dx1_ { from_prtldx(dx1(p)) };
 
         // first order
         real_t c0, c1;
@@ -824,8 +823,8 @@ namespace kernel::sr {
       } else if constexpr (D == Dim::_2D) {
         const int  i { i1(p) + static_cast<int>(N_GHOSTS) };
         const int  j { i2(p) + static_cast<int>(N_GHOSTS) };
-        const auto dx1_ { static_cast<real_t>(dx1(p)) };
-        const auto dx2_ { static_cast<real_t>(dx2(p)) };
+        const auto dx1_ { from_prtldx(dx1(p)) };
+        const auto dx2_ { from_prtldx(dx2(p)) };
 
         // first order
         real_t c000, c100, c010, c110, c00, c10;
@@ -889,9 +888,9 @@ namespace kernel::sr {
         const int  i { i1(p) + static_cast<int>(N_GHOSTS) };
         const int  j { i2(p) + static_cast<int>(N_GHOSTS) };
         const int  k { i3(p) + static_cast<int>(N_GHOSTS) };
-        const auto dx1_ { static_cast<real_t>(dx1(p)) };
-        const auto dx2_ { static_cast<real_t>(dx2(p)) };
-        const auto dx3_ { static_cast<real_t>(dx3(p)) };
+        const auto dx1_ { from_prtldx(dx1(p)) };
+        const auto dx2_ { from_prtldx(dx2(p)) };
+        const auto dx3_ { from_prtldx(dx3(p)) };
 
         // first order
         real_t c000, c100, c010, c110, c001, c101, c011, c111, c00, c10, c01,
@@ -1059,7 +1058,7 @@ namespace kernel::sr {
             tag(p) = ParticleTag::dead;
           } else if (is_reflect_i1min) {
             i1(p)      = 0;
-            dx1(p)     = ONE - dx1(p);
+            dx1(p)     = to_prtldx(ONE - from_prtldx(dx1(p)));
             invert_vel = true;
           }
         } else if (i1(p) >= ni1) {
@@ -1070,7 +1069,7 @@ namespace kernel::sr {
             tag(p) = ParticleTag::dead;
           } else if (is_reflect_i1max) {
             i1(p)      = ni1 - 1;
-            dx1(p)     = ONE - dx1(p);
+            dx1(p)     = to_prtldx(ONE - from_prtldx(dx1(p)));
             invert_vel = true;
           }
         }
@@ -1101,11 +1100,11 @@ namespace kernel::sr {
             tag(p) = ParticleTag::dead;
           } else if (is_reflect_i2min) {
             i2(p)      = 0;
-            dx2(p)     = ONE - dx2(p);
+            dx2(p)     = to_prtldx(ONE - from_prtldx(dx2(p)));
             invert_vel = true;
           } else if (is_axis_i2min) {
             i2(p)  = 0;
-            dx2(p) = ONE - dx2(p);
+            dx2(p) = to_prtldx(ONE - from_prtldx(dx2(p)));
           }
         } else if (i2(p) >= ni2) {
           if (is_periodic_i2max) {
@@ -1115,11 +1114,11 @@ namespace kernel::sr {
             tag(p) = ParticleTag::dead;
           } else if (is_reflect_i2max) {
             i2(p)      = ni2 - 1;
-            dx2(p)     = ONE - dx2(p);
+            dx2(p)     = to_prtldx(ONE - from_prtldx(dx2(p)));
             invert_vel = true;
           } else if (is_axis_i2max) {
             i2(p)  = ni2 - 1;
-            dx2(p) = ONE - dx2(p);
+            dx2(p) = to_prtldx(ONE - from_prtldx(dx2(p)));
           }
         }
         if (invert_vel) {
@@ -1149,7 +1148,7 @@ namespace kernel::sr {
             tag(p) = ParticleTag::dead;
           } else if (is_reflect_i3min) {
             i3(p)      = 0;
-            dx3(p)     = ONE - dx3(p);
+            dx3(p)     = to_prtldx(ONE - from_prtldx(dx3(p)));
             invert_vel = true;
           }
         } else if (i3(p) >= ni3) {
@@ -1160,7 +1159,7 @@ namespace kernel::sr {
             tag(p) = ParticleTag::dead;
           } else if (is_reflect_i3max) {
             i3(p)      = ni3 - 1;
-            dx3(p)     = ONE - dx3(p);
+            dx3(p)     = to_prtldx(ONE - from_prtldx(dx3(p)));
             invert_vel = true;
           }
         }
@@ -1181,7 +1180,6 @@ namespace kernel::sr {
           }
         }
       }
-#if defined(MPI_ENABLED)
       if constexpr (D == Dim::_1D) {
         tag(p) = mpi::SendTag(tag(p), i1(p) < 0, i1(p) >= ni1);
       } else if constexpr (D == Dim::_2D) {
@@ -1195,7 +1193,6 @@ namespace kernel::sr {
                               i3(p) < 0,
                               i3(p) >= ni3);
       }
-#endif
     }
   };
 
@@ -0,0 +1,332 @@
+/**
+ * @file kernels/prtl_histogram.hpp
+ * @brief Histograms of the particle distribution (phase-space, angular, etc.)
+ * @implements
+ *   - kernel::hist_axis_t
+ *   - kernel::PrtlHistogram_kernel<>
+ * @namespaces:
+ *   - kernel::
+ * @note
+ * The histogram is flattened (row-major: the last axis changes the fastest)
+ * & accumulated with a scatter view; each particle contributes its weight
+ * @note Particles outside the ranges of the axes (or outside the box) are
+ * not counted
+ */
+
+#ifndef KERNELS_PRTL_HISTOGRAM_HPP
+#define KERNELS_PRTL_HISTOGRAM_HPP
+
+#include "enums.h"
+#include "global.h"
+
+#include "arch/kokkos_aliases.h"
+#include "utils/error.h"
+#include "utils/numeric.h"
+
+#include <Kokkos_ScatterView.hpp>
+
+#include <vector>
+
+namespace kernel {
+  using namespace ntt;
+
+  /**
+   * @brief Single axis of the histogram computed by `PrtlHistogram_kernel`
+   * @param q: quantity along the axis
+   * @param min, max: range of the quantity
+   * @param n_bins: # of bins
+   * @param log_bins: whether the bins are logarithmic
+   */
+  struct hist_axis_t {
+    HistAxis::type q;
+    real_t         min, max;
+    std::size_t    n_bins;
+    bool           log_bins;
+  };
+
+  template <SimEngine::type S, class M>
+  class PrtlHistogram_kernel {
+    static_assert(M::is_metric, "M must be a metric class");
+    static constexpr auto D = M::Dim;
+
+    scatter_array_t<real_t*> Hist;
+
+    unsigned short            naxes { 0 };
+    list_t<HistAxis::type, 3> axis_q;
+    list_t<real_t, 3>         axis_min, axis_max;
+    list_t<std::size_t, 3>    axis_n;
+    list_t<bool, 3>           axis_log;
+    bool                      compute_u { false };
+    bool                      compute_b { false };
+
+    bool       use_box;
+    coord_t<D> box_min { ZERO }, box_max { ZERO };
+
+    const ndfield_t<D, 6>    EM;
+    const array_t<int*>      i1, i2, i3;
+    const array_t<prtldx_t*> dx1, dx2, dx3;
+    const array_t<real_t*>   ux1, ux2, ux3;
+    const array_t<real_t*>   phi;
+    const array_t<real_t*>   weight;
+    const array_t<short*>    tag;
+    const bool               is_massive;
+    const M                  metric;
+
+  public:
+    /**
+     * @param axes axes of the histogram (up to 3)
+     * @param scatter_hist flattened histogram (of size n_bins1 * n_bins2 * ...)
+     * @param box extent of the box in physical coordinates (empty = no box)
+     * @param EM electromagnetic fields (only used for "upar", "uperp" & "mu")
+     * @param is_massive whether the species is massive
+     * @param metric metric of the domain
+     */
+    PrtlHistogram_kernel(const std::vector<hist_axis_t>& axes,
+                         const scatter_array_t<real_t*>& scatter_hist,
+                         const boundaries_t<real_t>&     box,
+                         const ndfield_t<D, 6>&          EM,
+                         const array_t<int*>&            i1,
+                         const array_t<int*>&            i2,
+                         const array_t<int*>&            i3,
+                         const array_t<prtldx_t*>&       dx1,
+                         const array_t<prtldx_t*>&       dx2,
+                         const array_t<prtldx_t*>&       dx3,
+                         const array_t<real_t*>&         ux1,
+                         const array_t<real_t*>&         ux2,
+                         const array_t<real_t*>&         ux3,
+                         const array_t<real_t*>&         phi,
+                         const array_t<real_t*>&         weight,
+                         const array_t<short*>&          tag,
+                         bool                            is_massive,
+                         const M&                        metric)
+      : Hist { scatter_hist }
+      , use_box { not box.empty() }
+      , EM { EM }
+      , i1 { i1 }
+      , i2 { i2 }
+      , i3 { i3 }
+      , dx1 { dx1 }
+      , dx2 { dx2 }
+      , dx3 { dx3 }
+      , ux1 { ux1 }
+      , ux2 { ux2 }
+      , ux3 { ux3 }
+      , phi { phi }
+      , weight { weight }
+      , tag { tag }
+      , is_massive { is_massive }
+      , metric { metric } {
+      raise::ErrorIf(axes.empty() or (axes.size() > 3),
+                     "Histogram must have 1 to 3 axes",
+                     HERE);
+      std::size_t nbins_total { 1 };
+      for (const auto& axis : axes) {
+        raise::ErrorIf((axis.n_bins == 0) or (axis.min >= axis.max) or
+                         (axis.log_bins and (axis.min <= ZERO)),
+                       "Invalid histogram axis",
+                       HERE);
+        axis_q[naxes]   = axis.q;
+        axis_min[naxes] = axis.log_bins ? math::log10(axis.min) : axis.min;
+        axis_max[naxes] = axis.log_bins ? math::log10(axis.max) : axis.max;
+        axis_n[naxes]   = axis.n_bins;
+        axis_log[naxes] = axis.log_bins;
+        compute_u = compute_u || (axis.q == HistAxis::U1) ||
+                    (axis.q == HistAxis::U2) || (axis.q == HistAxis::U3);
+        compute_b = compute_b || (axis.q == HistAxis::Upar) ||
+                    (axis.q == HistAxis::Uperp) || (axis.q == HistAxis::Mu);
+        nbins_total *= axis.n_bins;
+        ++naxes;
+      }
+      raise::ErrorIf(Hist.subview().extent(0) != nbins_total,
+                     "Histogram size does not match the axes",
+                     HERE);
+      raise::ErrorIf(compute_b and (S != SimEngine::SRPIC),
+                     "Histograms w.r.t. the magnetic field are only "
+                     "supported for SRPIC",
+                     HERE);
+      raise::ErrorIf(compute_b and (EM.extent(0) == 0),
+                     "Fields are required for the histogram",
+                     HERE);
+      if (use_box) {
+        raise::ErrorIf(box.size() != static_cast<std::size_t>(D),
+                       "Histogram box must be defined for each dimension",
+                       HERE);
+        coord_t<D> xmin_Ph { ZERO }, xmax_Ph { ZERO };
+        for (unsigned short d { 0 }; d < D; ++d) {
+          xmin_Ph[d] = box[d].first;
+          xmax_Ph[d] = box[d].second;
+        }
+        metric.template convert<Crd::Ph, Crd::Cd>(xmin_Ph, box_min);
+        metric.template convert<Crd::Ph, Crd::Cd>(xmax_Ph, box_max);
+      }
+    }
+
+    Inline void operator()(index_t p) const {
+      if (tag(p) != ParticleTag::alive) {
+        return;
+      }
+      coord_t<M::PrtlDim> xp_Cd { ZERO };
+      getPrtlPos(p, xp_Cd);
+      if (use_box) {
+        for (unsigned short d { 0 }; d < D; ++d) {
+          if ((xp_Cd[d] < box_min[d]) or (xp_Cd[d] >= box_max[d])) {
+            return;
+          }
+        }
+      }
+      vec_t<Dim::_3D> u_Phys { ZERO };
+      if (compute_u) {
+        getPrtlU(p, xp_Cd, u_Phys);
+      }
+      // components of the 4-velocity w.r.t. the local magnetic field
+      real_t u_par { ZERO }, u_perp { ZERO }, mu { ZERO };
+      if (compute_b) {
+        if constexpr (S == SimEngine::SRPIC) {
+          vec_t<Dim::_3D> b_Cntrv { ZERO }, b_XYZ { ZERO };
+          getCellB(p, b_Cntrv);
+          metric.template transform_xyz<Idx::U, Idx::XYZ>(xp_Cd,
+                                                           b_Cntrv,
+                                                           b_XYZ);
+          const auto b_norm = NORM(b_XYZ[0], b_XYZ[1], b_XYZ[2]);
+          if (b_norm == ZERO) {
+            // direction is not defined
+            return;
+          }
+          const auto u_norm = NORM(ux1(p), ux2(p), ux3(p));
+          u_par  = DOT(ux1(p), ux2(p), ux3(p), b_XYZ[0], b_XYZ[1], b_XYZ[2]) /
+                  b_norm;
+          u_perp = math::sqrt(math::max(ZERO, SQR(u_norm) - SQR(u_par)));
+          mu     = (u_norm > ZERO) ? u_par / u_norm : ZERO;
+        } else {
+          raise::KernelError(HERE, "Magnetic field is only available in SRPIC");
+        }
+      }
+      std::size_t idx { 0 };
+      for (unsigned short a { 0 }; a < naxes; ++a) {
+        real_t value { ZERO };
+        if (axis_q[a] == HistAxis::X1) {
+          value = metric.template convert<1, Crd::Cd, Crd::Ph>(xp_Cd[0]);
+        } else if (axis_q[a] == HistAxis::X2) {
+          if constexpr ((D == Dim::_2D) || (D == Dim::_3D)) {
+            value = metric.template convert<2, Crd::Cd, Crd::Ph>(xp_Cd[1]);
+          }
+        } else if (axis_q[a] == HistAxis::X3) {
+          if constexpr (D == Dim::_3D) {
+            value = metric.template convert<3, Crd::Cd, Crd::Ph>(xp_Cd[2]);
+          } else if constexpr (M::PrtlDim == Dim::_3D) {
+            value = xp_Cd[2];
+          }
+        } else if (axis_q[a] == HistAxis::U1) {
+          value = u_Phys[0];
+        } else if (axis_q[a] == HistAxis::U2) {
+          value = u_Phys[1];
+        } else if (axis_q[a] == HistAxis::U3) {
+          value = u_Phys[2];
+        } else if (axis_q[a] == HistAxis::E) {
+          if (is_massive) {
+            value = U2GAMMA(ux1(p), ux2(p), ux3(p)) - ONE;
+          } else {
+            value = NORM(ux1(p), ux2(p), ux3(p));
+          }
+        } else if (axis_q[a] == HistAxis::Upar) {
+          value = u_par;
+        } else if (axis_q[a] == HistAxis::Uperp) {
+          value = u_perp;
+        } else if (axis_q[a] == HistAxis::Mu) {
+          value = mu;
+        }
+        if (axis_log[a]) {
+          if (value <= ZERO) {
+            return;
+          }
+          value = math::log10(value);
+        }
+        if ((value < axis_min[a]) or (value >= axis_max[a])) {
+          return;
+        }
+        auto bin = static_cast<std::size_t>(static_cast<real_t>(axis_n[a]) *
+                                            (value - axis_min[a]) /
+                                            (axis_max[a] - axis_min[a]));
+        if (bin >= axis_n[a]) {
+          // roundoff at the upper edge
+          bin = axis_n[a] - 1;
+        }
+        idx = idx * axis_n[a] + bin;
+      }
+      auto hist_acc  = Hist.access();
+      hist_acc(idx) += weight(p);
+    }
+
+    Inline void getPrtlPos(index_t p, coord_t<M::PrtlDim>& xp) const {
+      if constexpr ((D == Dim::_1D) || (D == Dim::_2D) || (D == Dim::_3D)) {
+        xp[0] = static_cast<real_t>(i1(p)) + from_prtldx(dx1(p));
+      }
+      if constexpr ((D == Dim::_2D) || (D == Dim::_3D)) {
+        xp[1] = static_cast<real_t>(i2(p)) + from_prtldx(dx2(p));
+      }
+      if constexpr (D == Dim::_3D) {
+        xp[2] = static_cast<real_t>(i3(p)) + from_prtldx(dx3(p));
+      } else if constexpr (M::PrtlDim == Dim::_3D) {
+        xp[2] = phi(p);
+      }
+    }
+
+    /**
+     * @brief 4-velocity in the same basis as in the particle output
+     */
+    Inline void getPrtlU(index_t                    p,
+                         const coord_t<M::PrtlDim>& xp_Cd,
+                         vec_t<Dim::_3D>&           u_Phys) const {
+      if constexpr (S == SimEngine::SRPIC) {
+        if constexpr (M::CoordType == Coord::Cart) {
+          u_Phys[0] = ux1(p);
+          u_Phys[1] = ux2(p);
+          u_Phys[2] = ux3(p);
+        } else {
+          metric.template transform_xyz<Idx::XYZ, Idx::T>(
+            xp_Cd,
+            { ux1(p), ux2(p), ux3(p) },
+            u_Phys);
+        }
+      } else if constexpr (S == SimEngine::GRPIC) {
+        coord_t<D> x_Cd { ZERO };
+        for (unsigned short d { 0 }; d < D; ++d) {
+          x_Cd[d] = xp_Cd[d];
+        }
+        metric.template transform<Idx::D, Idx::PD>(x_Cd,
+                                                   { ux1(p), ux2(p), ux3(p) },
+                                                   u_Phys);
+      } else {
+        raise::KernelError(HERE, "Unrecognized simulation engine");
+      }
+    }
+
+    /**
+     * @brief Magnetic field at the center of the cell of the particle
+     */
+    Inline void getCellB(index_t p, vec_t<Dim::_3D>& b) const {
+      if constexpr (D == Dim::_1D) {
+        const int i { i1(p) + static_cast<int>(N_GHOSTS) };
+        b[0] = HALF * (EM(i, em::bx1) + EM(i + 1, em::bx1));
+        b[1] = EM(i, em::bx2);
+        b[2] = EM(i, em::bx3);
+      } else if constexpr (D == Dim::_2D) {
+        const int i { i1(p) + static_cast<int>(N_GHOSTS) };
+        const int j { i2(p) + static_cast<int>(N_GHOSTS) };
+        b[0] = HALF * (EM(i, j, em::bx1) + EM(i + 1, j, em::bx1));
+        b[1] = HALF * (EM(i, j, em::bx2) + EM(i, j + 1, em::bx2));
+        b[2] = EM(i, j, em::bx3);
+      } else if constexpr (D == Dim::_3D) {
+        const int i { i1(p) + static_cast<int>(N_GHOSTS) };
+        const int j { i2(p) + static_cast<int>(N_GHOSTS) };
+        const int k { i3(p) + static_cast<int>(N_GHOSTS) };
+        b[0] = HALF * (EM(i, j, k, em::bx1) + EM(i + 1, j, k, em::bx1));
+        b[1] = HALF * (EM(i, j, k, em::bx2) + EM(i, j + 1, k, em::bx2));
+        b[2] = HALF * (EM(i, j, k, em::bx3) + EM(i, j, k + 1, em::bx3));
+      }
+    }
+  };
+
+} // namespace kernel
+
+#endif // KERNELS_PRTL_HISTOGRAM_HPP
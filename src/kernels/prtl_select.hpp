@@ -0,0 +1,194 @@
+/**
+ * @file kernels/prtl_select.hpp
+ * @brief Selection of the particles for the output
+ * @implements
+ *   - kernel::PrtlSelect_kernel<>
+ * @namespaces:
+ *   - kernel::
+ * @note
+ * Used as a functor of `Kokkos::parallel_scan`: the indices of the selected
+ * particles are written consecutively (stream compaction), the scan result is
+ * the number of the selected particles
+ * @note Particles are selected by the stride (of their IDs if tracked), by the
+ * set of IDs, by the box in physical coordinates & by the minimum energy
+ */
+
+#ifndef KERNELS_PRTL_SELECT_HPP
+#define KERNELS_PRTL_SELECT_HPP
+
+#include "enums.h"
+#include "global.h"
+
+#include "arch/kokkos_aliases.h"
+#include "utils/error.h"
+#include "utils/numeric.h"
+
+namespace kernel {
+  using namespace ntt;
+
+  template <class M>
+  class PrtlSelect_kernel {
+    static_assert(M::is_metric, "M must be a metric class");
+    static constexpr Dimension D = M::Dim;
+
+  protected:
+    array_t<std::size_t*>       indices;
+    const std::size_t           stride;
+    const array_t<std::size_t*> ids_sel;
+    const bool                  use_box;
+    coord_t<D>                  box_min { ZERO }, box_max { ZERO };
+    const real_t                e_min;
+    const bool                  is_massive;
+    const array_t<int*>         i1, i2, i3;
+    const array_t<prtldx_t*>    dx1, dx2, dx3;
+    const array_t<real_t*>      ux1, ux2, ux3;
+    const array_t<short*>       tag;
+    const array_t<std::size_t*> id;
+
+  public:
+    /**
+     * @param indices output: indices of the selected particles
+     * @param stride select every `stride`-th particle (ignored if `ids_sel` is set)
+     * @param ids_sel sorted IDs to select (empty = all)
+     * @param box extent of the box in physical coordinates (empty = no box)
+     * @param e_min minimum energy: gamma - 1 (massive) or |u| (massless)
+     * @param is_massive whether the species is massive
+     * @param id IDs of the particles (empty if not tracked)
+     * @param metric metric of the domain
+     */
+    PrtlSelect_kernel(array_t<std::size_t*>&       indices,
+                      std::size_t                  stride,
+                      const array_t<std::size_t*>& ids_sel,
+                      const boundaries_t<real_t>&  box,
+                      real_t                       e_min,
+                      bool                         is_massive,
+                      const array_t<int*>&         i1,
+                      const array_t<int*>&         i2,
+                      const array_t<int*>&         i3,
+                      const array_t<prtldx_t*>&    dx1,
+                      const array_t<prtldx_t*>&    dx2,
+                      const array_t<prtldx_t*>&    dx3,
+                      const array_t<real_t*>&      ux1,
+                      const array_t<real_t*>&      ux2,
+                      const array_t<real_t*>&      ux3,
+                      const array_t<short*>&       tag,
+                      const array_t<std::size_t*>& id,
+                      const M&                     metric)
+      : indices { indices }
+      , stride { stride }
+      , ids_sel { ids_sel }
+      , use_box { not box.empty() }
+      , e_min { e_min }
+      , is_massive { is_massive }
+      , i1 { i1 }
+      , i2 { i2 }
+      , i3 { i3 }
+      , dx1 { dx1 }
+      , dx2 { dx2 }
+      , dx3 { dx3 }
+      , ux1 { ux1 }
+      , ux2 { ux2 }
+      , ux3 { ux3 }
+      , tag { tag }
+      , id { id } {
+      raise::ErrorIf(stride == 0, "Stride must be positive", HERE);
+      raise::ErrorIf(ids_sel.extent(0) > 0 and id.extent(0) == 0,
+                     "Selection by ID requires the particle IDs",
+                     HERE);
+      if (use_box) {
+        raise::ErrorIf(box.size() != static_cast<std::size_t>(D),
+                       "Selection box must be defined for each dimension",
+                       HERE);
+        // the conversion is monotonic in each direction: only the corners of
+        // ... the box are converted to the code units of the domain
+        coord_t<D> xmin_Ph { ZERO }, xmax_Ph { ZERO };
+        for (unsigned short d { 0 }; d < D; ++d) {
+          xmin_Ph[d] = box[d].first;
+          xmax_Ph[d] = box[d].second;
+        }
+        metric.template convert<Crd::Ph, Crd::Cd>(xmin_Ph, box_min);
+        metric.template convert<Crd::Ph, Crd::Cd>(xmax_Ph, box_max);
+      }
+    }
+
+    Inline void operator()(index_t p, std::size_t& n, const bool is_final) const {
+      if (selected(p)) {
+        if (is_final) {
+          indices(n) = p;
+        }
+        ++n;
+      }
+    }
+
+    Inline auto selected(index_t p) const -> bool {
+      if (tag(p) != ParticleTag::alive) {
+        return false;
+      }
+      if (ids_sel.extent(0) > 0) {
+        if (not selectedID(id(p))) {
+          return false;
+        }
+      } else if (id.extent(0) > 0) {
+        // IDs do not change when the particles are sorted or communicated
+        if (id(p) % stride != 0) {
+          return false;
+        }
+      } else if (p % stride != 0) {
+        return false;
+      }
+      if (use_box and not insideBox(p)) {
+        return false;
+      }
+      if (e_min > ZERO) {
+        real_t en;
+        if (is_massive) {
+          en = U2GAMMA(ux1(p), ux2(p), ux3(p)) - ONE;
+        } else {
+          en = NORM(ux1(p), ux2(p), ux3(p));
+        }
+        if (en < e_min) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    Inline auto selectedID(std::size_t pid) const -> bool {
+      // binary search in the sorted IDs
+      std::size_t lo { 0 }, hi { ids_sel.extent(0) };
+      while (lo < hi) {
+        const auto mid = lo + (hi - lo) / 2;
+        if (ids_sel(mid) < pid) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+      return (lo < ids_sel.extent(0)) and (ids_sel(lo) == pid);
+    }
+
+    Inline auto insideBox(index_t p) const -> bool {
+      if constexpr ((D == Dim::_1D) || (D == Dim::_2D) || (D == Dim::_3D)) {
+        const auto x1 = static_cast<real_t>(i1(p)) + from_prtldx(dx1(p));
+        if ((x1 < box_min[0]) or (x1 >= box_max[0])) {
+          return false;
+        }
+      }
+      if constexpr ((D == Dim::_2D) || (D == Dim::_3D)) {
+        const auto x2 = static_cast<real_t>(i2(p)) + from_prtldx(dx2(p));
+        if ((x2 < box_min[1]) or (x2 >= box_max[1])) {
+          return false;
+        }
+      }
+      if constexpr (D == Dim::_3D) {
+        const auto x3 = static_cast<real_t>(i3(p)) + from_prtldx(dx3(p));
+        if ((x3 < box_min[2]) or (x3 >= box_max[2])) {
+          return false;
+        }
+      }
+      return true;
+    }
+  };
+} // namespace kernel
+
+#endif // KERNELS_PRTL_SELECT_HPP
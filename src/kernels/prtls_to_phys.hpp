@@ -10,6 +10,8 @@
  * and velocities to physical units
  * @note SR : to the corresponding tetrad basis
  * @note GR : x -- coordinate basis, u -- covariant basis
+ * @note Either every `stride`-th particle is converted, or the particles with
+ * the given indices (e.g., selected by `PrtlSelect_kernel`)
  */
 
 #ifndef KERNELS_PRTLS_TO_PHYS_HPP
@@ -31,43 +33,46 @@ namespace kernel {
     static constexpr Dimension D = M::Dim;
 
   protected:
-    const std::size_t        stride;
-    array_t<real_t*>         buff_x1;
-    array_t<real_t*>         buff_x2;
-    array_t<real_t*>         buff_x3;
-    array_t<real_t*>         buff_ux1;
-    array_t<real_t*>         buff_ux2;
-    array_t<real_t*>         buff_ux3;
-    array_t<real_t*>         buff_wei;
-    const array_t<int*>      i1, i2, i3;
-    const array_t<prtldx_t*> dx1, dx2, dx3;
-    const array_t<real_t*>   ux1, ux2, ux3;
-    const array_t<real_t*>   phi;
-    const array_t<real_t*>   weight;
-    const M                  metric;
+    const std::size_t           stride;
+    const array_t<std::size_t*> indices;
+    array_t<real_t*>            buff_x1;
+    array_t<real_t*>            buff_x2;
+    array_t<real_t*>            buff_x3;
+    array_t<real_t*>            buff_ux1;
+    array_t<real_t*>            buff_ux2;
+    array_t<real_t*>            buff_ux3;
+    array_t<real_t*>            buff_wei;
+    const array_t<int*>         i1, i2, i3;
+    const array_t<prtldx_t*>    dx1, dx2, dx3;
+    const array_t<real_t*>      ux1, ux2, ux3;
+    const array_t<real_t*>      phi;
+    const array_t<real_t*>      weight;
+    const M                     metric;
 
   public:
-    PrtlToPhys_kernel(std::size_t               stride,
-                      array_t<real_t*>&         buff_x1,
-                      array_t<real_t*>&         buff_x2,
-                      array_t<real_t*>&         buff_x3,
-                      array_t<real_t*>&         buff_ux1,
-                      array_t<real_t*>&         buff_ux2,
-                      array_t<real_t*>&         buff_ux3,
-                      array_t<real_t*>&         buff_wei,
-                      const array_t<int*>&      i1,
-                      const array_t<int*>&      i2,
-                      const array_t<int*>&      i3,
-                      const array_t<prtldx_t*>& dx1,
-                      const array_t<prtldx_t*>& dx2,
-                      const array_t<prtldx_t*>& dx3,
-                      const array_t<real_t*>&   ux1,
-                      const array_t<real_t*>&   ux2,
-                      const array_t<real_t*>&   ux3,
-                      const array_t<real_t*>&   phi,
-                      const array_t<real_t*>&   weight,
-                      const M&                  metric)
+    PrtlToPhys_kernel(std::size_t                  stride,
+                      array_t<real_t*>&            buff_x1,
+                      array_t<real_t*>&            buff_x2,
+                      array_t<real_t*>&            buff_x3,
+                      array_t<real_t*>&            buff_ux1,
+                      array_t<real_t*>&            buff_ux2,
+                      array_t<real_t*>&            buff_ux3,
+                      array_t<real_t*>&            buff_wei,
+                      const array_t<int*>&         i1,
+                      const array_t<int*>&         i2,
+                      const array_t<int*>&         i3,
+                      const array_t<prtldx_t*>&    dx1,
+                      const array_t<prtldx_t*>&    dx2,
+                      const array_t<prtldx_t*>&    dx3,
+                      const array_t<real_t*>&      ux1,
+                      const array_t<real_t*>&      ux2,
+                      const array_t<real_t*>&      ux3,
+                      const array_t<real_t*>&      phi,
+                      const array_t<real_t*>&      weight,
+                      const M&                     metric,
+                      const array_t<std::size_t*>& indices = {})
       : stride { stride }
+      , indices { indices }
       , buff_x1 { buff_x1 }
       , buff_x2 { buff_x2 }
       , buff_x3 { buff_x3 }
@@ -105,38 +110,43 @@ namespace kernel {
     Inline void operator()(index_t p) const {
       bufferX(p);
       bufferU(p);
-      buff_wei(p) = weight(p * stride);
+      buff_wei(p) = weight(prtl(p));
+    }
+
+    /**
+     * @brief Index of the particle to write to the p-th slot of the buffers
+     */
+    Inline auto prtl(index_t p) const -> std::size_t {
+      return (indices.extent(0) > 0) ? indices(p) : p * stride;
     }
 
     Inline void bufferX(index_t& p) const {
+      const auto q = prtl(p);
       if constexpr ((D == Dim::_1D) || (D == Dim::_2D) || (D == Dim::_3D)) {
         buff_x1(p) = metric.template convert<1, Crd::Cd, Crd::Ph>(
-          static_cast<real_t>(i1(p * stride)) +
-          static_cast<real_t>(dx1(p * stride)));
+          static_cast<real_t>(i1(q)) + from_prtldx(dx1(q)));
       }
       if constexpr ((D == Dim::_2D) || (D == Dim::_3D)) {
         buff_x2(p) = metric.template convert<2, Crd::Cd, Crd::Ph>(
-          static_cast<real_t>(i2(p * stride)) +
-          static_cast<real_t>(dx2(p * stride)));
+          static_cast<real_t>(i2(q)) + from_prtldx(dx2(q)));
       }
       if constexpr ((D == Dim::_2D) && (M::CoordType != Coord::Cart)) {
-        buff_x3(p) = phi(p * stride);
+        buff_x3(p) = phi(q);
       }
       if constexpr (D == Dim::_3D) {
         buff_x3(p) = metric.template convert<3, Crd::Cd, Crd::Ph>(
-          static_cast<real_t>(i3(p * stride)) +
-          static_cast<real_t>(dx3(p * stride)));
+          static_cast<real_t>(i3(q)) + from_prtldx(dx3(q)));
       }
     }
 
     Inline void bufferU(index_t& p) const {
+      const auto      q = prtl(p);
       vec_t<Dim::_3D> u_Phys { ZERO };
       if constexpr (D == Dim::_1D) {
         if constexpr (M::CoordType == Coord::Cart) {
           metric.template transform_xyz<Idx::XYZ, Idx::T>(
-            { static_cast<real_t>(i1(p * stride)) +
-              static_cast<real_t>(dx1(p * stride)) },
-            { ux1(p * stride), ux2(p * stride), ux3(p * stride) },
+            { static_cast<real_t>(i1(q)) + from_prtldx(dx1(q)) },
+            { ux1(q), ux2(q), ux3(q) },
             u_Phys);
         } else {
           raise::KernelError(HERE, "Unsupported coordinate system in 1D");
@@ -144,28 +154,22 @@ namespace kernel {
       } else if constexpr (D == Dim::_2D) {
         if constexpr (M::CoordType == Coord::Cart) {
           metric.template transform_xyz<Idx::XYZ, Idx::T>(
-            { static_cast<real_t>(i1(p * stride)) +
-                static_cast<real_t>(dx1(p * stride)),
-              static_cast<real_t>(i2(p * stride)) +
-                static_cast<real_t>(dx2(p * stride)) },
-            { ux1(p * stride), ux2(p * stride), ux3(p * stride) },
+            { static_cast<real_t>(i1(q)) + from_prtldx(dx1(q)),
+              static_cast<real_t>(i2(q)) + from_prtldx(dx2(q)) },
+            { ux1(q), ux2(q), ux3(q) },
             u_Phys);
         } else if constexpr (S == SimEngine::SRPIC) {
           metric.template transform_xyz<Idx::XYZ, Idx::T>(
-            { static_cast<real_t>(i1(p * stride)) +
-                static_cast<real_t>(dx1(p * stride)),
-              static_cast<real_t>(i2(p * stride)) +
-                static_cast<real_t>(dx2(p * stride)),
-              phi(p * stride) },
-            { ux1(p * stride), ux2(p * stride), ux3(p * stride) },
+            { static_cast<real_t>(i1(q)) + from_prtldx(dx1(q)),
+              static_cast<real_t>(i2(q)) + from_prtldx(dx2(q)),
+              phi(q) },
+            { ux1(q), ux2(q), ux3(q) },
             u_Phys);
         } else if constexpr (S == SimEngine::GRPIC) {
           metric.template transform<Idx::D, Idx::PD>(
-            { static_cast<real_t>(i1(p * stride)) +
-                static_cast<real_t>(dx1(p * stride)),
-              static_cast<real_t>(i2(p * stride)) +
-                static_cast<real_t>(dx2(p * stride)) },
-            { ux1(p * stride), ux2(p * stride), ux3(p * stride) },
+            { static_cast<real_t>(i1(q)) + from_prtldx(dx1(q)),
+              static_cast<real_t>(i2(q)) + from_prtldx(dx2(q)) },
+            { ux1(q), ux2(q), ux3(q) },
             u_Phys);
         } else {
           raise::KernelError(HERE, "Unrecognized simulation engine");
@@ -173,23 +177,17 @@ namespace kernel {
       } else if constexpr (D == Dim::_3D) {
         if constexpr (S == SimEngine::SRPIC) {
           metric.template transform_xyz<Idx::XYZ, Idx::T>(
-            { static_cast<real_t>(i1(p * stride)) +
-                static_cast<real_t>(dx1(p * stride)),
-              static_cast<real_t>(i2(p * stride)) +
-                static_cast<real_t>(dx2(p * stride)),
-              static_cast<real_t>(i3(p * stride)) +
-                static_cast<real_t>(dx3(p * stride)) },
-            { ux1(p * stride), ux2(p * stride), ux3(p * stride) },
+            { static_cast<real_t>(i1(q)) + from_prtldx(dx1(q)),
+              static_cast<real_t>(i2(q)) + from_prtldx(dx2(q)),
+              static_cast<real_t>(i3(q)) + from_prtldx(dx3(q)) },
+            { ux1(q), ux2(q), ux3(q) },
             u_Phys);
         } else if constexpr (S == SimEngine::GRPIC) {
           metric.template transform<Idx::D, Idx::PD>(
-            { static_cast<real_t>(i1(p * stride)) +
-                static_cast<real_t>(dx1(p * stride)),
-              static_cast<real_t>(i2(p * stride)) +
-                static_cast<real_t>(dx2(p * stride)),
-              static_cast<real_t>(i3(p * stride)) +
-                static_cast<real_t>(dx3(p * stride)) },
-            { ux1(p * stride), ux2(p * stride), ux3(p * stride) },
+            { static_cast<real_t>(i1(q)) + from_prtldx(dx1(q)),
+              static_cast<real_t>(i2(q)) + from_prtldx(dx2(q)),
+              static_cast<real_t>(i3(q)) + from_prtldx(dx3(q)) },
+            { ux1(q), ux2(q), ux3(q) },
             u_Phys);
         } else {
           raise::KernelError(HERE, "Unrecognized simulation engine");
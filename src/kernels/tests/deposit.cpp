@@ -2,6 +2,7 @@
 #include "global.h"
 
 #include "arch/kokkos_aliases.h"
+#include "arch/mpi_tags.h"
 #include "utils/comparators.h"
 
 #include "metrics/kerr_schild.h"
@@ -11,6 +12,7 @@
 #include "metrics/qspherical.h"
 #include "metrics/spherical.h"
 
+#include "framework/containers/particles.h"
 #include "kernels/currents_deposit.hpp"
 
 #include <Kokkos_Core.hpp>
@@ -61,24 +63,28 @@ void testDeposit(const std::vector<std::size_t>&      res,
   const auto nx2 = res[1];
 
   ndfield_t<M::Dim, 3> J { "J", nx1 + 2 * N_GHOSTS, nx2 + 2 * N_GHOSTS };
-  array_t<int*>        i1 { "i1", 10 };
-  array_t<int*>        i2 { "i2", 10 };
-  array_t<int*>        i3 { "i3", 10 };
+  // the tiled deposit groups the particles of the container (see `TileIndex`)
+  Particles<M::Dim, M::CoordType> prtls {
+    1, "e-", 1.0, 1.0, 10, PrtlPusher::BORIS, false, Cooling::NONE
+  };
+  auto&                i1     = prtls.i1;
+  auto&                i2     = prtls.i2;
+  auto&                i3     = prtls.i3;
+  auto&                dx1    = prtls.dx1;
+  auto&                dx2    = prtls.dx2;
+  auto&                dx3    = prtls.dx3;
+  auto&                ux1    = prtls.ux1;
+  auto&                ux2    = prtls.ux2;
+  auto&                ux3    = prtls.ux3;
+  auto&                phi    = prtls.phi;
+  auto&                weight = prtls.weight;
+  auto&                tag    = prtls.tag;
   array_t<int*>        i1_prev { "i1_prev", 10 };
   array_t<int*>        i2_prev { "i2_prev", 10 };
   array_t<int*>        i3_prev { "i3_prev", 10 };
-  array_t<prtldx_t*>   dx1 { "dx1", 10 };
-  array_t<prtldx_t*>   dx2 { "dx2", 10 };
-  array_t<prtldx_t*>   dx3 { "dx3", 10 };
   array_t<prtldx_t*>   dx1_prev { "dx1_prev", 10 };
   array_t<prtldx_t*>   dx2_prev { "dx2_prev", 10 };
   array_t<prtldx_t*>   dx3_prev { "dx3_prev", 10 };
-  array_t<real_t*>     ux1 { "ux1", 10 };
-  array_t<real_t*>     ux2 { "ux2", 10 };
-  array_t<real_t*>     ux3 { "ux3", 10 };
-  array_t<real_t*>     phi { "phi", 10 };
-  array_t<real_t*>     weight { "weight", 10 };
-  array_t<short*>      tag { "tag", 10 };
   const real_t         charge { 1.0 }, inv_dt { 1.0 };
 
   auto J_scat = Kokkos::Experimental::create_scatter_view(J);
@@ -174,6 +180,119 @@ void testDeposit(const std::vector<std::size_t>&      res,
           "DepositCurrents_kernel::Jy1 is incorrect");
   errorIf(not equal(J_h(i0 + 1 + N_GHOSTS, j0 + N_GHOSTS, cur::jx2), Jy2, "", acc),
           "DepositCurrents_kernel::Jy2 is incorrect");
+
+  // tiled deposit must reproduce the same currents, incl. the ones of the
+  // ... particles tagged to be sent (here: one leaving through the +x1 edge)
+  put_value<int>(i1, static_cast<int>(nx1), 1);
+  put_value<int>(i2, j0, 1);
+  put_value<int>(i1_prev, static_cast<int>(nx1) - 1, 1);
+  put_value<int>(i2_prev, j0, 1);
+  put_value<prtldx_t>(dx1, dxf, 1);
+  put_value<prtldx_t>(dx2, dyf, 1);
+  put_value<prtldx_t>(dx1_prev, dxi, 1);
+  put_value<prtldx_t>(dx2_prev, dyi, 1);
+  put_value<real_t>(weight, 1.0, 1);
+  put_value<short>(tag, mpi::PrtlSendTag<Dim::_2D>::ip1__j0, 1);
+  prtls.set_npart(2);
+
+  Kokkos::deep_copy(J, ZERO);
+  J_scat.reset();
+  Kokkos::parallel_for("CurrentsDeposit",
+                       prtls.rangeActiveParticles(),
+                       kernel::DepositCurrents_kernel<S, M>(J_scat,
+                                                            i1,
+                                                            i2,
+                                                            i3,
+                                                            i1_prev,
+                                                            i2_prev,
+                                                            i3_prev,
+                                                            dx1,
+                                                            dx2,
+                                                            dx3,
+                                                            dx1_prev,
+                                                            dx2_prev,
+                                                            dx3_prev,
+                                                            ux1,
+                                                            ux2,
+                                                            ux3,
+                                                            phi,
+                                                            weight,
+                                                            tag,
+                                                            metric,
+                                                            charge,
+                                                            inv_dt));
+  Kokkos::Experimental::contribute(J, J_scat);
+
+  ndfield_t<M::Dim, 3> J_tiled { "J_tiled", nx1 + 2 * N_GHOSTS, nx2 + 2 * N_GHOSTS };
+  const unsigned short tile_size = 4;
+  const auto [tile_offsets, tile_prtls] = prtls.TileIndex(res, tile_size);
+  {
+    // repeated calls reuse the same buffers
+    const auto [offsets_again, prtls_again] = prtls.TileIndex(res, tile_size);
+    errorIf((offsets_again.data() != tile_offsets.data()) or
+              (prtls_again.data() != tile_prtls.data()),
+            "TileIndex reallocated its buffers");
+    auto tile_offsets_h = Kokkos::create_mirror_view(tile_offsets);
+    Kokkos::deep_copy(tile_offsets_h, tile_offsets);
+    // 3 x 3 tiles: both particles are binned
+    errorIf((tile_offsets_h(0) != 0) or (tile_offsets_h(9) != 2),
+            "TileIndex skipped the particles");
+  }
+  using deposit_t         = kernel::DepositCurrentsTiled_kernel<S, M>;
+  const auto deposit_tile = deposit_t(J_tiled,
+                                      tile_offsets,
+                                      tile_prtls,
+                                      res,
+                                      tile_size,
+                                      i1,
+                                      i2,
+                                      i3,
+                                      i1_prev,
+                                      i2_prev,
+                                      i3_prev,
+                                      dx1,
+                                      dx2,
+                                      dx3,
+                                      dx1_prev,
+                                      dx2_prev,
+                                      dx3_prev,
+                                      ux1,
+                                      ux2,
+                                      ux3,
+                                      phi,
+                                      weight,
+                                      tag,
+                                      metric,
+                                      charge,
+                                      inv_dt);
+  errorIf(deposit_tile.ntiles_tot() != 9,
+          "DepositCurrentsTiled_kernel::ntiles_tot is incorrect");
+  Kokkos::parallel_for(
+    "CurrentsDepositTiled",
+    team_policy_t(deposit_tile.ntiles_tot(), Kokkos::AUTO)
+      .set_scratch_size(0, Kokkos::PerTeam(deposit_t::scratch_size(tile_size))),
+    deposit_tile);
+
+  std::size_t ndiff { 0 };
+  Kokkos::parallel_reduce(
+    "CompareTiled",
+    Kokkos::MDRangePolicy<Kokkos::Rank<2>>({ 0, 0 },
+                                           { nx1 + 2 * N_GHOSTS, nx2 + 2 * N_GHOSTS }),
+    Lambda(const int i, const int j, std::size_t& nd) {
+      for (auto c = 0; c < 3; ++c) {
+        if (not cmp::AlmostEqual(J(i, j, c), J_tiled(i, j, c), epsilon * acc)) {
+          nd += 1;
+        }
+      }
+    },
+    ndiff);
+  errorIf(ndiff != 0, "DepositCurrentsTiled_kernel differs from the scatter one");
+
+  // the leaving particle deposits across the edge of the domain
+  auto J_tiled_h = Kokkos::create_mirror_view(J_tiled);
+  Kokkos::deep_copy(J_tiled_h, J_tiled);
+  errorIf(cmp::AlmostZero(J_tiled_h(nx1 - 1 + N_GHOSTS, j0 + N_GHOSTS, cur::jx1)),
+          "DepositCurrentsTiled_kernel lost the current of a leaving particle");
 }
 
 auto main(int argc, char* argv[]) -> int {
@@ -0,0 +1,134 @@
+#include "kernels/fields_accumulate.hpp"
+
+#include "global.h"
+
+#include "arch/kokkos_aliases.h"
+#include "utils/comparators.h"
+#include "utils/error.h"
+#include "utils/formatting.h"
+#include "utils/numeric.h"
+
+#include <Kokkos_Core.hpp>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using namespace ntt;
+
+void checkField(const ndfield_t<Dim::_2D, 6>& fld,
+                unsigned short                c,
+                real_t                        expected,
+                const std::string&            label) {
+  auto fld_h = Kokkos::create_mirror_view(fld);
+  Kokkos::deep_copy(fld_h, fld);
+  for (std::size_t i { N_GHOSTS }; i < fld.extent(0) - N_GHOSTS; ++i) {
+    for (std::size_t j { N_GHOSTS }; j < fld.extent(1) - N_GHOSTS; ++j) {
+      raise::ErrorIf(not cmp::AlmostEqual_host(fld_h(i, j, c),
+                                               expected,
+                                               static_cast<real_t>(1e-5)),
+                     fmt::format("Wrong %s at (%d, %d): %f",
+                                 label.c_str(),
+                                 i,
+                                 j,
+                                 fld_h(i, j, c)),
+                     HERE);
+    }
+  }
+}
+
+void testFieldsAccumulate() {
+  const std::size_t nx = 8 + 2 * N_GHOSTS, ny = 8 + 2 * N_GHOSTS;
+  const auto        range = CreateRangePolicy<Dim::_2D>(
+    { N_GHOSTS, N_GHOSTS },
+    { nx - N_GHOSTS, ny - N_GHOSTS });
+
+  // sampled fields: E = (1, -2, 0) * n, B = (0, 0, 3) at the n-th sample
+  ndfield_t<Dim::_2D, 6> fld { "fld", nx, ny };
+  ndfield_t<Dim::_2D, 6> out { "out", nx, ny };
+  ndfield_t<Dim::_2D, 3> acc_mean { "acc_mean", nx, ny };
+  ndfield_t<Dim::_2D, 3> acc_rms { "acc_rms", nx, ny };
+  ndfield_t<Dim::_2D, 3> acc_int { "acc_int", nx, ny };
+  Kokkos::deep_copy(Kokkos::subview(fld, Kokkos::ALL, Kokkos::ALL, 5),
+                    static_cast<real_t>(3));
+
+  const auto        dt       = static_cast<real_t>(0.5);
+  const std::size_t nsamples = 3;
+  for (std::size_t n { 1 }; n <= nsamples; ++n) {
+    Kokkos::deep_copy(Kokkos::subview(fld, Kokkos::ALL, Kokkos::ALL, 0),
+                      static_cast<real_t>(n));
+    Kokkos::deep_copy(Kokkos::subview(fld, Kokkos::ALL, Kokkos::ALL, 1),
+                      -TWO * static_cast<real_t>(n));
+    Kokkos::parallel_for("Mean",
+                         range,
+                         kernel::AccumulateFields_kernel<Dim::_2D>(
+                           acc_mean,
+                           fld,
+                           0,
+                           kernel::AccumOp::Value,
+                           ONE));
+    Kokkos::parallel_for("RMS",
+                         range,
+                         kernel::AccumulateFields_kernel<Dim::_2D>(
+                           acc_rms,
+                           fld,
+                           0,
+                           kernel::AccumOp::Square,
+                           ONE));
+    Kokkos::parallel_for("Poynting",
+                         range,
+                         kernel::AccumulateFields_kernel<Dim::_2D>(
+                           acc_int,
+                           fld,
+                           0,
+                           kernel::AccumOp::Cross,
+                           dt));
+  }
+  const auto inv_n = ONE / static_cast<real_t>(nsamples);
+
+  // mean: E1 = (1 + 2 + 3) / 3 = 2
+  Kokkos::parallel_for(
+    "Finalize",
+    range,
+    kernel::FinalizeAccumulator_kernel<Dim::_2D>(acc_mean, out, 0, inv_n, false));
+  checkField(out, 0, TWO, "mean E1");
+  checkField(out, 1, -static_cast<real_t>(4), "mean E2");
+  checkField(out, 2, ZERO, "mean E3");
+
+  // rms: E1 = sqrt((1 + 4 + 9) / 3)
+  Kokkos::parallel_for(
+    "Finalize",
+    range,
+    kernel::FinalizeAccumulator_kernel<Dim::_2D>(acc_rms, out, 3, inv_n, true));
+  checkField(out,
+             3,
+             math::sqrt(static_cast<real_t>(14) / static_cast<real_t>(3)),
+             "rms E1");
+  checkField(out,
+             4,
+             TWO * math::sqrt(static_cast<real_t>(14) / static_cast<real_t>(3)),
+             "rms E2");
+
+  // integral of E x B = (-6 n, -3 n, 0) over 3 samples separated by dt
+  Kokkos::parallel_for(
+    "Finalize",
+    range,
+    kernel::FinalizeAccumulator_kernel<Dim::_2D>(acc_int, out, 0, ONE, false));
+  checkField(out, 0, -static_cast<real_t>(36) * dt, "integral S1");
+  checkField(out, 1, -static_cast<real_t>(18) * dt, "integral S2");
+  checkField(out, 2, ZERO, "integral S3");
+}
+
+auto main(int argc, char* argv[]) -> int {
+  Kokkos::initialize(argc, argv);
+
+  try {
+    testFieldsAccumulate();
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    Kokkos::finalize();
+    return 1;
+  }
+  Kokkos::finalize();
+  return 0;
+}
@@ -244,6 +244,62 @@ void testParticleMoments(const std::vector<std::size_t>&      res,
                         metric.Dim,
                         metric.Label));
   }
+
+  // all the components deposited in a single pass should be the same
+  ndfield_t<Dim::_2D, 3> buff_fused { "buff_fused",
+                                      nx1 + 2 * N_GHOSTS,
+                                      nx2 + 2 * N_GHOSTS };
+  auto scatter_fused = Kokkos::Experimental::create_scatter_view(buff_fused);
+  Kokkos::parallel_for(
+    "ParticleMultiMoments",
+    10,
+    kernel::ParticleMultiMoments_kernel<S, M, 3>(
+      { { FldsID::T, comp1[0], comp1[1], 0 },
+        { FldsID::T, comp2[0], comp2[1], 1 },
+        { FldsID::T, comp3[0], comp3[1], 2 } },
+      scatter_fused,
+      i1,
+      i2,
+      i3,
+      dx1,
+      dx2,
+      dx3,
+      ux1,
+      ux2,
+      ux3,
+      phi,
+      weight,
+      tag,
+      mass,
+      charge,
+      use_weights,
+      metric,
+      boundaries,
+      nx2,
+      inv_n0,
+      window));
+  Kokkos::Experimental::contribute(buff_fused, scatter_fused);
+  {
+    auto buff_h       = Kokkos::create_mirror_view(buff);
+    auto buff_fused_h = Kokkos::create_mirror_view(buff_fused);
+    Kokkos::deep_copy(buff_h, buff);
+    Kokkos::deep_copy(buff_fused_h, buff_fused);
+    for (unsigned int idx1 = 0; idx1 < nx1 + 2 * N_GHOSTS; ++idx1) {
+      for (unsigned int idx2 = 0; idx2 < nx2 + 2 * N_GHOSTS; ++idx2) {
+        for (unsigned short c = 0; c < 3; ++c) {
+          errorIf(not cmp::AlmostEqual_host(buff_fused_h(idx1, idx2, c),
+                                            buff_h(idx1, idx2, c),
+                                            epsilon * acc),
+                  fmt::format("wrong fused moment %d at %d %d for %dD %s",
+                              c,
+                              idx1,
+                              idx2,
+                              metric.Dim,
+                              metric.Label));
+        }
+      }
+    }
+  }
 }
 
 auto main(int argc, char* argv[]) -> int {
@@ -0,0 +1,240 @@
+#include "kernels/prtl_histogram.hpp"
+
+#include "enums.h"
+#include "global.h"
+
+#include "arch/kokkos_aliases.h"
+#include "utils/error.h"
+#include "utils/formatting.h"
+#include "utils/numeric.h"
+
+#include "metrics/minkowski.h"
+
+#include <Kokkos_Core.hpp>
+#include <Kokkos_ScatterView.hpp>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ntt;
+
+/**
+ * @brief Computes the histogram & returns it on the host
+ */
+template <class M>
+auto computeHistogram(const M&                               metric,
+                      const std::vector<kernel::hist_axis_t>& axes,
+                      const boundaries_t<real_t>&             box,
+                      const ndfield_t<Dim::_2D, 6>&           EM,
+                      const array_t<int*>&                    i1,
+                      const array_t<int*>&                    i2,
+                      const array_t<prtldx_t*>&               dx1,
+                      const array_t<prtldx_t*>&               dx2,
+                      const array_t<real_t*>&                 ux1,
+                      const array_t<real_t*>&                 ux2,
+                      const array_t<real_t*>&                 ux3,
+                      const array_t<real_t*>&                 weight,
+                      const array_t<short*>&                  tag)
+  -> std::vector<real_t> {
+  std::size_t nbins { 1 };
+  for (const auto& axis : axes) {
+    nbins *= axis.n_bins;
+  }
+  array_t<real_t*>   hist { "hist", nbins };
+  array_t<int*>      i3;
+  array_t<prtldx_t*> dx3;
+  array_t<real_t*>   phi;
+  auto hist_scatter = Kokkos::Experimental::create_scatter_view(hist);
+  const auto hist_kernel = kernel::PrtlHistogram_kernel<SimEngine::SRPIC, M>(
+    axes,
+    hist_scatter,
+    box,
+    EM,
+    i1,
+    i2,
+    i3,
+    dx1,
+    dx2,
+    dx3,
+    ux1,
+    ux2,
+    ux3,
+    phi,
+    weight,
+    tag,
+    true,
+    metric);
+  Kokkos::parallel_for("Histogram", i1.extent(0), hist_kernel);
+  Kokkos::Experimental::contribute(hist, hist_scatter);
+  auto hist_h = Kokkos::create_mirror_view(hist);
+  Kokkos::deep_copy(hist_h, hist);
+  std::vector<real_t> result;
+  for (std::size_t n { 0 }; n < nbins; ++n) {
+    result.push_back(hist_h(n));
+  }
+  return result;
+}
+
+void checkBin(const std::vector<real_t>& hist,
+              std::size_t                idx,
+              real_t                     expected,
+              const std::string&         label) {
+  raise::ErrorIf(
+    hist[idx] != expected,
+    fmt::format("Wrong %s histogram at %d: %f", label.c_str(), idx, hist[idx]),
+    HERE);
+}
+
+void testPrtlHistogram() {
+  using M = metric::Minkowski<Dim::_2D>;
+  // 10 x 10 cells of size 0.1
+  const std::vector<std::size_t> res { 10, 10 };
+  const boundaries_t<real_t>     extent {
+    { ZERO, ONE },
+    { ZERO, ONE }
+  };
+  const M metric { res, extent, {} };
+
+  // uniform magnetic field along x1
+  ndfield_t<Dim::_2D, 6> EM { "EM", 10 + 2 * N_GHOSTS, 10 + 2 * N_GHOSTS };
+  Kokkos::deep_copy(Kokkos::subview(EM, Kokkos::ALL, Kokkos::ALL, em::bx1),
+                    ONE);
+
+  const std::size_t  nprtl = 100;
+  array_t<int*>      i1 { "i1", nprtl };
+  array_t<int*>      i2 { "i2", nprtl };
+  array_t<prtldx_t*> dx1 { "dx1", nprtl };
+  array_t<prtldx_t*> dx2 { "dx2", nprtl };
+  array_t<real_t*>   ux1 { "ux1", nprtl };
+  array_t<real_t*>   ux2 { "ux2", nprtl };
+  array_t<real_t*>   ux3 { "ux3", nprtl };
+  array_t<real_t*>   weight { "weight", nprtl };
+  array_t<short*>    tag { "tag", nprtl };
+
+  // particle p sits in the middle of the cell (p % 10, p / 10) & has the
+  // ... 4-velocity (p % 10 + 0.5, 1, 0); the last row of particles is dead
+  Kokkos::parallel_for(
+    "Init",
+    nprtl,
+    Lambda(index_t p) {
+      i1(p)     = static_cast<int>(p % 10);
+      i2(p)     = static_cast<int>(p / 10);
+      dx1(p)    = static_cast<prtldx_t>(0.5);
+      dx2(p)    = static_cast<prtldx_t>(0.5);
+      ux1(p)    = static_cast<real_t>(p % 10) + HALF;
+      ux2(p)    = ONE;
+      ux3(p)    = ZERO;
+      weight(p) = ONE;
+      tag(p)    = (p >= 90) ? ParticleTag::dead : ParticleTag::alive;
+    });
+
+  {
+    // x1 -- u1 phase-space: particles lie on the diagonal
+    const std::vector<kernel::hist_axis_t> axes {
+      { HistAxis::X1, ZERO, ONE, 10, false },
+      { HistAxis::U1, ZERO, static_cast<real_t>(10), 10, false }
+    };
+    const auto hist = computeHistogram(
+      metric,
+      axes,
+      {},
+      EM,
+      i1,
+      i2,
+      dx1,
+      dx2,
+      ux1,
+      ux2,
+      ux3,
+      weight,
+      tag);
+    for (std::size_t i { 0 }; i < 10; ++i) {
+      for (std::size_t j { 0 }; j < 10; ++j) {
+        checkBin(hist,
+                 i * 10 + j,
+                 (i == j) ? static_cast<real_t>(9) : ZERO,
+                 "x1-u1");
+      }
+    }
+  }
+
+  {
+    // u_parallel -- u_perp w.r.t. the magnetic field
+    const std::vector<kernel::hist_axis_t> axes {
+      {  HistAxis::Upar, ZERO, static_cast<real_t>(10), 10, false },
+      { HistAxis::Uperp, ZERO,                     TWO,  2, false }
+    };
+    const auto hist = computeHistogram(
+      metric,
+      axes,
+      {},
+      EM,
+      i1,
+      i2,
+      dx1,
+      dx2,
+      ux1,
+      ux2,
+      ux3,
+      weight,
+      tag);
+    for (std::size_t i { 0 }; i < 10; ++i) {
+      checkBin(hist, i * 2, ZERO, "upar-uperp");
+      checkBin(hist, i * 2 + 1, static_cast<real_t>(9), "upar-uperp");
+    }
+  }
+
+  {
+    // energy (log bins) -- pitch angle within the box x1 < 0.5
+    const boundaries_t<real_t> box {
+      { ZERO, HALF },
+      { ZERO,  ONE }
+    };
+    const auto e_min = static_cast<real_t>(0.1);
+    const auto e_max = static_cast<real_t>(100);
+    const std::vector<kernel::hist_axis_t> axes {
+      {  HistAxis::E, e_min, e_max, 3,  true },
+      { HistAxis::Mu,  -ONE,   ONE, 4, false }
+    };
+    const auto hist = computeHistogram(
+      metric,
+      axes,
+      box,
+      EM,
+      i1,
+      i2,
+      dx1,
+      dx2,
+      ux1,
+      ux2,
+      ux3,
+      weight,
+      tag);
+    // u1 = 0.5: E = 0.5 & mu = 0.45, u1 >= 1.5: 1 < E < 10 & mu > 0.5
+    real_t total { ZERO };
+    for (const auto& h : hist) {
+      total += h;
+    }
+    raise::ErrorIf(total != static_cast<real_t>(45),
+                   "Wrong # of particles in the box",
+                   HERE);
+    checkBin(hist, 0 * 4 + 2, static_cast<real_t>(9), "e-mu");
+    checkBin(hist, 1 * 4 + 3, static_cast<real_t>(36), "e-mu");
+  }
+}
+
+auto main(int argc, char* argv[]) -> int {
+  Kokkos::initialize(argc, argv);
+
+  try {
+    testPrtlHistogram();
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    Kokkos::finalize();
+    return 1;
+  }
+  Kokkos::finalize();
+  return 0;
+}
@@ -0,0 +1,251 @@
+#include "kernels/prtl_select.hpp"
+
+#include "enums.h"
+#include "global.h"
+
+#include "arch/kokkos_aliases.h"
+#include "utils/error.h"
+#include "utils/formatting.h"
+#include "utils/numeric.h"
+
+#include "metrics/minkowski.h"
+
+#include <Kokkos_Core.hpp>
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace ntt;
+
+/**
+ * @brief Runs the selection & returns the selected indices
+ */
+template <class M>
+auto selectParticles(const M&                     metric,
+                     std::size_t                  stride,
+                     const array_t<std::size_t*>& ids_sel,
+                     const boundaries_t<real_t>&  box,
+                     real_t                       e_min,
+                     const array_t<int*>&         i1,
+                     const array_t<int*>&         i2,
+                     const array_t<prtldx_t*>&    dx1,
+                     const array_t<prtldx_t*>&    dx2,
+                     const array_t<real_t*>&      ux1,
+                     const array_t<short*>&       tag,
+                     const array_t<std::size_t*>& id)
+  -> std::vector<std::size_t> {
+  const auto            nprtl = i1.extent(0);
+  array_t<std::size_t*> indices { "indices", nprtl };
+  array_t<int*>         i3;
+  array_t<prtldx_t*>    dx3;
+  array_t<real_t*>      ux2 { "ux2", nprtl };
+  array_t<real_t*>      ux3 { "ux3", nprtl };
+  std::size_t           nsel { 0 };
+  Kokkos::parallel_scan("Select",
+                        nprtl,
+                        kernel::PrtlSelect_kernel<M>(indices,
+                                                     stride,
+                                                     ids_sel,
+                                                     box,
+                                                     e_min,
+                                                     true,
+                                                     i1,
+                                                     i2,
+                                                     i3,
+                                                     dx1,
+                                                     dx2,
+                                                     dx3,
+                                                     ux1,
+                                                     ux2,
+                                                     ux3,
+                                                     tag,
+                                                     id,
+                                                     metric),
+                        nsel);
+  auto indices_h = Kokkos::create_mirror_view(indices);
+  Kokkos::deep_copy(indices_h, indices);
+  std::vector<std::size_t> selected;
+  for (std::size_t n { 0 }; n < nsel; ++n) {
+    selected.push_back(indices_h(n));
+  }
+  return selected;
+}
+
+void testPrtlSelect() {
+  using M = metric::Minkowski<Dim::_2D>;
+  // 10 x 10 cells of size 0.1
+  const std::vector<std::size_t> res { 10, 10 };
+  const boundaries_t<real_t>     extent {
+    { ZERO, ONE },
+    { ZERO, ONE }
+  };
+  const M metric { res, extent, {} };
+
+  const std::size_t     nprtl = 100;
+  array_t<int*>         i1 { "i1", nprtl };
+  array_t<int*>         i2 { "i2", nprtl };
+  array_t<prtldx_t*>    dx1 { "dx1", nprtl };
+  array_t<prtldx_t*>    dx2 { "dx2", nprtl };
+  array_t<real_t*>      ux1 { "ux1", nprtl };
+  array_t<short*>       tag { "tag", nprtl };
+  array_t<std::size_t*> id { "id", nprtl };
+  array_t<std::size_t*> no_id;
+  array_t<std::size_t*> no_ids_sel;
+
+  // particle p sits in the middle of the cell (p % 10, p / 10), has the
+  // ... 4-velocity p / 10 & the ID 1000 + p; every 10-th particle is dead
+  Kokkos::parallel_for(
+    "Init",
+    nprtl,
+    Lambda(index_t p) {
+      i1(p)  = static_cast<int>(p % 10);
+      i2(p)  = static_cast<int>(p / 10);
+      dx1(p) = static_cast<prtldx_t>(0.5);
+      dx2(p) = static_cast<prtldx_t>(0.5);
+      ux1(p) = static_cast<real_t>(p) / static_cast<real_t>(10);
+      tag(p) = (p % 10 == 9) ? ParticleTag::dead : ParticleTag::alive;
+      id(p)  = 1000 + p;
+    });
+
+  {
+    // every 3-rd particle (by index)
+    const auto sel = selectParticles(metric,
+                                     3,
+                                     no_ids_sel,
+                                     {},
+                                     ZERO,
+                                     i1,
+                                     i2,
+                                     dx1,
+                                     dx2,
+                                     ux1,
+                                     tag,
+                                     no_id);
+    for (const auto& p : sel) {
+      raise::ErrorIf((p % 3 != 0) or (p % 10 == 9),
+                     "Wrong stride selection",
+                     HERE);
+    }
+    // 34 multiples of 3, 4 of which are dead (9, 39, 69, 99)
+    raise::ErrorIf(sel.size() != 30,
+                   fmt::format("Wrong # of particles selected by stride: %lu",
+                               sel.size()),
+                   HERE);
+  }
+
+  {
+    // every 4-th particle (by ID)
+    const auto sel = selectParticles(metric,
+                                     4,
+                                     no_ids_sel,
+                                     {},
+                                     ZERO,
+                                     i1,
+                                     i2,
+                                     dx1,
+                                     dx2,
+                                     ux1,
+                                     tag,
+                                     id);
+    for (const auto& p : sel) {
+      raise::ErrorIf((1000 + p) % 4 != 0, "Wrong selection by ID stride", HERE);
+    }
+    // IDs 1000, 1004, ..., 1096 (dead particles have odd IDs)
+    raise::ErrorIf(sel.size() != 25,
+                   "Wrong # of particles selected by ID",
+                   HERE);
+  }
+
+  {
+    // set of IDs (including a dead particle & a non-existing ID)
+    const std::vector<std::size_t> ids { 1005, 1019, 1042, 1077, 5000 };
+    array_t<std::size_t*>          ids_sel { "ids_sel", ids.size() };
+    auto ids_sel_h = Kokkos::create_mirror_view(ids_sel);
+    for (std::size_t n { 0 }; n < ids.size(); ++n) {
+      ids_sel_h(n) = ids[n];
+    }
+    Kokkos::deep_copy(ids_sel, ids_sel_h);
+    const auto sel = selectParticles(metric,
+                                     1,
+                                     ids_sel,
+                                     {},
+                                     ZERO,
+                                     i1,
+                                     i2,
+                                     dx1,
+                                     dx2,
+                                     ux1,
+                                     tag,
+                                     id);
+    raise::ErrorIf(sel != std::vector<std::size_t> { 5, 42, 77 },
+                   "Wrong selection by ID",
+                   HERE);
+  }
+
+  {
+    // box in physical coordinates: cells [2, 5) x [0, 3)
+    const boundaries_t<real_t> box {
+      { 0.2, 0.5 },
+      { 0.0, 0.3 }
+    };
+    const auto sel = selectParticles(metric,
+                                     1,
+                                     no_ids_sel,
+                                     box,
+                                     ZERO,
+                                     i1,
+                                     i2,
+                                     dx1,
+                                     dx2,
+                                     ux1,
+                                     tag,
+                                     no_id);
+    for (const auto& p : sel) {
+      raise::ErrorIf((p % 10 < 2) or (p % 10 >= 5) or (p / 10 >= 3),
+                     "Wrong selection by box",
+                     HERE);
+    }
+    raise::ErrorIf(sel.size() != 9, "Wrong # of particles in the box", HERE);
+  }
+
+  {
+    // energy threshold between the particles 49 & 50
+    const auto e_min = math::sqrt(ONE + SQR(static_cast<real_t>(4.95))) - ONE;
+
+    const auto sel = selectParticles(metric,
+                                     1,
+                                     no_ids_sel,
+                                     {},
+                                     e_min,
+                                     i1,
+                                     i2,
+                                     dx1,
+                                     dx2,
+                                     ux1,
+                                     tag,
+                                     no_id);
+    for (const auto& p : sel) {
+      raise::ErrorIf(p < 50, "Wrong selection by energy", HERE);
+    }
+    // 50 particles above the threshold, 5 of which are dead
+    raise::ErrorIf(sel.size() != 45,
+                   "Wrong # of particles above the threshold",
+                   HERE);
+  }
+}
+
+auto main(int argc, char* argv[]) -> int {
+  Kokkos::initialize(argc, argv);
+
+  try {
+    testPrtlSelect();
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    Kokkos::finalize();
+    return 1;
+  }
+  Kokkos::finalize();
+  return 0;
+}
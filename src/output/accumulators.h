@@ -0,0 +1,63 @@
+/**
+ * @file output/accumulators.h
+ * @brief Defines the metadata for the time-accumulated field diagnostics
+ * @implements
+ *   - out::OutputAccumulator
+ * @note Quantities: "E", "B", "J" & "S" (the Poynting vector E x B)
+ * @note Modes: "mean", "rms" & "integral" (time-integrated)
+ */
+
+#ifndef OUTPUT_ACCUMULATORS_H
+#define OUTPUT_ACCUMULATORS_H
+
+#include <string>
+
+namespace out {
+
+  class OutputAccumulator {
+    const std::string m_quantity;
+    const std::string m_mode;
+
+  public:
+    /**
+     * @param quantity accumulated vector quantity
+     * @param mode how the samples are combined
+     */
+    OutputAccumulator(const std::string& quantity, const std::string& mode)
+      : m_quantity { quantity }
+      , m_mode { mode } {}
+
+    ~OutputAccumulator() = default;
+
+    [[nodiscard]]
+    auto quantity() const -> const std::string& {
+      return m_quantity;
+    }
+
+    [[nodiscard]]
+    auto mode() const -> const std::string& {
+      return m_mode;
+    }
+
+    /**
+     * @brief Whether the accumulator needs E & B (otherwise J) at each sample
+     */
+    [[nodiscard]]
+    auto is_electromagnetic() const -> bool {
+      return m_quantity != "J";
+    }
+
+    /**
+     * @param ci component index (starting at 0)
+     * @example "fE1mean", "fB3rms", "fJ2int"
+     */
+    [[nodiscard]]
+    auto name(unsigned short ci) const -> std::string {
+      return "f" + m_quantity + std::to_string(ci + 1) +
+             (m_mode == "integral" ? "int" : m_mode);
+    }
+  };
+
+} // namespace out
+
+#endif // OUTPUT_ACCUMULATORS_H
@@ -0,0 +1,70 @@
+/**
+ * @file output/buffers.h
+ * @brief Persistent buffers reused between the output steps
+ * @implements
+ *   - out::BufferPool<>
+ * @namespaces:
+ *   - out::
+ * @note Buffers only grow: views returned by the pool are unmanaged & remain
+ * valid until the next request of the same buffer
+ */
+
+#ifndef OUTPUT_BUFFERS_H
+#define OUTPUT_BUFFERS_H
+
+#include "global.h"
+
+#include <Kokkos_Core.hpp>
+
+#include <map>
+#include <string>
+#include <type_traits>
+
+namespace out {
+
+  template <class MemSpace, typename T = real_t>
+  class BufferPool {
+    std::map<std::string, Kokkos::View<T*, MemSpace>> m_buffers;
+
+  public:
+    BufferPool()  = default;
+    ~BufferPool() = default;
+
+    /**
+     * @brief Allocates (or grows) the buffer to hold at least `size` elements
+     * @param label buffer label
+     * @param size # of elements
+     * @param margin extra fraction to allocate when the buffer grows
+     */
+    void reserve(const std::string& label, std::size_t size, double margin = 0.0) {
+      auto& buffer = m_buffers[label];
+      if (buffer.extent(0) < size) {
+        buffer = Kokkos::View<T*, MemSpace> {
+          Kokkos::view_alloc(Kokkos::WithoutInitializing, label),
+          size + static_cast<std::size_t>(margin * static_cast<double>(size))
+        };
+      }
+    }
+
+    /**
+     * @brief Shapes the beginning of the buffer as a view of given extents
+     * @tparam V view type (should live in `MemSpace`)
+     * @param label buffer label
+     * @param margin extra fraction to allocate if the buffer has to grow
+     * @param extents extents of the view
+     */
+    template <class V, typename... Extents>
+    auto view(const std::string& label, double margin, Extents... extents) -> V {
+      static_assert(
+        std::is_same<typename V::memory_space, typename MemSpace::memory_space>::value,
+        "View should be in the memory space of the pool");
+      std::size_t size { 1 };
+      ((size *= static_cast<std::size_t>(extents)), ...);
+      reserve(label, size, margin);
+      return V { m_buffers[label].data(), static_cast<std::size_t>(extents)... };
+    }
+  };
+
+} // namespace out
+
+#endif // OUTPUT_BUFFERS_H
@@ -0,0 +1,410 @@
+#include "output/checkpoint.h"
+
+#include "enums.h"
+#include "global.h"
+
+#include "arch/kokkos_aliases.h"
+#include "utils/error.h"
+#include "utils/formatting.h"
+
+#include <Kokkos_Core.hpp>
+#include <adios2.h>
+
+#if defined(MPI_ENABLED)
+  #include "arch/mpi_aliases.h"
+
+  #include <mpi.h>
+#endif
+
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace out {
+
+  namespace {
+    auto FieldBox(const std::vector<std::size_t>& glob_shape,
+                  const std::vector<std::size_t>& loc_corner,
+                  const std::vector<std::size_t>& loc_shape,
+                  std::size_t ncomp) -> std::vector<adios2::Dims> {
+      adios2::Dims g_shape { glob_shape.begin(), glob_shape.end() };
+      adios2::Dims l_corner { loc_corner.begin(), loc_corner.end() };
+      adios2::Dims l_shape { loc_shape.begin(), loc_shape.end() };
+      g_shape.push_back(ncomp);
+      l_corner.push_back(0);
+      l_shape.push_back(ncomp);
+      if constexpr (not std::is_same<typename ndfield_t<Dim::_3D, 6>::array_layout,
+                                     Kokkos::LayoutRight>::value) {
+        std::reverse(g_shape.begin(), g_shape.end());
+        std::reverse(l_corner.begin(), l_corner.end());
+        std::reverse(l_shape.begin(), l_shape.end());
+      }
+      return { g_shape, l_corner, l_shape };
+    }
+  } // namespace
+
+  auto CheckpointFilename(const std::string& path, std::size_t step)
+    -> std::string {
+    return fmt::format("%s/step-%08lu.bp", path.c_str(), step);
+  }
+
+  auto ListCheckpoints(const std::string& path) -> std::vector<std::string> {
+    namespace fs = std::filesystem;
+    std::vector<std::string> checkpoints;
+    if (not fs::is_directory(path)) {
+      return checkpoints;
+    }
+    for (const auto& entry : fs::directory_iterator(path)) {
+      const auto fname = entry.path().filename().string();
+      if (fname.rfind("step-", 0) == 0 and entry.path().extension() == ".bp") {
+        checkpoints.push_back(entry.path().string());
+      }
+    }
+    // zero-padded step numbers => lexicographic order == chronological order
+    std::sort(checkpoints.begin(), checkpoints.end());
+    return checkpoints;
+  }
+
+  auto FindLatestCheckpoint(const std::string& path) -> std::size_t {
+    const auto checkpoints = ListCheckpoints(path);
+    raise::ErrorIf(checkpoints.empty(),
+                   fmt::format("No checkpoints found in %s", path.c_str()),
+                   HERE);
+    const auto fname = std::filesystem::path(checkpoints.back()).stem().string();
+    return std::stoul(fname.substr(5));
+  }
+
+  CheckpointWriter::~CheckpointWriter() {
+    if (m_pending) {
+      finalizePending();
+    }
+  }
+
+  void CheckpointWriter::init(std::size_t        interval,
+                              long double        interval_time,
+                              std::size_t        keep,
+                              const std::string& path) {
+    m_enabled = (interval > 0) or (interval_time > 0.0);
+    if (not m_enabled) {
+      return;
+    }
+    m_tracker = Tracker("checkpoint", interval, interval_time);
+    m_keep    = keep;
+    m_path    = path;
+
+    m_io = m_adios.DeclareIO("Entity::Checkpoint");
+    m_io.SetEngine("BPFile");
+    // flush the data in the background while the simulation proceeds
+    m_io.SetParameters({
+      { "AsyncWrite", "true" }
+    });
+
+    m_io.DefineVariable<std::size_t>("Step");
+    m_io.DefineVariable<long double>("Time");
+
+#if defined(MPI_ENABLED)
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    if (rank == MPI_ROOT_RANK) {
+      std::filesystem::create_directories(m_path);
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+#else
+    std::filesystem::create_directories(m_path);
+#endif
+    // older checkpoints (e.g., from a previous run) also count towards `keep`
+    m_saved = ListCheckpoints(m_path);
+  }
+
+  auto CheckpointWriter::shouldSave(std::size_t step, long double time) -> bool {
+    return m_enabled and m_tracker.shouldWrite(step, time);
+  }
+
+  void CheckpointWriter::defineFieldVariable(const std::string& name,
+                                             const std::vector<std::size_t>& glob_shape,
+                                             const std::vector<std::size_t>& loc_corner,
+                                             const std::vector<std::size_t>& loc_shape,
+                                             std::size_t ncomp) {
+    const auto box = FieldBox(glob_shape, loc_corner, loc_shape, ncomp);
+    m_io.DefineVariable<real_t>(name, box[0], box[1], box[2]);
+  }
+
+  void CheckpointWriter::updateFieldVariable(const std::string& name,
+                                             const std::vector<std::size_t>& glob_shape,
+                                             const std::vector<std::size_t>& loc_corner,
+                                             const std::vector<std::size_t>& loc_shape,
+                                             std::size_t ncomp) {
+    auto var = m_io.InquireVariable<real_t>(name);
+    raise::ErrorIf(not var, name + " is not defined", HERE);
+    const auto box = FieldBox(glob_shape, loc_corner, loc_shape, ncomp);
+    var.SetShape(box[0]);
+    var.SetSelection(adios2::Box<adios2::Dims>(box[1], box[2]));
+  }
+
+  template <typename T>
+  void CheckpointWriter::defineParticleVariable(const std::string& name) {
+    m_io.DefineVariable<T>(name,
+                           { adios2::UnknownDim },
+                           { adios2::UnknownDim },
+                           { adios2::UnknownDim });
+  }
+
+  void CheckpointWriter::definePerDomainVariable(const std::string& name,
+                                                 std::size_t        ndomains,
+                                                 std::size_t        index) {
+    m_io.DefineVariable<std::size_t>(name,
+                                     { ndomains },
+                                     { index },
+                                     { 1 },
+                                     adios2::ConstantDims);
+  }
+
+  void CheckpointWriter::finalizePending() {
+    // blocks until the background flush of the previous checkpoint is done
+    m_writer.Close();
+    m_pending = false;
+    if (m_keep == 0) {
+      return;
+    }
+#if defined(MPI_ENABLED)
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+#endif
+    while (m_saved.size() > m_keep) {
+#if defined(MPI_ENABLED)
+      if (rank == MPI_ROOT_RANK) {
+        std::filesystem::remove_all(m_saved.front());
+      }
+#else
+      std::filesystem::remove_all(m_saved.front());
+#endif
+      m_saved.erase(m_saved.begin());
+    }
+  }
+
+  void CheckpointWriter::beginSaving(std::size_t step, long double time) {
+    raise::ErrorIf(not m_enabled, "Checkpoint writer is disabled", HERE);
+    if (m_pending) {
+      finalizePending();
+    }
+    const auto fname = CheckpointFilename(m_path, step);
+    m_adios.ExitComputationBlock();
+    try {
+      m_writer = m_io.Open(fname, adios2::Mode::Write);
+    } catch (std::exception& e) {
+      raise::Fatal(e.what(), HERE);
+    }
+    m_saved.push_back(fname);
+    m_writer.BeginStep();
+    m_writer.Put(m_io.InquireVariable<std::size_t>("Step"), step, adios2::Mode::Sync);
+    m_writer.Put(m_io.InquireVariable<long double>("Time"), time, adios2::Mode::Sync);
+  }
+
+  void CheckpointWriter::endSaving() {
+    // the data is copied into ADIOS2 buffers, the file is closed lazily
+    m_writer.EndStep();
+    m_pending = true;
+    m_adios.EnterComputationBlock();
+  }
+
+  template <Dimension D, int N>
+  void CheckpointWriter::saveField(const std::string&     name,
+                                   const ndfield_t<D, N>& field) {
+    auto var     = m_io.InquireVariable<real_t>(name);
+    auto field_h = Kokkos::create_mirror_view(field);
+    Kokkos::deep_copy(field_h, field);
+    m_writer.Put<real_t>(var, field_h.data(), adios2::Mode::Sync);
+  }
+
+  template <typename T>
+  void CheckpointWriter::saveParticleQuantity(const std::string& name,
+                                              std::size_t        glob_total,
+                                              std::size_t        loc_offset,
+                                              std::size_t        count,
+                                              const array_t<T*>& array) {
+    auto var = m_io.InquireVariable<T>(name);
+    var.SetShape({ glob_total });
+    var.SetSelection(adios2::Box<adios2::Dims>({ loc_offset }, { count }));
+    if (count == 0) {
+      return;
+    }
+    auto slice   = Kokkos::subview(array, range_tuple_t(0, count));
+    auto slice_h = Kokkos::create_mirror_view(slice);
+    Kokkos::deep_copy(slice_h, slice);
+    m_writer.Put<T>(var, slice_h.data(), adios2::Mode::Sync);
+  }
+
+  void CheckpointWriter::savePerDomainValue(const std::string& name,
+                                            std::size_t        value) {
+    m_writer.Put(m_io.InquireVariable<std::size_t>(name), value, adios2::Mode::Sync);
+  }
+
+  template <Dimension D, int N>
+  void ReadField(adios2::IO&                     io,
+                 adios2::Engine&                 reader,
+                 const std::string&              name,
+                 const std::vector<std::size_t>& glob_shape,
+                 const std::vector<std::size_t>& loc_corner,
+                 const std::vector<std::size_t>& loc_shape,
+                 ndfield_t<D, N>&                field) {
+    auto var = io.InquireVariable<real_t>(name);
+    raise::ErrorIf(not var,
+                   fmt::format("%s not found in the checkpoint", name.c_str()),
+                   HERE);
+    const auto box = FieldBox(glob_shape, loc_corner, loc_shape, N);
+    raise::ErrorIf(var.Shape() != box[0],
+                   fmt::format("%s in the checkpoint has a different shape "
+                               "(was the domain decomposition changed?)",
+                               name.c_str()),
+                   HERE);
+    var.SetSelection(adios2::Box<adios2::Dims>(box[1], box[2]));
+    auto field_h = Kokkos::create_mirror_view(field);
+    reader.Get<real_t>(var, field_h.data(), adios2::Mode::Sync);
+    Kokkos::deep_copy(field, field_h);
+  }
+
+  template <typename T>
+  void ReadParticleQuantity(adios2::IO&        io,
+                            adios2::Engine&    reader,
+                            const std::string& name,
+                            std::size_t        offset,
+                            std::size_t        count,
+                            array_t<T*>&       array) {
+    auto var = io.InquireVariable<T>(name);
+    raise::ErrorIf(not var,
+                   fmt::format("%s not found in the checkpoint", name.c_str()),
+                   HERE);
+    if (count == 0) {
+      return;
+    }
+    var.SetSelection(adios2::Box<adios2::Dims>({ offset }, { count }));
+    auto slice   = Kokkos::subview(array, range_tuple_t(0, count));
+    auto slice_h = Kokkos::create_mirror_view(slice);
+    reader.Get<T>(var, slice_h.data(), adios2::Mode::Sync);
+    Kokkos::deep_copy(slice, slice_h);
+  }
+
+  template void CheckpointWriter::defineParticleVariable<int>(const std::string&);
+  template void CheckpointWriter::defineParticleVariable<short>(const std::string&);
+  template void CheckpointWriter::defineParticleVariable<float>(const std::string&);
+  template void CheckpointWriter::defineParticleVariable<double>(const std::string&);
+  template void CheckpointWriter::defineParticleVariable<std::size_t>(
+    const std::string&);
+
+  template void CheckpointWriter::saveField<Dim::_1D, 3>(const std::string&,
+                                                         const ndfield_t<Dim::_1D, 3>&);
+  template void CheckpointWriter::saveField<Dim::_1D, 6>(const std::string&,
+                                                         const ndfield_t<Dim::_1D, 6>&);
+  template void CheckpointWriter::saveField<Dim::_2D, 3>(const std::string&,
+                                                         const ndfield_t<Dim::_2D, 3>&);
+  template void CheckpointWriter::saveField<Dim::_2D, 6>(const std::string&,
+                                                         const ndfield_t<Dim::_2D, 6>&);
+  template void CheckpointWriter::saveField<Dim::_3D, 3>(const std::string&,
+                                                         const ndfield_t<Dim::_3D, 3>&);
+  template void CheckpointWriter::saveField<Dim::_3D, 6>(const std::string&,
+                                                         const ndfield_t<Dim::_3D, 6>&);
+
+  template void CheckpointWriter::saveParticleQuantity<int>(const std::string&,
+                                                            std::size_t,
+                                                            std::size_t,
+                                                            std::size_t,
+                                                            const array_t<int*>&);
+  template void CheckpointWriter::saveParticleQuantity<short>(const std::string&,
+                                                              std::size_t,
+                                                              std::size_t,
+                                                              std::size_t,
+                                                              const array_t<short*>&);
+  template void CheckpointWriter::saveParticleQuantity<float>(const std::string&,
+                                                              std::size_t,
+                                                              std::size_t,
+                                                              std::size_t,
+                                                              const array_t<float*>&);
+  template void CheckpointWriter::saveParticleQuantity<double>(
+    const std::string&,
+    std::size_t,
+    std::size_t,
+    std::size_t,
+    const array_t<double*>&);
+  template void CheckpointWriter::saveParticleQuantity<std::size_t>(
+    const std::string&,
+    std::size_t,
+    std::size_t,
+    std::size_t,
+    const array_t<std::size_t*>&);
+
+  template void ReadField<Dim::_1D, 3>(adios2::IO&,
+                                       adios2::Engine&,
+                                       const std::string&,
+                                       const std::vector<std::size_t>&,
+                                       const std::vector<std::size_t>&,
+                                       const std::vector<std::size_t>&,
+                                       ndfield_t<Dim::_1D, 3>&);
+  template void ReadField<Dim::_1D, 6>(adios2::IO&,
+                                       adios2::Engine&,
+                                       const std::string&,
+                                       const std::vector<std::size_t>&,
+                                       const std::vector<std::size_t>&,
+                                       const std::vector<std::size_t>&,
+                                       ndfield_t<Dim::_1D, 6>&);
+  template void ReadField<Dim::_2D, 3>(adios2::IO&,
+                                       adios2::Engine&,
+                                       const std::string&,
+                                       const std::vector<std::size_t>&,
+                                       const std::vector<std::size_t>&,
+                                       const std::vector<std::size_t>&,
+                                       ndfield_t<Dim::_2D, 3>&);
+  template void ReadField<Dim::_2D, 6>(adios2::IO&,
+                                       adios2::Engine&,
+                                       const std::string&,
+                                       const std::vector<std::size_t>&,
+                                       const std::vector<std::size_t>&,
+                                       const std::vector<std::size_t>&,
+                                       ndfield_t<Dim::_2D, 6>&);
+  template void ReadField<Dim::_3D, 3>(adios2::IO&,
+                                       adios2::Engine&,
+                                       const std::string&,
+                                       const std::vector<std::size_t>&,
+                                       const std::vector<std::size_t>&,
+                                       const std::vector<std::size_t>&,
+                                       ndfield_t<Dim::_3D, 3>&);
+  template void ReadField<Dim::_3D, 6>(adios2::IO&,
+                                       adios2::Engine&,
+                                       const std::string&,
+                                       const std::vector<std::size_t>&,
+                                       const std::vector<std::size_t>&,
+                                       const std::vector<std::size_t>&,
+                                       ndfield_t<Dim::_3D, 6>&);
+  template void ReadParticleQuantity<int>(adios2::IO&,
+                                          adios2::Engine&,
+                                          const std::string&,
+                                          std::size_t,
+                                          std::size_t,
+                                          array_t<int*>&);
+  template void ReadParticleQuantity<short>(adios2::IO&,
+                                            adios2::Engine&,
+                                            const std::string&,
+                                            std::size_t,
+                                            std::size_t,
+                                            array_t<short*>&);
+  template void ReadParticleQuantity<float>(adios2::IO&,
+                                            adios2::Engine&,
+                                            const std::string&,
+                                            std::size_t,
+                                            std::size_t,
+                                            array_t<float*>&);
+  template void ReadParticleQuantity<double>(adios2::IO&,
+                                             adios2::Engine&,
+                                             const std::string&,
+                                             std::size_t,
+                                             std::size_t,
+                                             array_t<double*>&);
+  template void ReadParticleQuantity<std::size_t>(adios2::IO&,
+                                                  adios2::Engine&,
+                                                  const std::string&,
+                                                  std::size_t,
+                                                  std::size_t,
+                                                  array_t<std::size_t*>&);
+
+} // namespace out
@@ -0,0 +1,205 @@
+/**
+ * @file output/checkpoint.h
+ * @brief Writer which dumps the raw simulation state for restarts
+ * @implements
+ *   - out::CheckpointWriter
+ *   - out::CheckpointFilename -> std::string
+ *   - out::FindLatestCheckpoint -> std::size_t
+ *   - out::ReadField<> -> void
+ *   - out::ReadParticleQuantity<> -> void
+ * @cpp:
+ *   - checkpoint.cpp
+ * @namespaces:
+ *   - out::
+ * @macros:
+ *   - MPI_ENABLED
+ * @note
+ * Checkpoints are written with the BP5 engine in the `AsyncWrite` mode:
+ * `endSaving()` only finalizes the step, while the actual flush to disk
+ * happens in the background and is only awaited at the next checkpoint
+ * (or upon destruction of the writer).
+ */
+
+#ifndef OUTPUT_CHECKPOINT_H
+#define OUTPUT_CHECKPOINT_H
+
+#include "enums.h"
+#include "global.h"
+
+#include "arch/kokkos_aliases.h"
+
+#include "output/writer.h"
+
+#include <adios2.h>
+
+#if defined(MPI_ENABLED)
+  #include <mpi.h>
+#endif
+
+#include <string>
+#include <vector>
+
+namespace out {
+
+  /**
+   * @brief Name of the checkpoint file for a given timestep
+   * @param path directory where checkpoints are stored
+   * @param step timestep
+   */
+  auto CheckpointFilename(const std::string&, std::size_t) -> std::string;
+
+  /**
+   * @brief Lists all the checkpoint files in the directory (oldest first)
+   * @param path directory where checkpoints are stored
+   */
+  auto ListCheckpoints(const std::string&) -> std::vector<std::string>;
+
+  /**
+   * @brief Finds the timestep of the latest checkpoint in the directory
+   * @param path directory where checkpoints are stored
+   */
+  auto FindLatestCheckpoint(const std::string&) -> std::size_t;
+
+  /**
+   * @brief Reads a field (incl. ghost cells) saved with `CheckpointWriter`
+   * @param io ADIOS2 IO object
+   * @param reader ADIOS2 engine opened for reading
+   * @param name name of the variable
+   * @param glob_shape expected global shape (w/o the components)
+   * @param loc_corner local corner (w/o the components)
+   * @param loc_shape local shape (w/o the components)
+   * @param field field to read into
+   */
+  template <Dimension D, int N>
+  void ReadField(adios2::IO&,
+                 adios2::Engine&,
+                 const std::string&,
+                 const std::vector<std::size_t>&,
+                 const std::vector<std::size_t>&,
+                 const std::vector<std::size_t>&,
+                 ndfield_t<D, N>&);
+
+  /**
+   * @brief Reads a particle quantity saved with `CheckpointWriter`
+   * @param io ADIOS2 IO object
+   * @param reader ADIOS2 engine opened for reading
+   * @param name name of the variable
+   * @param offset global offset of the local particles
+   * @param count number of local particles
+   * @param array array to read into (starting from 0)
+   */
+  template <typename T>
+  void ReadParticleQuantity(adios2::IO&,
+                            adios2::Engine&,
+                            const std::string&,
+                            std::size_t,
+                            std::size_t,
+                            array_t<T*>&);
+
+  class CheckpointWriter {
+#if !defined(MPI_ENABLED)
+    adios2::ADIOS m_adios;
+#else // MPI_ENABLED
+    adios2::ADIOS m_adios { MPI_COMM_WORLD };
+#endif
+    adios2::IO     m_io;
+    adios2::Engine m_writer;
+
+    Tracker     m_tracker { "checkpoint", 1, -1.0 };
+    bool        m_enabled { false };
+    // true if the last checkpoint is still being flushed in the background
+    bool        m_pending { false };
+    // number of checkpoints to keep on disk (0 = keep all)
+    std::size_t m_keep { 0 };
+    std::string m_path;
+
+    std::vector<std::string> m_saved;
+
+    void finalizePending();
+
+  public:
+    CheckpointWriter() = default;
+    ~CheckpointWriter();
+
+    CheckpointWriter(const CheckpointWriter&)            = delete;
+    CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+    /**
+     * @param interval number of timesteps between checkpoints
+     * @param interval_time physical time between checkpoints
+     * @param keep number of checkpoints to keep on disk
+     * @param path directory where checkpoints are stored
+     */
+    void init(std::size_t, long double, std::size_t, const std::string&);
+
+    auto shouldSave(std::size_t, long double) -> bool;
+
+    /**
+     * @brief Defines a field variable including the ghost cells
+     * @param name name of the variable
+     * @param glob_shape global shape (w/o the components)
+     * @param loc_corner local corner (w/o the components)
+     * @param loc_shape local shape (w/o the components)
+     * @param ncomp number of components
+     */
+    void defineFieldVariable(const std::string&,
+                             const std::vector<std::size_t>&,
+                             const std::vector<std::size_t>&,
+                             const std::vector<std::size_t>&,
+                             std::size_t);
+
+    /**
+     * @brief Changes the local part of a field variable (e.g., after load balancing)
+     * @param name name of the variable
+     * @param glob_shape global shape (w/o the components)
+     * @param loc_corner local corner (w/o the components)
+     * @param loc_shape local shape (w/o the components)
+     * @param ncomp number of components
+     */
+    void updateFieldVariable(const std::string&,
+                             const std::vector<std::size_t>&,
+                             const std::vector<std::size_t>&,
+                             const std::vector<std::size_t>&,
+                             std::size_t);
+
+    template <typename T>
+    void defineParticleVariable(const std::string&);
+
+    /**
+     * @brief Defines a variable with a single value per domain
+     * @param name name of the variable
+     * @param ndomains total number of domains
+     * @param index index of the local domain
+     */
+    void definePerDomainVariable(const std::string&, std::size_t, std::size_t);
+
+    void beginSaving(std::size_t, long double);
+    void endSaving();
+
+    template <Dimension D, int N>
+    void saveField(const std::string&, const ndfield_t<D, N>&);
+
+    template <typename T>
+    void saveParticleQuantity(const std::string&,
+                              std::size_t,
+                              std::size_t,
+                              std::size_t,
+                              const array_t<T*>&);
+
+    void savePerDomainValue(const std::string&, std::size_t);
+
+    /* getters -------------------------------------------------------------- */
+    [[nodiscard]]
+    auto enabled() const -> bool {
+      return m_enabled;
+    }
+
+    [[nodiscard]]
+    auto path() const -> const std::string& {
+      return m_path;
+    }
+  };
+
+} // namespace out
+
+#endif // OUTPUT_CHECKPOINT_H
@@ -0,0 +1,68 @@
+/**
+ * @file output/histograms.h
+ * @brief Defines the metadata for particle histograms
+ * @implements
+ *   - out::OutputHistogram
+ */
+
+#ifndef OUTPUT_HISTOGRAMS_H
+#define OUTPUT_HISTOGRAMS_H
+
+#include <string>
+#include <vector>
+
+namespace out {
+
+  class OutputHistogram {
+    const std::string              m_label;
+    const unsigned short           m_sp;
+    const std::vector<std::size_t> m_shape;
+
+  public:
+    /**
+     * @param label name of the histogram
+     * @param sp species index
+     * @param shape # of bins along each axis
+     */
+    OutputHistogram(const std::string&              label,
+                    unsigned short                  sp,
+                    const std::vector<std::size_t>& shape)
+      : m_label { label }
+      , m_sp { sp }
+      , m_shape { shape } {}
+
+    ~OutputHistogram() = default;
+
+    [[nodiscard]]
+    auto label() const -> std::string {
+      return m_label;
+    }
+
+    [[nodiscard]]
+    auto species() const -> unsigned short {
+      return m_sp;
+    }
+
+    [[nodiscard]]
+    auto shape() const -> const std::vector<std::size_t>& {
+      return m_shape;
+    }
+
+    [[nodiscard]]
+    auto name() const -> std::string {
+      return "hN_" + m_label + "_" + std::to_string(m_sp);
+    }
+
+    /**
+     * @brief Name of the bin edges along the axis (shared by all the species)
+     * @param axis axis index (starting at 0)
+     */
+    [[nodiscard]]
+    auto binsName(unsigned short axis) const -> std::string {
+      return "hBn" + std::to_string(axis + 1) + "_" + m_label;
+    }
+  };
+
+} // namespace out
+
+#endif // OUTPUT_HISTOGRAMS_H
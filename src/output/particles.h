@@ -14,9 +14,13 @@ namespace out {
 
   class OutputSpecies {
     const unsigned short m_sp;
+    // whether the particle IDs are written
+    const bool           m_ids;
 
   public:
-    OutputSpecies(unsigned short sp) : m_sp { sp } {}
+    OutputSpecies(unsigned short sp, bool ids = false)
+      : m_sp { sp }
+      , m_ids { ids } {}
 
     ~OutputSpecies() = default;
 
@@ -25,6 +29,11 @@ namespace out {
       return m_sp;
     }
 
+    [[nodiscard]]
+    auto ids() const -> bool {
+      return m_ids;
+    }
+
     [[nodiscard]]
     auto name(const std::string& q, unsigned short c) const -> std::string {
       return "p" + q + (c == 0 ? "" : std::to_string(c)) + "_" +
@@ -0,0 +1,131 @@
+#include "output/staging.h"
+
+#include "global.h"
+
+#include "utils/error.h"
+
+#include <Kokkos_Core.hpp>
+#include <adios2.h>
+
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+
+namespace out {
+
+  auto StagedStep::addBytes(const std::string&  name,
+                            const std::string&  type,
+                            std::size_t         elsize,
+                            const adios2::Dims& shape,
+                            const adios2::Dims& start,
+                            const adios2::Dims& count) -> char* {
+    if (nvariables == variables.size()) {
+      variables.emplace_back();
+    }
+    auto& var = variables[nvariables++];
+    var.name  = name;
+    var.shape = shape;
+    var.start = start;
+    var.count = count;
+    var.type  = type;
+    std::size_t size { elsize };
+    for (const auto& c : count) {
+      size *= c;
+    }
+    if (var.data.extent(0) < size) {
+      var.data = staging_bytes_t {
+        Kokkos::view_alloc(Kokkos::WithoutInitializing, "staged:" + name),
+        size
+      };
+    }
+    return var.data.data();
+  }
+
+  StagingQueue::StagingQueue(std::size_t                             depth,
+                             const std::function<void(StagedStep&)>& write)
+    : m_depth { depth }
+    , m_write { write } {
+    raise::ErrorIf(m_depth == 0, "Staging queue depth must be positive", HERE);
+    m_thread = std::thread(&StagingQueue::process, this);
+  }
+
+  StagingQueue::~StagingQueue() {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+      m_thread.join();
+    }
+  }
+
+  void StagingQueue::process() {
+    while (true) {
+      StagedStep staged;
+      {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this] {
+          return m_stop or not m_pending.empty();
+        });
+        if (m_pending.empty()) {
+          // stopped & nothing left to write
+          return;
+        }
+        staged = std::move(m_pending.front());
+        m_pending.pop_front();
+        m_busy = true;
+      }
+      try {
+        m_write(staged);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_error = std::current_exception();
+      }
+      staged.clear();
+      {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free.push_back(std::move(staged));
+        m_busy = false;
+      }
+      m_cv.notify_all();
+    }
+  }
+
+  auto StagingQueue::acquire() -> StagedStep {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] {
+      return m_pending.size() < m_depth;
+    });
+    if (m_error) {
+      std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+    if (m_free.empty()) {
+      return StagedStep {};
+    }
+    auto staged = std::move(m_free.back());
+    m_free.pop_back();
+    return staged;
+  }
+
+  void StagingQueue::push(StagedStep&& staged) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_pending.push_back(std::move(staged));
+    }
+    m_cv.notify_all();
+  }
+
+  void StagingQueue::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this] {
+      return m_pending.empty() and not m_busy;
+    });
+    if (m_error) {
+      std::rethrow_exception(std::exchange(m_error, nullptr));
+    }
+  }
+
+} // namespace out
@@ -0,0 +1,140 @@
+/**
+ * @file output/staging.h
+ * @brief Host-side staging of the output data & the queue of staged steps
+ * @implements
+ *   - out::StagedVariable
+ *   - out::StagedStep
+ *   - out::StagingQueue
+ * @cpp:
+ *   - staging.cpp
+ * @namespaces:
+ *   - out::
+ * @note The buffers are reused between the output steps: their capacity is
+ * only allocated once (in the pinned host memory if the device has one)
+ */
+
+#ifndef OUTPUT_STAGING_H
+#define OUTPUT_STAGING_H
+
+#include "global.h"
+
+#include <Kokkos_Core.hpp>
+#include <adios2.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace out {
+
+  // page-locked host memory for fast device-to-host copies
+  using staging_space_t = Kokkos::SharedHostPinnedSpace;
+  using staging_array_t = Kokkos::View<real_t*, staging_space_t>;
+  using staging_bytes_t = Kokkos::View<char*, staging_space_t>;
+
+  /**
+   * @brief Host copy of a single variable with its selection
+   */
+  struct StagedVariable {
+    std::string     name;
+    // global shape (empty for local arrays), local corner & local shape
+    adios2::Dims    shape, start, count;
+    // ADIOS2 name of the element type (e.g., "double" or "uint64_t")
+    std::string     type;
+    // raw bytes: only the first prod(count) elements are used
+    staging_bytes_t data;
+  };
+
+  /**
+   * @brief All the data of a single output step
+   */
+  struct StagedStep {
+    std::string                 fname;
+    std::size_t                 step { 0 };
+    long double                 time { 0.0 };
+    // only the first `nvariables` are used (the rest are kept for reuse)
+    std::vector<StagedVariable> variables;
+    std::size_t                 nvariables { 0 };
+
+    /**
+     * @brief Adds a variable to the step reusing the existing buffers
+     * @tparam T element type
+     * @returns pointer to the host buffer of size prod(count)
+     */
+    template <typename T = real_t>
+    auto add(const std::string&  name,
+             const adios2::Dims& shape,
+             const adios2::Dims& start,
+             const adios2::Dims& count) -> T* {
+      return reinterpret_cast<T*>(
+        addBytes(name, adios2::GetType<T>(), sizeof(T), shape, start, count));
+    }
+
+    /**
+     * @brief Adds a variable of any type given the size of its elements
+     * @returns pointer to the host buffer of size prod(count) * elsize
+     */
+    auto addBytes(const std::string&  name,
+                  const std::string&  type,
+                  std::size_t         elsize,
+                  const adios2::Dims& shape,
+                  const adios2::Dims& start,
+                  const adios2::Dims& count) -> char*;
+
+    void clear() {
+      nvariables = 0;
+    }
+  };
+
+  /**
+   * @brief Queue of the staged steps written on a dedicated I/O thread
+   * @note At most `depth` steps can be waiting to be written at once: staging
+   * the next one blocks until the oldest one is written (back-pressure)
+   */
+  class StagingQueue {
+    const std::size_t                m_depth;
+    std::function<void(StagedStep&)> m_write;
+
+    std::mutex              m_mutex;
+    std::condition_variable m_cv;
+    std::deque<StagedStep>  m_pending;
+    std::vector<StagedStep> m_free;
+    bool                    m_busy { false };
+    bool                    m_stop { false };
+    std::exception_ptr      m_error { nullptr };
+
+    std::thread m_thread;
+
+    void process();
+
+  public:
+    StagingQueue(std::size_t depth, const std::function<void(StagedStep&)>& write);
+    ~StagingQueue();
+
+    StagingQueue(const StagingQueue&)            = delete;
+    StagingQueue& operator=(const StagingQueue&) = delete;
+
+    /**
+     * @brief Returns an empty step buffer (blocks if the queue is full)
+     */
+    auto acquire() -> StagedStep;
+
+    /**
+     * @brief Schedules the staged step for writing
+     */
+    void push(StagedStep&&);
+
+    /**
+     * @brief Blocks until all the scheduled steps are written
+     */
+    void wait();
+  };
+
+} // namespace out
+
+#endif // OUTPUT_STAGING_H
@@ -0,0 +1,152 @@
+#include "enums.h"
+#include "global.h"
+
+#include "arch/kokkos_aliases.h"
+#include "utils/error.h"
+#include "utils/formatting.h"
+
+#include "output/checkpoint.h"
+
+#include <Kokkos_Core.hpp>
+#include <adios2.h>
+
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+void cleanup() {
+  namespace fs = std::filesystem;
+  fs::path temppath { "checkpoints" };
+  fs::remove_all(temppath);
+}
+
+auto main(int argc, char* argv[]) -> int {
+  Kokkos::initialize(argc, argv);
+
+  try {
+    using namespace ntt;
+    constexpr std::size_t nx1 = 10, nx2 = 12;
+    constexpr std::size_t npart = 100, maxnpart = 150;
+    const std::vector<std::size_t> glob_shape { nx1 + 2 * N_GHOSTS,
+                                                nx2 + 2 * N_GHOSTS };
+    const std::vector<std::size_t> loc_corner { 0, 0 };
+
+    ndfield_t<Dim::_2D, 6> em { "em", nx1 + 2 * N_GHOSTS, nx2 + 2 * N_GHOSTS };
+    array_t<int*>          i1 { "i1", maxnpart };
+    array_t<float*>        dx1 { "dx1", maxnpart };
+    array_t<short*>        tag { "tag", maxnpart };
+    Kokkos::parallel_for(
+      "fill",
+      CreateRangePolicy<Dim::_2D>({ 0, 0 }, { nx1 + 2 * N_GHOSTS, nx2 + 2 * N_GHOSTS }),
+      Lambda(index_t i1, index_t i2) {
+        for (auto c = 0; c < 6; ++c) {
+          em(i1, i2, c) = static_cast<real_t>(i1 + 100 * i2 + 10000 * c);
+        }
+      });
+    Kokkos::parallel_for(
+      "fill",
+      maxnpart,
+      Lambda(index_t p) {
+        i1(p)  = static_cast<int>(p);
+        dx1(p) = static_cast<float>(p) / 1000.0f;
+        tag(p) = (p % 2 == 0) ? ParticleTag::alive : ParticleTag::dead;
+      });
+
+    {
+      // write two checkpoints keeping only the last one
+      out::CheckpointWriter writer;
+      writer.init(10, -1.0, 1, "checkpoints");
+      writer.defineFieldVariable("em", glob_shape, loc_corner, glob_shape, 6);
+      writer.defineParticleVariable<int>("s1_i1");
+      writer.defineParticleVariable<float>("s1_dx1");
+      writer.defineParticleVariable<short>("s1_tag");
+      writer.definePerDomainVariable("s1_npart", 1, 0);
+      raise::ErrorIf(writer.shouldSave(5, 0.5), "shouldSave(5) is true", HERE);
+      for (const auto step : { 10, 20 }) {
+        raise::ErrorIf(not writer.shouldSave(step, 0.0),
+                       fmt::format("shouldSave(%d) is false", step),
+                       HERE);
+        writer.beginSaving(step, 0.1 * step);
+        writer.saveField<Dim::_2D, 6>("em", em);
+        writer.saveParticleQuantity<int>("s1_i1", npart, 0, npart, i1);
+        writer.saveParticleQuantity<float>("s1_dx1", npart, 0, npart, dx1);
+        writer.saveParticleQuantity<short>("s1_tag", npart, 0, npart, tag);
+        writer.savePerDomainValue("s1_npart", npart);
+        writer.endSaving();
+      }
+    }
+
+    {
+      // read back
+      raise::ErrorIf(out::ListCheckpoints("checkpoints").size() != 1,
+                     "old checkpoints have not been removed",
+                     HERE);
+      const auto step = out::FindLatestCheckpoint("checkpoints");
+      raise::ErrorIf(step != 20, "latest checkpoint is not at step 20", HERE);
+
+      adios2::ADIOS adios;
+      adios2::IO    io = adios.DeclareIO("read-test");
+      io.SetEngine("BPFile");
+      adios2::Engine reader = io.Open(out::CheckpointFilename("checkpoints", step),
+                                      adios2::Mode::Read);
+      reader.BeginStep();
+      std::size_t step_read { 0 };
+      reader.Get(io.InquireVariable<std::size_t>("Step"), step_read, adios2::Mode::Sync);
+      raise::ErrorIf(step_read != 20, "Step is not 20", HERE);
+
+      std::size_t npart_read { 0 };
+      reader.Get(io.InquireVariable<std::size_t>("s1_npart"),
+                 npart_read,
+                 adios2::Mode::Sync);
+      raise::ErrorIf(npart_read != npart, "npart is not correct", HERE);
+
+      ndfield_t<Dim::_2D, 6> em_read { "em_read",
+                                       nx1 + 2 * N_GHOSTS,
+                                       nx2 + 2 * N_GHOSTS };
+      array_t<int*>          i1_read { "i1_read", maxnpart };
+      array_t<float*>        dx1_read { "dx1_read", maxnpart };
+      array_t<short*>        tag_read { "tag_read", maxnpart };
+      out::ReadField<Dim::_2D, 6>(io, reader, "em", glob_shape, loc_corner, glob_shape, em_read);
+      out::ReadParticleQuantity<int>(io, reader, "s1_i1", 0, npart, i1_read);
+      out::ReadParticleQuantity<float>(io, reader, "s1_dx1", 0, npart, dx1_read);
+      out::ReadParticleQuantity<short>(io, reader, "s1_tag", 0, npart, tag_read);
+      reader.EndStep();
+      reader.Close();
+
+      std::size_t nerrors { 0 };
+      Kokkos::parallel_reduce(
+        "compare",
+        CreateRangePolicy<Dim::_2D>({ 0, 0 }, { nx1 + 2 * N_GHOSTS, nx2 + 2 * N_GHOSTS }),
+        Lambda(index_t i1, index_t i2, std::size_t & nerr) {
+          for (auto c = 0; c < 6; ++c) {
+            if (em_read(i1, i2, c) != em(i1, i2, c)) {
+              nerr += 1;
+            }
+          }
+        },
+        nerrors);
+      raise::ErrorIf(nerrors != 0, "em is not restored exactly", HERE);
+      Kokkos::parallel_reduce(
+        "compare",
+        npart,
+        Lambda(index_t p, std::size_t & nerr) {
+          if ((i1_read(p) != i1(p)) or (dx1_read(p) != dx1(p)) or
+              (tag_read(p) != tag(p))) {
+            nerr += 1;
+          }
+        },
+        nerrors);
+      raise::ErrorIf(nerrors != 0, "particles are not restored exactly", HERE);
+    }
+  } catch (std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    cleanup();
+    Kokkos::finalize();
+    return 1;
+  }
+  cleanup();
+  Kokkos::finalize();
+  return 0;
+}
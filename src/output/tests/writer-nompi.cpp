@@ -1,6 +1,7 @@
 #include "enums.h"
 #include "global.h"
 
+#include "utils/comparators.h"
 #include "utils/formatting.h"
 
 #include "output/fields.h"
@@ -14,12 +15,17 @@
 #include <iostream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 void cleanup() {
   namespace fs = std::filesystem;
   fs::path tempfile_path { "test.h5" };
   fs::remove(tempfile_path);
+  fs::path tempfile_ds_path { "test-ds.h5" };
+  fs::remove(tempfile_ds_path);
+  fs::path tempfile_async_path { "test-async.h5" };
+  fs::remove(tempfile_async_path);
 }
 
 auto main(int argc, char* argv[]) -> int {
@@ -105,6 +111,146 @@ auto main(int argc, char* argv[]) -> int {
       }
       reader.Close();
     }
+
+    {
+      // downsampled (block-averaged) output
+      auto writer_ds = out::Writer("hdf5");
+      writer_ds.defineMeshLayout({ 10, 10, 10 },
+                                 { 0, 0, 0 },
+                                 { 10, 10, 10 },
+                                 false,
+                                 Coord::Cart,
+                                 { 2, 3, 4 },
+                                 true);
+      writer_ds.defineFieldOutputs(SimEngine::SRPIC, { "E" });
+      writer_ds.beginWriting("test-ds", 0, 0.0);
+      writer_ds.writeField<Dim::_3D, 3>(names, field, addresses);
+      writer_ds.endWriting();
+
+      adios2::ADIOS  adios;
+      adios2::IO     io     = adios.DeclareIO("read-test-ds");
+      io.SetEngine("hdf5");
+      adios2::Engine reader = io.Open("test-ds.h5", adios2::Mode::Read);
+      reader.BeginStep();
+      auto data = io.InquireVariable<real_t>(names[0]);
+      auto dims = data.Shape();
+      raise::ErrorIf(dims.size() != 3, "downsampled field is not 3D", HERE);
+      raise::ErrorIf(dims[0] * dims[1] * dims[2] != 5 * 4 * 3,
+                     "downsampled field is not 5x4x3",
+                     HERE);
+      std::vector<real_t> values;
+      reader.Get(data, values, adios2::Mode::Sync);
+      reader.EndStep();
+      reader.Close();
+      // average of i1 + i2 + i3 over the first & the last blocks
+      raise::ErrorIf(not cmp::AlmostEqual_host(values.front(),
+                                               (real_t)(3.0 + 3 * N_GHOSTS)),
+                     "wrong value in the first downsampled cell",
+                     HERE);
+      raise::ErrorIf(not cmp::AlmostEqual_host(values.back(),
+                                               (real_t)(26.0 + 3 * N_GHOSTS)),
+                     "wrong value in the last downsampled cell",
+                     HERE);
+    }
+
+    {
+      // asynchronous output (written when the writer goes out of scope)
+      {
+        auto writer_async = out::Writer("hdf5");
+        writer_async.defineMeshLayout({ 10, 10, 10 },
+                                      { 0, 0, 0 },
+                                      { 10, 10, 10 },
+                                      false,
+                                      Coord::Cart);
+        writer_async.defineFieldOutputs(SimEngine::SRPIC, { "E" });
+        writer_async.enableAsync(1);
+        for (std::size_t st { 0 }; st < 3; ++st) {
+          writer_async.beginWriting("test-async", st, 0.1 * st);
+          writer_async.writeField<Dim::_3D, 3>(names, field, addresses);
+          writer_async.endWriting();
+        }
+      }
+
+      adios2::ADIOS  adios;
+      adios2::IO     io     = adios.DeclareIO("read-test-async");
+      io.SetEngine("hdf5");
+      adios2::Engine reader = io.Open("test-async.h5", adios2::Mode::Read);
+      std::size_t    nsteps { 0 };
+      while (reader.BeginStep() == adios2::StepStatus::OK) {
+        std::size_t step_read;
+        reader.Get(io.InquireVariable<std::size_t>("Step"),
+                   step_read,
+                   adios2::Mode::Sync);
+        raise::ErrorIf(step_read != nsteps, "Step is not correct", HERE);
+        std::vector<real_t> values;
+        reader.Get(io.InquireVariable<real_t>(names[0]), values, adios2::Mode::Sync);
+        raise::ErrorIf(values.size() != 10 * 10 * 10,
+                       "asynchronous output has wrong size",
+                       HERE);
+        reader.EndStep();
+        ++nsteps;
+      }
+      reader.Close();
+      raise::ErrorIf(nsteps != 3, "not all asynchronous steps were written", HERE);
+    }
+
+#if defined(ADIOS2_HAVE_SST)
+    {
+      // streaming output with a loopback reader
+      std::size_t nsteps { 0 };
+      bool        reader_failed { false };
+      std::thread reader_thread([&]() {
+        try {
+          adios2::ADIOS  adios;
+          adios2::IO     io     = adios.DeclareIO("read-test-sst");
+          io.SetEngine("SST");
+          adios2::Engine reader = io.Open("test-sst", adios2::Mode::Read);
+          while (reader.BeginStep() == adios2::StepStatus::OK) {
+            std::size_t step_read;
+            reader.Get(io.InquireVariable<std::size_t>("Step"),
+                       step_read,
+                       adios2::Mode::Sync);
+            std::vector<real_t> values;
+            reader.Get(io.InquireVariable<real_t>(names[0]),
+                       values,
+                       adios2::Mode::Sync);
+            reader.EndStep();
+            reader_failed = reader_failed || (step_read != nsteps) ||
+                            (values.size() != 10 * 10 * 10);
+            ++nsteps;
+          }
+          reader.Close();
+        } catch (std::exception& e) {
+          std::cerr << e.what() << std::endl;
+          reader_failed = true;
+        }
+      });
+      {
+        // the stream is closed when the writer goes out of scope
+        auto writer_sst = out::Writer("SST");
+        raise::ErrorIf(not writer_sst.isStreaming(),
+                       "SST should be a streaming engine",
+                       HERE);
+        writer_sst.setEngineParameter("RendezvousReaderCount", "1");
+        writer_sst.setEngineParameter("QueueLimit", "1");
+        writer_sst.setEngineParameter("QueueFullPolicy", "Block");
+        writer_sst.defineMeshLayout({ 10, 10, 10 },
+                                    { 0, 0, 0 },
+                                    { 10, 10, 10 },
+                                    false,
+                                    Coord::Cart);
+        writer_sst.defineFieldOutputs(SimEngine::SRPIC, { "E" });
+        for (std::size_t st { 0 }; st < 3; ++st) {
+          writer_sst.beginWriting("test-sst", st, 0.1 * st);
+          writer_sst.writeField<Dim::_3D, 3>(names, field, addresses);
+          writer_sst.endWriting();
+        }
+      }
+      reader_thread.join();
+      raise::ErrorIf(reader_failed, "streamed steps are not correct", HERE);
+      raise::ErrorIf(nsteps != 3, "not all streamed steps were received", HERE);
+    }
+#endif
   } catch (std::exception& e) {
     std::cerr << e.what() << std::endl;
     cleanup();
@@ -4,11 +4,19 @@
 
 #include "arch/kokkos_aliases.h"
 #include "utils/error.h"
+#include "utils/formatting.h"
+#include "utils/log.h"
 #include "utils/param_container.h"
 
+#include "output/buffers.h"
+#include "output/staging.h"
+
 #include <Kokkos_Core.hpp>
 
+#include <algorithm>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #if defined(MPI_ENABLED)
@@ -22,11 +30,27 @@ namespace out {
   Writer::Writer(const std::string& engine) : m_engine { engine } {
     m_io = m_adios.DeclareIO("Entity::ADIOS2");
     m_io.SetEngine(engine);
+    m_streaming = (fmt::toLower(engine) == "sst") ||
+                  (fmt::toLower(engine) == "ssc");
 
     m_io.DefineVariable<std::size_t>("Step");
     m_io.DefineVariable<long double>("Time");
   }
 
+  Writer::~Writer() {
+    // all the scheduled steps are written before the stream is closed
+    m_queue.reset();
+    if (m_stream_open) {
+      m_writer.Close();
+      m_stream_open = false;
+    }
+  }
+
+  void Writer::setEngineParameter(const std::string& key,
+                                  const std::string& value) {
+    m_io.SetParameter(key, value);
+  }
+
   void Writer::addTracker(const std::string& type,
                           std::size_t        interval,
                           long double        interval_time) {
@@ -45,15 +69,42 @@ namespace out {
     }
   }
 
-  void Writer::defineMeshLayout(const std::vector<std::size_t>& glob_shape,
-                                const std::vector<std::size_t>& loc_corner,
-                                const std::vector<std::size_t>& loc_shape,
-                                bool                            incl_ghosts,
-                                Coord                           coords) {
-    m_flds_ghosts   = incl_ghosts;
-    m_flds_g_shape  = glob_shape;
-    m_flds_l_corner = loc_corner;
-    m_flds_l_shape  = loc_shape;
+  void Writer::defineMeshLayout(const std::vector<std::size_t>&    glob_shape,
+                                const std::vector<std::size_t>&    loc_corner,
+                                const std::vector<std::size_t>&    loc_shape,
+                                bool                               incl_ghosts,
+                                Coord                              coords,
+                                const std::vector<unsigned short>& stride,
+                                bool                               average) {
+    m_flds_ghosts  = incl_ghosts;
+    m_flds_stride  = stride;
+    m_flds_average = average;
+    if (m_flds_stride.size() == 0) {
+      m_flds_stride = std::vector<unsigned short>(glob_shape.size(), 1);
+    }
+    raise::ErrorIf(m_flds_stride.size() != glob_shape.size(),
+                   "Output stride must be defined for each dimension",
+                   HERE);
+    for (const auto& st : m_flds_stride) {
+      raise::ErrorIf(st == 0, "Output stride must be positive", HERE);
+      raise::ErrorIf((st > 1) && incl_ghosts,
+                     "Downsampled output is not compatible with ghost cells",
+                     HERE);
+    }
+    m_mesh_g_shape = glob_shape;
+    m_flds_g_shape.clear();
+    for (std::size_t i { 0 }; i < m_mesh_g_shape.size(); ++i) {
+      m_flds_g_shape.push_back(
+        (m_mesh_g_shape[i] + m_flds_stride[i] - 1) / m_flds_stride[i]);
+    }
+    setLocalLayout(loc_corner, loc_shape);
+
+    // field components are prepared for the output one at a time
+    std::size_t nout { 1 };
+    for (const auto& n : m_flds_l_shape) {
+      nout *= n;
+    }
+    m_device_buffers.reserve("output_field", nout);
 
     m_io.DefineAttribute("NGhosts", incl_ghosts ? N_GHOSTS : 0);
     m_io.DefineAttribute("Dimension", m_flds_g_shape.size());
@@ -67,18 +118,15 @@ namespace out {
       m_io.DefineVariable<real_t>("X" + std::to_string(i + 1),
                                   g_shape,
                                   l_corner,
-                                  l_shape,
-                                  adios2::ConstantDims);
+                                  l_shape);
       // cell-edges
-      const auto   is_last  = (m_flds_l_corner[i] + m_flds_l_shape[i] ==
-                            m_flds_g_shape[i]);
+      const auto   is_last  = isLastBlock(i);
       adios2::Dims g_shape1 = { m_flds_g_shape[i] + 1 };
       adios2::Dims l_shape1 = { m_flds_l_shape[i] + (is_last ? 1 : 0) };
       m_io.DefineVariable<real_t>("X" + std::to_string(i + 1) + "e",
                                   g_shape1,
                                   l_corner,
-                                  l_shape1,
-                                  adios2::ConstantDims);
+                                  l_shape1);
     }
 
     if constexpr (std::is_same<typename ndfield_t<Dim::_3D, 6>::array_layout,
@@ -92,6 +140,53 @@ namespace out {
     }
   }
 
+  void Writer::setLocalLayout(const std::vector<std::size_t>& loc_corner,
+                              const std::vector<std::size_t>& loc_shape) {
+    m_mesh_l_corner = loc_corner;
+    m_mesh_l_shape  = loc_shape;
+    m_flds_l_corner.clear();
+    m_flds_l_shape.clear();
+    for (unsigned short i { 0 }; i < m_mesh_g_shape.size(); ++i) {
+      const std::size_t stride = m_flds_stride[i];
+      // averaging blocks cannot be split between the subdomains
+      raise::ErrorIf(m_flds_average &&
+                       ((loc_corner[i] % stride != 0) ||
+                        (((loc_corner[i] + loc_shape[i]) % stride != 0) &&
+                         not isLastBlock(i))),
+                     "Averaged output requires the subdomains to be "
+                     "aligned with the output stride",
+                     HERE);
+      m_flds_l_corner.push_back((loc_corner[i] + stride - 1) / stride);
+      m_flds_l_shape.push_back(outputCells(i).second);
+    }
+  }
+
+  auto Writer::outputCells(unsigned short dim) const
+    -> std::pair<std::size_t, std::size_t> {
+    // output cells are the multiples of the stride within the local block
+    const std::size_t stride    = m_flds_stride[dim];
+    const auto        first_out = (m_mesh_l_corner[dim] + stride - 1) / stride;
+    const auto        end_out   = (m_mesh_l_corner[dim] + m_mesh_l_shape[dim] +
+                          stride - 1) /
+                         stride;
+    return { first_out * stride - m_mesh_l_corner[dim], end_out - first_out };
+  }
+
+  void Writer::updateMeshLayout(const std::vector<std::size_t>& loc_corner,
+                                const std::vector<std::size_t>& loc_shape) {
+    raise::ErrorIf((loc_corner.size() != m_flds_g_shape.size()) ||
+                     (loc_shape.size() != m_flds_g_shape.size()),
+                   "Mesh layout must be defined before it is updated",
+                   HERE);
+    // selections are set for each variable when it is written
+    setLocalLayout(loc_corner, loc_shape);
+    if constexpr (not std::is_same<typename ndfield_t<Dim::_3D, 6>::array_layout,
+                                   Kokkos::LayoutRight>::value) {
+      std::reverse(m_flds_l_corner.begin(), m_flds_l_corner.end());
+      std::reverse(m_flds_l_shape.begin(), m_flds_l_shape.end());
+    }
+  }
+
   void Writer::defineFieldOutputs(const SimEngine&                S,
                                   const std::vector<std::string>& flds_out) {
     m_flds_writers.clear();
@@ -104,46 +199,57 @@ namespace out {
     }
     for (const auto& fld : m_flds_writers) {
       if (fld.comp.size() == 0) {
-        m_io.DefineVariable<real_t>(fld.name(),
-                                    m_flds_g_shape,
-                                    m_flds_l_corner,
-                                    m_flds_l_shape,
-                                    adios2::ConstantDims);
+        auto var = m_io.DefineVariable<real_t>(fld.name(),
+                                               m_flds_g_shape,
+                                               m_flds_l_corner,
+                                               m_flds_l_shape);
+        compress("fields", var);
       } else {
         for (std::size_t i { 0 }; i < fld.comp.size(); ++i) {
-          m_io.DefineVariable<real_t>(fld.name(i),
-                                      m_flds_g_shape,
-                                      m_flds_l_corner,
-                                      m_flds_l_shape,
-                                      adios2::ConstantDims);
+          auto var = m_io.DefineVariable<real_t>(fld.name(i),
+                                                 m_flds_g_shape,
+                                                 m_flds_l_corner,
+                                                 m_flds_l_shape);
+          compress("fields", var);
         }
       }
     }
   }
 
   void Writer::defineParticleOutputs(Dimension                          dim,
-                                     const std::vector<unsigned short>& specs) {
+                                     const std::vector<unsigned short>& specs,
+                                     const std::vector<unsigned short>& tracked) {
     m_prtl_writers.clear();
     for (const auto& s : specs) {
-      m_prtl_writers.emplace_back(s);
+      m_prtl_writers.emplace_back(
+        s,
+        std::find(tracked.begin(), tracked.end(), s) != tracked.end());
     }
+    std::vector<std::string> names;
     for (const auto& prtl : m_prtl_writers) {
       for (auto d { 0u }; d < dim; ++d) {
-        m_io.DefineVariable<real_t>(prtl.name("X", d + 1),
-                                    { adios2::UnknownDim },
-                                    { adios2::UnknownDim },
-                                    { adios2::UnknownDim });
+        names.push_back(prtl.name("X", d + 1));
       }
       for (auto d { 0u }; d < Dim::_3D; ++d) {
-        m_io.DefineVariable<real_t>(prtl.name("U", d + 1),
-                                    { adios2::UnknownDim },
-                                    { adios2::UnknownDim },
-                                    { adios2::UnknownDim });
+        names.push_back(prtl.name("U", d + 1));
+      }
+      names.push_back(prtl.name("W", 0));
+    }
+    for (const auto& name : names) {
+      auto var = m_io.DefineVariable<real_t>(name,
+                                             { adios2::UnknownDim },
+                                             { adios2::UnknownDim },
+                                             { adios2::UnknownDim });
+      compress("particles", var);
+    }
+    for (const auto& prtl : m_prtl_writers) {
+      if (prtl.ids()) {
+        // IDs are not compressed (lossy compressors only accept floats)
+        m_io.DefineVariable<std::size_t>(prtl.name("ID", 0),
+                                         { adios2::UnknownDim },
+                                         { adios2::UnknownDim },
+                                         { adios2::UnknownDim });
       }
-      m_io.DefineVariable<real_t>(prtl.name("W", 0),
-                                  { adios2::UnknownDim },
-                                  { adios2::UnknownDim },
-                                  { adios2::UnknownDim });
     }
   }
 
@@ -158,48 +264,244 @@ namespace out {
     }
   }
 
+  void Writer::defineHistogramOutputs(const std::string& label,
+                                      const std::vector<unsigned short>& specs,
+                                      const std::vector<std::size_t>& shape) {
+    for (const auto& s : specs) {
+      m_hist_writers.emplace_back(label, s, shape);
+      m_io.DefineVariable<real_t>(m_hist_writers.back().name(), {}, {}, shape);
+    }
+    if (specs.empty()) {
+      return;
+    }
+    for (auto a { 0u }; a < shape.size(); ++a) {
+      m_io.DefineVariable<real_t>(m_hist_writers.back().binsName(a),
+                                  {},
+                                  {},
+                                  { shape[a] + 1 });
+    }
+  }
+
+  void Writer::defineAccumulatorOutputs(
+    const std::vector<OutputAccumulator>& accs) {
+    raise::ErrorIf((m_flds_g_shape.size() == 0) || (m_flds_l_corner.size() == 0) ||
+                     (m_flds_l_shape.size() == 0),
+                   "Mesh layout must be defined before field output",
+                   HERE);
+    m_acc_writers.clear();
+    for (const auto& acc : accs) {
+      m_acc_writers.push_back(acc);
+      for (auto i { 0u }; i < 3; ++i) {
+        auto var = m_io.DefineVariable<real_t>(acc.name(i),
+                                               m_flds_g_shape,
+                                               m_flds_l_corner,
+                                               m_flds_l_shape);
+        compress("fields", var);
+      }
+    }
+  }
+
+  void Writer::defineCompression(const std::string& category,
+                                 const std::string& type,
+                                 real_t             accuracy,
+                                 unsigned short     precision) {
+    m_compression.erase(category);
+    if (type == "none") {
+      return;
+    }
+    // operators are only applied by the BP engines
+    if (m_engine == "hdf5") {
+      raise::Warning("Compression is not supported by the HDF5 engine: " +
+                       category + " output is not compressed",
+                     HERE);
+      return;
+    }
+    bool           available { false };
+    adios2::Params op_params;
+    if (type == "blosc") {
+#if defined(ADIOS2_HAVE_BLOSC2) || defined(ADIOS2_HAVE_BLOSC)
+      available = true;
+#endif
+      op_params = {
+        { "compressor",             "zstd" },
+        {  "doshuffle", "BLOSC_BITSHUFFLE" }
+      };
+    } else if (type == "bzip2") {
+#if defined(ADIOS2_HAVE_BZIP2)
+      available = true;
+#endif
+    } else if (type == "zfp") {
+#if defined(ADIOS2_HAVE_ZFP)
+      available = true;
+#endif
+      if (precision > 0) {
+        op_params = {
+          { "precision", std::to_string(precision) }
+        };
+      } else {
+        op_params = {
+          { "accuracy", fmt::format("%.8e", static_cast<double>(accuracy)) }
+        };
+      }
+    } else if (type == "sz") {
+#if defined(ADIOS2_HAVE_SZ)
+      available = true;
+#endif
+      op_params = {
+        { "accuracy", fmt::format("%.8e", static_cast<double>(accuracy)) }
+      };
+    } else {
+      raise::Error("Unknown compression type " + type, HERE);
+    }
+    if (not available) {
+      raise::Warning("ADIOS2 is built without " + type + ": " + category +
+                       " output is not compressed",
+                     HERE);
+      return;
+    }
+    m_compression[category] = { type, op_params };
+  }
+
+  void Writer::compress(const std::string&        category,
+                        adios2::Variable<real_t>& var) {
+    const auto compression = m_compression.find(category);
+    if (compression != m_compression.end()) {
+      var.AddOperation(compression->second.first, compression->second.second);
+    }
+  }
+
+  template <Dimension D>
+  auto OutputBuffer(BufferPool<AccelMemSpace>&     pool,
+                    const tuple_t<std::size_t, D>& shape) -> ndarray_t<D> {
+    if constexpr (D == Dim::_1D) {
+      return pool.template view<ndarray_t<D>>("output_field", 0.0, shape[0]);
+    } else if constexpr (D == Dim::_2D) {
+      return pool.template view<ndarray_t<D>>("output_field", 0.0, shape[0], shape[1]);
+    } else if constexpr (D == Dim::_3D) {
+      return pool.template view<ndarray_t<D>>("output_field",
+                                              0.0,
+                                              shape[0],
+                                              shape[1],
+                                              shape[2]);
+    }
+  }
+
   template <Dimension D, int N>
-  void WriteField(adios2::IO&            io,
-                  adios2::Engine&        writer,
-                  const std::string&     varname,
-                  const ndfield_t<D, N>& field,
-                  std::size_t            comp,
-                  bool                   ghosts) {
-    auto       var      = io.InquireVariable<real_t>(varname);
+  void PrepareField(const ndfield_t<D, N>& field,
+                    std::size_t            comp,
+                    bool                   ghosts,
+                    const ndarray_t<D>&    output_field) {
     const auto gh_zones = ghosts ? 0 : N_GHOSTS;
 
     if constexpr (D == Dim::_1D) {
-      auto slice_i1     = range_tuple_t(gh_zones, field.extent(0) - gh_zones);
-      auto slice        = Kokkos::subview(field, slice_i1, comp);
-      auto output_field = array_t<real_t*>("output_field", slice.extent(0));
+      auto slice_i1 = range_tuple_t(gh_zones, field.extent(0) - gh_zones);
+      auto slice    = Kokkos::subview(field, slice_i1, comp);
       Kokkos::deep_copy(output_field, slice);
-      auto output_field_host = Kokkos::create_mirror_view(output_field);
-      Kokkos::deep_copy(output_field_host, output_field);
-      writer.Put(var, output_field_host);
     } else if constexpr (D == Dim::_2D) {
-      auto slice_i1     = range_tuple_t(gh_zones, field.extent(0) - gh_zones);
-      auto slice_i2     = range_tuple_t(gh_zones, field.extent(1) - gh_zones);
-      auto slice        = Kokkos::subview(field, slice_i1, slice_i2, comp);
-      auto output_field = array_t<real_t**>("output_field",
-                                            slice.extent(0),
-                                            slice.extent(1));
+      auto slice_i1 = range_tuple_t(gh_zones, field.extent(0) - gh_zones);
+      auto slice_i2 = range_tuple_t(gh_zones, field.extent(1) - gh_zones);
+      auto slice    = Kokkos::subview(field, slice_i1, slice_i2, comp);
       Kokkos::deep_copy(output_field, slice);
-      auto output_field_host = Kokkos::create_mirror_view(output_field);
-      Kokkos::deep_copy(output_field_host, output_field);
-      writer.Put(var, output_field_host);
     } else if constexpr (D == Dim::_3D) {
       auto slice_i1 = range_tuple_t(gh_zones, field.extent(0) - gh_zones);
       auto slice_i2 = range_tuple_t(gh_zones, field.extent(1) - gh_zones);
       auto slice_i3 = range_tuple_t(gh_zones, field.extent(2) - gh_zones);
       auto slice = Kokkos::subview(field, slice_i1, slice_i2, slice_i3, comp);
-      auto output_field = array_t<real_t***>("output_field",
-                                             slice.extent(0),
-                                             slice.extent(1),
-                                             slice.extent(2));
       Kokkos::deep_copy(output_field, slice);
-      auto output_field_host = Kokkos::create_mirror_view(output_field);
-      Kokkos::deep_copy(output_field_host, output_field);
-      writer.Put(var, output_field_host);
+    }
+  }
+
+  template <Dimension D, int N>
+  void PrepareDownsampledField(const ndfield_t<D, N>&         field,
+                               std::size_t                    comp,
+                               const tuple_t<std::size_t, D>& first,
+                               const tuple_t<std::size_t, D>& nout,
+                               const tuple_t<std::size_t, D>& stride,
+                               bool                           average,
+                               const ndarray_t<D>&            output_field) {
+    // output cell k covers the active cells [first + k * stride, ... + stride)
+    if constexpr (D == Dim::_1D) {
+      const auto f1 = first[0], s1 = stride[0];
+      const auto n1 = field.extent(0) - 2 * N_GHOSTS;
+      Kokkos::parallel_for(
+        "DownsampleField",
+        CreateRangePolicy<Dim::_1D>({ 0 }, { nout[0] }),
+        Lambda(index_t k1) {
+          const auto i1_min = f1 + k1 * s1;
+          if (average) {
+            const auto i1_max = (i1_min + s1 < n1) ? i1_min + s1 : n1;
+            real_t     sum { ZERO };
+            for (auto i1 = i1_min; i1 < i1_max; ++i1) {
+              sum += field(i1 + N_GHOSTS, comp);
+            }
+            output_field(k1) = sum / static_cast<real_t>(i1_max - i1_min);
+          } else {
+            output_field(k1) = field(i1_min + N_GHOSTS, comp);
+          }
+        });
+    } else if constexpr (D == Dim::_2D) {
+      const auto f1 = first[0], s1 = stride[0];
+      const auto f2 = first[1], s2 = stride[1];
+      const auto n1 = field.extent(0) - 2 * N_GHOSTS;
+      const auto n2 = field.extent(1) - 2 * N_GHOSTS;
+      Kokkos::parallel_for(
+        "DownsampleField",
+        CreateRangePolicy<Dim::_2D>({ 0, 0 }, { nout[0], nout[1] }),
+        Lambda(index_t k1, index_t k2) {
+          const auto i1_min = f1 + k1 * s1;
+          const auto i2_min = f2 + k2 * s2;
+          if (average) {
+            const auto i1_max = (i1_min + s1 < n1) ? i1_min + s1 : n1;
+            const auto i2_max = (i2_min + s2 < n2) ? i2_min + s2 : n2;
+            real_t     sum { ZERO };
+            for (auto i2 = i2_min; i2 < i2_max; ++i2) {
+              for (auto i1 = i1_min; i1 < i1_max; ++i1) {
+                sum += field(i1 + N_GHOSTS, i2 + N_GHOSTS, comp);
+              }
+            }
+            output_field(k1, k2) = sum / static_cast<real_t>(
+                                           (i1_max - i1_min) * (i2_max - i2_min));
+          } else {
+            output_field(k1, k2) = field(i1_min + N_GHOSTS, i2_min + N_GHOSTS, comp);
+          }
+        });
+    } else if constexpr (D == Dim::_3D) {
+      const auto f1 = first[0], s1 = stride[0];
+      const auto f2 = first[1], s2 = stride[1];
+      const auto f3 = first[2], s3 = stride[2];
+      const auto n1 = field.extent(0) - 2 * N_GHOSTS;
+      const auto n2 = field.extent(1) - 2 * N_GHOSTS;
+      const auto n3 = field.extent(2) - 2 * N_GHOSTS;
+      Kokkos::parallel_for(
+        "DownsampleField",
+        CreateRangePolicy<Dim::_3D>({ 0, 0, 0 }, { nout[0], nout[1], nout[2] }),
+        Lambda(index_t k1, index_t k2, index_t k3) {
+          const auto i1_min = f1 + k1 * s1;
+          const auto i2_min = f2 + k2 * s2;
+          const auto i3_min = f3 + k3 * s3;
+          if (average) {
+            const auto i1_max = (i1_min + s1 < n1) ? i1_min + s1 : n1;
+            const auto i2_max = (i2_min + s2 < n2) ? i2_min + s2 : n2;
+            const auto i3_max = (i3_min + s3 < n3) ? i3_min + s3 : n3;
+            real_t     sum { ZERO };
+            for (auto i3 = i3_min; i3 < i3_max; ++i3) {
+              for (auto i2 = i2_min; i2 < i2_max; ++i2) {
+                for (auto i1 = i1_min; i1 < i1_max; ++i1) {
+                  sum += field(i1 + N_GHOSTS, i2 + N_GHOSTS, i3 + N_GHOSTS, comp);
+                }
+              }
+            }
+            output_field(k1, k2, k3) = sum / static_cast<real_t>(
+                                               (i1_max - i1_min) *
+                                               (i2_max - i2_min) *
+                                               (i3_max - i3_min));
+          } else {
+            output_field(k1, k2, k3) = field(i1_min + N_GHOSTS,
+                                             i2_min + N_GHOSTS,
+                                             i3_min + N_GHOSTS,
+                                             comp);
+          }
+        });
     }
   }
 
@@ -213,49 +515,70 @@ namespace out {
     raise::ErrorIf(names.size() != addresses.size(),
                    "# of names != # of addresses ",
                    HERE);
+    tuple_t<std::size_t, D> first { 0 }, nout { 0 }, stride { 0 };
+    bool                    downsample { false };
+    for (unsigned short d { 0 }; d < D; ++d) {
+      const auto cells = outputCells(d);
+      first[d]         = cells.first;
+      nout[d]          = cells.second;
+      stride[d]        = m_flds_stride[d];
+      downsample       = downsample || (m_flds_stride[d] > 1);
+    }
+    // the same (persistent) buffer is used for all the components
+    const auto output_field = OutputBuffer<D>(m_device_buffers, nout);
     for (std::size_t i { 0 }; i < addresses.size(); ++i) {
-      WriteField<D, N>(m_io, m_writer, names[i], fld, addresses[i], m_flds_ghosts);
+      if (downsample) {
+        PrepareDownsampledField<D, N>(fld,
+                                      addresses[i],
+                                      first,
+                                      nout,
+                                      stride,
+                                      m_flds_average,
+                                      output_field);
+      } else {
+        PrepareField<D, N>(fld, addresses[i], m_flds_ghosts, output_field);
+      }
+      stage(names[i], m_flds_g_shape, m_flds_l_corner, m_flds_l_shape, output_field);
     }
   }
 
-  void Writer::writeParticleQuantity(const array_t<real_t*>& array,
-                                     std::size_t             glob_total,
-                                     std::size_t             loc_offset,
-                                     const std::string&      varname) {
-    auto var = m_io.InquireVariable<real_t>(varname);
-    var.SetShape({ glob_total });
-    var.SetSelection(
-      adios2::Box<adios2::Dims>({ loc_offset }, { array.extent(0) }));
-    auto array_h = Kokkos::create_mirror_view(array);
-    Kokkos::deep_copy(array_h, array);
-    m_writer.Put<real_t>(var, array_h);
+  template <typename T>
+  void Writer::writeParticleQuantity(const array_t<T*>& array,
+                                     std::size_t        glob_total,
+                                     std::size_t        loc_offset,
+                                     const std::string& varname) {
+    stage(varname, { glob_total }, { loc_offset }, { array.extent(0) }, array);
   }
 
   void Writer::writeSpectrum(const array_t<real_t*>& counts,
                              const std::string&      varname) {
-    auto counts_h = Kokkos::create_mirror_view(counts);
-    Kokkos::deep_copy(counts_h, counts);
+    writeHistogram(counts, { counts.extent(0) }, varname);
+  }
+
+  void Writer::writeHistogram(const array_t<real_t*>&         counts,
+                              const std::vector<std::size_t>& shape,
+                              const std::string&              varname) {
 #if defined(MPI_ENABLED)
-    array_t<real_t*> counts_all { "counts_all", counts.extent(0) };
-    auto             counts_h_all = Kokkos::create_mirror_view(counts_all);
-    int              rank;
+    auto counts_h = m_host_buffers.view<staging_array_t>("counts",
+                                                         0.0,
+                                                         counts.extent(0));
+    Kokkos::deep_copy(counts_h, counts);
+    int rank;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    // reduced directly to the staged buffer of the root rank
+    real_t* counts_all = nullptr;
+    if (rank == MPI_ROOT_RANK) {
+      counts_all = m_staged.add(varname, {}, {}, shape);
+    }
     MPI_Reduce(counts_h.data(),
-               counts_h_all.data(),
+               counts_all,
                counts_h.extent(0),
                mpi::get_type<real_t>(),
                MPI_SUM,
                MPI_ROOT_RANK,
                MPI_COMM_WORLD);
-    if (rank == MPI_ROOT_RANK) {
-      auto var = m_io.InquireVariable<real_t>(varname);
-      var.SetSelection(adios2::Box<adios2::Dims>({}, { counts.extent(0) }));
-      m_writer.Put<real_t>(var, counts_h_all);
-    }
 #else
-    auto var = m_io.InquireVariable<real_t>(varname);
-    var.SetSelection(adios2::Box<adios2::Dims>({}, { counts.extent(0) }));
-    m_writer.Put<real_t>(var, counts_h);
+    stage(varname, {}, {}, shape, counts);
 #endif
   }
 
@@ -268,45 +591,180 @@ namespace out {
       return;
     }
 #endif
-    auto var = m_io.InquireVariable<real_t>(varname);
-    var.SetSelection(adios2::Box<adios2::Dims>({}, { e_bins.extent(0) }));
-    auto e_bins_h = Kokkos::create_mirror_view(e_bins);
-    Kokkos::deep_copy(e_bins_h, e_bins);
-    m_writer.Put<real_t>(var, e_bins_h);
+    stage(varname, {}, {}, { e_bins.extent(0) }, e_bins);
   }
 
   void Writer::writeMesh(unsigned short          dim,
                          const array_t<real_t*>& xc,
                          const array_t<real_t*>& xe) {
-    auto varc = m_io.InquireVariable<real_t>("X" + std::to_string(dim + 1));
-    auto vare = m_io.InquireVariable<real_t>("X" + std::to_string(dim + 1) + "e");
-    auto xc_h = Kokkos::create_mirror_view(xc);
-    auto xe_h = Kokkos::create_mirror_view(xe);
-    Kokkos::deep_copy(xc_h, xc);
-    Kokkos::deep_copy(xe_h, xe);
-    m_writer.Put(varc, xc_h);
-    m_writer.Put(vare, xe_h);
+    auto xc_out = xc;
+    auto xe_out = xe;
+    if (m_flds_stride[dim] > 1) {
+      // output cell k spans the cells [first + k * stride, ... + stride)
+      const auto        cells   = outputCells(dim);
+      const auto        first   = cells.first;
+      const auto        nout    = cells.second;
+      const std::size_t stride  = m_flds_stride[dim];
+      const auto        ncells  = m_mesh_l_shape[dim];
+      const auto        average = m_flds_average;
+      const auto        nedges  = nout + (isLastBlock(dim) ? 1 : 0);
+      xc_out                    = array_t<real_t*> { "Xc", nout };
+      xe_out                    = array_t<real_t*> { "Xe", nedges };
+      Kokkos::parallel_for(
+        "DownsampleMesh",
+        nedges,
+        Lambda(index_t k) {
+          if (k == nout) {
+            // last edge of the mesh
+            xe_out(k) = xe(ncells);
+            return;
+          }
+          const auto i_min = first + k * stride;
+          const auto i_max = (i_min + stride < ncells) ? i_min + stride : ncells;
+          xe_out(k)        = xe(i_min);
+          if (average) {
+            real_t sum { ZERO };
+            for (auto i = i_min; i < i_max; ++i) {
+              sum += xc(i);
+            }
+            xc_out(k) = sum / static_cast<real_t>(i_max - i_min);
+          } else {
+            xc_out(k) = xc(i_min);
+          }
+        });
+    }
+    auto& cached = m_mesh_cache[{ dim, m_mesh_l_corner[dim], m_mesh_l_shape[dim] }];
+    cached.first  = Kokkos::create_mirror_view(xc_out);
+    cached.second = Kokkos::create_mirror_view(xe_out);
+    Kokkos::deep_copy(cached.first, xc_out);
+    Kokkos::deep_copy(cached.second, xe_out);
+    writeCachedMesh(dim);
+  }
+
+  auto Writer::writeCachedMesh(unsigned short dim) -> bool {
+    const auto cached = m_mesh_cache.find(
+      { dim, m_mesh_l_corner[dim], m_mesh_l_shape[dim] });
+    if (cached == m_mesh_cache.end()) {
+      return false;
+    }
+    const auto&       xc      = cached->second.first;
+    const auto&       xe      = cached->second.second;
+    const std::size_t stride  = m_flds_stride[dim];
+    const auto        g_shape = (m_mesh_g_shape[dim] + stride - 1) / stride;
+    const auto        corner  = (m_mesh_l_corner[dim] + stride - 1) / stride;
+    stage("X" + std::to_string(dim + 1),
+          { g_shape },
+          { corner },
+          { xc.extent(0) },
+          xc);
+    stage("X" + std::to_string(dim + 1) + "e",
+          { g_shape + 1 },
+          { corner },
+          { xe.extent(0) },
+          xe);
+    return true;
+  }
+
+  auto Writer::particleBuffer(const std::string& label, std::size_t size)
+    -> array_t<real_t*> {
+    // grows with a margin to avoid reallocating as the # of particles changes
+    return m_device_buffers.view<array_t<real_t*>>(label, 0.5, size);
+  }
+
+  auto Writer::particleIndexBuffer(const std::string& label, std::size_t size)
+    -> array_t<std::size_t*> {
+    return m_index_buffers.view<array_t<std::size_t*>>(label, 0.5, size);
+  }
+
+  void Writer::enableAsync(std::size_t depth) {
+    m_queue = std::make_unique<StagingQueue>(depth, [this](StagedStep& staged) {
+      writeStaged(staged);
+    });
+  }
+
+  template <class V>
+  void Writer::stage(const std::string&  varname,
+                     const adios2::Dims& shape,
+                     const adios2::Dims& start,
+                     const adios2::Dims& count,
+                     const V&            data) {
+    using T = typename V::non_const_value_type;
+    // copy to the (reusable) host buffer of the current step
+    auto buff = Kokkos::View<typename V::non_const_data_type,
+                             typename V::array_layout,
+                             Kokkos::HostSpace,
+                             Kokkos::MemoryTraits<Kokkos::Unmanaged>> {
+      m_staged.add<T>(varname, shape, start, count),
+      data.layout()
+    };
+    Kokkos::deep_copy(buff, data);
+  }
+
+  void Writer::writeStaged(StagedStep& staged) {
+    m_adios.ExitComputationBlock();
+    if (not m_stream_open) {
+      // files are reopened every step, streams only once (the first time
+      // blocks until the readers connect)
+      try {
+        m_writer = m_io.Open(m_streaming ? staged.fname
+                                         : staged.fname +
+                                             (m_engine == "hdf5" ? ".h5" : ".bp"),
+                             m_mode);
+      } catch (std::exception& e) {
+        raise::Fatal(e.what(), HERE);
+      }
+      m_mode        = adios2::Mode::Append;
+      m_stream_open = m_streaming;
+    }
+    m_writer.BeginStep();
+    m_writer.Put(m_io.InquireVariable<std::size_t>("Step"), &staged.step);
+    m_writer.Put(m_io.InquireVariable<long double>("Time"), &staged.time);
+    for (std::size_t i { 0 }; i < staged.nvariables; ++i) {
+      const auto& stvar = staged.variables[i];
+      if (stvar.type == adios2::GetType<std::size_t>()) {
+        putStaged<std::size_t>(stvar);
+      } else {
+        putStaged<real_t>(stvar);
+      }
+    }
+    m_writer.EndStep();
+    if (not m_streaming) {
+      m_writer.Close();
+    }
+    m_adios.EnterComputationBlock();
+  }
+
+  template <typename T>
+  void Writer::putStaged(const StagedVariable& stvar) {
+    auto var = m_io.InquireVariable<T>(stvar.name);
+    if (not stvar.shape.empty()) {
+      var.SetShape(stvar.shape);
+    }
+    var.SetSelection(adios2::Box<adios2::Dims>(stvar.start, stvar.count));
+    m_writer.Put<T>(var, reinterpret_cast<const T*>(stvar.data.data()));
   }
 
   void Writer::beginWriting(const std::string& fname,
                             std::size_t        tstep,
                             long double        time) {
-    m_adios.ExitComputationBlock();
-    try {
-      m_writer = m_io.Open(fname + (m_engine == "hdf5" ? ".h5" : ".bp"), m_mode);
-    } catch (std::exception& e) {
-      raise::Fatal(e.what(), HERE);
+    if (m_queue != nullptr) {
+      // waits if too many steps are still being written
+      m_staged = m_queue->acquire();
     }
-    m_mode = adios2::Mode::Append;
-    m_writer.BeginStep();
-    m_writer.Put(m_io.InquireVariable<std::size_t>("Step"), &tstep);
-    m_writer.Put(m_io.InquireVariable<long double>("Time"), &time);
+    m_staged.clear();
+    m_staged.fname = fname;
+    m_staged.step  = tstep;
+    m_staged.time  = time;
   }
 
   void Writer::endWriting() {
-    m_writer.EndStep();
-    m_writer.Close();
-    m_adios.EnterComputationBlock();
+    if (m_queue != nullptr) {
+      m_queue->push(std::move(m_staged));
+      m_staged = StagedStep {};
+    } else {
+      writeStaged(m_staged);
+      m_staged.clear();
+    }
   }
 
   template void Writer::writeField<Dim::_1D, 3>(const std::vector<std::string>&,
@@ -328,41 +786,38 @@ namespace out {
                                                 const ndfield_t<Dim::_3D, 6>&,
                                                 const std::vector<std::size_t>&);
 
-  template void WriteField<Dim::_1D, 3>(adios2::IO&,
-                                        adios2::Engine&,
-                                        const std::string&,
-                                        const ndfield_t<Dim::_1D, 3>&,
-                                        std::size_t,
-                                        bool);
-  template void WriteField<Dim::_1D, 6>(adios2::IO&,
-                                        adios2::Engine&,
-                                        const std::string&,
-                                        const ndfield_t<Dim::_1D, 6>&,
-                                        std::size_t,
-                                        bool);
-  template void WriteField<Dim::_2D, 3>(adios2::IO&,
-                                        adios2::Engine&,
-                                        const std::string&,
-                                        const ndfield_t<Dim::_2D, 3>&,
-                                        std::size_t,
-                                        bool);
-  template void WriteField<Dim::_2D, 6>(adios2::IO&,
-                                        adios2::Engine&,
-                                        const std::string&,
-                                        const ndfield_t<Dim::_2D, 6>&,
-                                        std::size_t,
-                                        bool);
-  template void WriteField<Dim::_3D, 3>(adios2::IO&,
-                                        adios2::Engine&,
-                                        const std::string&,
-                                        const ndfield_t<Dim::_3D, 3>&,
-                                        std::size_t,
-                                        bool);
-  template void WriteField<Dim::_3D, 6>(adios2::IO&,
-                                        adios2::Engine&,
-                                        const std::string&,
-                                        const ndfield_t<Dim::_3D, 6>&,
-                                        std::size_t,
-                                        bool);
+  template void Writer::writeParticleQuantity<real_t>(const array_t<real_t*>&,
+                                                      std::size_t,
+                                                      std::size_t,
+                                                      const std::string&);
+  template void Writer::writeParticleQuantity<std::size_t>(
+    const array_t<std::size_t*>&,
+    std::size_t,
+    std::size_t,
+    const std::string&);
 
+  template void PrepareField<Dim::_1D, 3>(const ndfield_t<Dim::_1D, 3>&,
+                                           std::size_t,
+                                           bool,
+                                           const ndarray_t<Dim::_1D>&);
+  template void PrepareField<Dim::_1D, 6>(const ndfield_t<Dim::_1D, 6>&,
+                                           std::size_t,
+                                           bool,
+                                           const ndarray_t<Dim::_1D>&);
+  template void PrepareField<Dim::_2D, 3>(const ndfield_t<Dim::_2D, 3>&,
+                                           std::size_t,
+                                           bool,
+                                           const ndarray_t<Dim::_2D>&);
+  template void PrepareField<Dim::_2D, 6>(const ndfield_t<Dim::_2D, 6>&,
+                                           std::size_t,
+                                           bool,
+                                           const ndarray_t<Dim::_2D>&);
+  template void PrepareField<Dim::_3D, 3>(const ndfield_t<Dim::_3D, 3>&,
+                                           std::size_t,
+                                           bool,
+                                           const ndarray_t<Dim::_3D>&);
+  template void PrepareField<Dim::_3D, 6>(const ndfield_t<Dim::_3D, 6>&,
+                                           std::size_t,
+                                           bool,
+                                           const ndarray_t<Dim::_3D>&);
 } // namespace out
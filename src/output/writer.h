@@ -12,9 +12,13 @@
 #include "arch/kokkos_aliases.h"
 #include "utils/param_container.h"
 
+#include "output/accumulators.h"
+#include "output/buffers.h"
 #include "output/fields.h"
+#include "output/histograms.h"
 #include "output/particles.h"
 #include "output/spectra.h"
+#include "output/staging.h"
 
 #include <adios2.h>
 #include <adios2/cxx11/KokkosView.h>
@@ -23,16 +27,20 @@
   #include <mpi.h>
 #endif
 
+#include <map>
+#include <memory>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace out {
 
   class Tracker {
-    const std::string m_type;
-    const std::size_t m_interval;
-    const long double m_interval_time;
-    const bool        m_use_time;
+    std::string m_type;
+    std::size_t m_interval;
+    long double m_interval_time;
+    bool        m_use_time;
 
     long double m_last_output_time { -1.0 };
 
@@ -68,6 +76,9 @@ namespace out {
     adios2::IO     m_io;
     adios2::Engine m_writer;
     adios2::Mode   m_mode { adios2::Mode::Write };
+    // streaming engines are opened once & closed at the end
+    bool           m_streaming { false };
+    bool           m_stream_open { false };
 
     // global shape of the fields array to output
     adios2::Dims      m_flds_g_shape;
@@ -78,53 +89,245 @@ namespace out {
     bool              m_flds_ghosts;
     const std::string m_engine;
 
+    // downsampling of the fields output (per dimension)
+    std::vector<unsigned short> m_flds_stride;
+    // average over the blocks of cells (or pick every `stride`-th cell)
+    bool                        m_flds_average { false };
+    // global shape, local corner & local shape of the full-resolution mesh
+    std::vector<std::size_t>    m_mesh_g_shape;
+    std::vector<std::size_t>    m_mesh_l_corner;
+    std::vector<std::size_t>    m_mesh_l_shape;
+
+    // persistent device buffers of the output data
+    BufferPool<AccelMemSpace>              m_device_buffers;
+    // persistent device buffers of the particle indices & IDs
+    BufferPool<AccelMemSpace, std::size_t> m_index_buffers;
+    // persistent host buffers of the data reduced across the ranks
+    BufferPool<staging_space_t>            m_host_buffers;
+    // output mesh coordinates (cell-centers & edges) of each local block
+    std::map<std::tuple<unsigned short, std::size_t, std::size_t>,
+             std::pair<array_mirror_t<real_t*>, array_mirror_t<real_t*>>>
+      m_mesh_cache;
+
     std::map<std::string, Tracker> m_trackers;
 
-    std::vector<OutputField>   m_flds_writers;
-    std::vector<OutputSpecies> m_prtl_writers;
-    std::vector<OutputSpectra> m_spectra_writers;
+    // compression operator type & parameters of each output category
+    std::map<std::string, std::pair<std::string, adios2::Params>> m_compression;
+
+    std::vector<OutputField>       m_flds_writers;
+    std::vector<OutputSpecies>     m_prtl_writers;
+    std::vector<OutputSpectra>     m_spectra_writers;
+    std::vector<OutputHistogram>   m_hist_writers;
+    std::vector<OutputAccumulator> m_acc_writers;
+
+    /**
+     * @brief Adds the compression operator of the output category (if any)
+     */
+    void compress(const std::string&, adios2::Variable<real_t>&);
+
+    /**
+     * @brief Sets the local part of the (downsampled) output mesh
+     * @param loc_corner local corner of the full-resolution mesh
+     * @param loc_shape local shape of the full-resolution mesh
+     */
+    void setLocalLayout(const std::vector<std::size_t>&,
+                        const std::vector<std::size_t>&);
+
+    /**
+     * @brief Local full-resolution cells which go to the output
+     * @param dim direction
+     * @returns index of the first cell (from the local corner) & # of output cells
+     */
+    auto outputCells(unsigned short dim) const
+      -> std::pair<std::size_t, std::size_t>;
+
+    auto isLastBlock(unsigned short dim) const -> bool {
+      return m_mesh_l_corner[dim] + m_mesh_l_shape[dim] == m_mesh_g_shape[dim];
+    }
+
+    // host copy of the data of the step being written
+    StagedStep                    m_staged;
+    // steps written on a dedicated I/O thread (if asynchronous)
+    std::unique_ptr<StagingQueue> m_queue;
+
+    /**
+     * @brief Copies the data to the host buffer of the current step
+     * @param varname variable name
+     * @param shape global shape (empty for local arrays)
+     * @param start local corner
+     * @param count local shape
+     * @param data contiguous device (or host) view
+     */
+    template <class V>
+    void stage(const std::string&,
+               const adios2::Dims&,
+               const adios2::Dims&,
+               const adios2::Dims&,
+               const V&);
+
+    /**
+     * @brief Writes all the staged data of a step with ADIOS2
+     */
+    void writeStaged(StagedStep&);
+
+    template <typename T>
+    void putStaged(const StagedVariable&);
 
   public:
     Writer() : m_engine { "disabled" } {}
 
     Writer(const std::string& engine);
-    ~Writer() = default;
+    ~Writer();
+
+    // the I/O thread of the staging queue & the open stream are bound to `this`
+    Writer(Writer&&)            = delete;
+    Writer& operator=(Writer&&) = delete;
 
-    Writer(Writer&&) = default;
+    /**
+     * @brief Moves the ADIOS2 writes to a dedicated I/O thread
+     * @param depth max # of the staged steps waiting to be written
+     * @note `endWriting` returns as soon as the data is copied to the host
+     */
+    void enableAsync(std::size_t depth);
+
+    /**
+     * @brief Sets a parameter of the ADIOS2 engine (e.g., of the SST stream)
+     * @note Should be called before the first output step
+     */
+    void setEngineParameter(const std::string&, const std::string&);
 
     void addTracker(const std::string&, std::size_t, long double);
     auto shouldWrite(const std::string&, std::size_t, long double) -> bool;
 
     void writeAttrs(const prm::Parameters& params);
 
+    /**
+     * @brief Defines the layout of the full-resolution mesh
+     * @param glob_shape global shape
+     * @param loc_corner local corner
+     * @param loc_shape local shape
+     * @param incl_ghosts whether the ghost cells are written
+     * @param coords coordinate system
+     * @param stride output every `stride`-th cell in each direction (optional)
+     * @param average average over the blocks of `stride` cells instead
+     * @note The fields & the mesh are downsampled on the fly when written
+     */
     void defineMeshLayout(const std::vector<std::size_t>&,
                           const std::vector<std::size_t>&,
                           const std::vector<std::size_t>&,
                           bool incl_ghosts,
-                          Coord);
+                          Coord,
+                          const std::vector<unsigned short>& stride  = {},
+                          bool                               average = false);
+
+    /**
+     * @brief Changes the local part of the mesh (e.g., after load balancing)
+     * @param loc_corner local corner
+     * @param loc_shape local shape
+     */
+    void updateMeshLayout(const std::vector<std::size_t>&,
+                          const std::vector<std::size_t>&);
+
+    /**
+     * @brief Compresses the variables of the output category defined afterwards
+     * @param category "fields" or "particles"
+     * @param type "none", "blosc", "bzip2", "zfp" or "sz"
+     * @param accuracy absolute error bound of the lossy compression
+     * @param precision # of bits kept by "zfp" (overrides `accuracy` if > 0)
+     * @note Ignored (with a warning) if ADIOS2 is built without the compressor
+     */
+    void defineCompression(const std::string&,
+                           const std::string&,
+                           real_t         accuracy  = 0.0,
+                           unsigned short precision = 0);
 
     void defineFieldOutputs(const SimEngine&, const std::vector<std::string>&);
-    void defineParticleOutputs(Dimension, const std::vector<unsigned short>&);
+    /**
+     * @brief Defines the particle quantities to write
+     * @param dim dimension of the particle coordinates
+     * @param specs species to write
+     * @param tracked species with the persistent IDs (written as `pID_*`)
+     */
+    void defineParticleOutputs(Dimension,
+                               const std::vector<unsigned short>&,
+                               const std::vector<unsigned short>& tracked = {});
     void defineSpectraOutputs(const std::vector<unsigned short>&);
-
+    /**
+     * @brief Defines the histogram (& its bin edges) for each species
+     * @param label name of the histogram
+     * @param specs species to compute the histogram for
+     * @param shape # of bins along each axis
+     */
+    void defineHistogramOutputs(const std::string&,
+                                const std::vector<unsigned short>&,
+                                const std::vector<std::size_t>&);
+    /**
+     * @brief Defines the time-accumulated fields (written with the fields)
+     * @param accs accumulated quantities (3 components each)
+     */
+    void defineAccumulatorOutputs(const std::vector<OutputAccumulator>&);
+
+    /**
+     * @brief Writes (& caches) the coordinates of the local block of the mesh
+     * @param dim direction
+     * @param xc cell-center coordinates
+     * @param xe cell-edge coordinates
+     */
     void writeMesh(unsigned short, const array_t<real_t*>&, const array_t<real_t*>&);
 
+    /**
+     * @brief Writes the cached coordinates of the local block of the mesh
+     * @param dim direction
+     * @returns false if the coordinates of the current block are not cached
+     */
+    auto writeCachedMesh(unsigned short) -> bool;
+
+    /**
+     * @brief Persistent device buffer for the particle quantities
+     * @param label buffer label
+     * @param size # of particles
+     * @note The buffer is reused (& overwritten) in the next output step
+     */
+    auto particleBuffer(const std::string&, std::size_t) -> array_t<real_t*>;
+
+    /**
+     * @brief Persistent device buffer for the particle indices (or IDs)
+     * @overload
+     */
+    auto particleIndexBuffer(const std::string&, std::size_t)
+      -> array_t<std::size_t*>;
+
     template <Dimension D, int N>
     void writeField(const std::vector<std::string>&,
                     const ndfield_t<D, N>&,
                     const std::vector<std::size_t>&);
 
-    void writeParticleQuantity(const array_t<real_t*>&,
+    template <typename T>
+    void writeParticleQuantity(const array_t<T*>&,
                                std::size_t,
                                std::size_t,
                                const std::string&);
     void writeSpectrum(const array_t<real_t*>&, const std::string&);
     void writeSpectrumBins(const array_t<real_t*>&, const std::string&);
+    /**
+     * @brief Writes the histogram summed over all the ranks
+     * @param counts flattened histogram
+     * @param shape # of bins along each axis
+     * @param varname variable name
+     */
+    void writeHistogram(const array_t<real_t*>&,
+                        const std::vector<std::size_t>&,
+                        const std::string&);
 
     void beginWriting(const std::string&, std::size_t, long double);
     void endWriting();
 
     /* getters -------------------------------------------------------------- */
+    [[nodiscard]]
+    auto isStreaming() const -> bool {
+      return m_streaming;
+    }
+
     auto fieldWriters() const -> const std::vector<OutputField>& {
       return m_flds_writers;
     }
@@ -136,6 +339,14 @@ namespace out {
     auto spectraWriters() const -> const std::vector<OutputSpectra>& {
       return m_spectra_writers;
     }
+
+    auto histogramWriters() const -> const std::vector<OutputHistogram>& {
+      return m_hist_writers;
+    }
+
+    auto accumulatorWriters() const -> const std::vector<OutputAccumulator>& {
+      return m_acc_writers;
+    }
   };
 
 } // namespace out